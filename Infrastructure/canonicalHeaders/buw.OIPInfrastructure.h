@@ -28,6 +28,7 @@
 #include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
 #include "OpenInfraPlatform/Infrastructure/Alignment/Alignment3DBased3D.h"
 #include "OpenInfraPlatform/Infrastructure/Alignment/IAlignment3D.h"
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CorridorMeshBuilder.h"
 
 // Import
 #include "OpenInfraPlatform/Infrastructure/Import/ImportLandXml.h"
@@ -54,6 +55,8 @@
 #include "OpenInfraPlatform/Infrastructure/Export/ExportIfc4x1.h"
 #include "OpenInfraPlatform/Infrastructure/Export/ExportIfcRoad.h"
 #include "OpenInfraPlatform/Infrastructure/Export/ExportSVG.h"
+#include "OpenInfraPlatform/Infrastructure/Export/ExportDXF.h"
+#include "OpenInfraPlatform/Infrastructure/Export/ExportObj.h"
 #include "OpenInfraPlatform/Infrastructure/Export/ExportIfcOWL4x1.h"
 
 #endif // end define buw_BlueInfrastructure_2c344381_de0a_4a5a_8499_87683fa8ce80_h
\ No newline at end of file
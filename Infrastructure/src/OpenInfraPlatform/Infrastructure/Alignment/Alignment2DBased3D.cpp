@@ -17,50 +17,39 @@
 
 #include "Alignment2DBased3D.h"
 
+#include <algorithm>
+
 buw::AxisAlignedBoundingBox3d OpenInfraPlatform::Infrastructure::getExtends(buw::ReferenceCounted<Alignment2DBased3D> alignment)
 {
-	// we run along along all alignments an determine the corresponding position
-	// this my seem stupid at first glance, but in this way we have not to introduce
-	// additional methods in the 2D alignment element class.
-	if (alignment == nullptr)
+	buw::Vector3d min_, max_;
+	if (alignment == nullptr || !alignment->getExtends(min_, max_))
 	{
 		return buw::AxisAlignedBoundingBox3d();
 	}
 
-	buw::Vector3d min_ = alignment->getPosition(0);
-	buw::Vector3d max_ = alignment->getPosition(0);
-
-	for(double s = alignment->getStartStation(); s < alignment->getEndStation(); s+= 1.0)
-	{
-		auto p = alignment->getPosition(s);
-		min_ = buw::minimizedVector(min_, p);
-		max_ = buw::minimizedVector(max_, p);
-	}
-
 	return buw::AxisAlignedBoundingBox3d(min_, max_);
 }
 
 buw::AxisAlignedBoundingBox3d OpenInfraPlatform::Infrastructure::getExtends(std::vector<buw::ReferenceCounted<IAlignment3D>> alignments)
 {
-	// we run along along all alignments an determine the corresponding position
-	// this my seem stupid at first glance, but in this way we have not to introduce
-	// additional methods in the 2D alignment element class.
-	if (alignments.size() == 0)
+	buw::Vector3d min_, max_;
+	bool bInitialized = false;
+	for (const auto& alignment : alignments)
 	{
-		return buw::AxisAlignedBoundingBox3d();
-	}
+		buw::Vector3d minimum, maximum;
+		if (!alignment->getExtends(minimum, maximum))
+		{
+			continue;
+		}
 
-	buw::Vector3d min_ = alignments[0]->getPosition(0);
-	buw::Vector3d max_ = alignments[0]->getPosition(0);
+		min_ = bInitialized ? buw::minimizedVector(min_, minimum) : minimum;
+		max_ = bInitialized ? buw::maximizedVector(max_, maximum) : maximum;
+		bInitialized = true;
+	}
 
-	for (int i = 0; i < alignments.size(); i++)
+	if (!bInitialized)
 	{
-		for(double s = alignments[i]->getStartStation(); s < alignments[i]->getEndStation(); s+= 1.0)
-		{
-			auto p = alignments[i]->getPosition(s);
-			min_ = buw::minimizedVector(min_, p);
-			max_ = buw::minimizedVector(max_, p);
-		}
+		return buw::AxisAlignedBoundingBox3d();
 	}
 
 	return buw::AxisAlignedBoundingBox3d(min_, max_);
@@ -83,26 +72,15 @@ void OpenInfraPlatform::Infrastructure::Alignment2DBased3D::addCrossSection(buw:
 
 buw::AxisAlignedBoundingBox3d OpenInfraPlatform::Infrastructure::Alignment2DBased3D::getVerticalAlignmentExtends() const
 {
-	if (!hasVerticalAlignment())
+	const Stationing start = hasVerticalAlignment() ? verticalAlignment_->getStartStation() : 0.0;
+	const Stationing end = hasVerticalAlignment() ? verticalAlignment_->getEndStation() : 0.0;
+	double minimumHeight, maximumHeight;
+	if (!hasVerticalAlignment() || !verticalAlignment_->getHeightRange(start, end, minimumHeight, maximumHeight))
 	{
 		return buw::AxisAlignedBoundingBox3d();
 	}
 
-	auto startStation = verticalAlignment_->getStartStation();
-	buw::Vector2d start = verticalAlignment_->getPosition(startStation);
-
-	buw::Vector3d min_(start.x(), 0, start.y());
-
-	buw::Vector3d max_ = min_;
-
-	for(double s = verticalAlignment_->getStartStation(); s < verticalAlignment_->getEndStation(); s+= 1.0)
-	{
-		auto p = verticalAlignment_->getPosition(s);
-		min_ = buw::minimizedVector( min_, buw::Vector3d(p.x(), 0.0, p.y()) );
-		max_ = buw::minimizedVector( max_, buw::Vector3d(p.x(), 0.0, p.y()) );
-	}
-
-	return buw::AxisAlignedBoundingBox3d(min_, max_);
+	return buw::AxisAlignedBoundingBox3d(buw::Vector3d(start, 0.0, minimumHeight), buw::Vector3d(end, 0.0, maximumHeight));
 }
 
 void OpenInfraPlatform::Infrastructure::Alignment2DBased3D::setVerticalAlignment(buw::ReferenceCounted<VerticalAlignment2D> verticalAlignment)
@@ -187,6 +165,79 @@ OpenInfraPlatform::Infrastructure::Stationing OpenInfraPlatform::Infrastructure:
 	return horizontalAlignment_->getStartStation();
 }
 
+bool OpenInfraPlatform::Infrastructure::Alignment2DBased3D::getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const
+{
+	buw::Vector2d horizontalMinimum, horizontalMaximum;
+	if (!horizontalAlignment_ || !horizontalAlignment_->getExtends(horizontalMinimum, horizontalMaximum))
+	{
+		return false;
+	}
+
+	// Heights like getPosition, stations outside of the vertical alignment get the height at its start.
+	double minimumHeight = 0.0, maximumHeight = 0.0;
+	if (verticalAlignment_ && verticalAlignment_->hasElements())
+	{
+		const Stationing start = getStartStation();
+		const Stationing end = getEndStation();
+		const Stationing verticalStart = verticalAlignment_->getStartStation();
+		const bool bFound = verticalAlignment_->getHeightRange(start, end, minimumHeight, maximumHeight);
+		if (!bFound || start < verticalStart || end > verticalAlignment_->getEndStation())
+		{
+			const double startHeight = verticalAlignment_->getPosition(verticalStart).y();
+			minimumHeight = bFound ? std::min(minimumHeight, startHeight) : startHeight;
+			maximumHeight = bFound ? std::max(maximumHeight, startHeight) : startHeight;
+		}
+	}
+
+	minimum = buw::Vector3d(horizontalMinimum.x(), horizontalMinimum.y(), minimumHeight);
+	maximum = buw::Vector3d(horizontalMaximum.x(), horizontalMaximum.y(), maximumHeight);
+	return true;
+}
+
+std::vector<OpenInfraPlatform::Infrastructure::Stationing> OpenInfraPlatform::Infrastructure::Alignment2DBased3D::getTessellation(const double chordTolerance, const double maximumSegmentLength /*= 0.0*/) const
+{
+	if (!horizontalAlignment_)
+	{
+		return std::vector<Stationing>();
+	}
+
+	std::lock_guard<std::mutex> lock(tessellationMutex_);
+	const int horizontalRevision = horizontalAlignment_->getRevision();
+	const int verticalRevision = verticalAlignment_ ? verticalAlignment_->getRevision() : -1;
+	if (tessellatedHorizontalAlignment_ != horizontalAlignment_ || tessellatedHorizontalRevision_ != horizontalRevision ||
+		tessellatedVerticalAlignment_ != verticalAlignment_ || tessellatedVerticalRevision_ != verticalRevision)
+	{
+		tessellations_.clear();
+		tessellatedHorizontalAlignment_ = horizontalAlignment_;
+		tessellatedVerticalAlignment_ = verticalAlignment_;
+		tessellatedHorizontalRevision_ = horizontalRevision;
+		tessellatedVerticalRevision_ = verticalRevision;
+	}
+
+	// The viewer and the exporters ask for different tolerances, keep each of them.
+	const auto key = std::make_pair(chordTolerance, maximumSegmentLength);
+	auto cached = tessellations_.find(key);
+	if (cached != tessellations_.end())
+	{
+		return cached->second;
+	}
+
+	std::vector<Stationing> stations = horizontalAlignment_->getTessellation(chordTolerance, maximumSegmentLength);
+	if (verticalAlignment_ && !stations.empty())
+	{
+		// Both are ascending, stations closer than a nanometer would only add degenerate segments.
+		const std::vector<Stationing> verticalStations = verticalAlignment_->getTessellation(stations.front(), stations.back(), chordTolerance);
+		std::vector<Stationing> merged(stations.size() + verticalStations.size());
+		std::merge(stations.begin(), stations.end(), verticalStations.begin(), verticalStations.end(), merged.begin());
+		merged.erase(std::unique(merged.begin(), merged.end(), [](const Stationing a, const Stationing b) { return b - a < 1e-9; }), merged.end());
+		merged.back() = stations.back();
+		stations.swap(merged);
+	}
+
+	tessellations_[key] = stations;
+	return stations;
+}
+
 buw::Vector3d OpenInfraPlatform::Infrastructure::Alignment2DBased3D::getPosition( const buw::Stationing station ) const 
 {
 	buw::Vector2d hp = getHorizontalPosition( station );
@@ -204,6 +255,43 @@ buw::Vector3d OpenInfraPlatform::Infrastructure::Alignment2DBased3D::getPosition
 	return buw::Vector3d(hp.x(), hp.y(), vp.y());
 }
 
+void OpenInfraPlatform::Infrastructure::Alignment2DBased3D::evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const
+{
+	std::vector<buw::Vector2d> horizontalPositions(count);
+	std::vector<buw::Vector2d> horizontalTangents(tangents ? count : 0);
+	std::vector<buw::Vector2d> horizontalNormals(normals ? count : 0);
+	horizontalAlignment_->getPositions(stations, count, horizontalPositions.data(), tangents ? horizontalTangents.data() : nullptr, normals ? horizontalNormals.data() : nullptr);
+
+	// Heights like getPosition, stations outside of the vertical alignment get the height at its start.
+	std::vector<double> heights(count, 0.0);
+	std::vector<double> gradients(count, 0.0);
+	if (verticalAlignment_)
+	{
+		verticalAlignment_->getHeights(stations, count, heights.data(), tangents ? gradients.data() : nullptr);
+
+		const Stationing start = verticalAlignment_->getStartStation();
+		const Stationing end = verticalAlignment_->getEndStation();
+		const double startHeight = verticalAlignment_->getPosition(start).y();
+		for (int i = 0; i < count; i++)
+		{
+			if (stations[i] < start || stations[i] > end)
+			{
+				heights[i] = startHeight;
+				gradients[i] = 0.0;
+			}
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		positions[i] = buw::Vector3d(horizontalPositions[i].x(), horizontalPositions[i].y(), heights[i]);
+		if (tangents)
+			tangents[i] = buw::Vector3d(horizontalTangents[i].x(), horizontalTangents[i].y(), gradients[i]).normalized();
+		if (normals)
+			normals[i] = buw::Vector3d(horizontalNormals[i].x(), horizontalNormals[i].y(), 0.0);
+	}
+}
+
 OpenInfraPlatform::Infrastructure::Alignment2DBased3D::Alignment2DBased3D(buw::ReferenceCounted<HorizontalAlignment2D> horizontalAlignment /*= nullptr*/,
 	buw::ReferenceCounted<VerticalAlignment2D> verticalAlignment /*= nullptr*/) :
 horizontalAlignment_(horizontalAlignment),
@@ -26,6 +26,9 @@
 #include <BlueFramework/Core/Math/vector.h>
 #include <BlueFramework/Core/Math/AxisAlignedBoundingBox.h>
 #include <boost/noncopyable.hpp>
+#include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace OpenInfraPlatform
@@ -55,6 +58,13 @@ namespace OpenInfraPlatform
 			//! Length of horizontal alignment
 			double			getLength() const override;	
 
+			//! Merges the bounds of the horizontal elements cached by the horizontal alignment with the height range of the vertical alignment.
+			bool			getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const override;
+
+			//! The tessellation of the horizontal alignment merged with the breakpoints and curved elements of the vertical alignment. The
+			//! result is cached per chord tolerance and maximum segment length until either alignment is replaced or has elements added.
+			std::vector<Stationing>	getTessellation(const double chordTolerance, const double maximumSegmentLength = 0.0) const override;
+
 			//---------------------------------------------------------------------------//
 			// Horizontal Alignment
 			//---------------------------------------------------------------------------//
@@ -108,12 +118,24 @@ namespace OpenInfraPlatform
 				return Id_;
 			}
 
+		protected:
+			//! Walks the horizontal and vertical elements once for the stations, each element evaluates its stations in one call.
+			void evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const override;
+
 		private:
 			int Id_ = -1; // invalid id.
 
 			std::vector<buw::ReferenceCounted<buw::CrossSectionStatic>>	crossSections_;
 			buw::ReferenceCounted<HorizontalAlignment2D>				horizontalAlignment_;
 			buw::ReferenceCounted<VerticalAlignment2D>					verticalAlignment_;
+
+			// results of getTessellation by chord tolerance and maximum segment length, and the alignments they were computed from
+			mutable std::mutex											tessellationMutex_;
+			mutable std::map<std::pair<double, double>, std::vector<Stationing>>	tessellations_;
+			mutable buw::ReferenceCounted<HorizontalAlignment2D>		tessellatedHorizontalAlignment_;
+			mutable buw::ReferenceCounted<VerticalAlignment2D>			tessellatedVerticalAlignment_;
+			mutable int													tessellatedHorizontalRevision_ = -1;
+			mutable int													tessellatedVerticalRevision_ = -1;
 		};
 
 		BLUEINFRASTRUCTURE_API buw::AxisAlignedBoundingBox3d getExtends(buw::ReferenceCounted<Alignment2DBased3D> alignment);
@@ -19,6 +19,8 @@
 #include <BlueFramework/Core/Math/util.h>
 
 #include <iomanip>      // std::setprecision
+#include <algorithm>
+#include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -76,17 +78,81 @@ buw::Stationing Alignment3DBased3D::getStartStation() const {
 }
 
 buw::Vector3d Alignment3DBased3D::getPosition( const Stationing station ) const {
-	double length = getEndStation() - getStartStation();
-	double t = station / length;
-	t = buw::clamp(t, 0.0, 1.0);
+	const double s = station - startSation_;
 	if (type_ == Alignment3DBased3DType::Spline)
-		return crs_.GetInterpolatedSplinePoint(t);
+		return crs_.GetSplinePointAtLength(s);
 	else if (type_ == Alignment3DBased3DType::Polyline)
-		return polyline_.Interpolate(t);
+		return polyline_.InterpolateAtLength(s);
 	else
 		return buw::Vector3d(0.0, 0.0, 0.0);
 }
 
+bool Alignment3DBased3D::getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const
+{
+	if (type_ == Alignment3DBased3DType::Spline)
+		return crs_.GetExtends(minimum, maximum);
+	else if (type_ == Alignment3DBased3DType::Polyline)
+		return polyline_.GetExtends(minimum, maximum);
+	else
+		return false;
+}
+
+std::vector<Stationing> Alignment3DBased3D::getTessellation(const double chordTolerance, const double maximumSegmentLength /*= 0.0*/) const
+{
+	if (type_ != Alignment3DBased3DType::Polyline)
+		return IAlignment3D::getTessellation(chordTolerance, maximumSegmentLength);
+
+	std::vector<Stationing> stations;
+	const size_t count = polyline_.GetNumPoints();
+	Stationing station = startSation_;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i > 0)
+			station += (polyline_.GetNthPoint(i) - polyline_.GetNthPoint(i - 1)).norm();
+		stations.push_back(station);
+	}
+
+	// Repeated points would give segments of length 0.
+	stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+	subdivideStations(stations, maximumSegmentLength);
+	return stations;
+}
+
+void Alignment3DBased3D::evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const
+{
+	std::vector<double> lengths(count);
+	for (int i = 0; i < count; i++)
+		lengths[i] = stations[i] - startSation_;
+
+	std::vector<buw::Vector3d> curveTangents(tangents || normals ? count : 0);
+	buw::Vector3d* t = curveTangents.empty() ? nullptr : curveTangents.data();
+	if (type_ == Alignment3DBased3DType::Spline)
+		crs_.GetSplinePointsAtLengths(lengths.data(), count, positions, t);
+	else if (type_ == Alignment3DBased3DType::Polyline)
+		polyline_.InterpolateAtLengths(lengths.data(), count, positions, t);
+	else
+	{
+		std::fill(positions, positions + count, buw::Vector3d(0.0, 0.0, 0.0));
+		std::fill(curveTangents.begin(), curveTangents.end(), buw::Vector3d(0.0, 0.0, 0.0));
+	}
+
+	if (!t)
+		return;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (tangents)
+			tangents[i] = t[i];
+		if (normals)
+		{
+			buw::Vector3d normal(-t[i].y(), t[i].x(), 0.0);
+			if (normal.norm() > 0)
+				normal.normalize();
+			normals[i] = normal;
+		}
+	}
+}
+
 Alignment3DBased3D::~Alignment3DBased3D() {
 
 }
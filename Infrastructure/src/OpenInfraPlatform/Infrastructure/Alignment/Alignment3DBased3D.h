@@ -41,7 +41,7 @@ public:
 
 	virtual ~Alignment3DBased3D();
 
-	//! Computes the 3d position given a stationing.
+	//! Computes the 3d position given a stationing. The distance from the start station is measured along the spline or polyline.
 	buw::Vector3d			getPosition(const Stationing station ) const override;
 
 	buw::Stationing			getStartStation() const override;
@@ -51,10 +51,20 @@ public:
 	//! Length of horizontal alignment
 	double					getLength() const override;	
 
+	//! The bounds of the polyline points or of the spline segments, both in closed form.
+	bool					getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const override;
+
+	//! The vertices of a polyline are exact, splines are sampled by the default.
+	std::vector<Stationing>	getTessellation(const double chordTolerance, const double maximumSegmentLength = 0.0) const override;
+
 	void					addPoint(const buw::Vector3d& p);
 	buw::Vector3d const&	getPoint(size_t const idx) const;
 	size_t					getNumPoints() const;
 
+protected:
+	//! Looks up the arc lengths in the table of the spline or polyline, the tangents are the ones of the curve.
+	void					evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const override;
+
 private:
 	buw::Stationing	startSation_;
 
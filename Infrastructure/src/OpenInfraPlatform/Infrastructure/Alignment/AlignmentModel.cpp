@@ -24,35 +24,31 @@ AlignmentModel::AlignmentModel()
 
 }
 
+AlignmentModel::AlignmentModel(const AlignmentModel& other)
+{
+    *this = other;
+}
+
 AlignmentModel::~AlignmentModel()
 {
 
 }
 
-buw::AxisAlignedBoundingBox3d AlignmentModel::getExtends() const
+AlignmentModel& AlignmentModel::operator=(const AlignmentModel& other)
 {
-    // we run along along all alignments an determine the corresponding position
-    // this my seem stupid at first glance, but in this way we have not to introduce
-    // additional methods in the 2D alignment element class.
-    if (alignments_.size() == 0)
+    if (this != &other)
     {
-        return buw::AxisAlignedBoundingBox3d();
-    }
+        alignments_ = other.alignments_;
 
-    buw::Vector3d min_ = alignments_[0]->getPosition(0);
-    buw::Vector3d max_ = alignments_[0]->getPosition(0);
-
-    for (int i = 0; i < alignments_.size(); i++)
-    {
-        for (double s = alignments_[i]->getStartStation(); s < alignments_[i]->getEndStation(); s += 1.0)
-        {
-            auto p = alignments_[i]->getPosition(s);
-            min_ = buw::minimizedVector(min_, p);
-            max_ = buw::maximizedVector(max_, p);
-        }
+        // The index is immutable and checks whether it matches the alignments, so the copy can share it.
+        std::atomic_store(&spatialIndex_, std::atomic_load(&other.spatialIndex_));
     }
+    return *this;
+}
 
-    return buw::AxisAlignedBoundingBox3d(min_, max_);
+buw::AxisAlignedBoundingBox3d AlignmentModel::getExtends() const
+{
+    return buw::getExtends(alignments_);
 }
 
 void AlignmentModel::deleteAlignment(buw::ReferenceCounted<buw::IAlignment3D> alignment)
@@ -76,6 +72,26 @@ void AlignmentModel::addAlignment(buw::ReferenceCounted<buw::IAlignment3D> align
     alignments_.push_back(alignment);
 }
 
+buw::ReferenceCounted<buw::AlignmentSpatialIndex> AlignmentModel::getSpatialIndex() const
+{
+    buw::ReferenceCounted<buw::AlignmentSpatialIndex> index = std::atomic_load(&spatialIndex_);
+    if (index && index->isCurrent(alignments_))
+    {
+        return index;
+    }
+
+    // Build the index only once if several threads query the model at the same time.
+    std::lock_guard<std::mutex> lock(spatialIndexMutex_);
+    index = std::atomic_load(&spatialIndex_);
+    if (!index || !index->isCurrent(alignments_))
+    {
+        index = std::make_shared<buw::AlignmentSpatialIndex>(alignments_);
+        std::atomic_store(&spatialIndex_, index);
+    }
+
+    return index;
+}
+
 std::vector<buw::ReferenceCounted<buw::IAlignment3D>> AlignmentModel::getAlignments()
 {
     return alignments_;
@@ -128,8 +144,9 @@ buw::AxisAlignedBoundingBox3d buw::AlignmentModel::getVerticalAlignmentExtends()
             }
             else
             {
-                auto u = buw::minimizedVector( b.getMinimum(), a->getVerticalAlignmentExtends().getMinimum() );
-                auto v = buw::minimizedVector( b.getMaximum(), a->getVerticalAlignmentExtends().getMaximum() );
+                const buw::AxisAlignedBoundingBox3d extends = a->getVerticalAlignmentExtends();
+                auto u = buw::minimizedVector( b.getMinimum(), extends.getMinimum() );
+                auto v = buw::maximizedVector( b.getMaximum(), extends.getMaximum() );
                 b.setMinimum(u);
                 b.setMaximum(v);
             }
@@ -22,7 +22,9 @@
 #include "OpenInfraPlatform/Infrastructure/namespace.h"
 #include "OpenInfraPlatform/Infrastructure/Alignment/IAlignment3D.h"
 #include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/AlignmentSpatialIndex.h"
 #include <boost/noncopyable.hpp>
+#include <mutex>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -30,9 +32,12 @@ class BLUEINFRASTRUCTURE_API AlignmentModel
 {
 public:
 	AlignmentModel();
+	AlignmentModel(const AlignmentModel& other);
 
 	virtual ~AlignmentModel();
 
+	AlignmentModel& operator=(const AlignmentModel& other);
+
 	int getAlignmentCount() const;
 
 	buw::ReferenceCounted<buw::IAlignment3D> getAlignment(const int index) const;
@@ -51,8 +56,16 @@ public:
 
 	buw::AxisAlignedBoundingBox3d getVerticalAlignmentExtends();
 
+	//! Index for reverse stationing of the alignments, built on first use after alignments have been added or deleted or the elements of
+	//! one of them have changed. Safe to call from many threads as long as the alignments are not changed at the same time.
+	buw::ReferenceCounted<buw::AlignmentSpatialIndex> getSpatialIndex() const;
+
 private:				
 	std::vector<buw::ReferenceCounted<buw::IAlignment3D>> alignments_;
+
+	// index for reverse stationing, built lazily and replaced when it no longer matches the alignments
+	mutable buw::ReferenceCounted<buw::AlignmentSpatialIndex> spatialIndex_;
+	mutable std::mutex spatialIndexMutex_;
 }; // end class AlignmentModel
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -0,0 +1,247 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AlignmentSpatialIndex.h"
+#include "Alignment2DBased3D.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <omp.h>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	// Children per node of the R-tree.
+	const int NodeCapacity = 16;
+
+	// Squared distance from the point to the box, 0 inside.
+	double squaredDistance(const buw::Vector2d& point, const buw::Vector2d& minimum, const buw::Vector2d& maximum)
+	{
+		const double dx = std::max(std::max(minimum.x() - point.x(), point.x() - maximum.x()), 0.0);
+		const double dy = std::max(std::max(minimum.y() - point.y(), point.y() - maximum.y()), 0.0);
+		return dx * dx + dy * dy;
+	}
+
+	// Sort tile recursive order: the items are sorted by the x-coordinate of their centers and cut into vertical slices of about
+	// sqrt(count / NodeCapacity) nodes, each slice is sorted by y, so consecutive runs of NodeCapacity items make compact nodes.
+	template<typename T>
+	void sortTileRecursive(std::vector<T>& items, const int first, const int last)
+	{
+		auto centerX = [](const T& item) { return item.minimum.x() + item.maximum.x(); };
+		auto centerY = [](const T& item) { return item.minimum.y() + item.maximum.y(); };
+
+		const int count = last - first;
+		const int nodeCount = (count + NodeCapacity - 1) / NodeCapacity;
+		const int sliceCount = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+		const int sliceSize = ((nodeCount + sliceCount - 1) / sliceCount) * NodeCapacity;
+
+		std::sort(items.begin() + first, items.begin() + last, [&](const T& a, const T& b) { return centerX(a) < centerX(b); });
+		for (int slice = first; slice < last; slice += sliceSize)
+		{
+			std::sort(items.begin() + slice, items.begin() + std::min(slice + sliceSize, last), [&](const T& a, const T& b) { return centerY(a) < centerY(b); });
+		}
+	}
+}
+
+AlignmentSpatialIndex::AlignmentSpatialIndex(const std::vector<buw::ReferenceCounted<IAlignment3D>>& alignments)
+{
+	for (int a = 0; a < static_cast<int>(alignments.size()); a++)
+	{
+		Source source = { alignments[a], nullptr, -1 };
+		if (alignments[a] && alignments[a]->getType() == e3DAlignmentType::e2DBased)
+			source.horizontalAlignment = std::static_pointer_cast<Alignment2DBased3D>(alignments[a])->getHorizontalAlignment();
+		if (source.horizontalAlignment)
+			source.revision = source.horizontalAlignment->getRevision();
+		sources_.push_back(source);
+
+		buw::ReferenceCounted<HorizontalAlignment2D> ha = source.horizontalAlignment;
+		if (!ha)
+			continue;
+
+		const int elementCount = ha->getAlignmentElementCount();
+		for (int i = 0; i < elementCount; i++)
+		{
+			Entry entry;
+			entry.element = ha->getAlignmentElementByIndex(i);
+			if (!entry.element)
+				continue;
+
+			ha->getElementExtends(i, entry.minimum, entry.maximum);
+			entry.alignment = a;
+			entry.index = i;
+			entry.startStation = ha->getStartStation(i);
+			entry.endStation = i + 1 < elementCount ? ha->getStartStation(i + 1) : ha->getEndStation();
+			entries_.push_back(entry);
+		}
+	}
+
+	build();
+}
+
+AlignmentSpatialIndex::~AlignmentSpatialIndex()
+{
+
+}
+
+void AlignmentSpatialIndex::build()
+{
+	if (entries_.empty())
+		return;
+
+	// Leaves over runs of entries, then levels of nodes over runs of the level below up to a single root at the end.
+	sortTileRecursive(entries_, 0, static_cast<int>(entries_.size()));
+	for (int first = 0; first < static_cast<int>(entries_.size()); first += NodeCapacity)
+	{
+		Node node;
+		node.first = first;
+		node.count = std::min(NodeCapacity, static_cast<int>(entries_.size()) - first);
+		node.bLeaf = true;
+		node.minimum = entries_[first].minimum;
+		node.maximum = entries_[first].maximum;
+		for (int i = first + 1; i < first + node.count; i++)
+		{
+			node.minimum = buw::minimizedVector(node.minimum, entries_[i].minimum);
+			node.maximum = buw::maximizedVector(node.maximum, entries_[i].maximum);
+		}
+		nodes_.push_back(node);
+	}
+
+	int levelBegin = 0;
+	int levelEnd = static_cast<int>(nodes_.size());
+	while (levelEnd - levelBegin > 1)
+	{
+		sortTileRecursive(nodes_, levelBegin, levelEnd);
+		for (int first = levelBegin; first < levelEnd; first += NodeCapacity)
+		{
+			Node node;
+			node.first = first;
+			node.count = std::min(NodeCapacity, levelEnd - first);
+			node.bLeaf = false;
+			node.minimum = nodes_[first].minimum;
+			node.maximum = nodes_[first].maximum;
+			for (int i = first + 1; i < first + node.count; i++)
+			{
+				node.minimum = buw::minimizedVector(node.minimum, nodes_[i].minimum);
+				node.maximum = buw::maximizedVector(node.maximum, nodes_[i].maximum);
+			}
+			nodes_.push_back(node);
+		}
+
+		levelBegin = levelEnd;
+		levelEnd = static_cast<int>(nodes_.size());
+	}
+}
+
+void AlignmentSpatialIndex::projectOntoEntry(const Entry& entry, const buw::Vector2d& point, AlignmentProjection& projection) const
+{
+	const double lerpParameter = entry.element->getClosestParameter(point);
+	const buw::Vector2d position = entry.element->getPosition(lerpParameter);
+	const double distance = (point - position).norm();
+	if (distance >= projection.distance)
+		return;
+
+	projection.alignment = entry.alignment;
+	projection.element = entry.index;
+	projection.station = entry.startStation + lerpParameter * (entry.endStation - entry.startStation);
+	projection.offset = (point - position).dot(entry.element->getNormal(lerpParameter));
+	projection.distance = distance;
+	projection.position = position;
+}
+
+AlignmentProjection AlignmentSpatialIndex::project(const buw::Vector2d& point, const double maximumDistance /*= std::numeric_limits<double>::max()*/) const
+{
+	AlignmentProjection projection;
+	projection.distance = maximumDistance;
+	if (nodes_.empty())
+		return projection;
+
+	// Best first search, the nodes and elements are visited by the distance to their bounds until it exceeds the one of the best projection.
+	typedef std::pair<double, int> QueueItem;
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+	const Node& root = nodes_.back();
+	queue.push(QueueItem(squaredDistance(point, root.minimum, root.maximum), static_cast<int>(nodes_.size()) - 1));
+
+	while (!queue.empty())
+	{
+		const QueueItem item = queue.top();
+		queue.pop();
+		if (item.first > projection.distance * projection.distance)
+			break;
+
+		const Node& node = nodes_[item.second];
+		for (int i = node.first; i < node.first + node.count; i++)
+		{
+			if (node.bLeaf)
+			{
+				if (squaredDistance(point, entries_[i].minimum, entries_[i].maximum) <= projection.distance * projection.distance)
+					projectOntoEntry(entries_[i], point, projection);
+			}
+			else
+			{
+				const double distance = squaredDistance(point, nodes_[i].minimum, nodes_[i].maximum);
+				if (distance <= projection.distance * projection.distance)
+					queue.push(QueueItem(distance, i));
+			}
+		}
+	}
+
+	if (projection.alignment < 0)
+		projection.distance = std::numeric_limits<double>::max();
+
+	return projection;
+}
+
+void AlignmentSpatialIndex::project(const buw::Vector2d* points, const int count, AlignmentProjection* projections, const double maximumDistance /*= std::numeric_limits<double>::max()*/, const int threadCount /*= 0*/) const
+{
+	const int threads = threadCount > 0 ? threadCount : omp_get_max_threads();
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(threads) if(threads > 1 && count > 1024)
+	for (int i = 0; i < count; i++)
+	{
+		projections[i] = project(points[i], maximumDistance);
+	}
+}
+
+int AlignmentSpatialIndex::getElementCount() const
+{
+	return static_cast<int>(entries_.size());
+}
+
+bool AlignmentSpatialIndex::isCurrent(const std::vector<buw::ReferenceCounted<IAlignment3D>>& alignments) const
+{
+	if (alignments.size() != sources_.size())
+		return false;
+
+	for (size_t i = 0; i < alignments.size(); i++)
+	{
+		const Source& source = sources_[i];
+		if (alignments[i] != source.alignment)
+			return false;
+		if (!source.alignment || source.alignment->getType() != e3DAlignmentType::e2DBased)
+			continue;
+
+		buw::ReferenceCounted<HorizontalAlignment2D> ha = std::static_pointer_cast<Alignment2DBased3D>(source.alignment)->getHorizontalAlignment();
+		if (ha != source.horizontalAlignment || (ha && ha->getRevision() != source.revision))
+			return false;
+	}
+	return true;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
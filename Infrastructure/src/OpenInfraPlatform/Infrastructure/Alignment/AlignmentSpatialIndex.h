@@ -0,0 +1,128 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_AlignmentSpatialIndex_e8e150ae_8e0a_4bcd_96a6_73c8ec826fa5_h
+#define OpenInfraPlatform_Infrastructure_AlignmentSpatialIndex_e8e150ae_8e0a_4bcd_96a6_73c8ec826fa5_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignment2D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2D.h"
+#include "IAlignment3D.h"
+#include "types.h"
+#include <BlueFramework/Core/memory.h>
+#include <BlueFramework/Core/Math/vector.h>
+#include <boost/noncopyable.hpp>
+#include <limits>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Closest point of the alignments to a position in the xy-plane.
+struct BLUEINFRASTRUCTURE_API AlignmentProjection
+{
+	//! Index of the alignment in the list the index was built from, -1 if no alignment is within the maximum distance.
+	int				alignment = -1;
+
+	//! Index of the horizontal alignment element.
+	int				element = -1;
+
+	Stationing		station = 0.0;
+
+	//! Distance along the normal of the alignment, positive to the left.
+	double			offset = 0.0;
+
+	//! Distance to the closest point, which differs from the offset beyond the ends of an alignment.
+	double			distance = std::numeric_limits<double>::max();
+
+	buw::Vector2d	position = buw::Vector2d(0.0, 0.0);
+};
+
+//! Reverse stationing, i.e. from xy-positions to the station and offset on the closest alignment. The bounds of the horizontal elements of
+//! all 2d based alignments are packed into an R-tree by sort tile recursive bulk loading, queries descend it closest box first and project
+//! onto the elements whose bounds are closer than the best projection so far. The index reflects the alignments when it was built.
+class BLUEINFRASTRUCTURE_API AlignmentSpatialIndex : boost::noncopyable
+{
+public:
+	//! Alignments which are not 2d based are skipped.
+	AlignmentSpatialIndex(const std::vector<buw::ReferenceCounted<IAlignment3D>>& alignments);
+
+	virtual ~AlignmentSpatialIndex();
+
+	//! Projects 'point' onto the closest alignment element not further away than 'maximumDistance'.
+	AlignmentProjection		project(const buw::Vector2d& point, const double maximumDistance = std::numeric_limits<double>::max()) const;
+
+	//! Projects 'count' points, chunks of them in parallel with 'threadCount' threads, 0 uses all available.
+	void					project(const buw::Vector2d* points, const int count, AlignmentProjection* projections, const double maximumDistance = std::numeric_limits<double>::max(), const int threadCount = 0) const;
+
+	//! Number of indexed horizontal alignment elements.
+	int						getElementCount() const;
+
+	//! Whether 'alignments' are the ones the index was built from and none of their horizontal alignments has been replaced or changed since.
+	bool					isCurrent(const std::vector<buw::ReferenceCounted<IAlignment3D>>& alignments) const;
+
+private:
+	// A horizontal alignment element with the station range and index of its alignment.
+	struct Entry
+	{
+		buw::Vector2d								minimum;
+		buw::Vector2d								maximum;
+		buw::ReferenceCounted<HorizontalAlignmentElement2D>	element;
+		int											alignment;
+		int											index;
+		Stationing									startStation;
+		Stationing									endStation;
+	};
+
+	// Children of a leaf are the entries first to first + count - 1, the ones of other nodes are nodes.
+	struct Node
+	{
+		buw::Vector2d	minimum;
+		buw::Vector2d	maximum;
+		int				first;
+		int				count;
+		bool			bLeaf;
+	};
+
+	// An alignment the index was built from with its horizontal alignment and the revision of it.
+	struct Source
+	{
+		buw::ReferenceCounted<IAlignment3D>			alignment;
+		buw::ReferenceCounted<HorizontalAlignment2D>	horizontalAlignment;
+		int											revision;
+	};
+
+	void					build();
+
+	void					projectOntoEntry(const Entry& entry, const buw::Vector2d& point, AlignmentProjection& projection) const;
+
+private:
+	std::vector<Entry>		entries_;
+	std::vector<Node>		nodes_;
+	std::vector<Source>		sources_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::AlignmentProjection;
+	using OpenInfraPlatform::Infrastructure::AlignmentSpatialIndex;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_AlignmentSpatialIndex_e8e150ae_8e0a_4bcd_96a6_73c8ec826fa5_h
@@ -16,55 +16,63 @@
 */
 
 #include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignment2D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/IAlignment3D.h"
 #include <BlueFramework/Core/assert.h>
+#include <algorithm>
+#include <limits>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
-HorizontalAlignment2D::HorizontalAlignment2D(const Stationing startStationing /*= 0.0*/) : startStationing_(startStationing) {
+HorizontalAlignment2D::HorizontalAlignment2D(const Stationing startStationing /*= 0.0*/) : startStationing_(startStationing), length_(0.0), revision_(0), lastElement_(0) {
+	// Empty bounds, any element extends them.
+	minimum_ = buw::Vector2d(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	maximum_ = -minimum_;
 }
 
 buw::ReferenceCounted<HorizontalAlignmentElement2D> HorizontalAlignment2D::getAlignmentElementByStationing(const Stationing station, double* lerpParameter /*= nullptr*/) const {
-	if (horizontalElements_.size() == 0) {
+	const int index = getAlignmentElementIndexByStationing(station, lastElement_.load(std::memory_order_relaxed));
+	if (index < 0) {
 		return nullptr;
 	}
 
-	// If station is out of range return nullptr
-	if (station < getStartStation() || station > getEndStation()) {
-		// std::cout << "invalid station" << std::endl;
+	// Several threads may sample the alignment, the hint is only a guess anyway.
+	lastElement_.store(index, std::memory_order_relaxed);
 
-		if (station < getStartStation()) {
-			// first alignment
-			return horizontalElements_[0];
-		}
-
-		if (station > getEndStation()) {
-			// last alignment
-			return horizontalElements_[horizontalElements_.size() - 1];
-		}
+	// Stations out of range get the first or last element and leave the lerp parameter unchanged.
+	if (lerpParameter && station >= getStartStation() && station <= getEndStation()) {
+		const Stationing start = index > 0 ? endStations_[index - 1] : startStationing_;
+		*lerpParameter = std::min(std::max((station - start) / (endStations_[index] - start), 0.0), 1.0);
 
-		return nullptr;
+		BLUE_ASSERT(*lerpParameter >= 0.0, "Invalid value.");
+		BLUE_ASSERT(*lerpParameter <= 1.0, "Invalid value.");
 	}
 
-	double currentStationT3 = startStationing_;
-	double previousStationT1 = 0;
+	return horizontalElements_[index];
+}
 
-	for (buw::ReferenceCounted<HorizontalAlignmentElement2D> a : horizontalElements_) {
-		previousStationT1 = currentStationT3;
-		currentStationT3 += a->getLength();
+int HorizontalAlignment2D::getAlignmentElementIndexByStationing(const Stationing station, const int hint /*= -1*/) const {
+	const int count = static_cast<int>(horizontalElements_.size());
+	if (count == 0) {
+		return -1;
+	}
 
-		if (currentStationT3 >= station) {
-			if (lerpParameter) {
-				*lerpParameter = ((station - previousStationT1) / (currentStationT3 - previousStationT1));
+	if (station < getStartStation()) {
+		return 0;
+	}
 
-				BLUE_ASSERT(*lerpParameter >= 0.0, "Invalid value.");
-				BLUE_ASSERT(*lerpParameter <= 1.0, "Invalid value.");
-			}
+	if (station > getEndStation()) {
+		return count - 1;
+	}
 
-			return a;
+	// The station belongs to the first element ending at or after it.
+	for (int i = std::max(hint, 0); i < count && i <= hint + 1; i++) {
+		if (endStations_[i] >= station && (i == 0 || endStations_[i - 1] < station)) {
+			return i;
 		}
 	}
 
-	return nullptr;
+	const int index = static_cast<int>(std::lower_bound(endStations_.begin(), endStations_.end(), station) - endStations_.begin());
+	return std::min(index, count - 1);
 }
 
 Stationing HorizontalAlignment2D::getEndStation() const {
@@ -75,17 +83,78 @@ Stationing HorizontalAlignment2D::getStartStation(const int index /*= 0*/) const
 	BLUE_ASSERT(index >= 0, "Invalid index.");
 	//BLUE_ASSERT(index < horizontalElements_.size(), "Invalid index.");
 
-	Stationing s = startStationing_;
-
-	for (int i = 0; i < index && index < horizontalElements_.size(); i++) {
-		s += horizontalElements_[i]->getLength();
+	if (index > 0 && index < getAlignmentElementCount()) {
+		return endStations_[index - 1];
 	}
 
-	return s;
+	return startStationing_;
 }
 
 void HorizontalAlignment2D::addElement(buw::ReferenceCounted<HorizontalAlignmentElement2D> he) {
+	const double length = he ? he->getLength() : 0.0;
+	endStations_.push_back((endStations_.empty() ? startStationing_ : endStations_.back()) + length);
+	length_ += length;
+
+	// Missing elements get empty bounds.
+	buw::Vector2d minimum(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	buw::Vector2d maximum = -minimum;
+	if (he) {
+		he->getExtends(minimum, maximum);
+		minimum_ = buw::minimizedVector(minimum_, minimum);
+		maximum_ = buw::maximizedVector(maximum_, maximum);
+	}
+	elementMinimums_.push_back(minimum);
+	elementMaximums_.push_back(maximum);
+
 	horizontalElements_.push_back(he);
+	revision_++;
+}
+
+bool HorizontalAlignment2D::getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+	if (!(minimum_.x() <= maximum_.x())) {
+		return false;
+	}
+
+	minimum = minimum_;
+	maximum = maximum_;
+	return true;
+}
+
+void HorizontalAlignment2D::getElementExtends(const int index, buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+	BLUE_ASSERT(index >= 0, "Invalid index.");
+	BLUE_ASSERT(index < getAlignmentElementCount(), "Invalid index.");
+	minimum = elementMinimums_[index];
+	maximum = elementMaximums_[index];
+}
+
+std::vector<Stationing> HorizontalAlignment2D::getTessellation(const double chordTolerance, const double maximumSegmentLength /*= 0.0*/) const {
+	std::vector<Stationing> stations;
+	if (horizontalElements_.empty()) {
+		return stations;
+	}
+
+	std::vector<double> lerpParameters;
+	for (int i = 0; i < static_cast<int>(horizontalElements_.size()); i++) {
+		const Stationing start = getStartStation(i);
+		stations.push_back(start);
+		if (horizontalElements_[i]) {
+			lerpParameters.clear();
+			horizontalElements_[i]->getTessellation(chordTolerance, lerpParameters);
+			for (const double lerpParameter : lerpParameters) {
+				stations.push_back(start + lerpParameter * (endStations_[i] - start));
+			}
+		}
+	}
+	stations.push_back(getEndStation());
+
+	// Elements of length 0 share their station with the next one.
+	stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+	subdivideStations(stations, maximumSegmentLength);
+	return stations;
+}
+
+int HorizontalAlignment2D::getRevision() const {
+	return revision_;
 }
 
 buw::ReferenceCounted<HorizontalAlignmentElement2D> HorizontalAlignment2D::getAlignmentElementByIndex(int index) {
@@ -95,14 +164,7 @@ buw::ReferenceCounted<HorizontalAlignmentElement2D> HorizontalAlignment2D::getAl
 }
 
 double HorizontalAlignment2D::getLength() const {
-	double sum = 0;
-
-	for (buw::ReferenceCounted<HorizontalAlignmentElement2D> alignmentElement : horizontalElements_) {
-		if(alignmentElement)
-			sum += alignmentElement->getLength();
-	}
-
-	return sum;
+	return length_;
 }
 
 int HorizontalAlignment2D::getAlignmentElementCount() const {
@@ -146,6 +208,34 @@ buw::Vector2d HorizontalAlignment2D::getNormal(const Stationing station) const
 	return a->getNormal(lerpScalar);
 }
 
+void HorizontalAlignment2D::getPositions(const Stationing* stations, const int count, buw::Vector2d* positions, buw::Vector2d* tangents, buw::Vector2d* normals) const {
+	const int elementCount = static_cast<int>(horizontalElements_.size());
+	BLUE_ASSERT(elementCount > 0 || count == 0, "Invalid alignment element.");
+
+	const Stationing alignmentEnd = getEndStation();
+	std::vector<double> lerpParameters(count);
+	int index = -1;
+	for (int first = 0; first < count;) {
+		index = getAlignmentElementIndexByStationing(stations[first], index);
+
+		// The run of stations on the element, the first and last element take the stations out of range as well.
+		const Stationing start = index > 0 ? endStations_[index - 1] : startStationing_;
+		const Stationing end = endStations_[index];
+		int last = first;
+		for (; last < count; last++) {
+			const Stationing s = stations[last];
+			if ((index > 0 && s <= start) || (index + 1 < elementCount && s > end))
+				break;
+
+			// Stations out of range are evaluated at the start of the element like getAlignmentElementByStationing does.
+			lerpParameters[last] = s >= startStationing_ && s <= alignmentEnd ? std::min(std::max((s - start) / (end - start), 0.0), 1.0) : 0.0;
+		}
+
+		horizontalElements_[index]->getPositions(&lerpParameters[first], last - first, positions + first, tangents ? tangents + first : nullptr, normals ? normals + first : nullptr);
+		first = last;
+	}
+}
+
 bool HorizontalAlignment2D::hasSuccessor(buw::ReferenceCounted<HorizontalAlignmentElement2D> element) {
 	for (int i = 0; i < horizontalElements_.size(); i++) {
 		if (element == horizontalElements_[i]) {
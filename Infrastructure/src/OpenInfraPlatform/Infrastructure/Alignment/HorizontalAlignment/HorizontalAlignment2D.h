@@ -25,6 +25,7 @@
 #include "OpenInfraPlatform/Infrastructure/namespace.h"
 #include <boost/noncopyable.hpp>
 #include <buw.Core.h>
+#include <atomic>
 #include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
@@ -43,6 +44,10 @@ public:
 	//! The normal points into the left perpendicular direction of the tangent.
 	buw::Vector2d getNormal(const Stationing station) const;
 
+	//! Computes getPosition, getTangent and getNormal at 'count' stations, tangents and normals only if the arrays are given. The stations that
+	//! follow each other on one element are evaluated by a single call of the element, so sorted stations walk the elements once.
+	void getPositions(const Stationing* stations, const int count, buw::Vector2d* positions, buw::Vector2d* tangents = nullptr, buw::Vector2d* normals = nullptr) const;
+
 	int getAlignmentElementCount() const;
 
 	//! Computes the length of the horizontal alignment
@@ -62,6 +67,24 @@ public:
 	//! station is assumed to be between [0;getLength]
 	buw::ReferenceCounted<HorizontalAlignmentElement2D> getAlignmentElementByStationing(const Stationing station, double* lerpParameter = nullptr) const;
 
+	//! Index of the element returned by getAlignmentElementByStationing, or -1 if there are no elements. The element at 'hint' and its successor
+	//! are tested first, e.g. the one of the previous station when sampling along the alignment, otherwise the end stations are searched binary.
+	int getAlignmentElementIndexByStationing(const Stationing station, const int hint = -1) const;
+
+	//! Axis aligned bounds of all elements, false if there are none. The bounds are merged from the ones of the elements by addElement.
+	bool getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const;
+
+	//! Axis aligned bounds of the nth element as computed by its getExtends when it was added.
+	void getElementExtends(const int index, buw::Vector2d& minimum, buw::Vector2d& maximum) const;
+
+	//! Stations of a polyline which deviates from the alignment by at most 'chordTolerance' and has no segment longer than
+	//! 'maximumSegmentLength', 0 for no limit. It passes the start and end of every element and the inner vertices of their getTessellation,
+	//! so lines contribute their end points only.
+	std::vector<Stationing> getTessellation(const double chordTolerance, const double maximumSegmentLength = 0.0) const;
+
+	//! Incremented whenever an element is added, so tessellations cached by others can tell if they are outdated.
+	int getRevision() const;
+
 	bool hasSuccessor(buw::ReferenceCounted<HorizontalAlignmentElement2D> element);
 
 	//! Get the successor element if it exists, otherwise nullptr.
@@ -70,6 +93,21 @@ public:
 private:
 	Stationing startStationing_;
 	std::vector<buw::ReferenceCounted<HorizontalAlignmentElement2D>> horizontalElements_; // the order of the elements is important here
+
+	// summed up lengths of the elements, updated by addElement
+	double length_;
+	std::vector<Stationing> endStations_;
+
+	// bounds of each element and of all of them, updated by addElement
+	std::vector<buw::Vector2d> elementMinimums_;
+	std::vector<buw::Vector2d> elementMaximums_;
+	buw::Vector2d minimum_;
+	buw::Vector2d maximum_;
+
+	int revision_;
+
+	// element found by the last lookup, the hint for the next one
+	mutable std::atomic<int> lastElement_;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -19,12 +19,118 @@
 
 #include "qapplication.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
 eHorizontalAlignmentType HorizontalAlignmentElement2D::getAlignmentType() const {
     return eHorizontalAlignmentType::Unknown;
 }
 
+void HorizontalAlignmentElement2D::getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents, buw::Vector2d* normals) const {
+    for (int i = 0; i < count; i++) {
+        positions[i] = getPosition(lerpParameters[i]);
+        if (tangents)
+            tangents[i] = getTangent(lerpParameters[i]);
+        if (normals)
+            normals[i] = getNormal(lerpParameters[i]);
+    }
+}
+
+void HorizontalAlignmentElement2D::getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+    const int count = std::max(static_cast<int>(std::ceil(getLength())), 1) + 1;
+    std::vector<double> lerpParameters(count);
+    for (int i = 0; i < count; i++)
+        lerpParameters[i] = static_cast<double>(i) / (count - 1);
+
+    std::vector<buw::Vector2d> positions(count);
+    getPositions(lerpParameters.data(), count, positions.data());
+
+    minimum = maximum = positions[0];
+    for (int i = 1; i < count; i++) {
+        minimum = buw::minimizedVector(minimum, positions[i]);
+        maximum = buw::maximizedVector(maximum, positions[i]);
+    }
+}
+
+double HorizontalAlignmentElement2D::getClosestParameter(const buw::Vector2d& point) const {
+    const int intervals = std::max(static_cast<int>(std::ceil(getLength())), 16);
+    int best = 0;
+    double bestDistance = (getPosition(0.0) - point).squaredNorm();
+    for (int i = 1; i <= intervals; i++) {
+        const double distance = (getPosition(static_cast<double>(i) / intervals) - point).squaredNorm();
+        if (distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+
+    // The distance is assumed to be unimodal between the neighbours of the closest sample.
+    const double ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+    double a = static_cast<double>(std::max(best - 1, 0)) / intervals;
+    double b = static_cast<double>(std::min(best + 1, intervals)) / intervals;
+    double c = b - ratio * (b - a);
+    double d = a + ratio * (b - a);
+    double distanceC = (getPosition(c) - point).squaredNorm();
+    double distanceD = (getPosition(d) - point).squaredNorm();
+    for (int i = 0; i < 60 && b - a > 1e-12; i++) {
+        if (distanceC < distanceD) {
+            b = d;
+            d = c;
+            distanceD = distanceC;
+            c = b - ratio * (b - a);
+            distanceC = (getPosition(c) - point).squaredNorm();
+        }
+        else {
+            a = c;
+            c = d;
+            distanceC = distanceD;
+            d = a + ratio * (b - a);
+            distanceD = (getPosition(d) - point).squaredNorm();
+        }
+    }
+
+    const double lerpParameter = 0.5 * (a + b);
+    return (getPosition(lerpParameter) - point).squaredNorm() < bestDistance ? lerpParameter : static_cast<double>(best) / intervals;
+}
+
+void HorizontalAlignmentElement2D::getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const {
+    // Four intervals at least so that an S-shaped element, whose midpoint lies on the chord, is still split.
+    const int initialIntervals = 4;
+    const int maximumDepth = 20;
+
+    struct Interval {
+        double a;
+        double b;
+        int depth;
+    };
+
+    std::vector<Interval> stack;
+    for (int i = initialIntervals - 1; i >= 0; i--)
+        stack.push_back({ static_cast<double>(i) / initialIntervals, static_cast<double>(i + 1) / initialIntervals, 0 });
+
+    while (!stack.empty()) {
+        const Interval interval = stack.back();
+        stack.pop_back();
+
+        const double m = 0.5 * (interval.a + interval.b);
+        const buw::Vector2d start = getPosition(interval.a);
+        const buw::Vector2d chord = getPosition(interval.b) - start;
+        const buw::Vector2d offset = getPosition(m) - start;
+        const double squaredLength = chord.squaredNorm();
+        const double distance = squaredLength > 0.0 ? std::abs(chord.x() * offset.y() - chord.y() * offset.x()) / std::sqrt(squaredLength) : offset.norm();
+        if (distance > chordTolerance && interval.depth < maximumDepth) {
+            stack.push_back({ m, interval.b, interval.depth + 1 });
+            stack.push_back({ interval.a, m, interval.depth + 1 });
+        }
+        else if (interval.b < 1.0) {
+            lerpParameters.push_back(interval.b);
+        }
+    }
+}
+
 bool HorizontalAlignmentElement2D::genericQuery(const int /*id*/, void* /*result*/) const {
     return false;
 }
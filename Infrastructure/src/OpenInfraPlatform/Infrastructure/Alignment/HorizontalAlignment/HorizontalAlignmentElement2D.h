@@ -24,6 +24,7 @@
 #include "OpenInfraPlatform/Infrastructure/namespace.h"
 #include <boost/noncopyable.hpp>
 #include <buw.Core.h>
+#include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -48,6 +49,23 @@ public:
 	//! The normal points into the left perpendicular direction of the tangent.
 	virtual buw::Vector2d getNormal(const double lerpParameter) const = 0;
 
+	//! Evaluates the element at 'count' parameters. Tangents and normals are only written if the arrays are given. The default calls the
+	//! methods above for each parameter, elements with a closed form override it to set up their constants once per call.
+	virtual void getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents = nullptr, buw::Vector2d* normals = nullptr) const;
+
+	//! Axis aligned bounds of the element. The default samples the element about every meter, elements with a closed form override it with
+	//! the end points and the points where the tangent is parallel to an axis.
+	virtual void getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const;
+
+	//! Lerp parameter of the point of the element closest to 'point'. The default samples the element about every meter and refines the closest
+	//! sample by golden section search, elements with a closed form or a cheap derivative override it.
+	virtual double getClosestParameter(const buw::Vector2d& point) const;
+
+	//! Appends the lerp parameters strictly between 0 and 1, ascending, of a polyline through the start and end point which deviates from the
+	//! element by at most 'chordTolerance'. The default bisects intervals while their midpoint is further from the chord, elements with a
+	//! curvature in closed form override it.
+	virtual void getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const;
+
 	//! Should return the same value as getPosition(0.0)
 	virtual buw::Vector2d getStartPosition() const = 0;
 
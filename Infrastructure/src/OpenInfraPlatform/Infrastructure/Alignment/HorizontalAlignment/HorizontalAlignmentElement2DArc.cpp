@@ -18,6 +18,7 @@
 #include "HorizontalAlignmentElement2DArc.h"
 #include <BlueFramework/Core/assert.h>
 
+#include <cmath>
 #include <utility>
 
 OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::HorizontalAlignmentElement2DArc(const buw::Vector2d& center,
@@ -99,6 +100,90 @@ buw::Vector2d OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc
     return clockWise_ ? normal : -normal;
 }
 
+void OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents, buw::Vector2d* normals) const {
+    // Same rotation as getPosition with the sweep angle determined once.
+    const buw::Vector2d v1 = start_ - center_;
+    const buw::Vector2d v2 = end_ - center_;
+    const double sweep = clockWise_ ? -buw::calculateAngleBetweenVectors(v2, v1) : buw::calculateAngleBetweenVectors(v1, v2);
+    const double radius = v1.norm();
+
+    for (int i = 0; i < count; i++) {
+        BLUE_ASSERT(lerpParameters[i] >= 0.0, "Invalid lerp paramter.");
+        BLUE_ASSERT(lerpParameters[i] <= 1.0, "Invalid lerp paramter.");
+
+        const double c = std::cos(sweep * lerpParameters[i]);
+        const double s = std::sin(sweep * lerpParameters[i]);
+        const buw::Vector2d radial(c * v1.x() - s * v1.y(), s * v1.x() + c * v1.y());
+        positions[i] = center_ + radial;
+
+        if (tangents || normals) {
+            const buw::Vector2d normal = clockWise_ ? buw::Vector2d(radial / radius) : buw::Vector2d(-radial / radius);
+            if (tangents)
+                tangents[i] = buw::orthogonal(normal, false);
+            if (normals)
+                normals[i] = normal;
+        }
+    }
+}
+
+void OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+    minimum = buw::minimizedVector(start_, end_);
+    maximum = buw::maximizedVector(start_, end_);
+
+    const buw::Vector2d v1 = start_ - center_;
+    const buw::Vector2d v2 = end_ - center_;
+    const double sweep = clockWise_ ? buw::calculateAngleBetweenVectors(v2, v1) : buw::calculateAngleBetweenVectors(v1, v2);
+    const double radius = v1.norm();
+    const double twoPi = 2.0 * buw::constantsd::pi();
+    const double startAngle = std::atan2(v1.y(), v1.x());
+
+    // The points at 0, 90, 180 and 270 degrees around the center are extremes if the sweep passes them.
+    const buw::Vector2d axes[4] = { buw::Vector2d(1, 0), buw::Vector2d(0, 1), buw::Vector2d(-1, 0), buw::Vector2d(0, -1) };
+    for (int k = 0; k < 4; k++) {
+        const double angle = k * 0.5 * buw::constantsd::pi();
+        double offset = std::fmod(clockWise_ ? startAngle - angle : angle - startAngle, twoPi);
+        if (offset < 0.0)
+            offset += twoPi;
+
+        if (offset <= sweep) {
+            const buw::Vector2d p = center_ + radius * axes[k];
+            minimum = buw::minimizedVector(minimum, p);
+            maximum = buw::maximizedVector(maximum, p);
+        }
+    }
+}
+
+double OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::getClosestParameter(const buw::Vector2d& point) const {
+    const buw::Vector2d v1 = start_ - center_;
+    const buw::Vector2d v = point - center_;
+    const double sweep = clockWise_ ? buw::calculateAngleBetweenVectors(end_ - center_, v1) : buw::calculateAngleBetweenVectors(v1, end_ - center_);
+    if (sweep > 0.0 && v.squaredNorm() > 0.0) {
+        const double twoPi = 2.0 * buw::constantsd::pi();
+        const double angle = std::atan2(v.y(), v.x()) - std::atan2(v1.y(), v1.x());
+        double offset = std::fmod(clockWise_ ? -angle : angle, twoPi);
+        if (offset < 0.0)
+            offset += twoPi;
+
+        if (offset <= sweep)
+            return offset / sweep;
+    }
+
+    return (point - start_).squaredNorm() <= (point - end_).squaredNorm() ? 0.0 : 1.0;
+}
+
+void OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const {
+    const double radius = getRadius();
+    if (!(radius > 0.0))
+        return;
+
+    // Chords of more than half a circle deviate by more than the radius, so tolerances of the radius or more still split at half circles.
+    const double sweep = getLength() / radius;
+    const double maximumAngle = chordTolerance < radius ? 2.0 * std::acos(1.0 - chordTolerance / radius) : buw::constantsd::pi();
+    const int intervals = static_cast<int>(std::ceil(sweep / maximumAngle));
+    for (int i = 1; i < intervals; i++)
+        lerpParameters.push_back(static_cast<double>(i) / intervals);
+}
+
 double OpenInfraPlatform::Infrastructure::HorizontalAlignmentElement2DArc::getLength() const {
     auto radius = getRadius();
 
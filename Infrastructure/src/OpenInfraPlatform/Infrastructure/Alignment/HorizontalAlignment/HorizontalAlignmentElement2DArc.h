@@ -41,6 +41,17 @@ public:
 
     virtual buw::Vector2d getNormal(const double lerpParameter) const override;
 
+    virtual void getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents = nullptr, buw::Vector2d* normals = nullptr) const override;
+
+    //! The end points and the points of the sweep furthest from the center along each axis.
+    virtual void getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const override;
+
+    //! The point on the ray from the center through 'point' if the sweep passes it, otherwise the closer end point.
+    virtual double getClosestParameter(const buw::Vector2d& point) const override;
+
+    //! Equal angles, each chord of an angle 2 acos(1 - chordTolerance / radius) deviates by chordTolerance in its middle.
+    virtual void getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const override;
+
     virtual buw::Vector2d getCenter() const { return center_; }
 
     virtual bool getClockWise() const { return clockWise_; }
@@ -16,11 +16,14 @@
 */
 
 #include "HorizontalAlignmentElement2DClothoid.h"
+#include "../../Core/Fresnel.h"
 #include "../../Core/Line2.h"
 #include <BlueFramework/Core/Math/Matrix.h>
-#include <BlueFramework/Core/Exception.h>
 #include <BlueFramework/Core/assert.h>
 
+#include <algorithm>
+#include <cmath>
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
 clothoidDescription::clothoidDescription() {
@@ -76,6 +79,19 @@ HorizontalAlignmentElement2DClothoid::HorizontalAlignmentElement2DClothoid(const
         else
             endL_ = buw::max(startL_ - cd.length, 0.0);
     }
+
+    scale_ = clothoidConstant_ * std::sqrt(buw::constantsd::pi());
+    startLocalPosition_ = computeLocalPosition(startL_);
+    startT_ = computeT(startL_, clothoidConstant_);
+
+    // Exits run backwards along the local clothoid and are mirrored at the y-axis, clockwise ones are mirrored at the x-axis.
+    const double entrySign = isEntry() ? 1.0 : -1.0;
+    const double turnSign = counterClockwise_ ? 1.0 : -1.0;
+    turn_ = entrySign * turnSign;
+
+    const buw::Matrix22d rotation = buw::createRotationMatrix(startDirection_ - turn_ * startT_);
+    axisX_ = entrySign * rotation.col(0);
+    axisY_ = turnSign * rotation.col(1);
 }
 
 OpenInfraPlatform::Infrastructure::eHorizontalAlignmentType HorizontalAlignmentElement2DClothoid::getAlignmentType() const {
@@ -104,49 +120,214 @@ bool HorizontalAlignmentElement2DClothoid::genericQuery(const int id, void* resu
 }
 
 buw::Vector2d HorizontalAlignmentElement2DClothoid::getPosition(const double lerpParameter) const {
-    buw::Vector2d localPosition, localOffset;
-
-    double L = startL_ + (endL_ - startL_) * lerpParameter;
+    const double L = startL_ + (endL_ - startL_) * lerpParameter;
+    const buw::Vector2d localOffset = computeLocalPosition(L) - startLocalPosition_;
 
-    localPosition = computeLocalPosition(L);
+    return startPosition_ + axisX_ * localOffset.x() + axisY_ * localOffset.y();
+}
 
-    double angle;
+buw::Vector2d HorizontalAlignmentElement2DClothoid::getTangent(const double lerpParameter) const
+{
+    const double direction = computeDirection(startL_ + (endL_ - startL_) * lerpParameter);
+    return buw::Vector2d(std::cos(direction), std::sin(direction));
+}
 
-    buw::Vector2d position;
-    angle = computeT(startL_, clothoidConstant_);
-    localOffset = localPosition - computeLocalPosition(startL_);
+buw::Vector2d HorizontalAlignmentElement2DClothoid::getNormal(const double lerpParameter) const
+{
+    // Rotate the tangent by 90 degrees CCW to get the normal.
+    return buw::orthogonal(getTangent(lerpParameter), true);
+}
+
+void HorizontalAlignmentElement2DClothoid::getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents, buw::Vector2d* normals) const {
+    const double invScale = 1.0 / scale_;
+
+    for (int i = 0; i < count; i++) {
+        const double L = startL_ + (endL_ - startL_) * lerpParameters[i];
+
+        double C, S;
+        buw::computeFresnelIntegrals(L * invScale, C, S);
+        const double dx = scale_ * C - startLocalPosition_.x();
+        const double dy = scale_ * S - startLocalPosition_.y();
+        positions[i] = startPosition_ + axisX_ * dx + axisY_ * dy;
+
+        if (tangents || normals) {
+            const double direction = computeDirection(L);
+            const buw::Vector2d tangent(std::cos(direction), std::sin(direction));
+            if (tangents)
+                tangents[i] = tangent;
+            if (normals)
+                normals[i] = buw::orthogonal(tangent, true);
+        }
+    }
+}
 
-    if (!isEntry()) {
-        angle *= -1;
-        localOffset.x() *= -1;
+void HorizontalAlignmentElement2DClothoid::getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+    const buw::Vector2d start = getPosition(0.0);
+    const buw::Vector2d end = getPosition(1.0);
+    minimum = buw::minimizedVector(start, end);
+    maximum = buw::maximizedVector(start, end);
+    if (endL_ == startL_)
+        return;
+
+    // T(L) is monotone on each side of L = 0, so the direction passes each multiple of 90 degrees between its extremes at most once per side.
+    const double lowL = std::min(startL_, endL_);
+    const double highL = std::max(startL_, endL_);
+    const double lowT = lowL < 0.0 && highL > 0.0 ? 0.0 : std::min(computeT(lowL, clothoidConstant_), computeT(highL, clothoidConstant_));
+    const double highT = std::max(computeT(lowL, clothoidConstant_), computeT(highL, clothoidConstant_));
+    const double direction0 = startDirection_ + turn_ * (lowT - startT_);
+    const double direction1 = startDirection_ + turn_ * (highT - startT_);
+
+    const double quarter = 0.5 * buw::constantsd::pi();
+    const int first = static_cast<int>(std::ceil(std::min(direction0, direction1) / quarter));
+    const int last = static_cast<int>(std::floor(std::max(direction0, direction1) / quarter));
+    for (int k = first; k <= last; k++) {
+        // Solve startDirection_ + turn_ * (T(L) - startT_) = k * 90 degrees for T(L) = L^2 / (2 A^2).
+        const double T = startT_ + (k * quarter - startDirection_) * turn_;
+        if (T < 0.0)
+            continue;
+
+        const double L = clothoidConstant_ * std::sqrt(2.0 * T);
+        for (const double candidate : { L, -L }) {
+            if (candidate < lowL || candidate > highL)
+                continue;
+
+            const buw::Vector2d p = getPosition(std::min(std::max((candidate - startL_) / (endL_ - startL_), 0.0), 1.0));
+            minimum = buw::minimizedVector(minimum, p);
+            maximum = buw::maximizedVector(maximum, p);
+        }
     }
+}
 
-    if (!counterClockwise_) {
-        angle *= -1;
-        localOffset.y() *= -1;
+double HorizontalAlignmentElement2DClothoid::getClosestParameter(const buw::Vector2d& point) const {
+    if (endL_ == startL_)
+        return 0.0;
+
+    const int intervals = std::max(static_cast<int>(std::ceil(getLength() / 10.0)), 4);
+    std::vector<double> distances(intervals + 1);
+    for (int i = 0; i <= intervals; i++)
+        distances[i] = (getPosition(static_cast<double>(i) / intervals) - point).squaredNorm();
+
+    // Along the arc length s = t length, which runs backwards along L for exits, the derivative of |d|^2 / 2 with d = P - point is
+    // f = d.t and f' = 1 + kappa d.n, where the curvature kappa = turn_ sign L / A^2 is signed like the left normal n.
+    const double length = getLength();
+    const double sign = endL_ > startL_ ? 1.0 : -1.0;
+    auto derivatives = [&](const double t, double& fd) {
+        const double L = startL_ + (endL_ - startL_) * t;
+        const double direction = computeDirection(L);
+        const buw::Vector2d tangent(std::cos(direction), std::sin(direction));
+        const buw::Vector2d d = getPosition(t) - point;
+        fd = 1.0 + turn_ * sign * L / (clothoidConstant_ * clothoidConstant_) * d.dot(buw::orthogonal(tangent, true));
+        return d.dot(tangent);
+    };
+
+    // Refines the local minimum of the samples at i between its neighbours.
+    auto refine = [&](const int i) {
+        double low = static_cast<double>(std::max(i - 1, 0)) / intervals;
+        double high = static_cast<double>(std::min(i + 1, intervals)) / intervals;
+        double fd = 0.0;
+        if (derivatives(low, fd) < 0.0 && derivatives(high, fd) > 0.0) {
+            // Newton's method kept in the bracket of the sign change, bisection where f' is not positive or the step leaves the bracket,
+            // as around L = 0 where the curvature changes its sign.
+            double t = static_cast<double>(i) / intervals;
+            for (int iteration = 0; iteration < 60 && (high - low) * length > 1e-10; iteration++) {
+                const double f = derivatives(t, fd);
+                if (f == 0.0)
+                    break;
+
+                if (f < 0.0)
+                    low = t;
+                else
+                    high = t;
+
+                const double next = t - f / (fd * length);
+                if (fd > 0.0 && std::abs(next - t) * length < 1e-10)
+                    return next;
+
+                t = fd > 0.0 && next > low && next < high ? next : 0.5 * (low + high);
+            }
+            return t;
+        }
+
+        // No sign change, e.g. at the ends of the element, golden section search on the distance.
+        const double ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+        double a = high - ratio * (high - low);
+        double b = low + ratio * (high - low);
+        double distanceA = (getPosition(a) - point).squaredNorm();
+        double distanceB = (getPosition(b) - point).squaredNorm();
+        while ((high - low) * length > 1e-10) {
+            if (distanceA < distanceB) {
+                high = b;
+                b = a;
+                distanceB = distanceA;
+                a = high - ratio * (high - low);
+                distanceA = (getPosition(a) - point).squaredNorm();
+            } else {
+                low = a;
+                a = b;
+                distanceA = distanceB;
+                b = low + ratio * (high - low);
+                distanceB = (getPosition(b) - point).squaredNorm();
+            }
+        }
+        return 0.5 * (low + high);
+    };
+
+    // Minima of nearly the same distance may be closer to other samples than the global one, so each local minimum of the samples is
+    // refined.
+    double lerpParameter = 0.0;
+    double bestDistance = distances[0];
+    for (int i = 0; i <= intervals; i++) {
+        if (distances[i] < bestDistance) {
+            lerpParameter = static_cast<double>(i) / intervals;
+            bestDistance = distances[i];
+        }
     }
 
-    position = startPosition_ + buw::createRotationMatrix(startDirection_ - angle) * localOffset;
+    for (int i = 0; i <= intervals; i++) {
+        if ((i > 0 && distances[i - 1] < distances[i]) || (i < intervals && distances[i + 1] < distances[i]))
+            continue;
 
-    return position;
-}
+        const double refined = std::min(std::max(refine(i), 0.0), 1.0);
+        const double distance = (getPosition(refined) - point).squaredNorm();
+        if (distance <= bestDistance) {
+            lerpParameter = refined;
+            bestDistance = distance;
+        }
+    }
 
-buw::Vector2d HorizontalAlignmentElement2DClothoid::getTangent(const double lerpParameter) const
-{
-    throw buw::NotImplementedYetException("TODO");
+    return lerpParameter;
 }
 
-buw::Vector2d HorizontalAlignmentElement2DClothoid::getNormal(const double lerpParameter) const
-{
-    throw buw::NotImplementedYetException("TODO");
+void HorizontalAlignmentElement2DClothoid::getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const {
+    if (endL_ == startL_ || !(chordTolerance > 0.0))
+        return;
+
+    // U(L) = sign(L) 2/3 |L|^(3/2) / (A sqrt(8 e)) is the integral up to L and increases with L, so the chords have equal steps of U. The
+    // first chord from L = 0 deviates by about 1.15 e from the curve as the curvature grows over it, the tolerance is reduced accordingly.
+    const double e = 0.85 * chordTolerance;
+    const double scale = clothoidConstant_ * std::sqrt(8.0 * e);
+    auto integral = [scale](const double L) { return (L < 0.0 ? -1.0 : 1.0) * 2.0 / 3.0 * std::pow(std::abs(L), 1.5) / scale; };
+    auto inverse = [scale](const double U) { return (U < 0.0 ? -1.0 : 1.0) * std::pow(1.5 * scale * std::abs(U), 2.0 / 3.0); };
+
+    const double startU = integral(startL_);
+    const double endU = integral(endL_);
+    const int intervals = static_cast<int>(std::ceil(std::abs(endU - startU)));
+    for (int i = 1; i < intervals; i++) {
+        const double L = inverse(startU + (endU - startU) * i / intervals);
+        lerpParameters.push_back(std::min(std::max((L - startL_) / (endL_ - startL_), 0.0), 1.0));
+    }
 }
 
 buw::Vector2d HorizontalAlignmentElement2DClothoid::computeLocalPosition(const double L) const {
-    buw::Vector2d localPosition;
-    localPosition.x() = computeX(L, clothoidConstant_);
-    localPosition.y() = computeY(L, clothoidConstant_);
+    double C, S;
+    buw::computeFresnelIntegrals(L / scale_, C, S);
 
-    return localPosition;
+    return buw::Vector2d(scale_ * C, scale_ * S);
+}
+
+double HorizontalAlignmentElement2DClothoid::computeDirection(const double L) const {
+    // The local clothoid has the direction T(L), mirrored and rotated like the positions.
+    return startDirection_ + turn_ * (computeT(L, clothoidConstant_) - startT_);
 }
 
 buw::Vector2d HorizontalAlignmentElement2DClothoid::getStartPosition() const {
@@ -191,7 +372,7 @@ double HorizontalAlignmentElement2DClothoid::getStartDirection() const {
 }
 
 double HorizontalAlignmentElement2DClothoid::getEndDirection() const {
-    return startDirection_ + (computeT(endL_, clothoidConstant_) - computeT(startL_, clothoidConstant_)) * (counterClockwise_ ? 1 : -1) * (isEntry() ? 1 : -1);
+    return computeDirection(endL_);
 }
 
 double HorizontalAlignmentElement2DClothoid::getStartParameter() const
@@ -233,37 +414,18 @@ double HorizontalAlignmentElement2DClothoid::computeT(const double L, const doub
 }
 
 double HorizontalAlignmentElement2DClothoid::computeX(const double L, const double A) {
-    double x = L;
-    const int iterations = 5;
-
-    for (int i = 1; i < iterations + 1; i++) {
-        double sign = i % 2 == 0 ? 1 : -1;
-
-        double L_exponent = 5 + (i - 1) * 4;
-        double A_exponent = i * 4;
-        double factor = buw::factorial(2 * i) * std::pow(2.0, 2 * i) * (5 + (i - 1) * 4);
-
-        x += sign * std::pow(L, L_exponent) / (factor * std::pow(A, A_exponent));
-    }
-
-    return x;
+    // x(L) = A sqrt(pi) C(L / (A sqrt(pi))) with the normalized Fresnel cosine integral.
+    const double scale = A * std::sqrt(buw::constantsd::pi());
+    double C, S;
+    buw::computeFresnelIntegrals(L / scale, C, S);
+    return scale * C;
 }
 
 double HorizontalAlignmentElement2DClothoid::computeY(const double L, const double A) {
-    double y = 0;
-    const int iterations = 5;
-
-    for (int i = 0; i < iterations; i++) {
-        double sign = i % 2 == 0 ? 1 : -1;
-
-        double L_exponent = 3 + i * 4;
-        double A_exponent = 2 + i * 4;
-        double factor = buw::factorial(2 * i + 1) * std::pow(2.0, i * 2) * 2 * (A_exponent + 1);
-
-        y += sign * std::pow(L, L_exponent) / (factor * std::pow(A, A_exponent));
-    }
-
-    return y;
+    const double scale = A * std::sqrt(buw::constantsd::pi());
+    double C, S;
+    buw::computeFresnelIntegrals(L / scale, C, S);
+    return scale * S;
 }
 
 double HorizontalAlignmentElement2DClothoid::computeStartDirection(const buw::Vector2d& start, const buw::Vector2d& pi) {
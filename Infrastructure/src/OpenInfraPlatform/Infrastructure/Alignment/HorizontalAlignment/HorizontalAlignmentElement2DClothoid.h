@@ -64,6 +64,22 @@ public:
 	buw::Vector2d getPosition(const double lerpParameter) const override;
 	buw::Vector2d getTangent(const double lerpParameter) const override;
 	buw::Vector2d getNormal(const double lerpParameter) const override;
+
+	//! Evaluates the Fresnel integrals once per sample with the constants of the element computed in the constructor.
+	void getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents = nullptr, buw::Vector2d* normals = nullptr) const override;
+
+	//! The end points and the points where the direction is a multiple of 90 degrees, their arc lengths follow from the direction in closed form.
+	void getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const override;
+
+	//! Newton's method on the derivative of the squared distance over the arc length, started at each local minimum of samples every 10
+	//! meters and kept between its neighbours by bisection. Without a sign change between them a golden section search on the distance is
+	//! used.
+	double getClosestParameter(const buw::Vector2d& point) const override;
+
+	//! Equidistributes the integral of sqrt(curvature / (8 chordTolerance)) over the arc length, i.e. the number of chords of the sagitta
+	//! formula, which the curvature |L| / A^2 gives in closed form.
+	void getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const override;
+
 	buw::Vector2d getStartPosition() const override;
 	buw::Vector2d getEndPosition() const override;
 	buw::Vector2d getPiPosition() const;
@@ -96,11 +112,13 @@ public:
 	static double computeC(const double L, const double A);
 	static double computeT(const double L, const double A);
 
+	//! Coordinates at arc length L of the clothoid starting at the origin in direction of the x-axis and turning counterclockwise.
 	static double computeX(const double L, const double A);
 	static double computeY(const double L, const double A);
 
 private:
 	buw::Vector2d computeLocalPosition(const double L) const;
+	double computeDirection(const double L) const;
 
 private:
 	buw::Vector2d startPosition_;
@@ -111,6 +129,15 @@ private:
 	double clothoidConstant_;
 	double startL_;
 	double endL_;
+
+	// Constants of the element derived from the description. The local clothoid is scaled by A * sqrt(pi) from the normalized Fresnel
+	// integrals, the axes map the local offset from startL_ with the mirroring for exits and clockwise turns and the rotation to the start direction.
+	double scale_;
+	buw::Vector2d startLocalPosition_;
+	buw::Vector2d axisX_;
+	buw::Vector2d axisY_;
+	double startT_;
+	double turn_;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -18,6 +18,7 @@
 #include "HorizontalAlignmentElement2DLine.h"
 #include <BlueFramework/Core/assert.h>
 
+#include <algorithm>
 #include <utility>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
@@ -52,6 +53,41 @@ buw::Vector2d HorizontalAlignmentElement2DLine::getNormal(const double lerpParam
     return buw::orthogonal(getTangent(lerpParameter), true);
 }
 
+void HorizontalAlignmentElement2DLine::getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents, buw::Vector2d* normals) const {
+    const double x0 = start_.x(), y0 = start_.y();
+    const double dx = end_.x() - x0, dy = end_.y() - y0;
+    for (int i = 0; i < count; i++) {
+        positions[i] = buw::Vector2d(x0 + dx * lerpParameters[i], y0 + dy * lerpParameters[i]);
+    }
+
+    const buw::Vector2d tangent = getTangent(0.0);
+    const buw::Vector2d normal = buw::orthogonal(tangent, true);
+    for (int i = 0; i < count; i++) {
+        if (tangents)
+            tangents[i] = tangent;
+        if (normals)
+            normals[i] = normal;
+    }
+}
+
+void HorizontalAlignmentElement2DLine::getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const {
+    minimum = buw::minimizedVector(start_, end_);
+    maximum = buw::maximizedVector(start_, end_);
+}
+
+double HorizontalAlignmentElement2DLine::getClosestParameter(const buw::Vector2d& point) const {
+    const buw::Vector2d direction = end_ - start_;
+    const double squaredLength = direction.squaredNorm();
+    if (squaredLength == 0.0)
+        return 0.0;
+
+    return std::min(std::max((point - start_).dot(direction) / squaredLength, 0.0), 1.0);
+}
+
+void HorizontalAlignmentElement2DLine::getTessellation(const double /*chordTolerance*/, std::vector<double>& /*lerpParameters*/) const {
+
+}
+
 double HorizontalAlignmentElement2DLine::getLength() const {
     return (start_ - end_).norm();
 }
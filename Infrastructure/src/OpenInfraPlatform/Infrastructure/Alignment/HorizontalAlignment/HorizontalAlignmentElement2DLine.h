@@ -36,6 +36,17 @@ public:
 
 	virtual buw::Vector2d getNormal(const double lerpParameter) const override;
 
+	virtual void getPositions(const double* lerpParameters, const int count, buw::Vector2d* positions, buw::Vector2d* tangents = nullptr, buw::Vector2d* normals = nullptr) const override;
+
+	//! The bounds of the end points.
+	virtual void getExtends(buw::Vector2d& minimum, buw::Vector2d& maximum) const override;
+
+	//! The orthogonal projection onto the line clamped to the end points.
+	virtual double getClosestParameter(const buw::Vector2d& point) const override;
+
+	//! The end points are exact, so there are no inner vertices.
+	virtual void getTessellation(const double chordTolerance, std::vector<double>& lerpParameters) const override;
+
 	virtual buw::Vector2d getStartPosition() const override;
 
 	virtual buw::Vector2d getEndPosition() const override;
@@ -17,6 +17,9 @@
 
 #include "IAlignment3D.h"
 #include <BlueFramework/Core/string.h>
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -40,6 +43,104 @@ buw::String IAlignment3D::getName() const
 	return name_;
 }
 
+void IAlignment3D::getPositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents /*= nullptr*/, buw::Vector3d* normals /*= nullptr*/, const int threadCount /*= 1*/) const
+{
+	const int chunkSize = 256;
+	const int chunkCount = (count + chunkSize - 1) / chunkSize;
+	const int threads = threadCount > 0 ? threadCount : omp_get_max_threads();
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1 && chunkCount > 1)
+	for (int c = 0; c < chunkCount; c++)
+	{
+		const int first = c * chunkSize;
+		evaluatePositions(stations + first, std::min(chunkSize, count - first), positions + first, tangents ? tangents + first : nullptr, normals ? normals + first : nullptr);
+	}
+}
+
+void IAlignment3D::evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const
+{
+	const Stationing start = getStartStation();
+	const Stationing end = getEndStation();
+	const double delta = 1e-4 * (end - start);
+
+	for (int i = 0; i < count; i++)
+	{
+		positions[i] = getPosition(stations[i]);
+		if (!tangents && !normals)
+			continue;
+
+		buw::Vector3d direction = getPosition(std::min(stations[i] + delta, end)) - getPosition(std::max(stations[i] - delta, start));
+		if (direction.norm() > 0)
+			direction.normalize();
+		if (tangents)
+			tangents[i] = direction;
+		if (normals)
+		{
+			buw::Vector3d normal(-direction.y(), direction.x(), 0.0);
+			if (normal.norm() > 0)
+				normal.normalize();
+			normals[i] = normal;
+		}
+	}
+}
+
+bool IAlignment3D::getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const
+{
+	const std::vector<Stationing> stations = createStations(getStartStation(), getEndStation(), 1.0);
+	if (stations.empty())
+		return false;
+
+	std::vector<buw::Vector3d> positions(stations.size());
+	getPositions(stations.data(), static_cast<int>(stations.size()), positions.data(), nullptr, nullptr, 0);
+
+	minimum = maximum = positions[0];
+	for (const buw::Vector3d& p : positions)
+	{
+		minimum = buw::minimizedVector(minimum, p);
+		maximum = buw::maximizedVector(maximum, p);
+	}
+	return true;
+}
+
+std::vector<Stationing> IAlignment3D::getTessellation(const double /*chordTolerance*/, const double maximumSegmentLength /*= 0.0*/) const
+{
+	const double step = maximumSegmentLength > 0.0 ? std::min(maximumSegmentLength, 1.0) : 1.0;
+	return createStations(getStartStation(), getEndStation(), step);
+}
+
+std::vector<Stationing> createStations(const Stationing start, const Stationing end, const double step)
+{
+	std::vector<Stationing> stations;
+	if (!(step > 0) || !(start <= end))
+		return stations;
+
+	const long long count = static_cast<long long>(std::ceil((end - start) / step));
+	stations.reserve(count + 1);
+	for (long long i = 0; i < count; i++)
+		stations.push_back(start + i * step);
+	stations.push_back(end);
+	return stations;
+}
+
+void subdivideStations(std::vector<Stationing>& stations, const double maximumSegmentLength)
+{
+	if (!(maximumSegmentLength > 0.0) || stations.size() < 2)
+		return;
+
+	std::vector<Stationing> subdivided;
+	subdivided.reserve(stations.size());
+	subdivided.push_back(stations[0]);
+	for (size_t i = 1; i < stations.size(); i++)
+	{
+		const Stationing start = stations[i - 1];
+		const long long count = static_cast<long long>(std::ceil((stations[i] - start) / maximumSegmentLength));
+		for (long long j = 1; j < count; j++)
+			subdivided.push_back(start + (stations[i] - start) * j / count);
+		subdivided.push_back(stations[i]);
+	}
+	stations.swap(subdivided);
+}
+
 IAlignment3D::~IAlignment3D()
 {
 
@@ -27,6 +27,7 @@
 #include <BlueFramework/Core/string.h>
 #include <boost/noncopyable.hpp>
 #include <string>
+#include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -61,6 +62,20 @@ public:
 	virtual Stationing		getEndStation() const = 0;
 	virtual double			getLength() const = 0;
 
+	//! Computes the positions at 'count' stations in ascending order. Tangents have unit length and point into the direction of increasing
+	//! station, normals are horizontal and point to the left of the tangent, both are only written if the arrays are given. Chunks of the
+	//! stations are evaluated in parallel with 'threadCount' threads, 0 uses all available.
+	void					getPositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents = nullptr, buw::Vector3d* normals = nullptr, const int threadCount = 1) const;
+
+	//! Axis aligned bounds of the alignment between its start and end station, false if it is empty. The default samples the alignment every
+	//! meter, alignments which know their geometry override it.
+	virtual bool			getExtends(buw::Vector3d& minimum, buw::Vector3d& maximum) const;
+
+	//! Ascending stations from the start to the end station of a polyline which deviates from the alignment by at most 'chordTolerance' and
+	//! has no segment longer than 'maximumSegmentLength', 0 for no limit. This is the sampling viewers and exporters use. The default has no
+	//! notion of the curvature and samples every meter, alignments which know their geometry override it.
+	virtual std::vector<Stationing>	getTessellation(const double chordTolerance, const double maximumSegmentLength = 0.0) const;
+
 	//! Retrieve name of alignment
 	buw::String				getName() const;
 
@@ -70,6 +85,11 @@ public:
 
 	e3DAlignmentType		getType() const;
 
+protected:
+	//! Evaluates one chunk of getPositions. The default calls getPosition and takes the tangent from the positions shortly before and after
+	//! each station, alignments override it to walk their elements once.
+	virtual void			evaluatePositions(const Stationing* stations, const int count, buw::Vector3d* positions, buw::Vector3d* tangents, buw::Vector3d* normals) const;
+
 protected:
 	e3DAlignmentType		type_;
 
@@ -77,13 +97,21 @@ private:
 	buw::String				name_;
 }; // end class IAlignment3D
 
+//! Stations from 'start' in steps of 'step' followed by 'end', the sweep used to sample an alignment.
+BLUEINFRASTRUCTURE_API std::vector<Stationing> createStations(const Stationing start, const Stationing end, const double step);
+
+//! Inserts equally spaced stations between ascending 'stations' wherever two of them are more than 'maximumSegmentLength' apart, nothing for 0.
+BLUEINFRASTRUCTURE_API void subdivideStations(std::vector<Stationing>& stations, const double maximumSegmentLength);
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
 
 namespace buw
 {
+	using OpenInfraPlatform::Infrastructure::createStations;
 	using OpenInfraPlatform::Infrastructure::e3DAlignmentTypeToString;
 	using OpenInfraPlatform::Infrastructure::e3DAlignmentType;
 	using OpenInfraPlatform::Infrastructure::IAlignment3D;
+	using OpenInfraPlatform::Infrastructure::subdivideStations;
 }
 
 #endif // end define OpenInfraPlatform_Infrastructure_IAlignment3D_f30b6bea_bf6e_4892_acc4_2b1f1952fe60_h
@@ -16,25 +16,126 @@
 */
 
 #include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignment2D.h"
+#include <algorithm>
+#include <limits>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
+VerticalAlignment2D::VerticalAlignment2D()
+    : minimumHeight_(std::numeric_limits<double>::max()), maximumHeight_(-std::numeric_limits<double>::max()), bOrdered_(true), revision_(0), lastElement_(0) {
+}
+
 buw::ReferenceCounted<VerticalAlignmentElement2D> VerticalAlignment2D::getAlignmentElementByStationing(const Stationing station) const {
-	if (verticalElements_.size() == 0) {
+	const int index = getAlignmentElementIndexByStationing(station, lastElement_.load(std::memory_order_relaxed));
+	if (index < 0) {
 		return nullptr;
 	}
 
-	for (int i = 0; i < verticalElements_.size(); i++) {
-		if (station >= verticalElements_[i]->getStartStation() && station < verticalElements_[i]->getEndStation()) {
-			return verticalElements_[i];
+	// Several threads may sample the alignment, the hint is only a guess anyway.
+	lastElement_.store(index, std::memory_order_relaxed);
+	return verticalElements_[index];
+}
+
+int VerticalAlignment2D::getAlignmentElementIndexByStationing(const Stationing station, const int hint /*= -1*/) const {
+	const int count = static_cast<int>(verticalElements_.size());
+
+	if (!bOrdered_) {
+		for (int i = 0; i < count; i++) {
+			if (station >= startStations_[i] && station < endStations_[i]) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	for (int i = std::max(hint, 0); i < count && i <= hint + 1; i++) {
+		if (station >= startStations_[i] && station < endStations_[i]) {
+			return i;
 		}
 	}
 
-	return nullptr;
+	// Only the last element starting at or before the station can contain it.
+	const int index = static_cast<int>(std::upper_bound(startStations_.begin(), startStations_.end(), station) - startStations_.begin()) - 1;
+	if (index >= 0 && station < endStations_[index]) {
+		return index;
+	}
+
+	return -1;
 }
 
 void VerticalAlignment2D::addElement(buw::ReferenceCounted<VerticalAlignmentElement2D> ve) {
+	const Stationing start = ve->getStartStation();
+	const Stationing end = ve->getEndStation();
+	if (end < start || (!endStations_.empty() && start < endStations_.back())) {
+		bOrdered_ = false;
+	}
+
+	startStations_.push_back(start);
+	endStations_.push_back(end);
+
+	double minimum, maximum;
+	ve->getHeightRange(start, end, minimum, maximum);
+	minimumHeights_.push_back(minimum);
+	maximumHeights_.push_back(maximum);
+	minimumHeight_ = std::min(minimumHeight_, minimum);
+	maximumHeight_ = std::max(maximumHeight_, maximum);
+
 	verticalElements_.push_back(ve);
+	revision_++;
+}
+
+bool VerticalAlignment2D::getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const {
+	const int count = static_cast<int>(verticalElements_.size());
+	if (count == 0 || end < start) {
+		return false;
+	}
+
+	if (start <= getStartStation() && end >= getEndStation() && bOrdered_) {
+		minimum = minimumHeight_;
+		maximum = maximumHeight_;
+		return true;
+	}
+
+	bool bFound = false;
+	for (int i = 0; i < count; i++) {
+		if (endStations_[i] < start || startStations_[i] > end) {
+			continue;
+		}
+
+		double elementMinimum = minimumHeights_[i], elementMaximum = maximumHeights_[i];
+		if (startStations_[i] < start || endStations_[i] > end) {
+			verticalElements_[i]->getHeightRange(start, end, elementMinimum, elementMaximum);
+		}
+
+		minimum = bFound ? std::min(minimum, elementMinimum) : elementMinimum;
+		maximum = bFound ? std::max(maximum, elementMaximum) : elementMaximum;
+		bFound = true;
+	}
+
+	return bFound;
+}
+
+std::vector<Stationing> VerticalAlignment2D::getTessellation(const Stationing start, const Stationing end, const double chordTolerance) const {
+	std::vector<Stationing> stations;
+	for (int i = 0; i < static_cast<int>(verticalElements_.size()); i++) {
+		if (endStations_[i] < start || startStations_[i] > end) {
+			continue;
+		}
+
+		stations.push_back(startStations_[i]);
+		verticalElements_[i]->getTessellation(chordTolerance, stations);
+		stations.push_back(endStations_[i]);
+	}
+
+	// Overlapping elements interleave, adjacent ones share their end and start station.
+	std::sort(stations.begin(), stations.end());
+	stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+	stations.erase(std::remove_if(stations.begin(), stations.end(), [&](const Stationing s) { return s < start || s > end; }), stations.end());
+	return stations;
+}
+
+int VerticalAlignment2D::getRevision() const {
+	return revision_;
 }
 
 Stationing VerticalAlignment2D::getEndStation() const {
@@ -64,6 +165,11 @@ int VerticalAlignment2D::getAlignmentElementCount() const {
 buw::Vector2d VerticalAlignment2D::getPosition(const Stationing station) const {
 	buw::ReferenceCounted<VerticalAlignmentElement2D> v = getAlignmentElementByStationing(station);
 
+	// The elements contain their start station only, the end of the last one belongs to it as well.
+	if (v == nullptr && hasElements() && station == getEndStation()) {
+		v = verticalElements_.back();
+	}
+
 	if (v == nullptr) {
 		return buw::Vector2d(station, 0);
 	}
@@ -71,6 +177,35 @@ buw::Vector2d VerticalAlignment2D::getPosition(const Stationing station) const {
 	return v->getPosition(station);
 }
 
+void VerticalAlignment2D::getHeights(const Stationing* stations, const int count, double* heights, double* gradients) const {
+	int index = -1;
+	for (int first = 0; first < count;) {
+		const int hint = index;
+		index = getAlignmentElementIndexByStationing(stations[first], hint);
+		if (index < 0 && hasElements() && stations[first] == getEndStation()) {
+			index = static_cast<int>(verticalElements_.size()) - 1;
+		}
+		if (index < 0) {
+			heights[first] = 0;
+			if (gradients)
+				gradients[first] = 0;
+			index = hint;
+			first++;
+			continue;
+		}
+
+		// Overlapping elements are searched for each station, the first one containing it wins.
+		int last = first + 1;
+		if (bOrdered_) {
+			while (last < count && stations[last] >= startStations_[index] && stations[last] < endStations_[index])
+				last++;
+		}
+
+		verticalElements_[index]->getHeights(stations + first, last - first, heights + first, gradients ? gradients + first : nullptr);
+		first = last;
+	}
+}
+
 bool VerticalAlignment2D::hasElements() const {
 	return verticalElements_.size() > 0;
 }
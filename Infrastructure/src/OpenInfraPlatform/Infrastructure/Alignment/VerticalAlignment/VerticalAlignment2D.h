@@ -26,15 +26,22 @@
 #include <BlueFramework/Core/memory.h>
 
 #include <boost/noncopyable.hpp>
+#include <atomic>
 #include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
 class BLUEINFRASTRUCTURE_API VerticalAlignment2D : boost::noncopyable {
 public:
+	VerticalAlignment2D();
+
 	//! Computes the 2d position in the horizontal alignment given a stationing.
 	buw::Vector2d getPosition(const Stationing station) const;
 
+	//! Heights of getPosition at 'count' stations and the gradients if the array is given, both are 0 where there is no element. The stations
+	//! that follow each other on one element are evaluated by a single call of the element.
+	void getHeights(const Stationing* stations, const int count, double* heights, double* gradients = nullptr) const;
+
 	int getAlignmentElementCount() const;
 
 	buw::ReferenceCounted<VerticalAlignmentElement2D> getAlignmentElementByIndex(int index);
@@ -47,10 +54,43 @@ public:
 
 	buw::ReferenceCounted<VerticalAlignmentElement2D> getAlignmentElementByStationing(const Stationing station) const;
 
+	//! Index of the first element with start station <= station < end station, or -1 if there is none. If the elements follow each other, the
+	//! element at 'hint' and its successor are tested first and the start stations are searched binary otherwise.
+	int getAlignmentElementIndexByStationing(const Stationing station, const int hint = -1) const;
+
 	bool hasElements() const;
 
+	//! Lowest and highest height of the elements between the stations, false if no element overlaps them. Elements inside of the range
+	//! use the heights cached by addElement, only the ones cut by the stations are evaluated.
+	bool getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const;
+
+	//! Start and end stations of the elements between the stations and the inner vertices of their getTessellation, ascending. These are the
+	//! breakpoints of the heights which a tessellation of the horizontal alignment has to include.
+	std::vector<Stationing> getTessellation(const Stationing start, const Stationing end, const double chordTolerance) const;
+
+	//! Incremented whenever an element is added, so tessellations cached by others can tell if they are outdated.
+	int getRevision() const;
+
 private:
 	std::vector<buw::ReferenceCounted<VerticalAlignmentElement2D>> verticalElements_; // the order of the elements is important here
+
+	// station ranges of the elements, updated by addElement
+	std::vector<Stationing> startStations_;
+	std::vector<Stationing> endStations_;
+
+	// height ranges of the elements and of all of them, updated by addElement
+	std::vector<double> minimumHeights_;
+	std::vector<double> maximumHeights_;
+	double minimumHeight_;
+	double maximumHeight_;
+
+	// true if the elements are sorted by station and do not overlap, so at most one contains a station
+	bool bOrdered_;
+
+	int revision_;
+
+	// element found by the last lookup, the hint for the next one
+	mutable std::atomic<int> lastElement_;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -16,11 +16,96 @@
 */
 
 #include "VerticalAlignmentElement2D.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 OpenInfraPlatform::Infrastructure::eVerticalAlignmentType OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2D::getAlignmentType() const {
 	return eVerticalAlignmentType::Unknown;
 }
 
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2D::getHeights(const Stationing* stations, const int count, double* heights, double* gradients) const {
+	const Stationing start = getStartStation();
+	const Stationing end = getEndStation();
+	const double delta = 1e-4 * (end - start);
+
+	for (int i = 0; i < count; i++) {
+		heights[i] = getPosition(stations[i]).y();
+		if (gradients) {
+			const Stationing s0 = std::max(stations[i] - delta, start);
+			const Stationing s1 = std::min(stations[i] + delta, end);
+			gradients[i] = s1 > s0 ? (getPosition(s1).y() - getPosition(s0).y()) / (s1 - s0) : 0.0;
+		}
+	}
+}
+
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2D::getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const {
+	Stationing stations[2] = { std::max(start, getStartStation()), std::min(end, getEndStation()) };
+	stations[1] = std::max(stations[0], stations[1]);
+
+	double heights[2], gradients[2];
+	getHeights(stations, 2, heights, gradients);
+	minimum = std::min(heights[0], heights[1]);
+	maximum = std::max(heights[0], heights[1]);
+
+	if (gradients[0] * gradients[1] >= 0.0)
+		return;
+
+	Stationing lo = stations[0], hi = stations[1];
+	for (int i = 0; i < 60 && hi - lo > 1e-9; i++) {
+		Stationing middle = 0.5 * (lo + hi);
+		double height, gradient;
+		getHeights(&middle, 1, &height, &gradient);
+		if ((gradient < 0.0) == (gradients[0] < 0.0))
+			lo = middle;
+		else
+			hi = middle;
+	}
+
+	Stationing apex = 0.5 * (lo + hi);
+	double height;
+	getHeights(&apex, 1, &height);
+	minimum = std::min(minimum, height);
+	maximum = std::max(maximum, height);
+}
+
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2D::getTessellation(const double chordTolerance, std::vector<Stationing>& stations) const {
+	const Stationing start = getStartStation();
+	const Stationing end = getEndStation();
+	if (!(end > start))
+		return;
+
+	// Four intervals at least, the midpoint of an element which changes its curvature may lie on the chord.
+	const int initialIntervals = 4;
+	const int maximumDepth = 20;
+
+	struct Interval {
+		Stationing a;
+		Stationing b;
+		int depth;
+	};
+
+	std::vector<Interval> stack;
+	for (int i = initialIntervals - 1; i >= 0; i--)
+		stack.push_back({ start + (end - start) * i / initialIntervals, i + 1 < initialIntervals ? start + (end - start) * (i + 1) / initialIntervals : end, 0 });
+
+	while (!stack.empty()) {
+		const Interval interval = stack.back();
+		stack.pop_back();
+
+		Stationing samples[3] = { interval.a, 0.5 * (interval.a + interval.b), interval.b };
+		double heights[3];
+		getHeights(samples, 3, heights);
+		if (std::abs(heights[1] - 0.5 * (heights[0] + heights[2])) > chordTolerance && interval.depth < maximumDepth) {
+			stack.push_back({ samples[1], interval.b, interval.depth + 1 });
+			stack.push_back({ interval.a, samples[1], interval.depth + 1 });
+		}
+		else if (interval.b < end) {
+			stations.push_back(interval.b);
+		}
+	}
+}
+
 bool OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2D::genericQuery(const int /*id*/, void* /*result*/) const {
 	return false;
 }
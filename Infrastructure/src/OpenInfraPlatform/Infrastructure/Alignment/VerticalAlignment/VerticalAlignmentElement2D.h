@@ -27,6 +27,7 @@
 #include <BlueFramework/Core/memory.h>
 #include <boost/noncopyable.hpp>
 #include <iostream>
+#include <vector>
 
 namespace OpenInfraPlatform {
 	namespace Infrastructure {
@@ -44,6 +45,19 @@ namespace OpenInfraPlatform {
 			*/
 			virtual buw::Vector2d getPosition(const Stationing station) const = 0;
 
+			//! Evaluates the heights at 'count' stations of the element and the gradients if the array is given. The default calls getPosition and
+			//! takes the gradient from the heights shortly before and after the station, elements with a closed form override it.
+			virtual void getHeights(const Stationing* stations, const int count, double* heights, double* gradients = nullptr) const;
+
+			//! Lowest and highest height of the element between the stations, which are clamped to the element. The default assumes a monotone
+			//! gradient and searches the point where it changes its sign by bisection, elements with a closed form override it.
+			virtual void getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const;
+
+			//! Appends the stations strictly between the start and end station, ascending, of a polyline through both ends whose heights deviate
+			//! from the element by at most 'chordTolerance'. The default bisects intervals while the height in their middle is further from the
+			//! chord, elements with a closed form override it.
+			virtual void getTessellation(const double chordTolerance, std::vector<Stationing>& stations) const;
+
 			//! Should return the same value as getPositon(getStartStation));
 			virtual buw::Vector2d getStartPosition() const = 0;
 
@@ -18,6 +18,8 @@
 #include "VerticalAlignmentElement2DArc.h"
 #include <BlueFramework/Core/assert.h>
 
+#include <algorithm>
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
 enum class eCircleIntersectionResult { NoIntersection, Coincident, TangentIntersection, TwoPointIntersection };
@@ -181,6 +183,41 @@ buw::Vector2d VerticalAlignmentElement2DArc::getPosition(const Stationing statio
 		return buw::Vector2d(station, b + sqrtTmp);
 }
 
+void VerticalAlignmentElement2DArc::getHeights(const Stationing* stations, const int count, double* heights, double* gradients) const {
+	// The center is the intersection of two circles, determine it once for all stations.
+	buw::Vector2d const center = getCenter();
+	const double a = center.x();
+	const double b = center.y();
+	const double sign = isConvex_ ? -1.0 : 1.0;
+
+	for (int i = 0; i < count; i++) {
+		const double dx = stations[i] - a;
+		const double sqrtTmp = std::sqrt(radius_ * radius_ - dx * dx);
+		heights[i] = b + sign * sqrtTmp;
+		if (gradients)
+			gradients[i] = -sign * dx / sqrtTmp;
+	}
+}
+
+void VerticalAlignmentElement2DArc::getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const {
+	Stationing stations[2] = { std::max(start, start_.x()), std::min(end, end_.x()) };
+	stations[1] = std::max(stations[0], stations[1]);
+
+	double heights[2];
+	getHeights(stations, 2, heights);
+	minimum = std::min(heights[0], heights[1]);
+	maximum = std::max(heights[0], heights[1]);
+
+	// The lowest point of a valley or highest point of a crest is directly below or above the center.
+	buw::Vector2d const center = getCenter();
+	if (center.x() > stations[0] && center.x() < stations[1]) {
+		if (isConvex_)
+			minimum = std::min(minimum, center.y() - radius_);
+		else
+			maximum = std::max(maximum, center.y() + radius_);
+	}
+}
+
 buw::Vector2d VerticalAlignmentElement2DArc::getStartPosition() const {
 	return start_;
 }
@@ -38,6 +38,11 @@ public:
 
 	virtual buw::Vector2d				getPosition(const Stationing station) const override;
 
+	virtual void						getHeights(const Stationing* stations, const int count, double* heights, double* gradients = nullptr) const override;
+
+	//! The heights at the stations and at the apex above or below the center if it lies between them.
+	virtual void						getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const override;
+
 	virtual buw::Vector2d				getStartPosition() const override;
 
 	virtual buw::Vector2d				getEndPosition() const override;
@@ -59,6 +59,17 @@ buw::Vector2d OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine:
 	return l.eval(station);
 }
 
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine::getHeights(const Stationing* stations, const int count, double* heights, double* gradients) const
+{
+	const double gradient = getGradient();
+	for (int i = 0; i < count; i++)
+	{
+		heights[i] = start_.y() + (stations[i] - start_.x()) * gradient;
+		if (gradients)
+			gradients[i] = gradient;
+	}
+}
+
 bool OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine::genericQuery(const int id, void* result) const 
 {
 	switch(id)
@@ -90,6 +101,11 @@ buw::Vector2d OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine:
 	return end_;
 }
 
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine::getTessellation(const double /*chordTolerance*/, std::vector<Stationing>& /*stations*/) const
+{
+
+}
+
 double OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DLine::getGradient() const
 {
 	double dy = end_.y() - start_.y();
@@ -38,6 +38,11 @@ public:
 
 	virtual buw::Vector2d					getPosition(const Stationing station) const override;
 
+	virtual void							getHeights(const Stationing* stations, const int count, double* heights, double* gradients = nullptr) const override;
+
+	//! Straight, so there are no inner vertices.
+	virtual void							getTessellation(const double chordTolerance, std::vector<Stationing>& stations) const override;
+
 	virtual buw::Vector2d					getStartPosition() const override;
 
 	virtual buw::Vector2d					getEndPosition() const override;
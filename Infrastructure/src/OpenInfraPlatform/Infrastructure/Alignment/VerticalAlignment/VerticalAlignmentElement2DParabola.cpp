@@ -18,6 +18,9 @@
 #include "VerticalAlignmentElement2DParabola.h"
 #include <BlueFramework/Core/assert.h>
 
+#include <algorithm>
+#include <cmath>
+
 OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::VerticalAlignmentElement2DParabola(const buw::Vector2d& start, const buw::Vector2d& end, const double startGradient, const double endGradient) :
 	start_(start),
 	end_(end),
@@ -48,6 +51,45 @@ buw::Vector2d OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParab
 	return buw::Vector2d(x, y);
 }
 
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::getHeights(const Stationing* stations, const int count, double* heights, double* gradients) const
+{
+	double a, b, c;
+	getParameters(a, b, c);
+
+	for (int i = 0; i < count; i++)
+	{
+		const double x = stations[i];
+		heights[i] = (a * x + b) * x + c;
+		if (gradients)
+			gradients[i] = 2.0 * a * x + b;
+	}
+}
+
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const
+{
+	double a, b, c;
+	getParameters(a, b, c);
+
+	const double x0 = std::max(start, start_.x());
+	const double x1 = std::max(x0, std::min(end, end_.x()));
+	const double y0 = (a * x0 + b) * x0 + c;
+	const double y1 = (a * x1 + b) * x1 + c;
+	minimum = std::min(y0, y1);
+	maximum = std::max(y0, y1);
+
+	// The gradient 2ax + b vanishes at the vertex.
+	if (a != 0.0)
+	{
+		const double x = -b / (2.0 * a);
+		if (x > x0 && x < x1)
+		{
+			const double y = (a * x + b) * x + c;
+			minimum = std::min(minimum, y);
+			maximum = std::max(maximum, y);
+		}
+	}
+}
+
 OpenInfraPlatform::Infrastructure::eVerticalAlignmentType 
 OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::getAlignmentType() const
 {
@@ -184,6 +226,20 @@ double OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::ge
 	return 2.0 * a * x + b;
 }
 
+void OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::getTessellation(const double chordTolerance, std::vector<Stationing>& stations) const
+{
+	double a, b, c;
+	getParameters(a, b, c);
+	if (a == 0.0 || !(chordTolerance > 0.0))
+		return;
+
+	const Stationing start = getStartStation();
+	const Stationing end = getEndStation();
+	const int intervals = static_cast<int>(std::ceil((end - start) / (2.0 * std::sqrt(chordTolerance / std::abs(a)))));
+	for (int i = 1; i < intervals; i++)
+		stations.push_back(start + (end - start) * i / intervals);
+}
+
 double OpenInfraPlatform::Infrastructure::VerticalAlignmentElement2DParabola::getCurvature() const
 {
 	double a, b, c;
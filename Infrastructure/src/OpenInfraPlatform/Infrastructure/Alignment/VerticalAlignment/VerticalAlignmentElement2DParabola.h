@@ -36,6 +36,14 @@ public:
 
 	virtual buw::Vector2d					getPosition(const Stationing station) const;
 
+	virtual void							getHeights(const Stationing* stations, const int count, double* heights, double* gradients = nullptr) const override;
+
+	//! The heights at the stations and at the vertex if it lies between them.
+	virtual void							getHeightRange(const Stationing start, const Stationing end, double& minimum, double& maximum) const override;
+
+	//! Equal steps of 2 sqrt(chordTolerance / |a|), the height of y = ax^2+bx+c deviates from a chord of length h by |a| h^2 / 4 in its middle.
+	virtual void							getTessellation(const double chordTolerance, std::vector<Stationing>& stations) const override;
+
 	buw::Vector2d							getStartPosition() const override;
 
 	buw::Vector2d							getEndPosition() const override;
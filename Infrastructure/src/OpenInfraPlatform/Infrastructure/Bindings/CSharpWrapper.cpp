@@ -65,7 +65,7 @@ extern "C"
 		{
 			auto aabb = alignmentModel->getExtends();
 
-			if (digitalElevationModel->getSurfaceCount() > 0)
+			if (digitalElevationModel->hasSurfaces())
 			{
 				minPos = buw::minimizedVector(minPos, aabb.getMinimum());
 				maxPos = buw::minimizedVector(maxPos, aabb.getMaximum());
@@ -113,12 +113,13 @@ extern "C"
 	
 	BLUEINFRASTRUCTURE_API int DigitalElevationModel_SurfaceCount(buw::DigitalElevationModel* d)
 	{
-		return d->getSurfaceCount();
+		return d->getSurfaceCount() + static_cast<int>(d->getRasterSurfaces().size());
 	}
 
+	// Raster surfaces follow the triangulated ones and are triangulated when they are requested.
 	BLUEINFRASTRUCTURE_API buw::Surface* DigitalElevationModel_GetSurface(buw::DigitalElevationModel* d, int index)
 	{
-		buw::ReferenceCounted<buw::Surface> surface = d->getSurface(index);
+		buw::ReferenceCounted<buw::Surface> surface = index < d->getSurfaceCount() ? d->getSurface(index) : d->getRasterSurfaces()[index - d->getSurfaceCount()]->createSurface();
 		buw::Surface *s = buw::Surface::createFlatCopy(*surface.get());
 
 		return s;
@@ -23,6 +23,9 @@
 #include <BlueFramework/Core/memory.h>
 #include <BlueFramework/Core/Math/vector.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 namespace OpenInfraPlatform
@@ -43,19 +46,15 @@ namespace OpenInfraPlatform
 			}
 
 			CatmullRomSpline3(const CatmullRomSpline3& source)
+				: vp(source.vp), delta_t(source.delta_t), lengths(source.lengths)
 			{
-				for (int i = 0; i < (int)source.vp.size(); i++)
-					vp.push_back(source.vp[i]);
-
-				delta_t = source.delta_t;
 			}
 
 			CatmullRomSpline3& operator= (const CatmullRomSpline3& source)
 			{
-				for (int i = 0; i < (int)source.vp.size(); i++)
-					vp.push_back(source.vp[i]);
-
+				vp = source.vp;
 				delta_t = source.delta_t;
+				lengths = source.lengths;
 
 				return *this;
 			}
@@ -69,6 +68,7 @@ namespace OpenInfraPlatform
 			{
 				vp.push_back(v);
 				delta_t = (ScalarType)1 / (ScalarType)(vp.size()-1);
+				UpdateLengths();
 			}
 
 			void AddSplinePoints(const std::vector<VectorType>& a)
@@ -78,6 +78,7 @@ namespace OpenInfraPlatform
 					vp.push_back(v);
 					delta_t = (ScalarType)1 / (ScalarType)(vp.size() - 1);
 				}
+				UpdateLengths();
 			}
 
 			VectorType GetInterpolatedSplinePoint(const ScalarType t) const  // t = 0...1; 0=vp[0] ... 1=vp[max]
@@ -107,22 +108,122 @@ namespace OpenInfraPlatform
 
 			ScalarType Length() const
 			{
-				ScalarType sum = 0;
+				return lengths.empty() ? 0 : lengths.back();
+			}
+
+			//! Axis aligned bounds of the spline, false if it has no points. Each coordinate of a segment is a cubic in the local parameter, so
+			//! besides the spline points only the roots of its quadratic derivative inside of the segment can be extremes.
+			bool GetExtends(VectorType& minimum, VectorType& maximum) const
+			{
+				if (vp.empty())
+					return false;
 
-				ScalarType delta = 0.01;
-				auto a = GetInterpolatedSplinePoint(0);
-				for (ScalarType t = delta; t < 1.0f; t+=delta)
+				minimum = maximum = vp[0];
+				for (int segment = 0; segment + 1 < (int)vp.size(); segment++)
 				{
-					auto b = GetInterpolatedSplinePoint(t);
+					int p0 = segment - 1;   fitBounds(p0);
+					int p3 = segment + 2;   fitBounds(p3);
+					const VectorType& v0 = vp[p0];
+					const VectorType& v1 = vp[segment];
+					const VectorType& v2 = vp[segment + 1];
+					const VectorType& v3 = vp[p3];
+
+					minimum = buw::minimizedVector(minimum, v2);
+					maximum = buw::maximizedVector(maximum, v2);
+
+					for (int axis = 0; axis < 3; axis++)
+					{
+						// Twice the derivative of Eq is 3 a t^2 + 2 b t + c.
+						const ScalarType a = -v0[axis] + 3 * v1[axis] - 3 * v2[axis] + v3[axis];
+						const ScalarType b = 2 * v0[axis] - 5 * v1[axis] + 4 * v2[axis] - v3[axis];
+						const ScalarType c = -v0[axis] + v2[axis];
+
+						ScalarType roots[2];
+						int rootCount = 0;
+						if (std::abs(a) <= std::numeric_limits<ScalarType>::epsilon() * (std::abs(b) + std::abs(c)))
+						{
+							if (b != 0)
+								roots[rootCount++] = -c / (2 * b);
+						}
+						else
+						{
+							const ScalarType discriminant = b * b - 3 * a * c;
+							if (discriminant >= 0)
+							{
+								roots[rootCount++] = (-b + std::sqrt(discriminant)) / (3 * a);
+								roots[rootCount++] = (-b - std::sqrt(discriminant)) / (3 * a);
+							}
+						}
+
+						for (int r = 0; r < rootCount; r++)
+						{
+							if (roots[r] > 0 && roots[r] < 1)
+							{
+								const ScalarType value = Eq(roots[r], v0, v1, v2, v3)[axis];
+								minimum[axis] = std::min(minimum[axis], value);
+								maximum[axis] = std::max(maximum[axis], value);
+							}
+						}
+					}
+				}
+				return true;
+			}
 
-					auto d = (a - b).norm();
+			//! Parameter t = 0...1 of GetInterpolatedSplinePoint at the arc length s from the first point, s is clamped to the spline.
+			ScalarType GetParameterAtLength(const ScalarType s) const
+			{
+				if (vp.size() < 2)
+					return 0;
 
-					sum += d;
+				int segment = 0;
+				ScalarType lt = 0;
+				FindParameter(s, 0, segment, lt);
+				return std::min((segment + lt) * delta_t, (ScalarType)1);
+			}
 
-					a = b;
-				}
+			//! Point at the arc length s from the first point.
+			VectorType GetSplinePointAtLength(const ScalarType s) const
+			{
+				VectorType point;
+				GetSplinePointsAtLengths(&s, 1, &point);
+				return point;
+			}
+
+			//! Unit tangent at the arc length s, zero where the spline does not move, e.g. between equal points.
+			VectorType GetSplineTangentAtLength(const ScalarType s) const
+			{
+				VectorType point, tangent;
+				GetSplinePointsAtLengths(&s, 1, &point, &tangent);
+				return tangent;
+			}
 
-				return sum;
+			//! Points and optionally tangents at 'count' arc lengths. Each one is looked up in the table of arc lengths by binary search, ascending
+			//! arc lengths continue with the interval of the previous one, and the parameter inside of the interval is refined by Newton's method.
+			void GetSplinePointsAtLengths(const ScalarType* s, const int count, VectorType* points, VectorType* tangents = nullptr) const
+			{
+				const VectorType zero = VectorType(0, 0, 0);
+				int node = 0;
+				for (int i = 0; i < count; i++)
+				{
+					if (vp.size() < 2)
+					{
+						points[i] = vp.empty() ? zero : vp[0];
+						if (tangents)
+							tangents[i] = zero;
+						continue;
+					}
+
+					int segment = 0;
+					ScalarType lt = 0;
+					node = FindParameter(s[i], node, segment, lt);
+					points[i] = SegmentPoint(segment, lt);
+					if (tangents)
+					{
+						const VectorType derivative = SegmentDerivative(segment, lt);
+						const ScalarType speed = derivative.norm();
+						tangents[i] = speed > 0 ? VectorType(derivative / speed) : zero;
+					}
+				}
 			}
 
 			// Static method for computing the Catmull-Rom parametric equation
@@ -144,7 +245,130 @@ namespace OpenInfraPlatform
 				return (p1*b1 + p2*b2 + p3*b3 + p4*b4); 
 			}
 
+			// Derivative of Eq with respect to t.
+			static VectorType EqDerivative(ScalarType t, 
+				const VectorType& p1, 
+				const VectorType& p2, 
+				const VectorType& p3, 
+				const VectorType& p4)
+			{
+				ScalarType t2 = t * t;
+
+				ScalarType b1 = .5 * (-3*t2 + 4*t - 1);
+				ScalarType b2 = .5 * ( 9*t2 - 10*t    );
+				ScalarType b3 = .5 * (-9*t2 + 8*t + 1);
+				ScalarType b4 = .5 * ( 3*t2 - 2*t     );
+
+				return (p1*b1 + p2*b2 + p3*b3 + p4*b4); 
+			}
+
 		private:
+			// Each segment between two spline points is split into this many intervals of the local parameter for the table of arc lengths.
+			static const int Subdivisions = 8;
+
+			VectorType SegmentPoint(const int segment, const ScalarType lt) const
+			{
+				int p0 = segment - 1;   fitBounds(p0);
+				int p3 = segment + 2;   fitBounds(p3);
+				return Eq(lt, vp[p0], vp[segment], vp[segment + 1], vp[p3]);
+			}
+
+			VectorType SegmentDerivative(const int segment, const ScalarType lt) const
+			{
+				int p0 = segment - 1;   fitBounds(p0);
+				int p3 = segment + 2;   fitBounds(p3);
+				return EqDerivative(lt, vp[p0], vp[segment], vp[segment + 1], vp[p3]);
+			}
+
+			// Arc length of the segment between the local parameters a and b by five point Gauss-Legendre quadrature of the speed.
+			ScalarType SegmentLength(const int segment, const ScalarType a, const ScalarType b) const
+			{
+				static const double nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+				static const double weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+				const ScalarType center = (a + b) / 2;
+				const ScalarType radius = (b - a) / 2;
+				ScalarType sum = 0;
+				for (int i = 0; i < 5; i++)
+					sum += (ScalarType)weights[i] * SegmentDerivative(segment, center + radius * (ScalarType)nodes[i]).norm();
+				return sum * radius;
+			}
+
+			// Adding a point changes the last segment, since its outer control point was clamped, and appends a new one. Only these are
+			// integrated again, so building a spline point by point stays linear.
+			void UpdateLengths()
+			{
+				const int segments = (int)vp.size() - 1;
+				if (segments < 1)
+				{
+					lengths.clear();
+					return;
+				}
+
+				const int first = std::max(0, std::min(((int)lengths.size() - 1) / Subdivisions - 1, segments - 1));
+				lengths.resize(first * Subdivisions + 1);
+				lengths[0] = 0;
+				for (int segment = first; segment < segments; segment++)
+				{
+					for (int k = 0; k < Subdivisions; k++)
+						lengths.push_back(lengths.back() + SegmentLength(segment, (ScalarType)k / Subdivisions, (ScalarType)(k + 1) / Subdivisions));
+				}
+			}
+
+			// Finds the segment and local parameter at the arc length s and returns the node of the table starting the interval, which is
+			// checked first for the next lookup.
+			int FindParameter(const ScalarType s, const int hint, int& segment, ScalarType& lt) const
+			{
+				const int last = (int)lengths.size() - 2;
+				const ScalarType length = std::min(std::max(s, (ScalarType)0), lengths.back());
+
+				// The last interval starting at or before the arc length, the hint and the interval after it are checked first.
+				int node = -1;
+				for (int k = hint; k <= std::min(hint + 1, last) && node < 0; k++)
+				{
+					if (lengths[k] <= length && (length < lengths[k + 1] || k == last))
+						node = k;
+				}
+				if (node < 0)
+					node = std::min(std::max((int)(std::upper_bound(lengths.begin(), lengths.end(), length) - lengths.begin()) - 1, 0), last);
+
+				segment = node / Subdivisions;
+				ScalarType lo = (ScalarType)(node % Subdivisions) / Subdivisions;
+				ScalarType hi = lo + (ScalarType)1 / Subdivisions;
+				const ScalarType start = lo;
+				const ScalarType target = length - lengths[node];
+				const ScalarType intervalLength = lengths[node + 1] - lengths[node];
+				if (!(intervalLength > 0))
+				{
+					lt = lo;
+					return node;
+				}
+
+				// Newton's method on the arc length from the start of the interval starting with linear interpolation, steps leaving the
+				// bracket are replaced by bisection.
+				const ScalarType tolerance = std::numeric_limits<ScalarType>::epsilon() * 16 * std::max(lengths.back(), (ScalarType)1);
+				lt = lo + (hi - lo) * target / intervalLength;
+				for (int iteration = 0; iteration < 20; iteration++)
+				{
+					const ScalarType error = SegmentLength(segment, start, lt) - target;
+					if (std::abs(error) <= tolerance)
+						break;
+
+					if (error > 0)
+						hi = lt;
+					else
+						lo = lt;
+
+					const ScalarType speed = SegmentDerivative(segment, lt).norm();
+					ScalarType next = speed > 0 ? lt - error / speed : lo - 1;
+					if (!(next > lo && next < hi))
+						next = (lo + hi) / 2;
+					lt = next;
+				}
+
+				return node;
+			}
+
 			void fitBounds(int& pp) const
 			{ 
 				if (pp < 0)
@@ -156,6 +380,9 @@ namespace OpenInfraPlatform
 		private:
 			std::vector<VectorType> vp;
 			ScalarType delta_t;
+
+			// Arc length from the first point to the start of each interval of Subdivisions per segment, plus the total length.
+			std::vector<ScalarType> lengths;
 		}; // end class CatmullRomSpline3f
 
 		typedef CatmullRomSpline3<float> CatmullRomSpline3f;
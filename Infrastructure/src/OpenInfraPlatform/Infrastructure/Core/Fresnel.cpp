@@ -0,0 +1,106 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Fresnel.h"
+
+#include <cmath>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	const double pi = 3.14159265358979323846;
+
+	// Coefficients of the Cephes fresnl routine, highest order first.
+	const double sn[6] = { -2.99181919401019853726E3, 7.08840045257738576863E5, -6.29741486205862506537E7, 2.54890880573376359104E9, -4.42979518059697779103E10, 3.18016297876567817986E11 };
+	const double sd[6] = { 2.81376268889994315696E2, 4.55847810806532581675E4, 5.17343888770096400730E6, 4.19320245898111231129E8, 2.24411795645340920940E10, 6.07366389490084639049E11 };
+
+	const double cn[6] = { -4.98843114573573548651E-8, 9.50428062829859605134E-6, -6.45191435683965050962E-4, 1.88843319396703850064E-2, -2.05525900955013891793E-1, 9.99999999999999998822E-1 };
+	const double cd[7] = { 3.99982968972495980367E-12, 9.15439215774657478799E-10, 1.25001862479598821474E-7, 1.22262789024179030997E-5, 8.68029542941784300606E-4, 4.12142090722199792936E-2, 1.00000000000000000118E0 };
+
+	const double fn[10] = { 4.21543555043677546506E-1, 1.43407919780758885261E-1, 1.15220955073585758835E-2, 3.45017939782574027900E-4, 4.63613749287867322088E-6,
+		3.05568983790257605827E-8, 1.02304514164907233465E-10, 1.72010743268161828879E-13, 1.34283276233062758925E-16, 3.76329711269987889006E-20 };
+	const double fd[10] = { 7.51586398353378947175E-1, 1.16888925859191382142E-1, 6.44051526508858611005E-3, 1.55934409164153020873E-4, 1.84627567348930545870E-6,
+		1.12699224763999035261E-8, 3.60140029589371370404E-11, 5.88754533621578410010E-14, 4.52001434074129701496E-17, 1.25443237090011264384E-20 };
+
+	const double gn[11] = { 5.04442073643383265887E-1, 1.97102833525523411709E-1, 1.87648584092575249293E-2, 6.84079380915393090172E-4, 1.15138826111884280931E-5,
+		9.82852443688422223854E-8, 4.45344415861750144738E-10, 1.08268041139020870318E-12, 1.37555460633261799868E-15, 8.36354435630677421531E-19, 1.86958710162783235106E-22 };
+	const double gd[11] = { 1.47495759925128324529E0, 3.37748989120019970451E-1, 2.53603741420338795122E-2, 8.14679107184306179049E-4, 1.27545075667729118702E-5,
+		1.04314589657571990585E-7, 4.60680728146520428211E-10, 1.10273215066240270757E-12, 1.38796531259578871258E-15, 8.39158816283118707363E-19, 1.86958710162783236342E-22 };
+
+	// Horner evaluation of the polynomial with the given coefficients.
+	template<int N>
+	double polynomial(const double x, const double (&coefficients)[N])
+	{
+		double result = coefficients[0];
+		for (int i = 1; i < N; i++)
+			result = result * x + coefficients[i];
+		return result;
+	}
+
+	// Same with an implicit leading coefficient of one.
+	template<int N>
+	double monicPolynomial(const double x, const double (&coefficients)[N])
+	{
+		double result = x + coefficients[0];
+		for (int i = 1; i < N; i++)
+			result = result * x + coefficients[i];
+		return result;
+	}
+}
+
+void computeFresnelIntegrals(const double x, double& C, double& S)
+{
+	const double ax = std::abs(x);
+	const double x2 = ax * ax;
+
+	if (x2 < 2.5)
+	{
+		const double t = x2 * x2;
+		S = ax * x2 * polynomial(t, sn) / monicPolynomial(t, sd);
+		C = ax * polynomial(t, cn) / polynomial(t, cd);
+	}
+	else if (ax > 36974.0)
+	{
+		// Limit of the Cephes routine, beyond it the phase pi/2 x^2 exceeds 2^31. The integrals still oscillate around 1/2, but by less than
+		// 1 / (pi |x|) < 8.7e-6, which is returned as 1/2. Clothoids of real alignments stay far below this argument.
+		C = 0.5;
+		S = 0.5;
+	}
+	else
+	{
+		// Asymptotic form C = 0.5 + f sin(pi/2 x^2) - g cos(pi/2 x^2) and S = 0.5 - f cos(pi/2 x^2) - g sin(pi/2 x^2).
+		const double t = pi * x2;
+		const double u = 1.0 / (t * t);
+		const double f = 1.0 - u * polynomial(u, fn) / monicPolynomial(u, fd);
+		const double g = polynomial(u, gn) / monicPolynomial(u, gd) / t;
+
+		const double c = std::cos(0.5 * t);
+		const double s = std::sin(0.5 * t);
+		const double r = pi * ax;
+		C = 0.5 + (f * s - g * c) / r;
+		S = 0.5 - (f * c + g * s) / r;
+	}
+
+	if (x < 0.0)
+	{
+		C = -C;
+		S = -S;
+	}
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
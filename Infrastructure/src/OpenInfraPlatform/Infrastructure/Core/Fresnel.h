@@ -0,0 +1,39 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_Fresnel_4f867ed6_0aac_489f_b178_10f241491d4c_h
+#define OpenInfraPlatform_Infrastructure_Fresnel_4f867ed6_0aac_489f_b178_10f241491d4c_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Normalized Fresnel integrals C(x) = integral of cos(pi/2 t^2) and S(x) = integral of sin(pi/2 t^2) from 0 to x. Uses the rational
+//! approximations of the Cephes library, a power series in x^4 below x^2 = 2.5 and the auxiliary functions f and g above, with a relative
+//! error of about 1e-15 over the whole range.
+BLUEINFRASTRUCTURE_API void computeFresnelIntegrals(const double x, double& C, double& S);
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::computeFresnelIntegrals;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_Fresnel_4f867ed6_0aac_489f_b178_10f241491d4c_h
@@ -19,6 +19,9 @@
 
 #include <BlueFramework/Core/Math/vector.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace OpenInfraPlatform
 {
 	namespace Infrastructure
@@ -38,20 +41,23 @@ namespace OpenInfraPlatform
 			{
 				points.push_back(p);
 				delta_t = (ScalarType)1 / (ScalarType)(points.size() - 1);
+				lengths.push_back(points.size() > 1 ? lengths.back() + (p - points[points.size() - 2]).norm() : 0);
+				minimum = points.size() > 1 ? buw::minimizedVector(minimum, p) : p;
+				maximum = points.size() > 1 ? buw::maximizedVector(maximum, p) : p;
 			}
 
 			void AddPoints(const std::vector<VectorType>& ps)
 			{
 				for (auto& p : ps)
 				{
-					points.push_back(p);
+					AddPoint(p);
 				}
-				delta_t = (ScalarType)1 / (ScalarType)(points.size() - 1);
 			}
 
+			//! t = 0...1 uniform over the points, i.e. each segment gets the same range of t regardless of its length.
 			VectorType Interpolate(const ScalarType t) const
 			{
-				int p0 = (int)(t / delta_t);
+				int p0 = std::min((int)(t / delta_t), (int)points.size() - 2);
 				int p1 = p0 + 1;
 
 				ScalarType lt = (t - delta_t * p0) / delta_t;
@@ -70,24 +76,88 @@ namespace OpenInfraPlatform
 
 			ScalarType Length() const
 			{
-				ScalarType sum = 0;
-				if (points.size() == 0)
-					return 0;
+				return lengths.empty() ? 0 : lengths.back();
+			}
+
+			//! Axis aligned bounds of the points, false if there are none.
+			bool GetExtends(VectorType& minimalPoint, VectorType& maximalPoint) const
+			{
+				if (points.empty())
+					return false;
+
+				minimalPoint = minimum;
+				maximalPoint = maximum;
+				return true;
+			}
+
+			//! Point at the arc length s from the first point, s is clamped to the polyline.
+			VectorType InterpolateAtLength(const ScalarType s) const
+			{
+				VectorType point;
+				InterpolateAtLengths(&s, 1, &point);
+				return point;
+			}
+
+			//! Unit direction of the segment at the arc length s, zero if the polyline has no length.
+			VectorType TangentAtLength(const ScalarType s) const
+			{
+				VectorType point, tangent;
+				InterpolateAtLengths(&s, 1, &point, &tangent);
+				return tangent;
+			}
 
-				VectorType last = points[0];
-				for (int i = 1; i < points.size(); i++)
+			//! Points and optionally tangents at 'count' arc lengths. The segment is looked up in the cumulative lengths by binary search,
+			//! ascending arc lengths continue with the segment of the previous one.
+			void InterpolateAtLengths(const ScalarType* s, const int count, VectorType* results, VectorType* tangents = nullptr) const
+			{
+				const VectorType zero = VectorType(0, 0, 0);
+				int segment = 0;
+				for (int i = 0; i < count; i++)
 				{
-					VectorType delta = points[i] - last;
-					sum += delta.norm();
-					last = points[i];
+					if (points.size() < 2)
+					{
+						results[i] = points.empty() ? zero : points[0];
+						if (tangents)
+							tangents[i] = zero;
+						continue;
+					}
+
+					const ScalarType length = std::min(std::max(s[i], (ScalarType)0), lengths.back());
+					segment = FindSegment(length, segment);
+
+					const ScalarType segmentLength = lengths[segment + 1] - lengths[segment];
+					const ScalarType lt = segmentLength > 0 ? (length - lengths[segment]) / segmentLength : 0;
+					results[i] = (points[segment + 1] - points[segment]) * lt + points[segment];
+					if (tangents)
+						tangents[i] = segmentLength > 0 ? VectorType((points[segment + 1] - points[segment]) / segmentLength) : zero;
 				}
+			}
 
-				return sum;
+		private:
+			// Index of the last segment starting at or before the arc length s, the hint and the segment after it are checked first.
+			int FindSegment(const ScalarType s, const int hint) const
+			{
+				const int last = (int)points.size() - 2;
+				for (int segment = hint; segment <= std::min(hint + 1, last); segment++)
+				{
+					if (lengths[segment] <= s && (s < lengths[segment + 1] || segment == last))
+						return segment;
+				}
+
+				const int segment = (int)(std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin()) - 1;
+				return std::min(std::max(segment, 0), last);
 			}
 
 		private:
 			std::vector<VectorType> points;
 			ScalarType delta_t;
+
+			// Arc length from the first point to each point.
+			std::vector<ScalarType> lengths;
+
+			// Bounds of the points, updated by AddPoint.
+			VectorType minimum;
+			VectorType maximum;
 		};
 
 		typedef Polyline<float> Polyline3f;
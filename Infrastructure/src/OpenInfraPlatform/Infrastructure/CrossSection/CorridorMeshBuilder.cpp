@@ -0,0 +1,342 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CorridorMeshBuilder.h"
+#include <algorithm>
+#include <numeric>
+#include <omp.h>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	std::vector<buw::ReferenceCounted<DesignCrossSectionProfile>> getDesignProfiles(CrossSectionStatic& crossSection, const bool bClosed)
+	{
+		std::vector<buw::ReferenceCounted<DesignCrossSectionProfile>> profiles;
+		const int count = bClosed ? crossSection.getClosedDesignCrossSectionProfileCount() : crossSection.getOpenDesignCrossSectionProfileCount();
+		for (int i = 0; i < count; i++)
+			profiles.push_back(bClosed ? crossSection.getClosedDesignCrossSectionProfile(i) : crossSection.getOpenDesignCrossSectionProfile(i));
+		return profiles;
+	}
+
+	// Twice the area enclosed by the profile, positive if it runs counter-clockwise in offset and height.
+	double getSignedArea(const DesignCrossSectionProfile& profile)
+	{
+		const auto& points = profile.crossSectionsPoints;
+		double area = 0.0;
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			const buw::Vector2d& a = points[i]->position;
+			const buw::Vector2d& b = points[(i + 1) % points.size()]->position;
+			area += a.x() * b.y() - b.x() * a.y();
+		}
+		return area;
+	}
+
+	// Appends the points of the profile placed at the position and normal of its cross section, returns the index of the first one.
+	int addDesignProfile(CorridorMesh& mesh, const DesignCrossSectionProfile& profile, const buw::Vector3d& position, const buw::Vector3d& normal, const double distance)
+	{
+		const int first = static_cast<int>(mesh.points.size());
+		for (const auto& point : profile.crossSectionsPoints)
+		{
+			mesh.points.push_back(position + point->position.x() * normal + buw::Vector3d(0.0, 0.0, point->position.y()));
+			mesh.textureCoordinates.push_back(buw::Vector2d(point->position.x(), distance));
+		}
+		return first;
+	}
+
+	// Ground profiles have absolute heights.
+	void addGroundProfiles(CorridorMesh& mesh, CrossSectionStatic& crossSection, const buw::Vector3d& position, const buw::Vector3d& normal, const double distance)
+	{
+		for (int i = 0; i < crossSection.getCrossSectionProfileCount(); i++)
+		{
+			const std::vector<buw::Vector2d>& points = crossSection.getCrossSectionProfile(i)->pntList2D;
+			const int first = static_cast<int>(mesh.points.size());
+			for (const buw::Vector2d& point : points)
+			{
+				mesh.points.push_back(buw::Vector3d(position.x() + point.x() * normal.x(), position.y() + point.x() * normal.y(), point.y()));
+				mesh.textureCoordinates.push_back(buw::Vector2d(point.x(), distance));
+			}
+			for (int p = first + 1; p < static_cast<int>(mesh.points.size()); p++)
+				mesh.groundEdges.push_back(buw::Vector2i(p - 1, p));
+		}
+	}
+}
+
+CorridorMeshBuilder::CorridorMeshBuilder(buw::ReferenceCounted<Alignment2DBased3D> alignment, const CorridorMeshDescription& desc /*= CorridorMeshDescription()*/) :
+	alignment_(alignment),
+	desc_(desc)
+{
+	update();
+}
+
+CorridorMeshBuilder::~CorridorMeshBuilder()
+{
+
+}
+
+int CorridorMeshBuilder::update()
+{
+	if (!isOutdated())
+		return 0;
+
+	readCrossSections();
+	meshes_.assign(positions_.size() > 1 ? positions_.size() - 1 : 0, CorridorMesh());
+
+	std::vector<int> indices(meshes_.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	buildMeshes(indices);
+	return static_cast<int>(indices.size());
+}
+
+int CorridorMeshBuilder::update(const Stationing start, const Stationing end)
+{
+	if (isOutdated())
+		return update();
+
+	std::vector<int> indices;
+	for (int i = 0; i < getMeshCount(); i++)
+	{
+		if (std::min(stations_[i], stations_[i + 1]) <= end && std::max(stations_[i], stations_[i + 1]) >= start)
+			indices.push_back(i);
+	}
+
+	buildMeshes(indices);
+	return static_cast<int>(indices.size());
+}
+
+int CorridorMeshBuilder::getMeshCount() const
+{
+	return static_cast<int>(meshes_.size());
+}
+
+const CorridorMesh& CorridorMeshBuilder::getMesh(const int index) const
+{
+	return meshes_[index];
+}
+
+CorridorMesh CorridorMeshBuilder::getMergedMesh() const
+{
+	CorridorMesh merged;
+	if (meshes_.empty())
+		return merged;
+
+	merged.startStation = meshes_.front().startStation;
+	merged.endStation = meshes_.back().endStation;
+	for (const CorridorMesh& mesh : meshes_)
+	{
+		const int offset = static_cast<int>(merged.points.size());
+		merged.points.insert(merged.points.end(), mesh.points.begin(), mesh.points.end());
+		merged.textureCoordinates.insert(merged.textureCoordinates.end(), mesh.textureCoordinates.begin(), mesh.textureCoordinates.end());
+		merged.surfaces.insert(merged.surfaces.end(), mesh.surfaces.begin(), mesh.surfaces.end());
+		for (const buw::Vector3i& triangle : mesh.triangles)
+			merged.triangles.push_back(triangle + buw::Vector3i(offset, offset, offset));
+		for (const buw::Vector2i& edge : mesh.longitudinalEdges)
+			merged.longitudinalEdges.push_back(edge + buw::Vector2i(offset, offset));
+		for (const buw::Vector2i& edge : mesh.profileEdges)
+			merged.profileEdges.push_back(edge + buw::Vector2i(offset, offset));
+		for (const buw::Vector2i& edge : mesh.groundEdges)
+			merged.groundEdges.push_back(edge + buw::Vector2i(offset, offset));
+	}
+	return merged;
+}
+
+buw::ReferenceCounted<Alignment2DBased3D> CorridorMeshBuilder::getAlignment() const
+{
+	return alignment_;
+}
+
+bool CorridorMeshBuilder::isOutdated() const
+{
+	buw::ReferenceCounted<HorizontalAlignment2D> ha = alignment_->getHorizontalAlignment();
+	buw::ReferenceCounted<VerticalAlignment2D> va = alignment_->getVerticalAlignment();
+	if (ha != horizontalAlignment_ || (ha ? ha->getRevision() : -1) != horizontalRevision_ || va != verticalAlignment_ || (va ? va->getRevision() : -1) != verticalRevision_)
+		return true;
+
+	if (alignment_->getCrossSectionCount() != static_cast<int>(crossSections_.size()))
+		return true;
+
+	for (int i = 0; i < static_cast<int>(crossSections_.size()); i++)
+	{
+		buw::ReferenceCounted<CrossSectionStatic> crossSection = alignment_->getCrossSection(i);
+		if (crossSection != crossSections_[i] || crossSection->stationing != stations_[i])
+			return true;
+	}
+
+	return false;
+}
+
+void CorridorMeshBuilder::readCrossSections()
+{
+	horizontalAlignment_ = alignment_->getHorizontalAlignment();
+	verticalAlignment_ = alignment_->getVerticalAlignment();
+	horizontalRevision_ = horizontalAlignment_ ? horizontalAlignment_->getRevision() : -1;
+	verticalRevision_ = verticalAlignment_ ? verticalAlignment_->getRevision() : -1;
+
+	crossSections_.clear();
+	stations_.clear();
+	for (int i = 0; i < alignment_->getCrossSectionCount(); i++)
+	{
+		crossSections_.push_back(alignment_->getCrossSection(i));
+		stations_.push_back(crossSections_.back()->stationing);
+	}
+
+	positions_.clear();
+	normals_.clear();
+	if (!horizontalAlignment_)
+		return;
+
+	// The positions are evaluated in ascending order, the cross sections need not be sorted.
+	const int count = static_cast<int>(stations_.size());
+	std::vector<int> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) { return stations_[a] < stations_[b]; });
+
+	std::vector<Stationing> sortedStations(count);
+	for (int i = 0; i < count; i++)
+		sortedStations[i] = stations_[order[i]];
+
+	std::vector<buw::Vector3d> sortedPositions(count), sortedNormals(count);
+	const int threads = desc_.threadCount > 0 ? desc_.threadCount : omp_get_max_threads();
+	alignment_->getPositions(sortedStations.data(), count, sortedPositions.data(), nullptr, sortedNormals.data(), threads);
+
+	positions_.resize(count);
+	normals_.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		positions_[order[i]] = sortedPositions[i];
+		normals_[order[i]] = sortedNormals[i];
+	}
+}
+
+void CorridorMeshBuilder::buildMeshes(const std::vector<int>& indices)
+{
+	const int threads = desc_.threadCount > 0 ? desc_.threadCount : omp_get_max_threads();
+	const int count = static_cast<int>(indices.size());
+	revision_++;
+
+#pragma omp parallel for schedule(dynamic, 16) num_threads(threads) if(threads > 1 && count > 1)
+	for (int i = 0; i < count; i++)
+	{
+		buildMesh(indices[i], meshes_[indices[i]]);
+		meshes_[indices[i]].revision = revision_;
+	}
+}
+
+void CorridorMeshBuilder::buildMesh(const int index, CorridorMesh& mesh) const
+{
+	mesh = CorridorMesh();
+	mesh.startStation = stations_[index];
+	mesh.endStation = stations_[index + 1];
+
+	CrossSectionStatic& start = *crossSections_[index];
+	CrossSectionStatic& end = *crossSections_[index + 1];
+	const double distance = mesh.endStation - mesh.startStation;
+	const bool bLast = index + 2 == static_cast<int>(crossSections_.size());
+
+	// Closed and open profiles are joined with the one at the same position in the list of the next cross section if both cross sections
+	// have as many of them and the two profiles have as many points.
+	for (const bool bClosed : { true, false })
+	{
+		const std::vector<buw::ReferenceCounted<DesignCrossSectionProfile>> startProfiles = getDesignProfiles(start, bClosed);
+		const std::vector<buw::ReferenceCounted<DesignCrossSectionProfile>> endProfiles = getDesignProfiles(end, bClosed);
+
+		for (size_t p = 0; p < std::max(startProfiles.size(), endProfiles.size()); p++)
+		{
+			const int startCount = p < startProfiles.size() ? static_cast<int>(startProfiles[p]->crossSectionsPoints.size()) : 0;
+			const int endCount = p < endProfiles.size() ? static_cast<int>(endProfiles[p]->crossSectionsPoints.size()) : 0;
+			const bool bJoined = startProfiles.size() == endProfiles.size() && startCount == endCount && startCount > 0;
+
+			int startFirst = -1, endFirst = -1;
+			if (p < startProfiles.size())
+			{
+				startFirst = addDesignProfile(mesh, *startProfiles[p], positions_[index], normals_[index], 0.0);
+				for (int k = 1; k < startCount; k++)
+					mesh.profileEdges.push_back(buw::Vector2i(startFirst + k - 1, startFirst + k));
+			}
+			if (p < endProfiles.size() && (bJoined || bLast))
+			{
+				endFirst = addDesignProfile(mesh, *endProfiles[p], positions_[index + 1], normals_[index + 1], distance);
+				for (int k = 1; bLast && k < endCount; k++)
+					mesh.profileEdges.push_back(buw::Vector2i(endFirst + k - 1, endFirst + k));
+			}
+
+			if (!bJoined)
+				continue;
+
+			const auto& startPoints = startProfiles[p]->crossSectionsPoints;
+			const auto& endPoints = endProfiles[p]->crossSectionsPoints;
+
+			// The triangles face to the right of a profile running from the left to the right, so they are turned for closed profiles
+			// running clockwise and for open ones running from the right to the left.
+			const bool bFlip = bClosed ? getSignedArea(*startProfiles[p]) < 0.0 : startPoints.front()->position.x() < startPoints.back()->position.x();
+			auto addTriangle = [&](const int a, const int b, const int c, const eCorridorSurface::Enum surface) {
+				mesh.triangles.push_back(bFlip ? buw::Vector3i(a, c, b) : buw::Vector3i(a, b, c));
+				mesh.surfaces.push_back(surface);
+			};
+			auto getOpenSurface = [](const double height) { return height < 0.0 ? eCorridorSurface::OpenBelow : eCorridorSurface::OpenAbove; };
+
+			bool bTopFace = false;
+			for (int k = 0; k < startCount; k++)
+			{
+				mesh.longitudinalEdges.push_back(buw::Vector2i(startFirst + k, endFirst + k));
+
+				// The top face of a closed profile starts at its point on the alignment.
+				if (bClosed && (startPoints[k]->position == buw::Vector2d(0.0, 0.0) || endPoints[k]->position == buw::Vector2d(0.0, 0.0)))
+					bTopFace = true;
+
+				if (k == 0 || (bClosed && !bTopFace))
+					continue;
+
+				const int s0 = startFirst + k - 1, s1 = startFirst + k;
+				const int e0 = endFirst + k - 1, e1 = endFirst + k;
+				if (bClosed)
+				{
+					addTriangle(s0, s1, e1, eCorridorSurface::Body);
+					addTriangle(s0, e1, e0, eCorridorSurface::Body);
+					continue;
+				}
+
+				// Split where the point crosses the height of the alignment, so that cut and fill meet there.
+				const double startHeight = startPoints[k]->position.y();
+				const double endHeight = endPoints[k]->position.y();
+				if (startHeight * endHeight < 0.0)
+				{
+					const double t = startHeight / (startHeight - endHeight);
+					const int c = static_cast<int>(mesh.points.size());
+					mesh.points.push_back(mesh.points[s1] + t * (mesh.points[e1] - mesh.points[s1]));
+					mesh.textureCoordinates.push_back(mesh.textureCoordinates[s1] + t * (mesh.textureCoordinates[e1] - mesh.textureCoordinates[s1]));
+
+					addTriangle(s0, s1, c, getOpenSurface(startHeight));
+					addTriangle(s0, c, e1, getOpenSurface(endHeight));
+					addTriangle(s0, e1, e0, getOpenSurface(endHeight));
+				}
+				else
+				{
+					addTriangle(s0, s1, e1, getOpenSurface(startHeight));
+					addTriangle(s0, e1, e0, getOpenSurface(startHeight));
+				}
+			}
+		}
+	}
+
+	addGroundProfiles(mesh, start, positions_[index], normals_[index], 0.0);
+	if (bLast)
+		addGroundProfiles(mesh, end, positions_[index + 1], normals_[index + 1], distance);
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
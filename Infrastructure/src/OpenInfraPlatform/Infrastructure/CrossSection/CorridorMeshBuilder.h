@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_CorridorMeshBuilder_01377773_41f6_46f3_a48f_1efe4919a154_h
+#define OpenInfraPlatform_Infrastructure_CorridorMeshBuilder_01377773_41f6_46f3_a48f_1efe4919a154_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CrossSectionStatic.h"
+#include <BlueFramework/Core/memory.h>
+#include <BlueFramework/Core/Math/vector.h>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Part of the road body a triangle of a corridor mesh belongs to.
+struct BLUEINFRASTRUCTURE_API eCorridorSurface
+{
+	enum Enum
+	{
+		//! Between closed design profiles, i.e. the pavement layers.
+		Body,
+
+		//! Between open design profiles above and below the height of the alignment, i.e. cut and fill slopes.
+		OpenAbove,
+		OpenBelow
+	};
+};
+
+struct CorridorMeshDescription
+{
+	//! Number of threads used to build the meshes, 0 uses all available.
+	int		threadCount = 0;
+};
+
+//! Road body between two consecutive cross sections of an alignment.
+struct CorridorMesh
+{
+	Stationing							startStation = 0.0;
+	Stationing							endStation = 0.0;
+
+	//! Increases each time the builder builds the mesh again, e.g. to upload only the meshes which changed.
+	int									revision = -1;
+
+	//! Points of the profiles at both cross sections, each of them once, and the ones where open faces are split.
+	std::vector<buw::Vector3d>			points;
+
+	//! Per point the offset to the left of the alignment and the distance from the start station along the alignment.
+	std::vector<buw::Vector2d>			textureCoordinates;
+
+	//! Two triangles between each two consecutive points of a design profile and the corresponding ones of the next cross section. Closed
+	//! profiles only have the ones from their point on the alignment on, which is their top face. Where a point of an open profile crosses the
+	//! height of the alignment, the face is split into three triangles at the crossing. They face out of closed profiles and up on open ones.
+	std::vector<buw::Vector3i>			triangles;
+
+	//! Per triangle the part of the road body.
+	std::vector<eCorridorSurface::Enum>	surfaces;
+
+	//! Lines along the alignment between corresponding points of the design profiles.
+	std::vector<buw::Vector2i>			longitudinalEdges;
+
+	//! Lines of the design profiles at the start station, the last mesh of an alignment also has the ones at its end station.
+	std::vector<buw::Vector2i>			profileEdges;
+
+	//! Lines of the ground profiles, whose heights are absolute, like the design profiles.
+	std::vector<buw::Vector2i>			groundEdges;
+};
+
+//! Sweeps the design cross section profiles along an alignment. Each profile point is placed at its offset along the horizontal normal and
+//! its height above the alignment, the positions and normals at the cross sections are evaluated in one batch. Profiles of consecutive cross
+//! sections with the same number of points are joined by triangles, each range between two cross sections is an indexed mesh of its own.
+//! The meshes are built in parallel and kept, so that only the ranges which changed need to be built again.
+class BLUEINFRASTRUCTURE_API CorridorMeshBuilder : boost::noncopyable
+{
+public:
+	//! Builds the meshes of all ranges between consecutive cross sections.
+	CorridorMeshBuilder(buw::ReferenceCounted<Alignment2DBased3D> alignment, const CorridorMeshDescription& desc = CorridorMeshDescription());
+
+	virtual ~CorridorMeshBuilder();
+
+	//! Builds all meshes again if the horizontal or vertical alignment or the cross sections were replaced, added or moved since the last
+	//! build. Returns the number of meshes built.
+	int								update();
+
+	//! As update, but also builds the meshes overlapping the range from 'start' to 'end' again, e.g. after their profiles were edited.
+	int								update(const Stationing start, const Stationing end);
+
+	//! Returns the number of ranges between consecutive cross sections.
+	int								getMeshCount() const;
+
+	const CorridorMesh&				getMesh(const int index) const;
+
+	//! All meshes in one, the indices refer to the merged points. Used by exports.
+	CorridorMesh					getMergedMesh() const;
+
+	buw::ReferenceCounted<Alignment2DBased3D>	getAlignment() const;
+
+private:
+	// Whether the cross sections or the alignments differ from the ones of the last build.
+	bool							isOutdated() const;
+
+	// Reads the cross sections and evaluates the alignment at their stations.
+	void							readCrossSections();
+
+	void							buildMeshes(const std::vector<int>& indices);
+
+	void							buildMesh(const int index, CorridorMesh& mesh) const;
+
+private:
+	buw::ReferenceCounted<Alignment2DBased3D>				alignment_;
+	CorridorMeshDescription									desc_;
+
+	// state of the last build
+	std::vector<buw::ReferenceCounted<CrossSectionStatic>>	crossSections_;
+	std::vector<Stationing>									stations_;
+	std::vector<buw::Vector3d>								positions_;
+	std::vector<buw::Vector3d>								normals_;
+	buw::ReferenceCounted<HorizontalAlignment2D>			horizontalAlignment_;
+	buw::ReferenceCounted<VerticalAlignment2D>				verticalAlignment_;
+	int														horizontalRevision_ = -1;
+	int														verticalRevision_ = -1;
+	int														revision_ = -1;
+
+	std::vector<CorridorMesh>								meshes_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::eCorridorSurface;
+	using OpenInfraPlatform::Infrastructure::CorridorMeshDescription;
+	using OpenInfraPlatform::Infrastructure::CorridorMesh;
+	using OpenInfraPlatform::Infrastructure::CorridorMeshBuilder;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_CorridorMeshBuilder_01377773_41f6_46f3_a48f_1efe4919a154_h
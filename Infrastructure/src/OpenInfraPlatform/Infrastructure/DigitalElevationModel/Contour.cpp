@@ -0,0 +1,367 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Contour.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <omp.h>
+#include <unordered_map>
+#include <utility>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	//! Part of a contour within one triangle, from the crossing on edge 'from' to the crossing on edge 'to'. Edges are keyed by their two point
+	//! indices, the smaller one in the upper half.
+	struct ContourSegment
+	{
+		int				level;
+		std::uint64_t	from;
+		std::uint64_t	to;
+	};
+
+	std::uint64_t edgeKey(const int a, const int b)
+	{
+		const std::uint32_t lo = static_cast<std::uint32_t>(std::min(a, b));
+		const std::uint32_t hi = static_cast<std::uint32_t>(std::max(a, b));
+		return (static_cast<std::uint64_t>(lo) << 32) | hi;
+	}
+
+	class SurfaceMesh
+	{
+	public:
+		explicit SurfaceMesh(const Surface& surface)
+			: points_(surface.getPoints()), triangles_(surface.getTriangeFaces())
+		{
+		}
+
+		int getTriangleCount() const
+		{
+			return static_cast<int>(triangles_.size());
+		}
+
+		bool getTriangle(const int i, int* v) const
+		{
+			v[0] = triangles_[i].x();
+			v[1] = triangles_[i].y();
+			v[2] = triangles_[i].z();
+			return true;
+		}
+
+		buw::Vector2d getPosition(const int v) const
+		{
+			return points_[v].block<2, 1>(0, 0);
+		}
+
+		double getHeight(const int v) const
+		{
+			return points_[v].z();
+		}
+
+	private:
+		const std::vector<buw::Vector3d>& points_;
+		const std::vector<buw::Vector3i>& triangles_;
+	};
+
+	//! Each cell of the raster consists of two triangles with the diagonal of RasterSurface::createSurface.
+	class RasterMesh
+	{
+	public:
+		explicit RasterMesh(const RasterSurface& raster)
+			: raster_(raster)
+		{
+		}
+
+		int getTriangleCount() const
+		{
+			if (raster_.getWidth() < 2 || raster_.getHeight() < 2)
+				return 0;
+			return 2 * (raster_.getWidth() - 1) * (raster_.getHeight() - 1);
+		}
+
+		bool getTriangle(const int i, int* v) const
+		{
+			const int cell = i / 2;
+			const int x = cell % (raster_.getWidth() - 1);
+			const int y = cell / (raster_.getWidth() - 1);
+			if (raster_.isNoData(x, y) || raster_.isNoData(x + 1, y) || raster_.isNoData(x, y + 1) || raster_.isNoData(x + 1, y + 1))
+				return false;
+
+			const int a = x + y * raster_.getWidth();
+			const int b = x + (y + 1) * raster_.getWidth();
+			const int c = (x + 1) + y * raster_.getWidth();
+			const int d = (x + 1) + (y + 1) * raster_.getWidth();
+			if (i % 2 == 0)
+			{
+				v[0] = a; v[1] = b; v[2] = c;
+			}
+			else
+			{
+				v[0] = c; v[1] = b; v[2] = d;
+			}
+			return true;
+		}
+
+		buw::Vector2d getPosition(const int v) const
+		{
+			return raster_.getOrigin() + buw::Vector2d(v % raster_.getWidth(), v / raster_.getWidth()) * raster_.getCellSize();
+		}
+
+		double getHeight(const int v) const
+		{
+			return raster_.getHeight(v % raster_.getWidth(), v / raster_.getWidth());
+		}
+
+	private:
+		const RasterSurface& raster_;
+	};
+
+	template<typename Mesh> buw::Vector2d edgeCrossing(const Mesh& mesh, const std::uint64_t key, const double level)
+	{
+		const int a = static_cast<int>(key >> 32);
+		const int b = static_cast<int>(key & 0xffffffffu);
+		const double za = mesh.getHeight(a);
+		const double zb = mesh.getHeight(b);
+
+		// Both triangles of the edge compute the crossing from the same end, so it is the same point. Vertices at the level are returned exactly.
+		const double t = (level - za) / (zb - za);
+		if (t <= 0.0)
+			return mesh.getPosition(a);
+		if (t >= 1.0)
+			return mesh.getPosition(b);
+		return mesh.getPosition(a) + t * (mesh.getPosition(b) - mesh.getPosition(a));
+	}
+
+	void removeDuplicatePoints(ContourLine& line)
+	{
+		std::vector<buw::Vector2d>& points = line.points;
+		points.erase(std::unique(points.begin(), points.end()), points.end());
+		if (line.closed && points.size() > 1 && points.front() == points.back())
+			points.pop_back();
+	}
+
+	//! Chaikin's corner cutting replaces each segment by its points at 1/4 and 3/4.
+	void smoothContour(ContourLine& line, const int iterations)
+	{
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			const std::vector<buw::Vector2d>& points = line.points;
+			const int n = static_cast<int>(points.size());
+			const int segmentCount = line.closed ? n : n - 1;
+
+			std::vector<buw::Vector2d> smoothed;
+			smoothed.reserve(2 * n);
+			if (!line.closed)
+				smoothed.push_back(points.front());
+
+			for (int i = 0; i < segmentCount; i++)
+			{
+				const buw::Vector2d& a = points[i];
+				const buw::Vector2d& b = points[(i + 1) % n];
+				smoothed.push_back(0.75 * a + 0.25 * b);
+				smoothed.push_back(0.25 * a + 0.75 * b);
+			}
+
+			if (!line.closed)
+				smoothed.push_back(points.back());
+			line.points.swap(smoothed);
+		}
+	}
+
+	//! Joins the segments of one level into polylines. Each edge is crossed by at most two segments, one leaving and one entering it.
+	template<typename Mesh> void joinSegments(const Mesh& mesh, const ContourSegment* segments, const int count, const double height, const bool major, const int smoothingIterations, std::vector<ContourLine>& contours)
+	{
+		std::unordered_map<std::uint64_t, int> byFrom;
+		byFrom.reserve(count);
+		for (int i = 0; i < count; i++)
+			byFrom.insert(std::make_pair(segments[i].from, i));
+
+		std::vector<char> hasPredecessor(count, 0);
+		for (int i = 0; i < count; i++)
+		{
+			auto it = byFrom.find(segments[i].to);
+			if (it != byFrom.end())
+				hasPredecessor[it->second] = 1;
+		}
+
+		std::vector<char> visited(count, 0);
+		auto trace = [&](const int first)
+		{
+			ContourLine line;
+			line.height = height;
+			line.major = major;
+			line.points.push_back(edgeCrossing(mesh, segments[first].from, height));
+
+			int i = first;
+			while (i >= 0 && !visited[i])
+			{
+				visited[i] = 1;
+				line.points.push_back(edgeCrossing(mesh, segments[i].to, height));
+
+				auto it = byFrom.find(segments[i].to);
+				i = it != byFrom.end() ? it->second : -1;
+			}
+
+			line.closed = i == first;
+			if (line.closed)
+				line.points.pop_back();
+
+			// Contours through a single point, e.g. a peak exactly at the level, collapse here.
+			removeDuplicatePoints(line);
+			if (line.points.size() < (line.closed ? 3u : 2u))
+				return;
+
+			smoothContour(line, smoothingIterations);
+			contours.push_back(std::move(line));
+		};
+
+		// Open contours start at the border of the surface, the remaining segments form closed contours.
+		for (int i = 0; i < count; i++)
+		{
+			if (!hasPredecessor[i] && !visited[i])
+				trace(i);
+		}
+		for (int i = 0; i < count; i++)
+		{
+			if (!visited[i])
+				trace(i);
+		}
+	}
+
+	template<typename Mesh> std::vector<ContourLine> extractContours(const Mesh& mesh, const ContourDescription& desc)
+	{
+		std::vector<ContourLine> contours;
+		if (!(desc.interval > 0.0))
+			return contours;
+
+		const int threadCount = desc.threadCount > 0 ? desc.threadCount : omp_get_max_threads();
+		const int triangleCount = mesh.getTriangleCount();
+
+		std::vector<std::vector<ContourSegment>> threadSegments(threadCount);
+		std::vector<int> threadMinLevel(threadCount, INT_MAX);
+		std::vector<int> threadMaxLevel(threadCount, INT_MIN);
+
+#pragma omp parallel num_threads(threadCount)
+		{
+			const int thread = omp_get_thread_num();
+			std::vector<ContourSegment>& segments = threadSegments[thread];
+
+#pragma omp for schedule(static, 4096)
+			for (int i = 0; i < triangleCount; i++)
+			{
+				int v[3];
+				if (!mesh.getTriangle(i, v))
+					continue;
+
+				// Orient the triangle counterclockwise, triangles without area in the plane have no direction and are left out.
+				const buw::Vector2d p0 = mesh.getPosition(v[0]);
+				const buw::Vector2d p1 = mesh.getPosition(v[1]);
+				const buw::Vector2d p2 = mesh.getPosition(v[2]);
+				const double area = (p1.x() - p0.x()) * (p2.y() - p0.y()) - (p1.y() - p0.y()) * (p2.x() - p0.x());
+				if (area == 0.0)
+					continue;
+				if (area < 0.0)
+					std::swap(v[1], v[2]);
+
+				const double z[3] = { mesh.getHeight(v[0]), mesh.getHeight(v[1]), mesh.getHeight(v[2]) };
+				const double zMin = std::min(z[0], std::min(z[1], z[2]));
+				const double zMax = std::max(z[0], std::max(z[1], z[2]));
+
+				const int first = static_cast<int>(std::floor((zMin - desc.baseHeight) / desc.interval));
+				const int last = static_cast<int>(std::ceil((zMax - desc.baseHeight) / desc.interval));
+				for (int k = first; k <= last; k++)
+				{
+					const double level = desc.baseHeight + k * desc.interval;
+					if (!(zMin < level && level <= zMax))
+						continue;
+
+					// Walking from the edge going down to the edge going up keeps the higher terrain on the left.
+					ContourSegment segment;
+					segment.level = k;
+					for (int j = 0; j < 3; j++)
+					{
+						const bool above = z[j] >= level;
+						const bool nextAbove = z[(j + 1) % 3] >= level;
+						if (above && !nextAbove)
+							segment.from = edgeKey(v[j], v[(j + 1) % 3]);
+						else if (!above && nextAbove)
+							segment.to = edgeKey(v[j], v[(j + 1) % 3]);
+					}
+					segments.push_back(segment);
+
+					threadMinLevel[thread] = std::min(threadMinLevel[thread], k);
+					threadMaxLevel[thread] = std::max(threadMaxLevel[thread], k);
+				}
+			}
+		}
+
+		const int minLevel = *std::min_element(threadMinLevel.begin(), threadMinLevel.end());
+		const int maxLevel = *std::max_element(threadMaxLevel.begin(), threadMaxLevel.end());
+		if (minLevel > maxLevel)
+			return contours;
+
+		// Sort the segments by level, keeping the order of the triangles within a level.
+		const int levelCount = maxLevel - minLevel + 1;
+		std::vector<int> levelStart(levelCount + 1, 0);
+		for (const auto& segments : threadSegments)
+		{
+			for (const auto& segment : segments)
+				levelStart[segment.level - minLevel + 1]++;
+		}
+		for (int k = 0; k < levelCount; k++)
+			levelStart[k + 1] += levelStart[k];
+
+		std::vector<ContourSegment> ordered(levelStart[levelCount]);
+		std::vector<int> fill(levelStart.begin(), levelStart.end() - 1);
+		for (auto& segments : threadSegments)
+		{
+			for (const auto& segment : segments)
+				ordered[fill[segment.level - minLevel]++] = segment;
+			std::vector<ContourSegment>().swap(segments);
+		}
+
+		std::vector<std::vector<ContourLine>> levelContours(levelCount);
+
+#pragma omp parallel for num_threads(threadCount) schedule(dynamic)
+		for (int k = 0; k < levelCount; k++)
+		{
+			const int level = minLevel + k;
+			const bool major = desc.majorEvery > 0 && level % desc.majorEvery == 0;
+			joinSegments(mesh, ordered.data() + levelStart[k], levelStart[k + 1] - levelStart[k], desc.baseHeight + level * desc.interval, major, desc.smoothingIterations, levelContours[k]);
+		}
+
+		for (auto& lines : levelContours)
+			std::move(lines.begin(), lines.end(), std::back_inserter(contours));
+		return contours;
+	}
+}
+
+std::vector<ContourLine> createContours(const Surface& surface, const ContourDescription& desc)
+{
+	return extractContours(SurfaceMesh(surface), desc);
+}
+
+std::vector<ContourLine> createContours(const RasterSurface& surface, const ContourDescription& desc)
+{
+	return extractContours(RasterMesh(surface), desc);
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -0,0 +1,77 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_Contour_5d2b8e14_c7a3_4f06_9b1e_3a8c6f2d7e45_h
+#define OpenInfraPlatform_Infrastructure_Contour_5d2b8e14_c7a3_4f06_9b1e_3a8c6f2d7e45_h
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+struct ContourDescription
+{
+	//! Height difference between two contours, the contours are at baseHeight + k * interval.
+	double	interval = 1.0;
+	double	baseHeight = 0.0;
+
+	//! Every 'majorEvery'-th contour counted from the base height is a major contour, 0 marks none.
+	int		majorEvery = 5;
+
+	//! Number of corner cutting iterations, each one doubles the number of points. The ends of open contours are kept.
+	int		smoothingIterations = 0;
+
+	//! Number of threads, 0 uses all available.
+	int		threadCount = 0;
+};
+
+struct ContourLine
+{
+	double						height = 0.0;
+	bool						major = false;
+
+	//! Closed contours do not repeat the first point at the end.
+	bool						closed = false;
+
+	//! The higher terrain is on the left side in the direction of the points.
+	std::vector<buw::Vector2d>	points;
+};
+
+//! Extracts the contours of the surface by marching triangles. The triangles are intersected with the levels in parallel, the segments of each
+//! level are then joined into polylines by the edges they cross. Vertices exactly at a level count as above it.
+BLUEINFRASTRUCTURE_API std::vector<ContourLine> createContours(const Surface& surface, const ContourDescription& desc = ContourDescription());
+
+//! Extracts the contours of the raster, each cell is split into the two triangles of RasterSurface::createSurface. Cells with a sample without
+//! data are left out.
+BLUEINFRASTRUCTURE_API std::vector<ContourLine> createContours(const RasterSurface& surface, const ContourDescription& desc = ContourDescription());
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::ContourDescription;
+	using OpenInfraPlatform::Infrastructure::ContourLine;
+	using OpenInfraPlatform::Infrastructure::createContours;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_Contour_5d2b8e14_c7a3_4f06_9b1e_3a8c6f2d7e45_h
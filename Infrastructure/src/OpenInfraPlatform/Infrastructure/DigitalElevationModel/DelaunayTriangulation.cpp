@@ -0,0 +1,663 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DelaunayTriangulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <utility>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	// Position of the cell (x, y) along a Hilbert curve through a grid of 65536 x 65536 cells.
+	std::uint32_t hilbertIndex(std::uint32_t x, std::uint32_t y)
+	{
+		const std::uint32_t n = 1u << 16;
+		std::uint32_t d = 0;
+		for (std::uint32_t s = n / 2; s > 0; s /= 2)
+		{
+			const std::uint32_t rx = (x & s) > 0 ? 1 : 0;
+			const std::uint32_t ry = (y & s) > 0 ? 1 : 0;
+			d += s * s * ((3 * rx) ^ ry);
+			if (ry == 0)
+			{
+				if (rx == 1)
+				{
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return d;
+	}
+
+	// Deterministic pseudo random bits for distributing the points to the insertion rounds.
+	std::uint64_t mixBits(std::uint64_t x)
+	{
+		x += 0x9e3779b97f4a7c15ull;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+}
+
+DelaunayTriangulation::DelaunayTriangulation(const std::vector<buw::Vector3d>& points, const std::vector<std::vector<buw::Vector3d>>& breakLines) :
+	points_(points),
+	superVertex_(0),
+	skippedSegments_(0)
+{
+	for (const std::vector<buw::Vector3d>& breakLine : breakLines)
+		points_.insert(points_.end(), breakLine.begin(), breakLine.end());
+
+	const int count = static_cast<int>(points_.size());
+	if (count < 3)
+		return;
+
+	buw::Vector2d boundsMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	buw::Vector2d boundsMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+	for (const buw::Vector3d& p : points_)
+	{
+		boundsMin = boundsMin.cwiseMin(p.block<2, 1>(0, 0));
+		boundsMax = boundsMax.cwiseMax(p.block<2, 1>(0, 0));
+	}
+
+	// Work relative to the lower left corner to keep the precision of the predicates for georeferenced coordinates.
+	positions_.resize(count + 3);
+#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+		positions_[i] = points_[i].block<2, 1>(0, 0) - boundsMin;
+
+	// The enclosing triangle only has to contain the points, inCircle treats its vertices as if they were infinitely far away. So the triangles
+	// connected to it are exactly the ones outside of the convex hull.
+	const double size = std::max(std::max(boundsMax.x() - boundsMin.x(), boundsMax.y() - boundsMin.y()), 1.0);
+	const double distance = 100.0 * size;
+	superVertex_ = count;
+	positions_[count] = buw::Vector2d(-distance, -distance);
+	positions_[count + 1] = buw::Vector2d(3.0 * distance, -distance);
+	positions_[count + 2] = buw::Vector2d(-distance, 3.0 * distance);
+
+	vertexTriangle_.assign(count + 3, -1);
+	triangles_.reserve(2 * static_cast<size_t>(count) + 8);
+	triangles_.resize(1);
+	setTriangle(0, count, count + 1, count + 2, -1, -1, -1, 0);
+
+	// Duplicate points are mapped to the vertex they coincide with.
+	std::vector<int> vertices(count, -1);
+	int hint = 0;
+	for (int i : getInsertionOrder(count, size))
+		vertices[i] = insertPoint(i, hint);
+
+	size_t offset = points.size();
+	for (const std::vector<buw::Vector3d>& breakLine : breakLines)
+	{
+		for (size_t i = 1; i < breakLine.size(); i++)
+			insertSegment(vertices[offset + i - 1], vertices[offset + i], 0);
+		offset += breakLine.size();
+	}
+}
+
+const std::vector<buw::Vector3d>& DelaunayTriangulation::getPoints() const
+{
+	return points_;
+}
+
+std::vector<buw::Vector3i> DelaunayTriangulation::getTriangles() const
+{
+	std::vector<buw::Vector3i> triangles;
+	triangles.reserve(triangles_.size());
+	for (const Triangle& t : triangles_)
+	{
+		if (t.v[0] < superVertex_ && t.v[1] < superVertex_ && t.v[2] < superVertex_)
+			triangles.push_back(buw::Vector3i(t.v[0], t.v[1], t.v[2]));
+	}
+	return triangles;
+}
+
+int DelaunayTriangulation::getSkippedBreakLineSegmentCount() const
+{
+	return skippedSegments_;
+}
+
+std::vector<int> DelaunayTriangulation::getInsertionOrder(const int count, const double size) const
+{
+	// Round r holds about half as many points as round r + 1, which keeps the triangulation well shaped while it grows. Within a round the
+	// points follow a Hilbert curve, so consecutive points are close to each other.
+	int rounds = 1;
+	while (rounds < 24 && (count >> rounds) > 64)
+		rounds++;
+
+	const double scale = 65535.0 / size;
+	std::vector<int> round(count);
+	std::vector<std::uint32_t> key(count);
+#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+	{
+		const std::uint64_t bits = mixBits(static_cast<std::uint64_t>(i));
+		int level = 0;
+		while (level < rounds - 1 && (bits & (1ull << level)))
+			level++;
+		round[i] = rounds - 1 - level;
+
+		const std::uint32_t x = static_cast<std::uint32_t>(std::min(positions_[i].x() * scale, 65535.0));
+		const std::uint32_t y = static_cast<std::uint32_t>(std::min(positions_[i].y() * scale, 65535.0));
+		key[i] = hilbertIndex(x, y);
+	}
+
+	std::vector<int> roundStart(rounds + 1, 0);
+	for (int i = 0; i < count; i++)
+		roundStart[round[i] + 1]++;
+	for (int r = 0; r < rounds; r++)
+		roundStart[r + 1] += roundStart[r];
+
+	std::vector<std::pair<std::uint32_t, int>> sorted(count);
+	std::vector<int> next(roundStart.begin(), roundStart.end() - 1);
+	for (int i = 0; i < count; i++)
+		sorted[next[round[i]]++] = std::make_pair(key[i], i);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int r = 0; r < rounds; r++)
+		std::sort(sorted.begin() + roundStart[r], sorted.begin() + roundStart[r + 1]);
+
+	std::vector<int> order(count);
+	for (int i = 0; i < count; i++)
+		order[i] = sorted[i].second;
+	return order;
+}
+
+int DelaunayTriangulation::insertPoint(const int vertex, int& hint)
+{
+	int edge = -1;
+	int existing = -1;
+	const int t = locate(positions_[vertex], hint, edge, existing);
+	if (t < 0)
+		return -1;
+
+	hint = t;
+	if (existing >= 0)
+		return existing;
+
+	if (edge >= 0)
+		splitEdge(t, edge, vertex);
+	else
+		splitTriangle(t, vertex);
+
+	legalize(vertex);
+	hint = vertexTriangle_[vertex];
+	return vertex;
+}
+
+int DelaunayTriangulation::locate(const buw::Vector2d& p, int hint, int& o_edge, int& o_vertex) const
+{
+	// Returns false if 'p' lies outside of 't', otherwise sets the edge or vertex 'p' lies on.
+	auto classify = [&](const int t) -> bool
+	{
+		const Triangle& tri = triangles_[t];
+		int edge = -1;
+		for (int k = 0; k < 3; k++)
+		{
+			const double o = orient(tri.v[(k + 1) % 3], tri.v[(k + 2) % 3], p);
+			if (o < 0)
+				return false;
+			if (o == 0)
+				edge = k;
+		}
+
+		o_edge = edge;
+		o_vertex = -1;
+		for (int k = 0; k < 3; k++)
+		{
+			if (positions_[tri.v[k]] == p)
+				o_vertex = tri.v[k];
+		}
+		return true;
+	};
+
+	// Walk towards 'p', starting at a different edge in each step so the walk cannot run in circles because of rounding.
+	int t = hint;
+	const size_t maxSteps = triangles_.size() + 16;
+	for (size_t step = 0; step < maxSteps && t >= 0; step++)
+	{
+		const Triangle& tri = triangles_[t];
+		int next = t;
+		for (int k = 0; k < 3 && next == t; k++)
+		{
+			const int e = static_cast<int>((k + step) % 3);
+			if (orient(tri.v[(e + 1) % 3], tri.v[(e + 2) % 3], p) < 0)
+				next = tri.n[e];
+		}
+
+		if (next == t)
+			return classify(t) ? t : -1;
+		t = next;
+	}
+
+	for (int i = 0; i < static_cast<int>(triangles_.size()); i++)
+	{
+		if (classify(i))
+			return i;
+	}
+	return -1;
+}
+
+void DelaunayTriangulation::splitTriangle(const int t, const int vertex)
+{
+	const Triangle old = triangles_[t];
+	const int t2 = static_cast<int>(triangles_.size());
+	const int t3 = t2 + 1;
+	triangles_.resize(triangles_.size() + 2);
+
+	const int a = old.v[0], b = old.v[1], c = old.v[2];
+	setTriangle(t, a, b, vertex, t2, t3, old.n[2], old.constrained & 4);
+	setTriangle(t2, b, c, vertex, t3, t, old.n[0], (old.constrained & 1) << 2);
+	setTriangle(t3, c, a, vertex, t, t2, old.n[1], (old.constrained & 2) << 1);
+	replaceNeighbour(old.n[0], t, t2);
+	replaceNeighbour(old.n[1], t, t3);
+
+	legalizeStack_.push_back(t);
+	legalizeStack_.push_back(t2);
+	legalizeStack_.push_back(t3);
+}
+
+void DelaunayTriangulation::splitEdge(const int t, const int edge, const int vertex)
+{
+	const Triangle T = triangles_[t];
+	const int a = T.v[edge], b = T.v[(edge + 1) % 3], c = T.v[(edge + 2) % 3];
+	const std::uint8_t cBC = (T.constrained >> edge) & 1;
+	const std::uint8_t cCA = (T.constrained >> ((edge + 1) % 3)) & 1;
+	const std::uint8_t cAB = (T.constrained >> ((edge + 2) % 3)) & 1;
+	const int nCA = T.n[(edge + 1) % 3];
+	const int nAB = T.n[(edge + 2) % 3];
+	const int u = T.n[edge];
+
+	const int t2 = static_cast<int>(triangles_.size());
+	if (u < 0)
+	{
+		triangles_.resize(triangles_.size() + 1);
+		setTriangle(t, a, b, vertex, -1, t2, nAB, cBC | (cAB << 2));
+		setTriangle(t2, a, vertex, c, -1, nCA, t, cBC | (cCA << 1));
+		replaceNeighbour(nCA, t, t2);
+
+		legalizeStack_.push_back(t);
+		legalizeStack_.push_back(t2);
+		return;
+	}
+
+	// 'u' contains the vertices d, c, b in counter-clockwise order.
+	const Triangle U = triangles_[u];
+	const int j = U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2);
+	const int d = U.v[j];
+	const std::uint8_t cBD = (U.constrained >> ((j + 1) % 3)) & 1;
+	const std::uint8_t cDC = (U.constrained >> ((j + 2) % 3)) & 1;
+	const int nBD = U.n[(j + 1) % 3];
+	const int nDC = U.n[(j + 2) % 3];
+
+	const int u2 = t2 + 1;
+	triangles_.resize(triangles_.size() + 2);
+	setTriangle(t, a, b, vertex, u2, t2, nAB, cBC | (cAB << 2));
+	setTriangle(t2, a, vertex, c, u, nCA, t, cBC | (cCA << 1));
+	setTriangle(u, d, c, vertex, t2, u2, nDC, cBC | (cDC << 2));
+	setTriangle(u2, d, vertex, b, t, nBD, u, cBC | (cBD << 1));
+	replaceNeighbour(nCA, t, t2);
+	replaceNeighbour(nBD, u, u2);
+
+	legalizeStack_.push_back(t);
+	legalizeStack_.push_back(t2);
+	legalizeStack_.push_back(u);
+	legalizeStack_.push_back(u2);
+}
+
+void DelaunayTriangulation::legalize(const int vertex)
+{
+	while (!legalizeStack_.empty())
+	{
+		const int t = legalizeStack_.back();
+		legalizeStack_.pop_back();
+
+		const int i = indexOf(t, vertex);
+		const int u = triangles_[t].n[i];
+		if (u < 0 || (triangles_[t].constrained & (1 << i)))
+			continue;
+
+		const Triangle& U = triangles_[u];
+		const int d = U.v[U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2)];
+		if (inCircle(t, d))
+		{
+			flip(t, i);
+			legalizeStack_.push_back(t);
+			legalizeStack_.push_back(u);
+		}
+	}
+}
+
+void DelaunayTriangulation::flip(const int t, const int edge)
+{
+	// Replaces the edge b-c shared by t = (a, b, c) and u = (d, c, b) with a-d, giving t = (a, b, d) and u = (a, d, c).
+	const Triangle T = triangles_[t];
+	const int u = T.n[edge];
+	const Triangle U = triangles_[u];
+	const int j = U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2);
+
+	const int a = T.v[edge], b = T.v[(edge + 1) % 3], c = T.v[(edge + 2) % 3];
+	const int d = U.v[j];
+	const int nCA = T.n[(edge + 1) % 3];
+	const int nAB = T.n[(edge + 2) % 3];
+	const int nBD = U.n[(j + 1) % 3];
+	const int nDC = U.n[(j + 2) % 3];
+	const std::uint8_t cCA = (T.constrained >> ((edge + 1) % 3)) & 1;
+	const std::uint8_t cAB = (T.constrained >> ((edge + 2) % 3)) & 1;
+	const std::uint8_t cBD = (U.constrained >> ((j + 1) % 3)) & 1;
+	const std::uint8_t cDC = (U.constrained >> ((j + 2) % 3)) & 1;
+
+	setTriangle(t, a, b, d, nBD, u, nAB, cBD | (cAB << 2));
+	setTriangle(u, a, d, c, nDC, nCA, t, cDC | (cCA << 1));
+	replaceNeighbour(nBD, u, t);
+	replaceNeighbour(nCA, t, u);
+}
+
+void DelaunayTriangulation::insertSegment(const int a, const int b, const int depth)
+{
+	if (a < 0 || b < 0 || a == b || depth > 64)
+		return;
+
+	int t = -1;
+	int edge = -1;
+	if (findEdge(a, b, t, edge))
+	{
+		setConstrained(t, edge);
+		return;
+	}
+
+	// Find the triangle around 'a' through which the segment leaves 'a'. Vertices on the segment split it into two segments.
+	const buw::Vector2d direction = positions_[b] - positions_[a];
+	const double length = direction.squaredNorm();
+	const int start = vertexTriangle_[a];
+	int x = -1;
+	int y = -1;
+	t = start;
+	do
+	{
+		const Triangle& T = triangles_[t];
+		const int i = indexOf(t, a);
+		const int v1 = T.v[(i + 1) % 3];
+		const int v2 = T.v[(i + 2) % 3];
+		for (int v : { v1, v2 })
+		{
+			const double projection = (positions_[v] - positions_[a]).dot(direction);
+			if (v < superVertex_ && orient(a, b, v) == 0 && projection > 0 && projection < length)
+			{
+				insertSegment(a, v, depth + 1);
+				insertSegment(v, b, depth + 1);
+				return;
+			}
+		}
+
+		if (orient(a, b, v1) < 0 && orient(a, b, v2) > 0)
+		{
+			x = v1;
+			y = v2;
+			break;
+		}
+		t = T.n[(i + 2) % 3];
+	} while (t >= 0 && t != start);
+
+	if (x < 0)
+	{
+		skippedSegments_++;
+		return;
+	}
+
+	// Collect the edges crossed by the segment, 'x' is always right and 'y' left of it.
+	std::deque<std::pair<int, int>> crossed;
+	while (true)
+	{
+		const Triangle& T = triangles_[t];
+		const int e = 3 - indexOf(t, x) - indexOf(t, y);
+		if (T.constrained & (1 << e))
+		{
+			// Crossing break lines would need an additional vertex at the intersection.
+			skippedSegments_++;
+			return;
+		}
+		crossed.push_back(std::make_pair(x, y));
+
+		const int u = T.n[e];
+		if (u < 0)
+		{
+			skippedSegments_++;
+			return;
+		}
+
+		const Triangle& U = triangles_[u];
+		const int w = U.v[U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2)];
+		if (w == b)
+			break;
+
+		const double o = orient(a, b, w);
+		if (o == 0)
+		{
+			insertSegment(a, w, depth + 1);
+			insertSegment(w, b, depth + 1);
+			return;
+		}
+
+		if (o < 0)
+			x = w;
+		else
+			y = w;
+		t = u;
+	}
+
+	// Flip the crossed edges until none is left. Edges of non-convex quadrilaterals are tried again later.
+	std::vector<std::pair<int, int>> created;
+	size_t iterations = 0;
+	const size_t maxIterations = 32 * crossed.size() + 64;
+	while (!crossed.empty())
+	{
+		if (++iterations > maxIterations)
+		{
+			skippedSegments_++;
+			return;
+		}
+
+		const std::pair<int, int> e = crossed.front();
+		crossed.pop_front();
+		if (!findEdge(e.first, e.second, t, edge))
+			continue;
+
+		const Triangle& T = triangles_[t];
+		const int u = T.n[edge];
+		const Triangle& U = triangles_[u];
+		const int p = T.v[edge];
+		const int q = U.v[U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2)];
+
+		const double ox = orient(p, q, e.first);
+		const double oy = orient(p, q, e.second);
+		if (!((ox < 0 && oy > 0) || (ox > 0 && oy < 0)))
+		{
+			crossed.push_back(e);
+			continue;
+		}
+
+		flip(t, edge);
+
+		const double op = orient(a, b, p);
+		const double oq = orient(a, b, q);
+		const bool bCrossing = p != a && p != b && q != a && q != b && ((op < 0 && oq > 0) || (op > 0 && oq < 0))
+			&& orient(p, q, a) * orient(p, q, b) < 0;
+		if (bCrossing)
+			crossed.push_back(std::make_pair(p, q));
+		else
+			created.push_back(std::make_pair(p, q));
+	}
+
+	if (findEdge(a, b, t, edge))
+		setConstrained(t, edge);
+	else
+		skippedSegments_++;
+
+	// Restore the Delaunay property for the new edges except the segment itself.
+	bool bFlipped = true;
+	for (int round = 0; round < 64 && bFlipped; round++)
+	{
+		bFlipped = false;
+		for (std::pair<int, int>& e : created)
+		{
+			if (!findEdge(e.first, e.second, t, edge) || (triangles_[t].constrained & (1 << edge)))
+				continue;
+
+			const Triangle& T = triangles_[t];
+			const int u = T.n[edge];
+			if (u < 0)
+				continue;
+
+			const Triangle& U = triangles_[u];
+			const int p = T.v[edge];
+			const int q = U.v[U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2)];
+			if (inCircle(t, q))
+			{
+				flip(t, edge);
+				e = std::make_pair(p, q);
+				bFlipped = true;
+			}
+		}
+	}
+}
+
+void DelaunayTriangulation::setConstrained(const int t, const int edge)
+{
+	triangles_[t].constrained |= 1 << edge;
+
+	const int u = triangles_[t].n[edge];
+	if (u >= 0)
+	{
+		Triangle& U = triangles_[u];
+		U.constrained |= 1 << (U.n[0] == t ? 0 : (U.n[1] == t ? 1 : 2));
+	}
+}
+
+bool DelaunayTriangulation::findEdge(const int a, const int b, int& o_triangle, int& o_edge) const
+{
+	// Turn around 'a' until a triangle with 'b' is found.
+	const int start = vertexTriangle_[a];
+	int t = start;
+	while (t >= 0)
+	{
+		const Triangle& T = triangles_[t];
+		const int i = indexOf(t, a);
+		if (T.v[(i + 1) % 3] == b)
+		{
+			o_triangle = t;
+			o_edge = (i + 2) % 3;
+			return true;
+		}
+		if (T.v[(i + 2) % 3] == b)
+		{
+			o_triangle = t;
+			o_edge = (i + 1) % 3;
+			return true;
+		}
+
+		t = T.n[(i + 2) % 3];
+		if (t == start)
+			break;
+	}
+	return false;
+}
+
+void DelaunayTriangulation::setTriangle(const int t, const int a, const int b, const int c, const int na, const int nb, const int nc, const std::uint8_t constrained)
+{
+	Triangle& T = triangles_[t];
+	T.v[0] = a;
+	T.v[1] = b;
+	T.v[2] = c;
+	T.n[0] = na;
+	T.n[1] = nb;
+	T.n[2] = nc;
+	T.constrained = constrained;
+
+	vertexTriangle_[a] = t;
+	vertexTriangle_[b] = t;
+	vertexTriangle_[c] = t;
+}
+
+void DelaunayTriangulation::replaceNeighbour(const int t, const int oldNeighbour, const int newNeighbour)
+{
+	if (t < 0)
+		return;
+
+	Triangle& T = triangles_[t];
+	for (int k = 0; k < 3; k++)
+	{
+		if (T.n[k] == oldNeighbour)
+		{
+			T.n[k] = newNeighbour;
+			return;
+		}
+	}
+}
+
+int DelaunayTriangulation::indexOf(const int t, const int vertex) const
+{
+	const Triangle& T = triangles_[t];
+	return T.v[0] == vertex ? 0 : (T.v[1] == vertex ? 1 : (T.v[2] == vertex ? 2 : -1));
+}
+
+double DelaunayTriangulation::orient(const int a, const int b, const int c) const
+{
+	return orient(a, b, positions_[c]);
+}
+
+double DelaunayTriangulation::orient(const int a, const int b, const buw::Vector2d& c) const
+{
+	const buw::Vector2d& pa = positions_[a];
+	const buw::Vector2d& pb = positions_[b];
+	return (pb.x() - pa.x()) * (c.y() - pa.y()) - (pb.y() - pa.y()) * (c.x() - pa.x());
+}
+
+bool DelaunayTriangulation::inCircle(const int t, const int vertex) const
+{
+	// A vertex of the enclosing triangle lies outside of every circle through the points.
+	if (vertex >= superVertex_)
+		return false;
+
+	// The circle through two points and a vertex of the enclosing triangle becomes the half-plane on the side of that vertex.
+	const Triangle& T = triangles_[t];
+	const int superCount = (T.v[0] >= superVertex_ ? 1 : 0) + (T.v[1] >= superVertex_ ? 1 : 0) + (T.v[2] >= superVertex_ ? 1 : 0);
+	if (superCount == 1)
+	{
+		const int k = T.v[0] >= superVertex_ ? 0 : (T.v[1] >= superVertex_ ? 1 : 2);
+		return orient(T.v[(k + 1) % 3], T.v[(k + 2) % 3], vertex) > 0;
+	}
+
+	const buw::Vector2d& d = positions_[vertex];
+	const buw::Vector2d a = positions_[T.v[0]] - d;
+	const buw::Vector2d b = positions_[T.v[1]] - d;
+	const buw::Vector2d c = positions_[T.v[2]] - d;
+
+	const double determinant = a.squaredNorm() * (b.x() * c.y() - c.x() * b.y())
+		+ b.squaredNorm() * (c.x() * a.y() - a.x() * c.y())
+		+ c.squaredNorm() * (a.x() * b.y() - b.x() * a.y());
+	return determinant > 0;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
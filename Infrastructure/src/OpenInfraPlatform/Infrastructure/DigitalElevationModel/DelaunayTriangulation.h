@@ -0,0 +1,107 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_DelaunayTriangulation_5e0a7c13_94b2_4f6d_8c3e_71d9b2a4f068_h
+#define OpenInfraPlatform_Infrastructure_DelaunayTriangulation_5e0a7c13_94b2_4f6d_8c3e_71d9b2a4f068_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <cstdint>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Incremental 2.5D Delaunay triangulation with break lines as constrained edges. The points are inserted in biased randomized rounds which are
+//! sorted along a Hilbert curve, so each point is found by a short walk from the previously inserted one. Break lines are inserted afterwards by
+//! flipping the edges they cross, constrained edges are never flipped.
+class BLUEINFRASTRUCTURE_API DelaunayTriangulation
+{
+public:
+	//! Triangulates the points and break lines. The vertices of the break lines are appended to the points, the ones coinciding with a point are not used by any triangle.
+	DelaunayTriangulation(const std::vector<buw::Vector3d>& points, const std::vector<std::vector<buw::Vector3d>>& breakLines = std::vector<std::vector<buw::Vector3d>>());
+
+	//! Returns the points followed by the vertices of the break lines. Duplicate points are not used by any triangle.
+	const std::vector<buw::Vector3d>& getPoints() const;
+
+	//! Returns the counter-clockwise triangles, the ones connected to the enclosing triangle are left out.
+	std::vector<buw::Vector3i> getTriangles() const;
+
+	//! Returns the number of break line segments which could not be inserted because they cross another break line.
+	int getSkippedBreakLineSegmentCount() const;
+
+private:
+	//! Edge i lies opposite of vertex v[i], n[i] is the triangle on the other side of it or -1. Bit i of 'constrained' marks edge i as break line.
+	struct Triangle
+	{
+		int				v[3];
+		int				n[3];
+		std::uint8_t	constrained;
+	};
+
+	std::vector<int> getInsertionOrder(const int count, const double size) const;
+
+	int insertPoint(const int vertex, int& hint);
+
+	int locate(const buw::Vector2d& p, int hint, int& o_edge, int& o_vertex) const;
+
+	void splitTriangle(const int t, const int vertex);
+
+	void splitEdge(const int t, const int edge, const int vertex);
+
+	void legalize(const int vertex);
+
+	void flip(const int t, const int edge);
+
+	void insertSegment(const int a, const int b, const int depth);
+
+	void setConstrained(const int t, const int edge);
+
+	bool findEdge(const int a, const int b, int& o_triangle, int& o_edge) const;
+
+	void setTriangle(const int t, const int a, const int b, const int c, const int na, const int nb, const int nc, const std::uint8_t constrained);
+
+	void replaceNeighbour(const int t, const int oldNeighbour, const int newNeighbour);
+
+	int indexOf(const int t, const int vertex) const;
+
+	double orient(const int a, const int b, const int c) const;
+
+	double orient(const int a, const int b, const buw::Vector2d& c) const;
+
+	bool inCircle(const int t, const int vertex) const;
+
+private:
+	std::vector<buw::Vector3d>		points_;
+	std::vector<buw::Vector2d>		positions_;		// relative to the lower left corner, including the enclosing triangle
+	std::vector<Triangle>			triangles_;
+	std::vector<int>				vertexTriangle_;
+	std::vector<int>				legalizeStack_;
+	int								superVertex_;
+	int								skippedSegments_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::DelaunayTriangulation;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_DelaunayTriangulation_5e0a7c13_94b2_4f6d_8c3e_71d9b2a4f068_h
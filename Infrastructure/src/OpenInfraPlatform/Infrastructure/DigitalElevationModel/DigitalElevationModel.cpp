@@ -16,24 +16,379 @@
 */
 
 #include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DelaunayTriangulation.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/SurfaceFootprintIndex.h"
 #include "OpenInfraPlatform/Infrastructure/Alignment/IAlignment3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
 #include <BlueFramework/Core/assert.h>
-#include <set>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <omp.h>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
+namespace {
+    // Queries the height of the surfaces of a model in the order of their priority and remembers the last hit triangle of each surface. Used by
+    // one thread at a time.
+    class HeightSampler {
+    public:
+        HeightSampler(const DigitalElevationModel& dem)
+            : surfaces_(dem.getSurfaces()), rasterSurfaces_(dem.getRasterSurfaces()), index_(dem.getFootprintIndex()), hints_(surfaces_.size(), -1) {
+        }
+
+        // Returns false if no surface contains the position, otherwise the height of the surface with the highest priority containing it.
+        bool getHeight(const buw::Vector2d& position, double& z) {
+            z = 0;
+            const int rank = index_->findEntry(position, [&](const int candidate) {
+                const SurfaceFootprintIndex::Entry& entry = index_->getEntry(candidate);
+                if (entry.bRaster)
+                    return rasterSurfaces_[entry.index]->tryGetZ(position, z);
+                return surfaces_[entry.index]->tryGetZ(position, z, hints_[entry.index]);
+            });
+            return rank >= 0;
+        }
+
+    private:
+        std::vector<buw::ReferenceCounted<buw::Surface>> surfaces_;
+        std::vector<buw::ReferenceCounted<buw::RasterSurface>> rasterSurfaces_;
+        std::shared_ptr<const SurfaceFootprintIndex> index_;
+        std::vector<int> hints_;
+    };
+
+    // Samples the surfaces along an alignment. Used by one thread at a time.
+    class SurfaceProfileSampler {
+    public:
+        SurfaceProfileSampler(const DigitalElevationModel& dem, const buw::IAlignment3D& alignment, const SurfaceProfileDescription& desc)
+            : heights_(dem), alignment_(alignment), desc_(desc), minimumStep_(desc.step / 1024) {
+            if (desc.minimumStep > minimumStep_)
+                minimumStep_ = desc.minimumStep;
+        }
+
+        bool getHeight(const buw::Vector2d& position, double& z) {
+            return heights_.getHeight(position, z);
+        }
+
+        bool getHeightAtStation(const double station, double& z) {
+            return getHeight(alignment_.getPosition(station).block<2, 1>(0, 0), z);
+        }
+
+        // Samples the stations [first, last) of the regular grid and appends them to 'o_profile'. With a tolerance, the station 'last' is sampled
+        // as well to refine the last step.
+        void sampleChunk(const double start, const double end, const long long first, const long long last, std::vector<std::pair<double, double>>& o_profile) {
+            const bool bRefine = desc_.tolerance > 0;
+            const long long count = last - first + (bRefine ? 1 : 0);
+
+            // Evaluate the alignment for the whole chunk before walking through the surfaces.
+            std::vector<double> stations(count);
+            std::vector<buw::Vector3d> positions(count);
+            for (long long i = 0; i < count; i++) {
+                stations[i] = std::min(start + (first + i) * desc_.step, end);
+            }
+            alignment_.getPositions(stations.data(), static_cast<int>(count), positions.data());
+
+            std::vector<double> heights(count);
+            std::vector<char> contained(count);
+            for (long long i = 0; i < count; i++) {
+                contained[i] = getHeight(positions[i].block<2, 1>(0, 0), heights[i]);
+            }
+
+            for (long long i = 0; i < last - first; i++) {
+                if (contained[i])
+                    o_profile.push_back(std::make_pair(stations[i], heights[i]));
+
+                if (bRefine && i + 1 < count)
+                    refine(stations[i], heights[i], contained[i] != 0, stations[i + 1], heights[i + 1], contained[i + 1] != 0, o_profile);
+            }
+        }
+
+    private:
+        // Bisects the step between two samples while the terrain deviates from the linear interpolation or the surfaces start or end in between.
+        void refine(const double s0, const double z0, const bool bContained0, const double s1, const double z1, const bool bContained1, std::vector<std::pair<double, double>>& o_profile) {
+            if ((s1 - s0) * 0.5 < minimumStep_)
+                return;
+
+            const double s = 0.5 * (s0 + s1);
+            double z = 0;
+            const bool bContained = getHeightAtStation(s, z);
+
+            bool bSplit = bContained0 != bContained || bContained != bContained1;
+            if (!bSplit && bContained)
+                bSplit = std::abs(z - 0.5 * (z0 + z1)) > desc_.tolerance;
+            if (!bSplit)
+                return;
+
+            refine(s0, z0, bContained0, s, z, bContained, o_profile);
+            if (bContained)
+                o_profile.push_back(std::make_pair(s, z));
+            refine(s, z, bContained, s1, z1, bContained1, o_profile);
+        }
+
+    private:
+        HeightSampler heights_;
+        const buw::IAlignment3D& alignment_;
+        const SurfaceProfileDescription& desc_;
+        double minimumStep_;
+    };
+
+    // Heights of a design surface, each thread uses its own copy.
+    class SurfaceDesign {
+    public:
+        SurfaceDesign(const buw::ReferenceCounted<buw::Surface>& surface)
+            : surface_(surface), hint_(-1) {
+        }
+
+        bool getHeight(const double /*station*/, const double /*offset*/, const buw::Vector2d& position, double& z) {
+            return surface_->tryGetZ(position, z, hint_);
+        }
+
+    private:
+        buw::ReferenceCounted<buw::Surface> surface_;
+        int hint_;
+    };
+
+    // Lower side of the road body of an alignment, given by the closed design cross sections in offset and height above the alignment. Copies share
+    // the cross sections.
+    class RoadBodyDesign {
+    public:
+        RoadBodyDesign(Alignment2DBased3D& alignment)
+            : alignment_(&alignment), station_(std::numeric_limits<double>::quiet_NaN()), alignmentHeight_(0) {
+            auto sections = std::make_shared<std::vector<Section>>();
+            for (int i = 0; i < alignment.getCrossSectionCount(); i++) {
+                buw::ReferenceCounted<buw::CrossSectionStatic> crossSection = alignment.getCrossSection(i);
+
+                Section section;
+                section.station = crossSection->stationing;
+                for (int j = 0; j < crossSection->getClosedDesignCrossSectionProfileCount(); j++) {
+                    std::vector<buw::Vector2d> polygon;
+                    for (const auto& point : crossSection->getClosedDesignCrossSectionProfile(j)->crossSectionsPoints)
+                        polygon.push_back(point->position);
+                    if (polygon.size() >= 3)
+                        section.bodies.push_back(polygon);
+                }
+                sections->push_back(section);
+            }
+
+            std::stable_sort(sections->begin(), sections->end(), [](const Section& a, const Section& b) { return a.station < b.station; });
+            sections_ = sections;
+        }
+
+        // Returns the largest distance of the road body from the alignment.
+        double getWidth() const {
+            double width = 0;
+            for (const Section& section : *sections_)
+                for (const auto& polygon : section.bodies)
+                    for (const buw::Vector2d& p : polygon)
+                        width = std::max(width, std::abs(p.x()));
+            return width;
+        }
+
+        bool getHeight(const double station, const double offset, const buw::Vector2d& /*position*/, double& z) {
+            const std::vector<Section>& sections = *sections_;
+            auto next = std::upper_bound(sections.begin(), sections.end(), station, [](const double s, const Section& section) { return s < section.station; });
+            if (next == sections.begin() || next == sections.end())
+                return false;
+
+            const Section& previous = *(next - 1);
+            double z0 = 0, z1 = 0;
+            if (!getLowerSide(previous, offset, z0) || !getLowerSide(*next, offset, z1))
+                return false;
+
+            // The cells of a row share their station.
+            if (station != station_) {
+                station_ = station;
+                alignmentHeight_ = alignment_->getPosition(station).z();
+            }
+
+            const double length = next->station - previous.station;
+            const double t = length > 0 ? (station - previous.station) / length : 0.0;
+            z = alignmentHeight_ + z0 + t * (z1 - z0);
+            return true;
+        }
+
+    private:
+        struct Section {
+            double station;
+            std::vector<std::vector<buw::Vector2d>> bodies;
+        };
+
+        // Lowest elevation of the borders of all bodies at the offset.
+        static bool getLowerSide(const Section& section, const double offset, double& z) {
+            bool bFound = false;
+            for (const auto& polygon : section.bodies) {
+                for (size_t i = 0; i < polygon.size(); i++) {
+                    const buw::Vector2d& a = polygon[i];
+                    const buw::Vector2d& b = polygon[(i + 1) % polygon.size()];
+                    if ((a.x() <= offset && offset < b.x()) || (b.x() <= offset && offset < a.x())) {
+                        const double height = a.y() + (offset - a.x()) / (b.x() - a.x()) * (b.y() - a.y());
+                        z = bFound ? std::min(z, height) : height;
+                        bFound = true;
+                    }
+                }
+            }
+            return bFound;
+        }
+
+        std::shared_ptr<const std::vector<Section>> sections_;
+        const Alignment2DBased3D* alignment_;
+        double station_;
+        double alignmentHeight_;
+    };
+
+    // Sums up the height difference of the design to the terrain in cells of station and offset. The rows of cells are aligned to the intervals
+    // and computed in parallel, each thread uses its own copy of the design.
+    template <typename Design>
+    EarthworkResult computeCorridorEarthwork(const DigitalElevationModel& dem, const buw::IAlignment3D& alignment, const Design& design, const double width, const EarthworkDescription& desc) {
+        EarthworkResult result;
+
+        const double start = std::max(desc.startStation, alignment.getStartStation());
+        const double end = std::min(desc.endStation, alignment.getEndStation());
+        if (!dem.hasSurfaces() || !(desc.cellSize > 0) || !(width > 0) || !(start < end))
+            return result;
+
+        // Interval borders at multiples of the interval length.
+        std::vector<double> borders(1, start);
+        if (desc.stationInterval > 0) {
+            for (long long k = static_cast<long long>(std::floor(start / desc.stationInterval)) + 1; k * desc.stationInterval < end; k++)
+                borders.push_back(k * desc.stationInterval);
+        }
+        borders.push_back(end);
+
+        struct Row {
+            int interval;
+            double start;
+            double end;
+        };
+
+        std::vector<Row> rows;
+        for (size_t i = 0; i + 1 < borders.size(); i++) {
+            const int count = std::max(1, static_cast<int>(std::ceil((borders[i + 1] - borders[i]) / desc.cellSize)));
+            for (int j = 0; j < count; j++)
+                rows.push_back({ static_cast<int>(i), borders[i] + (borders[i + 1] - borders[i]) * j / count, borders[i] + (borders[i + 1] - borders[i]) * (j + 1) / count });
+        }
+
+        const int columnCount = std::max(1, static_cast<int>(std::ceil(2 * width / desc.cellSize)));
+        const double columnWidth = 2 * width / columnCount;
+        const int threadCount = desc.threadCount > 0 ? desc.threadCount : omp_get_max_threads();
+
+        // Positions and left normals at the borders of the rows, evaluated along the alignment at once. Offsets are positive to the left like
+        // those of the cross sections.
+        std::vector<double> frameStations(2 * rows.size());
+        for (size_t r = 0; r < rows.size(); r++) {
+            frameStations[2 * r] = rows[r].start;
+            frameStations[2 * r + 1] = rows[r].end;
+        }
+        std::vector<buw::Vector3d> framePositions(frameStations.size());
+        std::vector<buw::Vector3d> frameNormals(frameStations.size());
+        alignment.getPositions(frameStations.data(), static_cast<int>(frameStations.size()), framePositions.data(), nullptr, frameNormals.data(), threadCount);
+
+        std::vector<double> cut(rows.size(), 0.0);
+        std::vector<double> fill(rows.size(), 0.0);
+
+#pragma omp parallel num_threads(threadCount)
+        {
+            HeightSampler terrain(dem);
+            Design localDesign = design;
+
+            auto getFrame = [&](const size_t index, buw::Vector2d& position, buw::Vector2d& normal) {
+                position = framePositions[index].block<2, 1>(0, 0);
+                normal = frameNormals[index].block<2, 1>(0, 0);
+                return normal.squaredNorm() > 0.5;
+            };
+
+#pragma omp for schedule(dynamic, 16)
+            for (int r = 0; r < static_cast<int>(rows.size()); r++) {
+                const Row& row = rows[r];
+                buw::Vector2d p0, n0, p1, n1;
+                if (!getFrame(2 * r, p0, n0) || !getFrame(2 * r + 1, p1, n1))
+                    continue;
+
+                const double station = 0.5 * (row.start + row.end);
+                for (int c = 0; c < columnCount; c++) {
+                    const double o0 = -width + c * columnWidth;
+                    const double o1 = o0 + columnWidth;
+
+                    // The cell is the quadrilateral between both stations and offsets, its area shrinks on the inner side of curves.
+                    const buw::Vector2d a = p0 + o0 * n0;
+                    const buw::Vector2d b = p1 + o0 * n1;
+                    const buw::Vector2d d = p1 + o1 * n1;
+                    const buw::Vector2d e = p0 + o1 * n0;
+                    const buw::Vector2d u = d - a;
+                    const buw::Vector2d v = e - b;
+                    const double area = 0.5 * std::abs(u.x() * v.y() - u.y() * v.x());
+                    const buw::Vector2d center = 0.25 * (a + b + d + e);
+
+                    double existingHeight = 0, designHeight = 0;
+                    if (!localDesign.getHeight(station, 0.5 * (o0 + o1), center, designHeight) || !terrain.getHeight(center, existingHeight))
+                        continue;
+
+                    const double difference = designHeight - existingHeight;
+                    if (difference > 0)
+                        fill[r] += difference * area;
+                    else
+                        cut[r] -= difference * area;
+                }
+            }
+        }
+
+        // Sum up the intervals in order for the mass haul.
+        result.intervals.resize(borders.size() - 1);
+        for (size_t i = 0; i < result.intervals.size(); i++) {
+            result.intervals[i].startStation = borders[i];
+            result.intervals[i].endStation = borders[i + 1];
+            result.intervals[i].cut = 0;
+            result.intervals[i].fill = 0;
+        }
+        for (size_t r = 0; r < rows.size(); r++) {
+            result.intervals[rows[r].interval].cut += cut[r];
+            result.intervals[rows[r].interval].fill += fill[r];
+        }
+
+        double massOrdinate = 0;
+        for (EarthworkInterval& interval : result.intervals) {
+            result.cut += interval.cut;
+            result.fill += interval.fill;
+            massOrdinate += desc.cutFactor * interval.cut - interval.fill;
+            interval.massOrdinate = massOrdinate;
+        }
+
+        return result;
+    }
+} // namespace
+
 DigitalElevationModel::DigitalElevationModel() {
 }
 
+DigitalElevationModel::DigitalElevationModel(const DigitalElevationModel& other) {
+    *this = other;
+}
+
 DigitalElevationModel::~DigitalElevationModel() {
 }
 
+DigitalElevationModel& DigitalElevationModel::operator=(const DigitalElevationModel& other) {
+    if (this != &other) {
+        surfaces_ = other.surfaces_;
+        rasterSurfaces_ = other.rasterSurfaces_;
+        surfacePriorities_ = other.surfacePriorities_;
+        rasterPriorities_ = other.rasterPriorities_;
+        breakLines_ = other.breakLines_;
+
+        // The index only depends on the surfaces and their priorities, so the copy can share it.
+        std::atomic_store(&footprintIndex_, std::atomic_load(&other.footprintIndex_));
+    }
+    return *this;
+}
+
 void DigitalElevationModel::addSurface(buw::ReferenceCounted<buw::Surface> surface) {
     surfaces_.push_back(surface);
+    surfacePriorities_.push_back(0);
+    invalidateFootprintIndex();
 }
 
 bool OpenInfraPlatform::Infrastructure::DigitalElevationModel::hasSurfaces() const {
-    return getSurfaceCount() > 0;
+    return getSurfaceCount() > 0 || !rasterSurfaces_.empty();
 }
 
 int DigitalElevationModel::getSurfaceCount() const {
@@ -48,17 +403,114 @@ const std::vector<buw::ReferenceCounted<buw::Surface>>& DigitalElevationModel::g
     return surfaces_;
 }
 
+void DigitalElevationModel::addRasterSurface(buw::ReferenceCounted<buw::RasterSurface> surface) {
+    rasterSurfaces_.push_back(surface);
+    rasterPriorities_.push_back(0);
+    invalidateFootprintIndex();
+}
+
+const std::vector<buw::ReferenceCounted<buw::RasterSurface>>& DigitalElevationModel::getRasterSurfaces() const {
+    return rasterSurfaces_;
+}
+
+void DigitalElevationModel::deleteRasterSurface(buw::ReferenceCounted<buw::RasterSurface> s) {
+    auto iterator = std::find(rasterSurfaces_.begin(), rasterSurfaces_.end(), s);
+
+    BLUE_ASSERT(iterator != rasterSurfaces_.end(), "Invalid surface");
+
+    if (iterator != rasterSurfaces_.end()) {
+        rasterPriorities_.erase(rasterPriorities_.begin() + (iterator - rasterSurfaces_.begin()));
+        rasterSurfaces_.erase(iterator);
+        invalidateFootprintIndex();
+    } else {
+        throw std::runtime_error("Deletion of raster surface failed.");
+    }
+}
+
+std::vector<buw::ReferenceCounted<buw::Surface>> DigitalElevationModel::getTriangulatedSurfaces() const {
+    std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = surfaces_;
+    for (const auto& raster : rasterSurfaces_)
+        surfaces.push_back(raster->createSurface());
+    return surfaces;
+}
+
+void DigitalElevationModel::setSurfacePriority(buw::ReferenceCounted<buw::Surface> surface, const int priority) {
+    auto iterator = std::find(surfaces_.begin(), surfaces_.end(), surface);
+
+    BLUE_ASSERT(iterator != surfaces_.end(), "Invalid surface");
+
+    if (iterator != surfaces_.end()) {
+        surfacePriorities_[iterator - surfaces_.begin()] = priority;
+        invalidateFootprintIndex();
+    } else {
+        throw std::runtime_error("Surface is not part of the model.");
+    }
+}
+
+void DigitalElevationModel::setSurfacePriority(buw::ReferenceCounted<buw::RasterSurface> surface, const int priority) {
+    auto iterator = std::find(rasterSurfaces_.begin(), rasterSurfaces_.end(), surface);
+
+    BLUE_ASSERT(iterator != rasterSurfaces_.end(), "Invalid surface");
+
+    if (iterator != rasterSurfaces_.end()) {
+        rasterPriorities_[iterator - rasterSurfaces_.begin()] = priority;
+        invalidateFootprintIndex();
+    } else {
+        throw std::runtime_error("Raster surface is not part of the model.");
+    }
+}
+
+int DigitalElevationModel::getSurfacePriority(buw::ReferenceCounted<buw::Surface> surface) const {
+    auto iterator = std::find(surfaces_.begin(), surfaces_.end(), surface);
+    if (iterator == surfaces_.end())
+        throw std::runtime_error("Surface is not part of the model.");
+
+    return surfacePriorities_[iterator - surfaces_.begin()];
+}
+
+int DigitalElevationModel::getSurfacePriority(buw::ReferenceCounted<buw::RasterSurface> surface) const {
+    auto iterator = std::find(rasterSurfaces_.begin(), rasterSurfaces_.end(), surface);
+    if (iterator == rasterSurfaces_.end())
+        throw std::runtime_error("Raster surface is not part of the model.");
+
+    return rasterPriorities_[iterator - rasterSurfaces_.begin()];
+}
+
+std::shared_ptr<const SurfaceFootprintIndex> DigitalElevationModel::getFootprintIndex() const {
+    std::shared_ptr<const SurfaceFootprintIndex> index = std::atomic_load(&footprintIndex_);
+    if (index)
+        return index;
+
+    // Build the index only once if several threads query the model at the same time.
+    std::lock_guard<std::mutex> lock(footprintIndexMutex_);
+    index = std::atomic_load(&footprintIndex_);
+    if (!index) {
+        index = std::make_shared<const SurfaceFootprintIndex>(surfaces_, surfacePriorities_, rasterSurfaces_, rasterPriorities_);
+        std::atomic_store(&footprintIndex_, index);
+    }
+    return index;
+}
+
+void DigitalElevationModel::invalidateFootprintIndex() {
+    std::atomic_store(&footprintIndex_, std::shared_ptr<const SurfaceFootprintIndex>());
+}
+
 void DigitalElevationModel::getSurfacesExtend(buw::Vector3d& minimalPosition, buw::Vector3d& maximalPosition) const {
     // Determine min and max positions
     minimalPosition = buw::Vector3d::Ones() * std::numeric_limits<double>::max();
-    maximalPosition = buw::Vector3d::Ones() * std::numeric_limits<double>::min();
+    maximalPosition = buw::Vector3d::Ones() * std::numeric_limits<double>::lowest();
 
     int surfaceCount = getSurfaceCount();
 
-    if (surfaceCount == 0) {
+    if (!hasSurfaces()) {
         minimalPosition = maximalPosition = buw::Vector3d(0, 0, 0);
     }
 
+    for (const auto& raster : rasterSurfaces_) {
+        updateMinMax(raster->getBoundsMin(), minimalPosition, maximalPosition);
+        updateMinMax(raster->getBoundsMax(), minimalPosition, maximalPosition);
+    }
+
     for (int si = 0; si < surfaceCount; si++) {
         auto s = getSurface(si);
 
@@ -74,34 +526,232 @@ void DigitalElevationModel::getSurfacesExtend(buw::Vector3d& minimalPosition, bu
 }
 
 std::vector<std::pair<double, double>> DigitalElevationModel::getSurfaceProfile(buw::ReferenceCounted<buw::IAlignment3D> a) const {
+    return getSurfaceProfile(a, SurfaceProfileDescription());
+}
+
+std::vector<std::pair<double, double>> DigitalElevationModel::getSurfaceProfile(buw::ReferenceCounted<buw::IAlignment3D> a, const SurfaceProfileDescription& desc) const {
     std::vector<std::pair<double, double>> profile;
 
-    for (double s = a->getStartStation(); s < a->getEndStation(); s += 0.5) {
-        buw::Vector2d position = a->getPosition(s).block<2, 1>(0, 0);
-        for (buw::ReferenceCounted<buw::Surface> surface : surfaces_) {
-            if (surface->contains(position)) {
-                double z = surface->getZ(position);
-                profile.push_back(std::pair<double, double>(s, z));
-                if (z != 0)
-                    break;
-            }
+    const double start = std::max(desc.startStation, a->getStartStation());
+    const double end = std::min(desc.endStation, a->getEndStation());
+    if (!hasSurfaces() || !(desc.step > 0) || !(start < end))
+        return profile;
+
+    // Stations start + i * step below the end station.
+    long long sampleCount = static_cast<long long>(std::ceil((end - start) / desc.step));
+    while (sampleCount > 1 && start + (sampleCount - 1) * desc.step >= end)
+        sampleCount--;
+
+    const long long chunkSize = 1024;
+    const int chunkCount = static_cast<int>((sampleCount + chunkSize - 1) / chunkSize);
+    const int threadCount = desc.threadCount > 0 ? desc.threadCount : omp_get_max_threads();
+
+    std::vector<std::vector<std::pair<double, double>>> chunks(chunkCount);
+
+#pragma omp parallel num_threads(threadCount)
+    {
+        SurfaceProfileSampler sampler(*this, *a, desc);
+
+#pragma omp for schedule(dynamic)
+        for (int c = 0; c < chunkCount; c++) {
+            const long long first = c * chunkSize;
+            const long long last = std::min(first + chunkSize, sampleCount);
+            sampler.sampleChunk(start, end, first, last, chunks[c]);
         }
     }
+
+    for (const auto& chunk : chunks)
+        profile.insert(profile.end(), chunk.begin(), chunk.end());
+
     return profile;
 }
 
+EarthworkResult DigitalElevationModel::computeEarthwork(buw::ReferenceCounted<buw::Surface> design, const EarthworkDescription& desc) const {
+    EarthworkResult result;
+    if (!hasSurfaces() || !design || design->getTriangleCount() == 0 || !(desc.cellSize > 0))
+        return result;
+
+    const buw::Vector3d boundsMin = design->getBoundsMin();
+    const buw::Vector3d boundsMax = design->getBoundsMax();
+    const int columnCount = std::max(1, static_cast<int>(std::ceil((boundsMax.x() - boundsMin.x()) / desc.cellSize)));
+    const int rowCount = std::max(1, static_cast<int>(std::ceil((boundsMax.y() - boundsMin.y()) / desc.cellSize)));
+    const int threadCount = desc.threadCount > 0 ? desc.threadCount : omp_get_max_threads();
+    const double area = desc.cellSize * desc.cellSize;
+
+    double cut = 0, fill = 0;
+
+#pragma omp parallel num_threads(threadCount) reduction(+ : cut, fill)
+    {
+        HeightSampler terrain(*this);
+        SurfaceDesign localDesign(design);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int y = 0; y < rowCount; y++) {
+            for (int x = 0; x < columnCount; x++) {
+                const buw::Vector2d center(boundsMin.x() + (x + 0.5) * desc.cellSize, boundsMin.y() + (y + 0.5) * desc.cellSize);
+
+                double existingHeight = 0, designHeight = 0;
+                if (!localDesign.getHeight(0, 0, center, designHeight) || !terrain.getHeight(center, existingHeight))
+                    continue;
+
+                const double difference = designHeight - existingHeight;
+                if (difference > 0)
+                    fill += difference * area;
+                else
+                    cut -= difference * area;
+            }
+        }
+    }
+
+    result.cut = cut;
+    result.fill = fill;
+    return result;
+}
+
+EarthworkResult DigitalElevationModel::computeEarthwork(buw::ReferenceCounted<buw::IAlignment3D> a, buw::ReferenceCounted<buw::Surface> design, const EarthworkDescription& desc) const {
+    if (!design)
+        return EarthworkResult();
+
+    return computeCorridorEarthwork(*this, *a, SurfaceDesign(design), desc.corridorWidth, desc);
+}
+
+EarthworkResult DigitalElevationModel::computeEarthwork(buw::ReferenceCounted<Alignment2DBased3D> a, const EarthworkDescription& desc) const {
+    RoadBodyDesign design(*a);
+
+    // Whole cells to both sides of the alignment, so that borders of the body at multiples of the cell size are borders of the cells as well.
+    const double width = std::min(desc.corridorWidth, std::ceil(design.getWidth() / desc.cellSize) * desc.cellSize);
+    return computeCorridorEarthwork(*this, *a, design, width, desc);
+}
+
 double DigitalElevationModel::getHeightAtPosition(buw::Vector2d position) const {
     double z = 0;
+    tryGetHeightAtPosition(position, z);
+    return z;
+}
+
+bool DigitalElevationModel::tryGetHeightAtPosition(const buw::Vector2d& position, double& o_z) const {
+    std::shared_ptr<const SurfaceFootprintIndex> index = getFootprintIndex();
+
+    return index->findEntry(position, [&](const int rank) {
+        const SurfaceFootprintIndex::Entry& entry = index->getEntry(rank);
+        if (entry.bRaster)
+            return rasterSurfaces_[entry.index]->tryGetZ(position, o_z);
+        return surfaces_[entry.index]->tryGetZ(position, o_z);
+    }) >= 0;
+}
+
+buw::ReferenceCounted<buw::Surface> DigitalElevationModel::mergeSurfaces() const {
+    std::shared_ptr<const SurfaceFootprintIndex> index = getFootprintIndex();
+    const int rankCount = index->getEntryCount();
+
+    // Returns the smallest rank below 'maxRank' of the surfaces containing the position, or -1.
+    auto findCoveringRank = [&](const buw::Vector2d& p, const int maxRank) {
+        double z = 0;
+        return index->findEntry(p, [&](const int rank) {
+            if (rank >= maxRank)
+                return false;
+
+            const SurfaceFootprintIndex::Entry& entry = index->getEntry(rank);
+            return entry.bRaster ? rasterSurfaces_[entry.index]->tryGetZ(p, z) : surfaces_[entry.index]->tryGetZ(p, z);
+        });
+    };
+
+    std::vector<buw::Vector3d> points;
+    std::vector<std::vector<buw::Vector3d>> breakLines;
+
+    for (int rank = 0; rank < rankCount; rank++) {
+        const SurfaceFootprintIndex::Entry& entry = index->getEntry(rank);
+        buw::ReferenceCounted<buw::Surface> surface = entry.bRaster ? rasterSurfaces_[entry.index]->createSurface() : surfaces_[entry.index];
+
+        const std::vector<buw::Vector3d>& surfacePoints = surface->getPoints();
+        const std::vector<buw::Vector3i>& triangles = surface->getTriangeFaces();
+        const int pointCount = static_cast<int>(surfacePoints.size());
+        const int triangleCount = static_cast<int>(triangles.size());
+
+        // Points covered by a surface with a higher priority are left out, as are triangles with such a corner or center.
+        std::vector<char> covered(pointCount, 0);
+        std::vector<char> kept(triangleCount, 0);
+        if (rank > 0) {
+#pragma omp parallel for schedule(dynamic, 1024)
+            for (int i = 0; i < pointCount; i++)
+                covered[i] = findCoveringRank(surfacePoints[i].block<2, 1>(0, 0), rank) >= 0;
+        }
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int i = 0; i < triangleCount; i++) {
+            const buw::Vector3i& t = triangles[i];
+            if (covered[t[0]] || covered[t[1]] || covered[t[2]])
+                continue;
+
+            const buw::Vector2d center = ((surfacePoints[t[0]] + surfacePoints[t[1]] + surfacePoints[t[2]]) / 3.0).block<2, 1>(0, 0);
+            kept[i] = rank == 0 || findCoveringRank(center, rank) < 0;
+        }
+
+        // All uncovered points of the triangles are used, so the gaps along the clipped borders are filled with terrain points.
+        std::vector<char> used(pointCount, 0);
+        for (const auto& t : triangles)
+            used[t[0]] = used[t[1]] = used[t[2]] = 1;
+
+        for (int i = 0; i < pointCount; i++) {
+            if (used[i] && !covered[i])
+                points.push_back(surfacePoints[i]);
+        }
+
+        // The edges of the kept triangles become break lines, so the triangulation keeps these triangles.
+        std::vector<std::pair<int, int>> keptEdges;
+        for (int i = 0; i < triangleCount; i++) {
+            if (!kept[i])
+                continue;
 
-    for (buw::ReferenceCounted<buw::Surface> surface : surfaces_) {
-        if (surface->contains(position)) {
-            z = surface->getZ(position);
-            if (z != 0)
-                break;
+            for (int k = 0; k < 3; k++) {
+                const int a = triangles[i][k];
+                const int b = triangles[i][(k + 1) % 3];
+                keptEdges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+            }
         }
+        std::sort(keptEdges.begin(), keptEdges.end());
+        keptEdges.erase(std::unique(keptEdges.begin(), keptEdges.end()), keptEdges.end());
+
+        for (const auto& edge : keptEdges)
+            breakLines.push_back({ surfacePoints[edge.first], surfacePoints[edge.second] });
     }
 
-    return z;
+    DelaunayTriangulation triangulation(points, breakLines);
+    const std::vector<buw::Vector3d>& triangulatedPoints = triangulation.getPoints();
+    const std::vector<buw::Vector3i> triangles = triangulation.getTriangles();
+
+    // The triangulation covers the convex hull, triangles whose center lies outside of all surfaces are removed.
+    std::vector<char> inside(triangles.size(), 0);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < static_cast<int>(triangles.size()); i++) {
+        const buw::Vector3i& t = triangles[i];
+        const buw::Vector2d center = ((triangulatedPoints[t[0]] + triangulatedPoints[t[1]] + triangulatedPoints[t[2]]) / 3.0).block<2, 1>(0, 0);
+        inside[i] = findCoveringRank(center, rankCount) >= 0;
+    }
+
+    std::vector<int> pointIndex(triangulatedPoints.size(), -1);
+    std::vector<buw::Vector3d> mergedPoints;
+    std::vector<buw::Vector3i> mergedTriangles;
+    for (size_t i = 0; i < triangles.size(); i++) {
+        if (!inside[i])
+            continue;
+
+        buw::Vector3i t = triangles[i];
+        for (int k = 0; k < 3; k++) {
+            if (pointIndex[t[k]] < 0) {
+                pointIndex[t[k]] = static_cast<int>(mergedPoints.size());
+                mergedPoints.push_back(triangulatedPoints[t[k]]);
+            }
+            t[k] = pointIndex[t[k]];
+        }
+        mergedTriangles.push_back(t);
+    }
+
+    buw::ReferenceCounted<buw::Surface> merged = std::make_shared<buw::Surface>();
+    merged->setName("Merged surface");
+    merged->setPoints(mergedPoints);
+    merged->setTriangles(mergedTriangles);
+    return merged;
 }
 
 void DigitalElevationModel::updateMinMax(const buw::Vector3d& position, buw::Vector3d& minPos, buw::Vector3d& maxPos) const {
@@ -115,6 +765,50 @@ void DigitalElevationModel::updateMinMax(const buw::Vector3d& position, buw::Vec
     }
 }
 
+std::vector<ContourLine> DigitalElevationModel::createContours(const ContourDescription& desc) const {
+    std::vector<ContourLine> contours;
+    for (const auto& surface : surfaces_) {
+        std::vector<ContourLine> lines = buw::createContours(*surface, desc);
+        std::move(lines.begin(), lines.end(), std::back_inserter(contours));
+    }
+    for (const auto& raster : rasterSurfaces_) {
+        std::vector<ContourLine> lines = buw::createContours(*raster, desc);
+        std::move(lines.begin(), lines.end(), std::back_inserter(contours));
+    }
+    return contours;
+}
+
+buw::ReferenceCounted<RasterSurface> DigitalElevationModel::createRasterSurface(const double cellSize, const int threadCount) const {
+    buw::Vector3d extendMinimum;
+    buw::Vector3d extendMaximum;
+    getSurfacesExtend(extendMinimum, extendMaximum);
+
+    int width = 0;
+    int height = 0;
+    if (cellSize > 0.0 && hasSurfaces()) {
+        width = static_cast<int>(std::floor((extendMaximum.x() - extendMinimum.x()) / cellSize)) + 1;
+        height = static_cast<int>(std::floor((extendMaximum.y() - extendMinimum.y()) / cellSize)) + 1;
+    }
+
+    buw::ReferenceCounted<RasterSurface> raster = std::make_shared<RasterSurface>(width, height, buw::Vector2d(extendMinimum.x(), extendMinimum.y()), cellSize);
+    raster->setName("Terrain");
+
+    // Build the index before the threads need it.
+    getFootprintIndex();
+
+    const int threads = threadCount > 0 ? threadCount : omp_get_max_threads();
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double z = 0.0;
+            if (tryGetHeightAtPosition(raster->getOrigin() + buw::Vector2d(x * cellSize, y * cellSize), z))
+                raster->setHeight(x, y, static_cast<float>(z));
+        }
+    }
+
+    return raster;
+}
+
 double DigitalElevationModel::getMinimumHeight() const {
     buw::Vector3d extendMinimum;
     buw::Vector3d extendMaximum;
@@ -143,7 +837,9 @@ void DigitalElevationModel::deleteSurface(buw::ReferenceCounted<buw::Surface> s)
     BLUE_ASSERT(iterator != surfaces_.end(), "Invalid surface");
 
     if (iterator != surfaces_.end()) {
+        surfacePriorities_.erase(surfacePriorities_.begin() + (iterator - surfaces_.begin()));
         surfaces_.erase(iterator);
+        invalidateFootprintIndex();
     } else {
         throw std::runtime_error("Deletion of alignment failed.");
     }
@@ -161,82 +857,16 @@ const std::vector<std::vector<buw::Vector3d>>& DigitalElevationModel::getBreakLi
     return breakLines_;
 }
 
-// http://guido.vonrudorff.de/qhull-minimal-example/
-// http://www.gamedev.net/topic/250932-convex-hull/
-// http://www.codeproject.com/Articles/6751/Delaunay-s-TIN-Triangulated-Irregular-Network
-extern "C" {
-
-#include "libqhull/io.h"
-#include "libqhull/libqhull.h"
-#include "libqhull/qset.h"
+buw::ReferenceCounted<buw::Surface> createSurfaceFromXYZPoints(const std::vector<buw::Vector3d>& positions) {
+    return createSurfaceFromXYZPoints(positions, std::vector<std::vector<buw::Vector3d>>());
 }
 
-buw::ReferenceCounted<buw::Surface> createSurfaceFromXYZPoints(const std::vector<buw::Vector3d>& positions) {
+buw::ReferenceCounted<buw::Surface> createSurfaceFromXYZPoints(const std::vector<buw::Vector3d>& positions, const std::vector<std::vector<buw::Vector3d>>& breakLines) {
     buw::ReferenceCounted<buw::Surface> s = std::make_shared<buw::Surface>();
 
-    buw::Vector2d min(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
-    for (auto& pos : positions) {
-        min.x() = std::min(min.x(), pos.x());
-        min.y() = std::min(min.y(), pos.y());
-    }
-
-    std::vector<buw::Vector2d> positions2;
-    for (auto& pos : positions) {
-        positions2.push_back(buw::Vector2d(pos.x() - min.x(), pos.y() - min.y()));
-    }
-
-    for (int i = 0; i < positions.size(); i++) {
-        s->addPoint(positions[i]);
-    }
-
-    if (positions.size() >= 4) {
-        if (true) {
-            char flags[250];
-
-            FILE* outfile = stdout;
-            FILE* errfile = stderr;
-
-            double* ptr = &(positions2[0].x());
-
-            sprintf_s(flags, "qhull QJ");
-            int exitcode = qh_new_qhull(2, (int)positions.size(), ptr, false, flags, outfile, errfile);
-
-            std::set<int> ignoreVertices;
-            if (!exitcode) {
-                int i = 0;
-                vertexT *vertex, **vertexp;
-                ;
-                FORALLvertices {
-                    ignoreVertices.insert(qh_pointid(vertex->point));
-                }
-            }
-
-            sprintf_s(flags, "qhull d QJ");
-            exitcode = qh_new_qhull(2, (int)positions.size(), ptr, false, flags, outfile, errfile);
-            if (!exitcode) {
-                facetT* facet;
-                FORALLfacets {
-                    vertexT *vertex, **vertexp;
-                    buw::Vector3i indices;
-
-                    int i = facet->toporient ^ qh_ORIENTclock ? 0 : 2;
-                    FOREACHvertex_(facet->vertices) {
-                        indices[i] = qh_pointid(vertex->point);
-
-                        i += facet->toporient ^ qh_ORIENTclock ? 1 : -1;
-                    }
-
-                    bool ignore = ignoreVertices.find(indices[0]) != ignoreVertices.end() && ignoreVertices.find(indices[1]) != ignoreVertices.end()
-                                  && ignoreVertices.find(indices[2]) != ignoreVertices.end();
-
-                    if (!ignore)
-                        s->addTriangle(indices);
-                }
-            } else {
-                assert(false);
-            };
-        }
-    }
+    DelaunayTriangulation triangulation(positions, breakLines);
+    s->setPoints(triangulation.getPoints());
+    s->setTriangles(triangulation.getTriangles());
 
     return s;
 }
@@ -20,39 +20,167 @@
 #define OpenInfraPlatform_Infrastructure_DigitalElevationModel_8b94f7d0_a5fc_4ba4_ab63_f15df1bd6515_h
 
 #include "OpenInfraPlatform/Infrastructure/Alignment/IAlignment3D.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Contour.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
 #include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
 #include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
 #include "OpenInfraPlatform/Infrastructure/namespace.h"
 #include <BlueFramework/Rasterizer/vertex.h>
 #include <boost/noncopyable.hpp>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
+class Alignment2DBased3D;
+class SurfaceFootprintIndex;
+
+//! Describes how the surface profile along an alignment is sampled.
+struct SurfaceProfileDescription {
+	//! Station range, clamped to the range of the alignment.
+	Stationing startStation = -std::numeric_limits<double>::infinity();
+	Stationing endStation = std::numeric_limits<double>::infinity();
+
+	//! Distance between two samples.
+	double step = 0.5;
+
+	//! If greater than 0, each step is bisected until the linear interpolation deviates less than 'tolerance' from the terrain or 'minimumStep' is reached.
+	//! The minimum step is at least 'step' / 1024, so a step is bisected at most ten times.
+	double tolerance = 0.0;
+	double minimumStep = 0.05;
+
+	//! Number of threads used for sampling, 0 uses all available.
+	int threadCount = 0;
+};
+
+//! Describes how cut and fill are computed.
+struct EarthworkDescription {
+	//! Station range, clamped to the range of the alignment.
+	Stationing startStation = -std::numeric_limits<double>::infinity();
+	Stationing endStation = std::numeric_limits<double>::infinity();
+
+	//! Length of the reported station intervals, their borders are multiples of it.
+	double stationInterval = 20.0;
+
+	//! Edge length of the cells in which the height difference is sampled at the center.
+	double cellSize = 0.5;
+
+	//! Width of the corridor to the left and right of the alignment. Road bodies limit it to their own width.
+	double corridorWidth = 50.0;
+
+	//! Factor applied to the cut for the mass haul, e.g. below 1 if the material is compacted again.
+	double cutFactor = 1.0;
+
+	//! Number of threads, 0 uses all available.
+	int threadCount = 0;
+};
+
+struct EarthworkInterval {
+	Stationing startStation;
+	Stationing endStation;
+
+	//! Volumes in the interval.
+	double cut;
+	double fill;
+
+	//! Mass haul ordinate at the end of the interval, the sum of the cut times the cut factor minus the fill since the start.
+	double massOrdinate;
+};
+
+struct EarthworkResult {
+	double cut = 0.0;
+	double fill = 0.0;
+
+	//! Intervals along the alignment, empty if no alignment is used.
+	std::vector<EarthworkInterval> intervals;
+};
+
 //! A digital terrain model exists of a number of surfaces.
 class BLUEINFRASTRUCTURE_API DigitalElevationModel {
 public:
 	static DigitalElevationModel* createFlatCopy(const DigitalElevationModel& src);
 
 	DigitalElevationModel();
+	DigitalElevationModel(const DigitalElevationModel& other);
 
 	virtual ~DigitalElevationModel();
 
+	DigitalElevationModel& operator=(const DigitalElevationModel& other);
+
 	void addSurface(buw::ReferenceCounted<buw::Surface> surface);
 
+	//! Returns true if there is a triangulated or a raster surface.
 	bool hasSurfaces() const;
 	int getSurfaceCount() const;
 	buw::ReferenceCounted<buw::Surface> getSurface(const int index) const;
 
 	const std::vector<buw::ReferenceCounted<buw::Surface>>& getSurfaces() const;
 
+	//! Raster surfaces are queried after the triangulated surfaces and triangulated on demand for rendering.
+	void addRasterSurface(buw::ReferenceCounted<buw::RasterSurface> surface);
+
+	const std::vector<buw::ReferenceCounted<buw::RasterSurface>>& getRasterSurfaces() const;
+
+	void deleteRasterSurface(buw::ReferenceCounted<buw::RasterSurface> s);
+
+	//! Returns the triangulated surfaces followed by the raster surfaces triangulated on the fly, e.g. for exporters which write triangles.
+	std::vector<buw::ReferenceCounted<buw::Surface>> getTriangulatedSurfaces() const;
+
+	//! Where surfaces overlap, the one with the highest priority defines the height. At equal priority triangulated surfaces come before raster
+	//! surfaces and surfaces added earlier first. New surfaces get priority 0.
+	void setSurfacePriority(buw::ReferenceCounted<buw::Surface> surface, const int priority);
+	void setSurfacePriority(buw::ReferenceCounted<buw::RasterSurface> surface, const int priority);
+
+	int getSurfacePriority(buw::ReferenceCounted<buw::Surface> surface) const;
+	int getSurfacePriority(buw::ReferenceCounted<buw::RasterSurface> surface) const;
+
+	//! Returns the index over the footprints of the surfaces in the order of their priority. It is built on the first call after the surfaces or
+	//! their priorities changed, surfaces must not be modified after they are added.
+	std::shared_ptr<const SurfaceFootprintIndex> getFootprintIndex() const;
+
 	void getSurfacesExtend(buw::Vector3d& minimalPosition, buw::Vector3d& maximalPosition) const;
 
 	buw::Vector3d getCenterPoint() const;
 
+	//! Returns pairs of station and height every 0.5 m along the alignment. Stations outside of all surfaces are skipped.
 	std::vector<std::pair<double, double>> getSurfaceProfile(buw::ReferenceCounted<buw::IAlignment3D> a) const;
+
+	//! Samples the profile in chunks of stations in parallel. Each chunk evaluates the alignment positions first and walks through the surfaces from the last hit triangle.
+	std::vector<std::pair<double, double>> getSurfaceProfile(buw::ReferenceCounted<buw::IAlignment3D> a, const SurfaceProfileDescription& desc) const;
+
+	//! Returns the height of the surface with the highest priority containing the position, or 0 if there is none.
 	double getHeightAtPosition(buw::Vector2d position) const;
 
+	//! Like getHeightAtPosition, but returns false if no surface contains the position, so terrain at height 0 is found as well.
+	bool tryGetHeightAtPosition(const buw::Vector2d& position, double& o_z) const;
+
+	//! Merges all surfaces into one triangulated surface. Parts of a surface covered by a surface with a higher priority are clipped, the
+	//! remaining triangles are kept as break lines and the gaps along the clipped borders are triangulated. Triangles outside of all surfaces
+	//! are left out.
+	buw::ReferenceCounted<buw::Surface> mergeSurfaces() const;
+
+	//! Computes cut and fill between the surfaces of this model as existing terrain and the design surface on a grid over the design. Only cells
+	//! covered by both are summed up. The rows of the grid are computed in parallel.
+	EarthworkResult computeEarthwork(buw::ReferenceCounted<buw::Surface> design, const EarthworkDescription& desc) const;
+
+	//! Computes cut and fill against the design surface in the corridor of the alignment per station interval including the mass haul. The
+	//! corridor is divided into cells of station and offset, so the corridor should not be wider than the smallest radius.
+	EarthworkResult computeEarthwork(buw::ReferenceCounted<buw::IAlignment3D> a, buw::ReferenceCounted<buw::Surface> design, const EarthworkDescription& desc) const;
+
+	//! Computes cut and fill against the road body of the alignment. The lower side of the closed design cross sections, whose heights are
+	//! relative to the alignment, is interpolated linearly between two cross sections at the same offset, offsets outside of the body of one of
+	//! them are left out.
+	EarthworkResult computeEarthwork(buw::ReferenceCounted<Alignment2DBased3D> a, const EarthworkDescription& desc) const;
+
+	//! Extracts the contours of all triangulated and raster surfaces, see createContours.
+	std::vector<ContourLine> createContours(const ContourDescription& desc) const;
+
+	//! Samples the height at the corners of cells of size 'cellSize' over the extent of all surfaces, e.g. for a terrain analysis. Positions
+	//! outside of all surfaces have no data. The rows are sampled in parallel.
+	buw::ReferenceCounted<RasterSurface> createRasterSurface(const double cellSize, const int threadCount = 0) const;
+
 	double getMinimumHeight() const;
 
 	double getMaximumHeight() const;
@@ -68,17 +196,33 @@ public:
 private:
 	void updateMinMax(const buw::Vector3d& position, buw::Vector3d& minPos, buw::Vector3d& maxPos) const;
 
+	void invalidateFootprintIndex();
+
 private:
 	std::vector<buw::ReferenceCounted<buw::Surface>> surfaces_;
+	std::vector<buw::ReferenceCounted<buw::RasterSurface>> rasterSurfaces_;
+	std::vector<int> surfacePriorities_;
+	std::vector<int> rasterPriorities_;
 	std::vector<std::vector<buw::Vector3d>> breakLines_;
+
+	// index over the surface footprints, built lazily and reset when the surfaces or their priorities change
+	mutable std::shared_ptr<const SurfaceFootprintIndex> footprintIndex_;
+	mutable std::mutex footprintIndexMutex_;
 }; // end class DigitalElevationModel
 
 BLUEINFRASTRUCTURE_API buw::ReferenceCounted<Surface> createSurfaceFromXYZPoints(const std::vector<buw::Vector3d>& positions);
 
+//! Triangulates the positions with a Delaunay triangulation in which the break lines are edges, e.g. kerbs and ditches. The vertices of the break lines are added to the surface.
+BLUEINFRASTRUCTURE_API buw::ReferenceCounted<Surface> createSurfaceFromXYZPoints(const std::vector<buw::Vector3d>& positions, const std::vector<std::vector<buw::Vector3d>>& breakLines);
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
 
 namespace buw {
 	using OpenInfraPlatform::Infrastructure::DigitalElevationModel;
+	using OpenInfraPlatform::Infrastructure::SurfaceProfileDescription;
+	using OpenInfraPlatform::Infrastructure::EarthworkDescription;
+	using OpenInfraPlatform::Infrastructure::EarthworkInterval;
+	using OpenInfraPlatform::Infrastructure::EarthworkResult;
 	using OpenInfraPlatform::Infrastructure::createSurfaceFromXYZPoints;
 } // namespace buw
 
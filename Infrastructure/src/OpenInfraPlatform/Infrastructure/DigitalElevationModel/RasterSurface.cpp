@@ -0,0 +1,235 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+RasterSurface::RasterSurface(const int width, const int height, const buw::Vector2d& origin, const double cellSize) :
+	width_(std::max(width, 0)),
+	height_(std::max(height, 0)),
+	origin_(origin),
+	cellSize_(cellSize),
+	heights_(static_cast<size_t>(std::max(width, 0)) * std::max(height, 0), std::numeric_limits<float>::quiet_NaN())
+{
+}
+
+RasterSurface::~RasterSurface()
+{
+
+}
+
+int RasterSurface::getWidth() const
+{
+	return width_;
+}
+
+int RasterSurface::getHeight() const
+{
+	return height_;
+}
+
+const buw::Vector2d& RasterSurface::getOrigin() const
+{
+	return origin_;
+}
+
+double RasterSurface::getCellSize() const
+{
+	return cellSize_;
+}
+
+void RasterSurface::setHeight(const int x, const int y, const float height)
+{
+	heights_[static_cast<size_t>(y) * width_ + x] = height;
+}
+
+float RasterSurface::getHeight(const int x, const int y) const
+{
+	return heights_[static_cast<size_t>(y) * width_ + x];
+}
+
+void RasterSurface::setNoData(const int x, const int y)
+{
+	setHeight(x, y, std::numeric_limits<float>::quiet_NaN());
+}
+
+bool RasterSurface::isNoData(const int x, const int y) const
+{
+	return std::isnan(getHeight(x, y));
+}
+
+const std::vector<float>& RasterSurface::getHeights() const
+{
+	return heights_;
+}
+
+bool RasterSurface::contains(const buw::Vector2d& p) const
+{
+	return width_ > 1 && height_ > 1 &&
+		p.x() >= origin_.x() && p.y() >= origin_.y() &&
+		p.x() <= origin_.x() + (width_ - 1) * cellSize_ && p.y() <= origin_.y() + (height_ - 1) * cellSize_;
+}
+
+double RasterSurface::getZ(const buw::Vector2d& xy) const
+{
+	double z = 0;
+	tryGetZ(xy, z);
+	return z;
+}
+
+bool RasterSurface::tryGetZ(const buw::Vector2d& xy, double& o_z) const
+{
+	if (!contains(xy))
+		return false;
+
+	const double fx = (xy.x() - origin_.x()) / cellSize_;
+	const double fy = (xy.y() - origin_.y()) / cellSize_;
+	const int x = std::min(static_cast<int>(fx), width_ - 2);
+	const int y = std::min(static_cast<int>(fy), height_ - 2);
+	const double tx = fx - x;
+	const double ty = fy - y;
+
+	const float* row = &heights_[static_cast<size_t>(y) * width_ + x];
+	const double h00 = row[0];
+	const double h10 = row[1];
+	const double h01 = row[width_];
+	const double h11 = row[width_ + 1];
+	if (std::isnan(h00) || std::isnan(h10) || std::isnan(h01) || std::isnan(h11))
+		return false;
+
+	o_z = (1 - ty) * ((1 - tx) * h00 + tx * h10) + ty * ((1 - tx) * h01 + tx * h11);
+	return true;
+}
+
+buw::Vector3d RasterSurface::getBoundsMin() const
+{
+	double minHeight = std::numeric_limits<double>::max();
+	for (float h : heights_)
+	{
+		if (!std::isnan(h))
+			minHeight = std::min(minHeight, static_cast<double>(h));
+	}
+	return buw::Vector3d(origin_.x(), origin_.y(), minHeight);
+}
+
+buw::Vector3d RasterSurface::getBoundsMax() const
+{
+	double maxHeight = std::numeric_limits<double>::lowest();
+	for (float h : heights_)
+	{
+		if (!std::isnan(h))
+			maxHeight = std::max(maxHeight, static_cast<double>(h));
+	}
+	return buw::Vector3d(origin_.x() + std::max(width_ - 1, 0) * cellSize_, origin_.y() + std::max(height_ - 1, 0) * cellSize_, maxHeight);
+}
+
+void RasterSurface::setName(const char* str)
+{
+	name_ = std::string(str);
+}
+
+const char* RasterSurface::getName() const
+{
+	return name_.c_str();
+}
+
+buw::ReferenceCounted<Surface> RasterSurface::createSurface(const int x0, const int y0, const int x1, const int y1, const int step) const
+{
+	buw::ReferenceCounted<Surface> s = std::make_shared<Surface>();
+	s->setName(name_.c_str());
+
+	const int stride = std::max(step, 1);
+	const int xBegin = std::max(x0, 0);
+	const int yBegin = std::max(y0, 0);
+	const int xEnd = std::min(x1, width_ - 1);
+	const int yEnd = std::min(y1, height_ - 1);
+	if (xBegin >= xEnd || yBegin >= yEnd)
+		return s;
+
+	// Sample columns and rows, the last one is always included so the tiles fit together.
+	std::vector<int> columns;
+	for (int x = xBegin; x < xEnd; x += stride)
+		columns.push_back(x);
+	columns.push_back(xEnd);
+
+	std::vector<int> rows;
+	for (int y = yBegin; y < yEnd; y += stride)
+		rows.push_back(y);
+	rows.push_back(yEnd);
+
+	const int columnCount = static_cast<int>(columns.size());
+	std::vector<buw::Vector3d> points;
+	points.reserve(columns.size() * rows.size());
+	for (int y : rows)
+	{
+		for (int x : columns)
+		{
+			const float h = getHeight(x, y);
+			points.push_back(buw::Vector3d(origin_.x() + x * cellSize_, origin_.y() + y * cellSize_, std::isnan(h) ? 0.0 : h));
+		}
+	}
+
+	std::vector<buw::Vector3i> triangles;
+	triangles.reserve(2 * (columns.size() - 1) * (rows.size() - 1));
+	for (int j = 0; j + 1 < static_cast<int>(rows.size()); j++)
+	{
+		for (int i = 0; i + 1 < columnCount; i++)
+		{
+			if (isNoData(columns[i], rows[j]) || isNoData(columns[i + 1], rows[j]) || isNoData(columns[i], rows[j + 1]) || isNoData(columns[i + 1], rows[j + 1]))
+				continue;
+
+			// Same diagonal as Surface::createFromHeightmap.
+			const int a = i + j * columnCount;
+			const int b = i + (j + 1) * columnCount;
+			const int c = (i + 1) + j * columnCount;
+			const int d = (i + 1) + (j + 1) * columnCount;
+			triangles.push_back(buw::Vector3i(a, b, c));
+			triangles.push_back(buw::Vector3i(c, b, d));
+		}
+	}
+
+	s->setPoints(points);
+	s->setTriangles(triangles);
+	return s;
+}
+
+buw::ReferenceCounted<Surface> RasterSurface::createSurface(const int step) const
+{
+	return createSurface(0, 0, width_ - 1, height_ - 1, step);
+}
+
+std::vector<buw::ReferenceCounted<Surface>> RasterSurface::createTiles(const int tileSize, const int step) const
+{
+	std::vector<buw::ReferenceCounted<Surface>> tiles;
+	const int size = std::max(tileSize, 1);
+	for (int y = 0; y < height_ - 1; y += size)
+	{
+		for (int x = 0; x < width_ - 1; x += size)
+		{
+			tiles.push_back(createSurface(x, y, x + size, y + size, step));
+		}
+	}
+	return tiles;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -0,0 +1,115 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_RasterSurface_9a4e6c21_3b7d_4f58_a0c2_6d1e8b5f9374_h
+#define OpenInfraPlatform_Infrastructure_RasterSurface_9a4e6c21_3b7d_4f58_a0c2_6d1e8b5f9374_h
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <BlueFramework/ImageProcessing/Image.h>
+#include <BlueFramework/ImageProcessing/ColorConverter.h>
+#include <string>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Terrain stored as heights on a regular grid. Sample (x, y) lies at origin + (x, y) * cellSize, samples without data are NaN. Heights are
+//! interpolated bilinearly in constant time, triangles are only created on demand, e.g. for rendering or export.
+class BLUEINFRASTRUCTURE_API RasterSurface
+{
+public:
+	//! Creates a raster with all samples set to no data.
+	RasterSurface(const int width, const int height, const buw::Vector2d& origin, const double cellSize);
+
+	virtual ~RasterSurface();
+
+	int getWidth() const;
+	int getHeight() const;
+
+	const buw::Vector2d& getOrigin() const;
+	double getCellSize() const;
+
+	void setHeight(const int x, const int y, const float height);
+	float getHeight(const int x, const int y) const;
+
+	void setNoData(const int x, const int y);
+	bool isNoData(const int x, const int y) const;
+
+	//! Returns all samples row by row, starting at the origin.
+	const std::vector<float>& getHeights() const;
+
+	//! Checks if a point is within the bounds of the raster.
+	bool contains(const buw::Vector2d& p) const;
+
+	//! Returns the bilinearly interpolated height, or 0 outside of the raster or if a surrounding sample has no data like Surface::getZ.
+	double getZ(const buw::Vector2d& xy) const;
+
+	//! Like getZ, but returns false instead of a height of 0 outside of the raster or next to a sample without data.
+	bool tryGetZ(const buw::Vector2d& xy, double& o_z) const;
+
+	buw::Vector3d getBoundsMin() const;
+	buw::Vector3d getBoundsMax() const;
+
+	void setName(const char* str);
+	const char* getName() const;
+
+	//! Triangulates the samples [x0, x1] x [y0, y1] using every 'step'-th sample, cells with a sample without data are left out.
+	buw::ReferenceCounted<Surface> createSurface(const int x0, const int y0, const int x1, const int y1, const int step = 1) const;
+
+	//! Triangulates the whole raster.
+	buw::ReferenceCounted<Surface> createSurface(const int step = 1) const;
+
+	//! Triangulates the raster in tiles of 'tileSize' cells, neighbouring tiles share their border samples.
+	std::vector<buw::ReferenceCounted<Surface>> createTiles(const int tileSize, const int step = 1) const;
+
+	//! Creates a raster with one sample per pixel of the image, centered at 'center'. The heights are the pixels converted to one channel.
+	template<typename T, size_t N> static RasterSurface* createFromHeightmap(const buw::Image<buw::Color<T, N>>& image, const double tileSize, const buw::Vector2d& center = buw::Vector2d::Zero())
+	{
+		RasterSurface* s = new RasterSurface(image.getWidth(), image.getHeight(), center - buw::Vector2d(image.getWidth() / 2.0 * tileSize, image.getHeight() / 2.0 * tileSize), tileSize);
+		s->setName("Heightmap terrain");
+
+		for (int y = 0; y < image.getHeight(); y++)
+		{
+			for (int x = 0; x < image.getWidth(); x++)
+			{
+				s->setHeight(x, y, buw::ColorConverter::convertTo<buw::Color1f>(image.getPixelColor(x, y))[0]);
+			}
+		}
+		return s;
+	}
+
+private:
+	int						width_;
+	int						height_;
+	buw::Vector2d			origin_;
+	double					cellSize_;
+	std::vector<float>		heights_;
+	std::string				name_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::RasterSurface;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_RasterSurface_9a4e6c21_3b7d_4f58_a0c2_6d1e8b5f9374_h
@@ -16,6 +16,7 @@
 */
 
 #include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/SurfaceIndex.h"
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
@@ -24,23 +25,46 @@ Surface::Surface()
 	clear();
 }
 
+Surface::Surface(const Surface& other)
+{
+	*this = other;
+}
+
 Surface::~Surface()
 {
 
 }
 
+Surface& Surface::operator=(const Surface& other)
+{
+	if (this != &other)
+	{
+		points_ = other.points_;
+		triangeIndices_ = other.triangeIndices_;
+		name_ = other.name_;
+		boundsMax_ = other.boundsMax_;
+		boundsMin_ = other.boundsMin_;
+
+		// The index only depends on points and triangles, so the copy can share it.
+		std::atomic_store(&index_, std::atomic_load(&other.index_));
+	}
+	return *this;
+}
+
 void Surface::clear()
 {
 	points_.clear();
 	triangeIndices_.clear();
+	invalidateIndex();
 	boundsMin_ = buw::Vector3d::Ones() * std::numeric_limits<double>::max();
-	boundsMax_ = buw::Vector3d::Ones() * std::numeric_limits<double>::min();
+	boundsMax_ = buw::Vector3d::Ones() * std::numeric_limits<double>::lowest();
 }
 
 void Surface::addPoint(const buw::Vector3d& p)
 {
 	updateBounds(p);
 	points_.push_back(p);
+	invalidateIndex();
 }
 
 void Surface::updateBounds(const buw::Vector3d& p)
@@ -66,13 +90,17 @@ bool Surface::pointInTriangle(buw::Vector2d& pt, int faceID) const
 	buw::Vector2d v2 = points_[face[1]].block<2,1>(0,0);
 	buw::Vector2d v3 = points_[face[2]].block<2,1>(0,0);
 
-	bool b1, b2, b3;
+	const double d1 = sign(pt, v1, v2);
+	const double d2 = sign(pt, v2, v3);
+	const double d3 = sign(pt, v3, v1);
 
-	b1 = sign(pt, v1, v2) < 0.0f;
-	b2 = sign(pt, v2, v3) < 0.0f;
-	b3 = sign(pt, v3, v1) < 0.0f;
+	// Points on an edge belong to both triangles, triangles without area contain no point.
+	if (d1 == 0 && d2 == 0 && d3 == 0)
+		return false;
 
-	return ((b1 == b2) && (b2 == b3));
+	const bool bNegative = d1 < 0 || d2 < 0 || d3 < 0;
+	const bool bPositive = d1 > 0 || d2 > 0 || d3 > 0;
+	return !(bNegative && bPositive);
 }
 
 double Surface::zRay(buw::Vector2d& xy, int faceID) const
@@ -102,14 +130,100 @@ double Surface::zRay(buw::Vector2d& xy, int faceID) const
 
 double Surface::getZ(buw::Vector2d& xy) const
 {
-	for (int i = 0; i < getTriangleCount(); i++)
+	double z = 0;
+	tryGetZ(xy, z);
+	return z;
+}
+
+double Surface::getZ(const buw::Vector2d& xy, int& hint) const
+{
+	double z = 0;
+	tryGetZ(xy, z, hint);
+	return z;
+}
+
+bool Surface::tryGetZ(const buw::Vector2d& xy, double& o_z) const
+{
+	buw::Vector2d position = xy;
+
+	// Only triangles whose bounding box contains the position are tested, the one with the smallest index wins as in a linear search.
+	int faceID = getIndex()->findTriangle(position, [&](int id) { return pointInTriangle(position, id); });
+	if (faceID >= 0)
+	{
+		o_z = zRay(position, faceID);
+		return true;
+	}
+	return false;
+}
+
+bool Surface::tryGetZ(const buw::Vector2d& xy, double& o_z, int& hint) const
+{
+	buw::Vector2d position = xy;
+	std::shared_ptr<const SurfaceIndex> index = getIndex();
+
+	int faceID = -1;
+	if (hint >= 0 && hint < getTriangleCount())
+		faceID = walkToTriangle(*index, position, hint);
+
+	if (faceID < 0)
+		faceID = index->findTriangle(position, [&](int id) { return pointInTriangle(position, id); });
+
+	if (faceID >= 0)
+	{
+		hint = faceID;
+		o_z = zRay(position, faceID);
+		return true;
+	}
+	return false;
+}
+
+int Surface::walkToTriangle(const SurfaceIndex& index, buw::Vector2d& xy, int faceID) const
+{
+	// Cross the first edge which separates the position from the opposite corner until no edge does. Gives up after a few steps or at the
+	// border, the index is used then.
+	for (int step = 0; step < 16; step++)
 	{
-		if (pointInTriangle(xy, i))
+		const buw::Vector3i& face = triangeIndices_[faceID];
+		int edge = -1;
+		for (int k = 0; k < 3 && edge < 0; k++)
 		{
-			return zRay(xy, i);
+			buw::Vector2d a = points_[face[k]].block<2, 1>(0, 0);
+			buw::Vector2d b = points_[face[(k + 1) % 3]].block<2, 1>(0, 0);
+			buw::Vector2d c = points_[face[(k + 2) % 3]].block<2, 1>(0, 0);
+			if (sign(xy, a, b) * sign(c, a, b) < 0)
+				edge = k;
 		}
+
+		if (edge < 0)
+			return pointInTriangle(xy, faceID) ? faceID : -1;
+
+		faceID = index.getNeighbour(faceID, edge);
+		if (faceID < 0)
+			return -1;
 	}
-	return 0;
+	return -1;
+}
+
+std::shared_ptr<const SurfaceIndex> Surface::getIndex() const
+{
+	std::shared_ptr<const SurfaceIndex> index = std::atomic_load(&index_);
+	if (index)
+		return index;
+
+	// Build the index only once if several threads query the surface at the same time.
+	std::lock_guard<std::mutex> lock(indexMutex_);
+	index = std::atomic_load(&index_);
+	if (!index)
+	{
+		index = std::make_shared<const SurfaceIndex>(points_, triangeIndices_);
+		std::atomic_store(&index_, index);
+	}
+	return index;
+}
+
+void Surface::invalidateIndex()
+{
+	std::atomic_store(&index_, std::shared_ptr<const SurfaceIndex>());
 }
 
 bool Surface::contains(buw::Vector2d& p) const
@@ -121,6 +235,7 @@ bool Surface::contains(buw::Vector2d& p) const
 void Surface::addTriangle(const buw::Vector3i& indices)
 {
 	triangeIndices_.push_back(indices);
+	invalidateIndex();
 }
 
 int Surface::getPointCount() const
@@ -173,7 +288,7 @@ int Surface::getTriangleCount() const
 void Surface::setPoints(const std::vector<buw::Vector3d>& points)
 {
 	boundsMin_ = buw::Vector3d::Ones() * std::numeric_limits<double>::max();
-	boundsMax_ = buw::Vector3d::Ones() * std::numeric_limits<double>::min();
+	boundsMax_ = buw::Vector3d::Ones() * std::numeric_limits<double>::lowest();
 
 	for (int i = 0; i < points.size(); i++)
 	{
@@ -181,6 +296,7 @@ void Surface::setPoints(const std::vector<buw::Vector3d>& points)
 	}
 
 	points_ = points;
+	invalidateIndex();
 }
 
 bool Surface::validate() const
@@ -205,6 +321,7 @@ bool Surface::validate() const
 void Surface::setTriangles(const std::vector<buw::Vector3i>& indices)
 {
 	triangeIndices_ = indices;
+	invalidateIndex();
 }
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
\ No newline at end of file
@@ -25,17 +25,24 @@
 #include <BlueFramework/ImageProcessing/Image.h>
 #include <BlueFramework/ImageProcessing/ColorConverter.h>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <BlueFramework/Rasterizer/IRenderSystem.h>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
 
+class SurfaceIndex;
+
 class BLUEINFRASTRUCTURE_API Surface
 {
 public:
 	Surface();
+	Surface(const Surface& other);
 	virtual ~Surface();
 
+	Surface& operator=(const Surface& other);
+
 	void clear();
 
 	static Surface* createFlatCopy(const Surface& src);
@@ -43,8 +50,18 @@ public:
 	//! Checks if a point is within the bounds of this specific surface element.
 	bool contains(buw::Vector2d& p) const;
 
+	//! Returns the height of the first triangle containing the position or 0. Uses a spatial index which is built on the first call, safe to call from many threads.
 	double getZ(buw::Vector2d& xy) const;				
 
+	//! Like getZ, but walks from the triangle 'hint' to the position first, which is fast for a sequence of close positions. 'hint' is set to the
+	//! triangle containing the position and kept if there is none, start with -1. On shared edges the height is equal, but the triangle may differ.
+	double getZ(const buw::Vector2d& xy, int& hint) const;
+
+	//! Like getZ, but returns false instead of a height of 0 if no triangle contains the position, so terrain at height 0 is found as well.
+	bool tryGetZ(const buw::Vector2d& xy, double& o_z) const;
+
+	bool tryGetZ(const buw::Vector2d& xy, double& o_z, int& hint) const;
+
 	// checks if all indices are valid
 	bool validate() const;
 
@@ -137,6 +154,12 @@ private:
 
 	void updateBounds(const buw::Vector3d& p);
 
+	int walkToTriangle(const SurfaceIndex& index, buw::Vector2d& xy, int faceID) const;
+
+	std::shared_ptr<const SurfaceIndex> getIndex() const;
+
+	void invalidateIndex();
+
 private:
 	std::vector<buw::Vector3d>			points_;
 	std::vector<buw::Vector3i>			triangeIndices_;
@@ -145,6 +168,10 @@ private:
 	// cached data
 	buw::Vector3d						boundsMax_;
 	buw::Vector3d						boundsMin_;
+
+	// spatial index over the triangles, built lazily and reset when the geometry changes
+	mutable std::shared_ptr<const SurfaceIndex>	index_;
+	mutable std::mutex					indexMutex_;
 };	
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
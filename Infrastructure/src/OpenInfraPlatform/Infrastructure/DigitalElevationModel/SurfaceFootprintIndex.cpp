@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/SurfaceFootprintIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+SurfaceFootprintIndex::SurfaceFootprintIndex(const std::vector<buw::ReferenceCounted<buw::Surface>>& surfaces, const std::vector<int>& surfacePriorities,
+	const std::vector<buw::ReferenceCounted<buw::RasterSurface>>& rasterSurfaces, const std::vector<int>& rasterPriorities)
+{
+	struct Candidate
+	{
+		int			priority;
+		Entry		entry;
+		Box			box;
+	};
+
+	std::vector<Candidate> candidates;
+	auto addCandidate = [&](const int priority, const bool bRaster, const int index, const buw::Vector3d& boundsMin, const buw::Vector3d& boundsMax)
+	{
+		if (!(boundsMin.x() <= boundsMax.x() && boundsMin.y() <= boundsMax.y()))
+			return;
+
+		Candidate candidate;
+		candidate.priority = priority;
+		candidate.entry.bRaster = bRaster;
+		candidate.entry.index = index;
+		candidate.box = { { boundsMin.x(), boundsMin.y() }, { boundsMax.x(), boundsMax.y() } };
+		candidates.push_back(candidate);
+	};
+
+	for (int i = 0; i < static_cast<int>(surfaces.size()); i++)
+	{
+		if (surfaces[i]->getTriangleCount() > 0)
+			addCandidate(surfacePriorities[i], false, i, surfaces[i]->getBoundsMin(), surfaces[i]->getBoundsMax());
+	}
+	for (int i = 0; i < static_cast<int>(rasterSurfaces.size()); i++)
+	{
+		if (rasterSurfaces[i]->getWidth() > 1 && rasterSurfaces[i]->getHeight() > 1)
+			addCandidate(rasterPriorities[i], true, i, rasterSurfaces[i]->getBoundsMin(), rasterSurfaces[i]->getBoundsMax());
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+	{
+		return std::make_tuple(-a.priority, a.entry.bRaster) < std::make_tuple(-b.priority, b.entry.bRaster);
+	});
+
+	for (const auto& candidate : candidates)
+	{
+		entries_.push_back(candidate.entry);
+		boxes_.push_back(candidate.box);
+	}
+
+	// About four cells per surface, so most cells hold only the few surfaces overlapping there.
+	const int count = static_cast<int>(boxes_.size());
+	double boundsMin[2] = { 0.0, 0.0 };
+	double boundsMax[2] = { 0.0, 0.0 };
+	for (int k = 0; k < 2; k++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			boundsMin[k] = i == 0 ? boxes_[i].min[k] : std::min(boundsMin[k], boxes_[i].min[k]);
+			boundsMax[k] = i == 0 ? boxes_[i].max[k] : std::max(boundsMax[k], boxes_[i].max[k]);
+		}
+
+		origin_[k] = boundsMin[k];
+		cellCount_[k] = std::max(1, std::min(64, 2 * static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))))));
+		cellSize_[k] = std::max(boundsMax[k] - boundsMin[k], 1e-9) / cellCount_[k];
+	}
+
+	auto cellRange = [&](const Box& box, const int k, int& first, int& last)
+	{
+		first = std::max(0, std::min(cellCount_[k] - 1, static_cast<int>(std::floor((box.min[k] - origin_[k]) / cellSize_[k]))));
+		last = std::max(0, std::min(cellCount_[k] - 1, static_cast<int>(std::floor((box.max[k] - origin_[k]) / cellSize_[k]))));
+	};
+
+	std::vector<int> cellCounts(cellCount_[0] * cellCount_[1] + 1, 0);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int rank = 0; rank < count; rank++)
+		{
+			int x0, x1, y0, y1;
+			cellRange(boxes_[rank], 0, x0, x1);
+			cellRange(boxes_[rank], 1, y0, y1);
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					const int cell = y * cellCount_[0] + x;
+					if (pass == 0)
+						cellCounts[cell + 1]++;
+					else
+						cellEntries_[cellCounts[cell]++] = rank;
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (size_t i = 1; i < cellCounts.size(); i++)
+				cellCounts[i] += cellCounts[i - 1];
+			cellStart_ = cellCounts;
+			cellEntries_.resize(cellCounts.back());
+		}
+	}
+}
+
+int SurfaceFootprintIndex::getEntryCount() const
+{
+	return static_cast<int>(entries_.size());
+}
+
+const SurfaceFootprintIndex::Entry& SurfaceFootprintIndex::getEntry(const int rank) const
+{
+	return entries_[rank];
+}
+
+int SurfaceFootprintIndex::getCell(const buw::Vector2d& p) const
+{
+	if (entries_.empty())
+		return -1;
+
+	int cell[2];
+	for (int k = 0; k < 2; k++)
+	{
+		const double f = std::floor((p[k] - origin_[k]) / cellSize_[k]);
+		if (!(f >= 0.0 && f <= cellCount_[k]))
+			return -1;
+
+		// The upper border belongs to the last cell.
+		cell[k] = std::min(static_cast<int>(f), cellCount_[k] - 1);
+	}
+	return cell[1] * cellCount_[0] + cell[0];
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
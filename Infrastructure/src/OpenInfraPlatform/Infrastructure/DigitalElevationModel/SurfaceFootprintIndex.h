@@ -0,0 +1,97 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_SurfaceFootprintIndex_e2a9c4f7_13b6_4d8e_a5f0_6c7b2d9e8a31_h
+#define OpenInfraPlatform_Infrastructure_SurfaceFootprintIndex_e2a9c4f7_13b6_4d8e_a5f0_6c7b2d9e8a31_h
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Two dimensional index over the bounding boxes of the surfaces of a digital elevation model. The surfaces are ranked by their priority, at
+//! equal priority triangulated surfaces come before raster surfaces and surfaces added earlier first. A uniform grid stores the ranks of the
+//! surfaces overlapping each cell in increasing order. Immutable after construction, so it can be queried from many threads at the same time.
+class SurfaceFootprintIndex
+{
+public:
+	struct Entry
+	{
+		bool	bRaster;
+
+		//! Index in the triangulated or the raster surfaces.
+		int		index;
+	};
+
+	SurfaceFootprintIndex(const std::vector<buw::ReferenceCounted<buw::Surface>>& surfaces, const std::vector<int>& surfacePriorities,
+		const std::vector<buw::ReferenceCounted<buw::RasterSurface>>& rasterSurfaces, const std::vector<int>& rasterPriorities);
+
+	//! Returns the number of ranked surfaces, surfaces without points are left out.
+	int getEntryCount() const;
+
+	const Entry& getEntry(const int rank) const;
+
+	//! Returns the smallest rank of the surfaces whose bounding box contains 'p' and for which 'contains' returns true, or -1 if there is none.
+	template<typename F> int findEntry(const buw::Vector2d& p, const F& contains) const
+	{
+		int cell = getCell(p);
+		if (cell < 0)
+			return -1;
+
+		for (int i = cellStart_[cell]; i < cellStart_[cell + 1]; i++)
+		{
+			int rank = cellEntries_[i];
+			if (boxes_[rank].contains(p) && contains(rank))
+				return rank;
+		}
+		return -1;
+	}
+
+private:
+	struct Box
+	{
+		double min[2];
+		double max[2];
+
+		bool contains(const buw::Vector2d& p) const
+		{
+			return p.x() >= min[0] && p.x() <= max[0] && p.y() >= min[1] && p.y() <= max[1];
+		}
+	};
+
+	int getCell(const buw::Vector2d& p) const;
+
+private:
+	std::vector<Entry>		entries_;
+	std::vector<Box>		boxes_;
+
+	double					origin_[2];
+	double					cellSize_[2];
+	int						cellCount_[2];
+	std::vector<int>		cellStart_;
+	std::vector<int>		cellEntries_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+#endif // end define OpenInfraPlatform_Infrastructure_SurfaceFootprintIndex_e2a9c4f7_13b6_4d8e_a5f0_6c7b2d9e8a31_h
@@ -0,0 +1,262 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/SurfaceIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+SurfaceIndex::SurfaceIndex(const std::vector<buw::Vector3d>& points, const std::vector<buw::Vector3i>& triangles)
+{
+	// Compute the 2D bounding box of each triangle. Triangles with invalid indices get an empty box and are never found.
+	boxes_.resize(triangles.size());
+	const int pointCount = static_cast<int>(points.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		const buw::Vector3i& face = triangles[i];
+		Box& box = boxes_[i];
+		box.min[0] = box.min[1] = std::numeric_limits<double>::max();
+		box.max[0] = box.max[1] = std::numeric_limits<double>::lowest();
+
+		if (face[0] < 0 || face[0] >= pointCount || face[1] < 0 || face[1] >= pointCount || face[2] < 0 || face[2] >= pointCount)
+			continue;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const buw::Vector3d& p = points[face[k]];
+			box.min[0] = std::min(box.min[0], p.x());
+			box.min[1] = std::min(box.min[1], p.y());
+			box.max[0] = std::max(box.max[0], p.x());
+			box.max[1] = std::max(box.max[1], p.y());
+		}
+	}
+
+	buildNeighbours(triangles);
+
+	// Scanning a few boxes is faster than any index.
+	if (boxes_.size() < 32)
+	{
+		type_ = eType::Linear;
+		return;
+	}
+
+	if (buildGrid())
+		type_ = eType::Grid;
+	else
+		buildHierarchy();
+}
+
+void SurfaceIndex::buildNeighbours(const std::vector<buw::Vector3i>& triangles)
+{
+	// Sort all edges by their end points, an edge shared by exactly two triangles connects them.
+	std::vector<std::pair<std::pair<int, int>, int>> edges;
+	edges.reserve(3 * triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		if (boxes_[i].min[0] > boxes_[i].max[0])
+			continue;
+
+		const buw::Vector3i& face = triangles[i];
+		for (int k = 0; k < 3; k++)
+		{
+			int a = face[k];
+			int b = face[(k + 1) % 3];
+			edges.push_back(std::make_pair(std::make_pair(std::min(a, b), std::max(a, b)), static_cast<int>(3 * i + k)));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+
+	neighbours_.assign(3 * triangles.size(), -1);
+	for (size_t i = 0; i < edges.size();)
+	{
+		size_t j = i + 1;
+		while (j < edges.size() && edges[j].first == edges[i].first)
+			j++;
+
+		// Edges of more than two triangles are ambiguous and treated as border.
+		if (j - i == 2)
+		{
+			neighbours_[edges[i].second] = edges[i + 1].second / 3;
+			neighbours_[edges[i + 1].second] = edges[i].second / 3;
+		}
+		i = j;
+	}
+}
+
+bool SurfaceIndex::buildGrid()
+{
+	double boundsMin[2] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+	double boundsMax[2] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+	for (const Box& box : boxes_)
+	{
+		if (box.min[0] > box.max[0])
+			continue;
+
+		for (int k = 0; k < 2; k++)
+		{
+			boundsMin[k] = std::min(boundsMin[k], box.min[k]);
+			boundsMax[k] = std::max(boundsMax[k], box.max[k]);
+		}
+	}
+
+	if (boundsMin[0] > boundsMax[0])
+		return false;
+
+	// Aim for about two triangles per cell and keep the cells roughly square.
+	const double width = std::max(boundsMax[0] - boundsMin[0], 1e-9);
+	const double height = std::max(boundsMax[1] - boundsMin[1], 1e-9);
+	const double targetCells = std::max(1.0, boxes_.size() / 2.0);
+	cellCount_[0] = std::max(1, std::min(1 << 15, static_cast<int>(std::ceil(std::sqrt(targetCells * width / height)))));
+	cellCount_[1] = std::max(1, std::min(1 << 15, static_cast<int>(std::ceil(targetCells / cellCount_[0]))));
+
+	for (int k = 0; k < 2; k++)
+	{
+		origin_[k] = boundsMin[k];
+		cellSize_[k] = (k == 0 ? width : height) / cellCount_[k];
+	}
+
+	auto getCellRange = [&](const Box& box, int* from, int* to) {
+		for (int k = 0; k < 2; k++)
+		{
+			from[k] = std::max(0, std::min(cellCount_[k] - 1, static_cast<int>((box.min[k] - origin_[k]) / cellSize_[k])));
+			to[k] = std::max(0, std::min(cellCount_[k] - 1, static_cast<int>((box.max[k] - origin_[k]) / cellSize_[k])));
+		}
+	};
+
+	// Count the references first. Long or very large triangles would be stored in too many cells, in this case the hierarchy is used.
+	const size_t cellCount = static_cast<size_t>(cellCount_[0]) * cellCount_[1];
+	const size_t maxReferences = 8 * boxes_.size() + cellCount;
+	cellStart_.assign(cellCount + 1, 0);
+	size_t references = 0;
+	for (const Box& box : boxes_)
+	{
+		if (box.min[0] > box.max[0])
+			continue;
+
+		int from[2], to[2];
+		getCellRange(box, from, to);
+		references += static_cast<size_t>(to[0] - from[0] + 1) * (to[1] - from[1] + 1);
+		if (references > maxReferences || references > static_cast<size_t>(std::numeric_limits<int>::max()))
+		{
+			cellStart_.clear();
+			return false;
+		}
+
+		for (int y = from[1]; y <= to[1]; y++)
+			for (int x = from[0]; x <= to[0]; x++)
+				cellStart_[y * cellCount_[0] + x + 1]++;
+	}
+
+	for (size_t i = 0; i < cellCount; i++)
+		cellStart_[i + 1] += cellStart_[i];
+
+	// Fill the cells in order of the triangle ids, so each cell is sorted.
+	cellTriangles_.resize(references);
+	std::vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+	for (int id = 0; id < static_cast<int>(boxes_.size()); id++)
+	{
+		const Box& box = boxes_[id];
+		if (box.min[0] > box.max[0])
+			continue;
+
+		int from[2], to[2];
+		getCellRange(box, from, to);
+		for (int y = from[1]; y <= to[1]; y++)
+			for (int x = from[0]; x <= to[0]; x++)
+				cellTriangles_[fill[y * cellCount_[0] + x]++] = id;
+	}
+
+	return true;
+}
+
+void SurfaceIndex::buildHierarchy()
+{
+	type_ = eType::Hierarchy;
+
+	order_.clear();
+	for (int id = 0; id < static_cast<int>(boxes_.size()); id++)
+	{
+		if (boxes_[id].min[0] <= boxes_[id].max[0])
+			order_.push_back(id);
+	}
+
+	nodes_.clear();
+	nodes_.reserve(2 * order_.size() / 4 + 1);
+	buildNode(0, static_cast<int>(order_.size()), 0);
+}
+
+int SurfaceIndex::buildNode(int first, int count, int depth)
+{
+	const int index = static_cast<int>(nodes_.size());
+	nodes_.push_back(Node());
+
+	Box box;
+	box.min[0] = box.min[1] = std::numeric_limits<double>::max();
+	box.max[0] = box.max[1] = std::numeric_limits<double>::lowest();
+	for (int i = first; i < first + count; i++)
+	{
+		const Box& b = boxes_[order_[i]];
+		for (int k = 0; k < 2; k++)
+		{
+			box.min[k] = std::min(box.min[k], b.min[k]);
+			box.max[k] = std::max(box.max[k], b.max[k]);
+		}
+	}
+	nodes_[index].box = box;
+
+	// Leaves hold up to four triangles, the depth limit keeps the traversal stack small. An empty root has an inverted box and is never entered.
+	if (count <= 4 || depth >= 48)
+	{
+		nodes_[index].first = first;
+		nodes_[index].count = count;
+		nodes_[index].right = -1;
+		return index;
+	}
+
+	// Split at the median of the box centers along the longer axis.
+	const int axis = (box.max[0] - box.min[0]) >= (box.max[1] - box.min[1]) ? 0 : 1;
+	const int half = count / 2;
+	std::nth_element(order_.begin() + first, order_.begin() + first + half, order_.begin() + first + count, [&](int lhs, int rhs) {
+		return boxes_[lhs].min[axis] + boxes_[lhs].max[axis] < boxes_[rhs].min[axis] + boxes_[rhs].max[axis];
+	});
+
+	// Build the children before writing to the node, since the node array may be reallocated.
+	const int left = buildNode(first, half, depth + 1);
+	const int right = buildNode(first + half, count - half, depth + 1);
+	nodes_[index].first = left;
+	nodes_[index].count = 0;
+	nodes_[index].right = right;
+	return index;
+}
+
+int SurfaceIndex::getCell(const buw::Vector2d& p) const
+{
+	const double x = (p.x() - origin_[0]) / cellSize_[0];
+	const double y = (p.y() - origin_[1]) / cellSize_[1];
+	if (!(x >= 0.0 && y >= 0.0 && x <= cellCount_[0] && y <= cellCount_[1]))
+		return -1;
+
+	const int cx = std::min(cellCount_[0] - 1, static_cast<int>(x));
+	const int cy = std::min(cellCount_[1] - 1, static_cast<int>(y));
+	return cy * cellCount_[0] + cx;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -0,0 +1,162 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_SurfaceIndex_3c2b0d5e_8f4a_4e7b_9d61_2a5f0c7e41b3_h
+#define OpenInfraPlatform_Infrastructure_SurfaceIndex_3c2b0d5e_8f4a_4e7b_9d61_2a5f0c7e41b3_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+//! Two dimensional index for finding the triangle of a surface which contains a position. Surfaces with few triangles are scanned linearly,
+//! others use a uniform grid. If the triangles are too unevenly sized for a grid, a bounding volume hierarchy is used instead. The index is
+//! immutable after construction, so it can be queried from many threads at the same time. It also stores the neighbours of each triangle for walking
+//! through the surface from a known triangle.
+class SurfaceIndex
+{
+public:
+	SurfaceIndex(const std::vector<buw::Vector3d>& points, const std::vector<buw::Vector3i>& triangles);
+
+	//! Returns the smallest id of the triangles whose bounding box contains 'p' and for which 'contains' returns true, or -1 if there is none.
+	template<typename F> int findTriangle(const buw::Vector2d& p, const F& contains) const
+	{
+		switch (type_)
+		{
+		case eType::Grid:
+		{
+			int cell = getCell(p);
+			if (cell < 0)
+				return -1;
+
+			// Triangles are stored in increasing order per cell, so the first hit has the smallest id.
+			for (int i = cellStart_[cell]; i < cellStart_[cell + 1]; i++)
+			{
+				int id = cellTriangles_[i];
+				if (boxes_[id].contains(p) && contains(id))
+					return id;
+			}
+			return -1;
+		}
+		case eType::Hierarchy:
+		{
+			int result = -1;
+			int stack[64];
+			int top = 0;
+			stack[top++] = 0;
+			while (top > 0)
+			{
+				const Node& node = nodes_[stack[--top]];
+				if (!node.box.contains(p))
+					continue;
+
+				if (node.count > 0)
+				{
+					for (int i = node.first; i < node.first + node.count; i++)
+					{
+						int id = order_[i];
+						if ((result == -1 || id < result) && boxes_[id].contains(p) && contains(id))
+							result = id;
+					}
+				}
+				else
+				{
+					stack[top++] = node.first;
+					stack[top++] = node.right;
+				}
+			}
+			return result;
+		}
+		default:
+		{
+			for (int id = 0; id < static_cast<int>(boxes_.size()); id++)
+			{
+				if (boxes_[id].contains(p) && contains(id))
+					return id;
+			}
+			return -1;
+		}
+		}
+	}
+
+	//! Returns the triangle sharing the edge from corner 'edge' to corner 'edge + 1' of triangle 'id', or -1 at the border of the surface.
+	int getNeighbour(const int id, const int edge) const
+	{
+		return neighbours_[3 * id + edge];
+	}
+
+private:
+	enum class eType
+	{
+		Linear,
+		Grid,
+		Hierarchy
+	};
+
+	struct Box
+	{
+		double min[2];
+		double max[2];
+
+		bool contains(const buw::Vector2d& p) const
+		{
+			return p.x() >= min[0] && p.x() <= max[0] && p.y() >= min[1] && p.y() <= max[1];
+		}
+	};
+
+	//! Inner nodes store their left child at 'first' and their right child at 'right', leaves store 'count' > 0 triangles of 'order_' starting at 'first'.
+	struct Node
+	{
+		Box box;
+		int first;
+		int count;
+		int right;
+	};
+
+	void buildNeighbours(const std::vector<buw::Vector3i>& triangles);
+
+	bool buildGrid();
+
+	void buildHierarchy();
+
+	int buildNode(int first, int count, int depth);
+
+	int getCell(const buw::Vector2d& p) const;
+
+private:
+	eType								type_;
+	std::vector<Box>					boxes_;
+	std::vector<int>					neighbours_;
+
+	// Uniform grid with the triangles of each cell stored consecutively.
+	double								origin_[2];
+	double								cellSize_[2];
+	int									cellCount_[2];
+	std::vector<int>					cellStart_;
+	std::vector<int>					cellTriangles_;
+
+	// Bounding volume hierarchy.
+	std::vector<Node>					nodes_;
+	std::vector<int>					order_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+#endif // end define OpenInfraPlatform_Infrastructure_SurfaceIndex_3c2b0d5e_8f4a_4e7b_9d61_2a5f0c7e41b3_h
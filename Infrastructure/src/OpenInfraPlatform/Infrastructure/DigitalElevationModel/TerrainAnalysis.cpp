@@ -0,0 +1,367 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainAnalysis.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <omp.h>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	const double Pi = 3.14159265358979323846;
+	const float RadiansToDegrees = static_cast<float>(180.0 / Pi);
+	const float NoData = std::numeric_limits<float>::quiet_NaN();
+
+	//! D8 neighbours in the order of their codes, starting east and turning clockwise. Raster rows go north, so south is the previous row.
+	const int FlowOffsetX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+	const int FlowOffsetY[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+
+	TerrainLayer createLayer(const RasterSurface& raster)
+	{
+		TerrainLayer layer;
+		layer.width = raster.getWidth();
+		layer.height = raster.getHeight();
+		layer.origin = raster.getOrigin();
+		layer.cellSize = raster.getCellSize();
+		layer.values.resize(static_cast<size_t>(layer.width) * layer.height, NoData);
+		return layer;
+	}
+
+	//! Calls 'processRow' for every row. Tiles of desc.tileRows rows are handed out to the threads, so a thread reads the rows of its tile
+	//! and their neighbours only.
+	template<typename RowFunction> void forEachRow(const int height, const TerrainAnalysisDescription& desc, const RowFunction& processRow)
+	{
+		const int tileRows = std::max(desc.tileRows, 1);
+		const int tileCount = (height + tileRows - 1) / tileRows;
+		const int threadCount = desc.threadCount > 0 ? desc.threadCount : omp_get_max_threads();
+
+#pragma omp parallel for num_threads(threadCount) schedule(dynamic)
+		for (int tile = 0; tile < tileCount; tile++)
+		{
+			const int yEnd = std::min(height, (tile + 1) * tileRows);
+			for (int y = tile * tileRows; y < yEnd; y++)
+				processRow(y);
+		}
+	}
+
+	//! Evaluates 'kernel' with the gradient of Horn's method scaled by the z-factor at all samples with data.
+	template<typename Kernel> TerrainLayer applyGradientKernel(const RasterSurface& raster, const TerrainAnalysisDescription& desc, const Kernel& kernel)
+	{
+		TerrainLayer layer = createLayer(raster);
+		const int width = layer.width;
+		const int height = layer.height;
+		const float* heights = raster.getHeights().data();
+		if (width == 0 || height == 0)
+			return layer;
+
+		// Samples at the border have only one neighbour in a direction, the differences are divided by the distance actually used.
+		const float scaleX = static_cast<float>(desc.zFactor / (8.0 * layer.cellSize));
+		const float scaleBorderX = width > 1 ? 2.0f * scaleX : 0.0f;
+
+		forEachRow(height, desc, [&](const int y)
+		{
+			const int ySouth = std::max(y - 1, 0);
+			const int yNorth = std::min(y + 1, height - 1);
+			const float* south = heights + static_cast<size_t>(ySouth) * width;
+			const float* center = heights + static_cast<size_t>(y) * width;
+			const float* north = heights + static_cast<size_t>(yNorth) * width;
+			float* out = &layer.values[static_cast<size_t>(y) * width];
+
+			const float scaleY = yNorth > ySouth ? static_cast<float>(desc.zFactor / (4.0 * (yNorth - ySouth) * layer.cellSize)) : 0.0f;
+
+			auto evaluate = [&](const int x, const int west, const int east, const float scaleWestEast) -> float
+			{
+				const float dzdx = ((north[east] + 2.0f * center[east] + south[east]) - (north[west] + 2.0f * center[west] + south[west])) * scaleWestEast;
+				const float dzdy = ((north[west] + 2.0f * north[x] + north[east]) - (south[west] + 2.0f * south[x] + south[east])) * scaleY;
+				return std::isnan(center[x]) ? NoData : kernel(dzdx, dzdy);
+			};
+
+			out[0] = evaluate(0, 0, std::min(1, width - 1), scaleBorderX);
+
+			// No branches on the border inside, so the compiler can vectorize the loop.
+			for (int x = 1; x < width - 1; x++)
+				out[x] = evaluate(x, x - 1, x + 1, scaleX);
+
+			if (width > 1)
+				out[width - 1] = evaluate(width - 1, width - 2, width - 1, scaleBorderX);
+		});
+
+		return layer;
+	}
+
+	//! Returns 1 + the index of the D8 neighbour with the steepest descent for each sample, or 0 if no neighbour with data is lower.
+	std::vector<std::uint8_t> computeFlowDirections(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+	{
+		const int width = raster.getWidth();
+		const int height = raster.getHeight();
+		const float* heights = raster.getHeights().data();
+		const float diagonalFactor = static_cast<float>(1.0 / std::sqrt(2.0));
+
+		std::vector<std::uint8_t> directions(static_cast<size_t>(width) * height, 0);
+		forEachRow(height, desc, [&](const int y)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const size_t i = static_cast<size_t>(y) * width + x;
+				if (std::isnan(heights[i]))
+					continue;
+
+				float steepest = 0.0f;
+				for (int k = 0; k < 8; k++)
+				{
+					const int nx = x + FlowOffsetX[k];
+					const int ny = y + FlowOffsetY[k];
+					if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+						continue;
+
+					// Comparisons with neighbours without data are false, so they are never chosen.
+					const float drop = (heights[i] - heights[static_cast<size_t>(ny) * width + nx]) * ((k & 1) ? diagonalFactor : 1.0f);
+					if (drop > steepest)
+					{
+						steepest = drop;
+						directions[i] = static_cast<std::uint8_t>(k + 1);
+					}
+				}
+			}
+		});
+
+		return directions;
+	}
+
+	//! Calls 'f' with the index of each neighbour flowing into the sample (x, y).
+	template<typename Function> void forEachInflow(const std::vector<std::uint8_t>& directions, const int width, const int height, const int x, const int y, const Function& f)
+	{
+		for (int k = 0; k < 8; k++)
+		{
+			const int nx = x + FlowOffsetX[k];
+			const int ny = y + FlowOffsetY[k];
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+				continue;
+
+			// The neighbour flows into the opposite direction.
+			const size_t j = static_cast<size_t>(ny) * width + nx;
+			if (directions[j] == (k + 4) % 8 + 1)
+				f(j);
+		}
+	}
+
+	float interpolate(const float a, const float b, const double t)
+	{
+		return static_cast<float>(a + (b - a) * t);
+	}
+
+	buw::Color4b rampColor(const eTerrainColorRamp ramp, const double t)
+	{
+		if (ramp == eTerrainColorRamp::Heat)
+		{
+			static const float stops[5][3] = { { 0, 0, 255 }, { 0, 255, 255 }, { 0, 255, 0 }, { 255, 255, 0 }, { 255, 0, 0 } };
+			const int i = std::min(static_cast<int>(t * 4.0), 3);
+			const double s = t * 4.0 - i;
+			return buw::Color4b(
+				static_cast<std::uint8_t>(interpolate(stops[i][0], stops[i + 1][0], s) + 0.5f),
+				static_cast<std::uint8_t>(interpolate(stops[i][1], stops[i + 1][1], s) + 0.5f),
+				static_cast<std::uint8_t>(interpolate(stops[i][2], stops[i + 1][2], s) + 0.5f),
+				255);
+		}
+
+		const std::uint8_t grey = static_cast<std::uint8_t>(255.0 * t + 0.5);
+		return buw::Color4b(grey, grey, grey, 255);
+	}
+}
+
+buw::ReferenceCounted<RasterSurface> createRasterSurface(const Surface& surface, const double cellSize, const int threadCount)
+{
+	const buw::Vector3d boundsMin = surface.getBoundsMin();
+	const buw::Vector3d boundsMax = surface.getBoundsMax();
+
+	int width = 0;
+	int height = 0;
+	if (cellSize > 0.0 && surface.getTriangleCount() > 0)
+	{
+		width = static_cast<int>(std::floor((boundsMax.x() - boundsMin.x()) / cellSize)) + 1;
+		height = static_cast<int>(std::floor((boundsMax.y() - boundsMin.y()) / cellSize)) + 1;
+	}
+
+	buw::ReferenceCounted<RasterSurface> raster = std::make_shared<RasterSurface>(width, height, buw::Vector2d(boundsMin.x(), boundsMin.y()), cellSize);
+	raster->setName(surface.getName());
+
+	const int threads = threadCount > 0 ? threadCount : omp_get_max_threads();
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+	for (int y = 0; y < height; y++)
+	{
+		int hint = -1;
+		for (int x = 0; x < width; x++)
+		{
+			double z = 0.0;
+			if (surface.tryGetZ(raster->getOrigin() + buw::Vector2d(x * cellSize, y * cellSize), z, hint))
+				raster->setHeight(x, y, static_cast<float>(z));
+		}
+	}
+
+	return raster;
+}
+
+TerrainLayer computeSlope(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+{
+	return applyGradientKernel(raster, desc, [](const float dzdx, const float dzdy)
+	{
+		return std::atan(std::sqrt(dzdx * dzdx + dzdy * dzdy)) * RadiansToDegrees;
+	});
+}
+
+TerrainLayer computeAspect(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+{
+	return applyGradientKernel(raster, desc, [](const float dzdx, const float dzdy)
+	{
+		// The terrain faces downhill, against the gradient.
+		const float aspect = std::atan2(-dzdx, -dzdy) * RadiansToDegrees;
+		return dzdx == 0.0f && dzdy == 0.0f ? -1.0f : (aspect < 0.0f ? aspect + 360.0f : aspect);
+	});
+}
+
+TerrainLayer computeHillshade(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+{
+	const double azimuth = desc.azimuth * Pi / 180.0;
+	const double altitude = desc.altitude * Pi / 180.0;
+	const float lightX = static_cast<float>(std::sin(azimuth) * std::cos(altitude));
+	const float lightY = static_cast<float>(std::cos(azimuth) * std::cos(altitude));
+	const float lightZ = static_cast<float>(std::sin(altitude));
+
+	return applyGradientKernel(raster, desc, [=](const float dzdx, const float dzdy)
+	{
+		// Dot product of the light direction and the normal (-dzdx, -dzdy, 1), shadowed sides are 0 and neighbours without data stay NaN.
+		const float shade = (lightZ - lightX * dzdx - lightY * dzdy) / std::sqrt(1.0f + dzdx * dzdx + dzdy * dzdy);
+		return shade < 0.0f ? 0.0f : shade;
+	});
+}
+
+TerrainLayer computeFlowDirection(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+{
+	TerrainLayer layer = createLayer(raster);
+	const std::vector<std::uint8_t> directions = computeFlowDirections(raster, desc);
+	const std::vector<float>& heights = raster.getHeights();
+
+	forEachRow(layer.height, desc, [&](const int y)
+	{
+		for (int x = 0; x < layer.width; x++)
+		{
+			const size_t i = static_cast<size_t>(y) * layer.width + x;
+			if (!std::isnan(heights[i]))
+				layer.values[i] = directions[i] == 0 ? 0.0f : static_cast<float>(1 << (directions[i] - 1));
+		}
+	});
+
+	return layer;
+}
+
+TerrainLayer computeFlowAccumulation(const RasterSurface& raster, const TerrainAnalysisDescription& desc)
+{
+	TerrainLayer layer = createLayer(raster);
+	const int width = layer.width;
+	const int height = layer.height;
+	const std::vector<float>& heights = raster.getHeights();
+	const std::vector<std::uint8_t> directions = computeFlowDirections(raster, desc);
+
+	std::ptrdiff_t offsets[8];
+	for (int k = 0; k < 8; k++)
+		offsets[k] = static_cast<std::ptrdiff_t>(FlowOffsetY[k]) * width + FlowOffsetX[k];
+
+	// Number of inflows of each sample and the number of them whose accumulation is not known yet.
+	std::vector<std::uint8_t> inflows(directions.size(), 0);
+	std::vector<std::atomic<std::uint8_t>> pending(directions.size());
+	forEachRow(height, desc, [&](const int y)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const size_t i = static_cast<size_t>(y) * width + x;
+			forEachInflow(directions, width, height, x, y, [&](const size_t) { inflows[i]++; });
+			pending[i].store(inflows[i], std::memory_order_relaxed);
+		}
+	});
+
+	std::vector<std::uint32_t> accumulation(directions.size(), 0);
+	forEachRow(height, desc, [&](const int y)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			// Only the samples without inflow start a flow path.
+			size_t i = static_cast<size_t>(y) * width + x;
+			if (std::isnan(heights[i]) || inflows[i] != 0)
+				continue;
+
+			for (;;)
+			{
+				std::uint32_t sum = 1;
+				if (inflows[i] != 0)
+					forEachInflow(directions, width, height, static_cast<int>(i % width), static_cast<int>(i / width), [&](const size_t j) { sum += accumulation[j]; });
+				accumulation[i] = sum;
+
+				if (directions[i] == 0)
+					break;
+
+				// The thread adding the last inflow continues downstream, acquire and release make the accumulations of all inflows visible to it.
+				const size_t next = i + offsets[directions[i] - 1];
+				if (pending[next].fetch_sub(1, std::memory_order_acq_rel) != 1)
+					break;
+				i = next;
+			}
+		}
+	});
+
+	forEachRow(height, desc, [&](const int y)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const size_t i = static_cast<size_t>(y) * width + x;
+			if (!std::isnan(heights[i]))
+				layer.values[i] = static_cast<float>(accumulation[i]);
+		}
+	});
+
+	return layer;
+}
+
+buw::Image4b createTerrainImage(const TerrainLayer& layer, const double minValue, const double maxValue, const eTerrainColorRamp ramp)
+{
+	buw::Image4b image(layer.width, layer.height);
+	const double range = maxValue > minValue ? maxValue - minValue : 1.0;
+
+#pragma omp parallel for schedule(static)
+	for (int y = 0; y < layer.height; y++)
+	{
+		for (int x = 0; x < layer.width; x++)
+		{
+			const float value = layer.getValue(x, y);
+			buw::Color4b color(0, 0, 0, 0);
+			if (!std::isnan(value))
+				color = rampColor(ramp, std::min(std::max((value - minValue) / range, 0.0), 1.0));
+
+			// The first image row is the northern one.
+			image.setPixelColor(x, layer.height - 1 - y, color);
+		}
+	}
+
+	return image;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
@@ -0,0 +1,114 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_TerrainAnalysis_e3a17c58_92d4_4b6f_8e0a_5c9b2d71f6a3_h
+#define OpenInfraPlatform_Infrastructure_TerrainAnalysis_e3a17c58_92d4_4b6f_8e0a_5c9b2d71f6a3_h
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <BlueFramework/ImageProcessing/Image.h>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+struct TerrainAnalysisDescription
+{
+	//! Direction the light comes from in degrees clockwise from north and its angle above the horizon, used for the hill-shade.
+	double	azimuth = 315.0;
+	double	altitude = 45.0;
+
+	//! Factor applied to the heights, e.g. to exaggerate flat terrain in the hill-shade.
+	double	zFactor = 1.0;
+
+	//! Number of raster rows processed as one task.
+	int		tileRows = 64;
+
+	//! Number of threads, 0 uses all available.
+	int		threadCount = 0;
+};
+
+//! One value per sample of a raster, laid out like the heights of a RasterSurface. Samples without data are NaN.
+struct TerrainLayer
+{
+	int					width = 0;
+	int					height = 0;
+	buw::Vector2d		origin = buw::Vector2d(0.0, 0.0);
+	double				cellSize = 1.0;
+	std::vector<float>	values;
+
+	float getValue(const int x, const int y) const
+	{
+		return values[static_cast<size_t>(y) * width + x];
+	}
+};
+
+enum class eTerrainColorRamp
+{
+	Greyscale,
+
+	//! Blue over cyan, green and yellow to red.
+	Heat
+};
+
+//! Samples the surface at the corners of cells of size 'cellSize' over its bounds, positions outside of the triangles have no data. The rows are
+//! sampled in parallel, each one walking from the triangle of the previous sample.
+BLUEINFRASTRUCTURE_API buw::ReferenceCounted<RasterSurface> createRasterSurface(const Surface& surface, const double cellSize, const int threadCount = 0);
+
+//! The analyses below use the gradient of Horn's method over the 3x3 neighbourhood of each sample. Border samples use the samples inside of the
+//! raster only, samples next to a sample without data have no data.
+
+//! Slope in degrees, 0 is flat.
+BLUEINFRASTRUCTURE_API TerrainLayer computeSlope(const RasterSurface& raster, const TerrainAnalysisDescription& desc = TerrainAnalysisDescription());
+
+//! Direction the terrain faces in degrees clockwise from north, -1 where it is flat.
+BLUEINFRASTRUCTURE_API TerrainLayer computeAspect(const RasterSurface& raster, const TerrainAnalysisDescription& desc = TerrainAnalysisDescription());
+
+//! Lambertian reflection of the light from azimuth and altitude between 0 and 1.
+BLUEINFRASTRUCTURE_API TerrainLayer computeHillshade(const RasterSurface& raster, const TerrainAnalysisDescription& desc = TerrainAnalysisDescription());
+
+//! D8 flow direction to the neighbour with the steepest descent, coded as 1 east, 2 south-east, 4 south, 8 south-west, 16 west, 32 north-west,
+//! 64 north and 128 north-east. Samples without a lower neighbour get 0, at equal descent the first direction wins.
+BLUEINFRASTRUCTURE_API TerrainLayer computeFlowDirection(const RasterSurface& raster, const TerrainAnalysisDescription& desc = TerrainAnalysisDescription());
+
+//! Number of samples draining through each sample along the D8 flow directions including the sample itself. Starting at the samples without
+//! inflow the flow paths are followed in parallel, a sample is continued by the thread adding the last of its inflows.
+BLUEINFRASTRUCTURE_API TerrainLayer computeFlowAccumulation(const RasterSurface& raster, const TerrainAnalysisDescription& desc = TerrainAnalysisDescription());
+
+//! Maps the values between minValue and maxValue to the color ramp, samples without data are transparent. North is at the top of the image.
+BLUEINFRASTRUCTURE_API buw::Image4b createTerrainImage(const TerrainLayer& layer, const double minValue, const double maxValue, const eTerrainColorRamp ramp = eTerrainColorRamp::Greyscale);
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::TerrainAnalysisDescription;
+	using OpenInfraPlatform::Infrastructure::TerrainLayer;
+	using OpenInfraPlatform::Infrastructure::eTerrainColorRamp;
+	using OpenInfraPlatform::Infrastructure::createRasterSurface;
+	using OpenInfraPlatform::Infrastructure::computeSlope;
+	using OpenInfraPlatform::Infrastructure::computeAspect;
+	using OpenInfraPlatform::Infrastructure::computeHillshade;
+	using OpenInfraPlatform::Infrastructure::computeFlowDirection;
+	using OpenInfraPlatform::Infrastructure::computeFlowAccumulation;
+	using OpenInfraPlatform::Infrastructure::createTerrainImage;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_TerrainAnalysis_e3a17c58_92d4_4b6f_8e0a_5c9b2d71f6a3_h
@@ -0,0 +1,636 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainLOD.h"
+#include <BlueFramework/Core/assert.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <omp.h>
+#include <queue>
+#include <utility>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+namespace
+{
+	//! Sum of squared distances to a set of planes, stored as the upper triangle of the symmetric 4x4 matrix.
+	struct Quadric
+	{
+		double q[10] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		void addPlane(const buw::Vector3d& n, const double d, const double weight)
+		{
+			const double v[4] = { n.x(), n.y(), n.z(), d };
+			int k = 0;
+			for (int i = 0; i < 4; i++)
+				for (int j = i; j < 4; j++)
+					q[k++] += weight * v[i] * v[j];
+		}
+
+		void add(const Quadric& other)
+		{
+			for (int k = 0; k < 10; k++)
+				q[k] += other.q[k];
+		}
+
+		double evaluate(const buw::Vector3d& p) const
+		{
+			const double v[4] = { p.x(), p.y(), p.z(), 1.0 };
+			double sum = 0.0;
+			int k = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				for (int j = i; j < 4; j++)
+					sum += (i == j ? 1.0 : 2.0) * q[k++] * v[i] * v[j];
+			}
+			return sum;
+		}
+	};
+
+	double cross2D(const buw::Vector3d& a, const buw::Vector3d& b, const buw::Vector3d& c)
+	{
+		return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+	}
+
+	//! Simplifies the mesh of one tile by half edge collapses u -> v in the order of the quadric error. A collapse is only done if the removed points
+	//! keep within the vertical error, the border keeps within the error in the plane and no triangle flips over in the plane.
+	class TileSimplifier
+	{
+	public:
+		TileSimplifier(const std::vector<buw::Vector3d>& points, const std::vector<buw::Vector3i>& triangles)
+			: points_(points), triangles_(triangles)
+		{
+			const int pointCount = static_cast<int>(points_.size());
+			const int triangleCount = static_cast<int>(triangles_.size());
+
+			alive_.assign(triangleCount, 1);
+			orientation_.resize(triangleCount);
+			trianglePoints_.resize(triangleCount);
+			removed_.assign(pointCount, 0);
+			locked_.assign(pointCount, 0);
+			stamps_.assign(pointCount, 0);
+			quadrics_.resize(pointCount);
+			vertexTriangles_.resize(pointCount);
+
+			for (int t = 0; t < triangleCount; t++)
+			{
+				const buw::Vector3i& face = triangles_[t];
+				const buw::Vector3d& a = points_[face[0]];
+				const buw::Vector3d& b = points_[face[1]];
+				const buw::Vector3d& c = points_[face[2]];
+
+				// Triangles without area in the plane can't be checked for fold-overs, so their points are kept.
+				const double area = cross2D(a, b, c);
+				const double scale = std::max((b - a).head<2>().squaredNorm(), (c - a).head<2>().squaredNorm());
+				orientation_[t] = area > 0.0 ? 1.0 : -1.0;
+				if (!(std::abs(area) > 1e-12 * scale))
+				{
+					for (int k = 0; k < 3; k++)
+						locked_[face[k]] = 1;
+				}
+
+				buw::Vector3d normal = (b - a).cross(c - a);
+				const double length = normal.norm();
+				if (length > 0.0)
+				{
+					normal /= length;
+					for (int k = 0; k < 3; k++)
+						quadrics_[face[k]].addPlane(normal, -normal.dot(a), 0.5 * length);
+				}
+
+				for (int k = 0; k < 3; k++)
+					vertexTriangles_[face[k]].push_back(t);
+			}
+
+			// Edges of more than two triangles are not manifold and kept.
+			std::vector<std::pair<int, int>> edges;
+			edges.reserve(3 * triangles_.size());
+			for (const buw::Vector3i& face : triangles_)
+			{
+				for (int k = 0; k < 3; k++)
+					edges.push_back(std::make_pair(std::min(face[k], face[(k + 1) % 3]), std::max(face[k], face[(k + 1) % 3])));
+			}
+			std::sort(edges.begin(), edges.end());
+			for (size_t i = 0; i + 2 < edges.size(); i++)
+			{
+				if (edges[i] == edges[i + 2])
+					locked_[edges[i].first] = locked_[edges[i].second] = 1;
+			}
+		}
+
+		void simplify(const double maximumError)
+		{
+			queue_ = std::priority_queue<Collapse>();
+			for (int u = 0; u < static_cast<int>(points_.size()); u++)
+				pushCollapses(u);
+
+			while (!queue_.empty())
+			{
+				const Collapse collapse = queue_.top();
+				queue_.pop();
+
+				if (collapse.stampFrom != stamps_[collapse.from] || collapse.stampTo != stamps_[collapse.to])
+					continue;
+
+				tryCollapse(collapse.from, collapse.to, maximumError);
+			}
+		}
+
+		TerrainLODMesh createMesh(const double error, const double skirtDepth) const
+		{
+			TerrainLODMesh mesh;
+			mesh.error = error;
+
+			std::vector<int> remap(points_.size(), -1);
+			for (size_t i = 0; i < points_.size(); i++)
+			{
+				if (!removed_[i] && !vertexTriangles_[i].empty())
+				{
+					remap[i] = static_cast<int>(mesh.points.size());
+					mesh.points.push_back(points_[i]);
+				}
+			}
+
+			// Border edges belong to a single triangle, the skirt continues its orientation downwards.
+			std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> edges;
+			for (size_t t = 0; t < triangles_.size(); t++)
+			{
+				if (!alive_[t])
+					continue;
+
+				const buw::Vector3i& face = triangles_[t];
+				const buw::Vector3i triangle(remap[face[0]], remap[face[1]], remap[face[2]]);
+				mesh.triangles.push_back(triangle);
+				for (int k = 0; k < 3; k++)
+				{
+					const int a = triangle[k];
+					const int b = triangle[(k + 1) % 3];
+					edges.push_back(std::make_pair(std::make_pair(std::min(a, b), std::max(a, b)), std::make_pair(a, b)));
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			std::vector<int> skirt(mesh.points.size(), -1);
+			auto getSkirtPoint = [&](const int p) {
+				if (skirt[p] < 0)
+				{
+					skirt[p] = static_cast<int>(mesh.points.size());
+					mesh.points.push_back(mesh.points[p] - buw::Vector3d(0.0, 0.0, skirtDepth));
+				}
+				return skirt[p];
+			};
+
+			for (size_t i = 0; i < edges.size();)
+			{
+				size_t j = i + 1;
+				while (j < edges.size() && edges[j].first == edges[i].first)
+					j++;
+
+				if (j - i == 1)
+				{
+					const int a = edges[i].second.first;
+					const int b = edges[i].second.second;
+					const int sa = getSkirtPoint(a);
+					const int sb = getSkirtPoint(b);
+					mesh.triangles.push_back(buw::Vector3i(b, a, sa));
+					mesh.triangles.push_back(buw::Vector3i(b, sa, sb));
+				}
+				i = j;
+			}
+
+			return mesh;
+		}
+
+	private:
+		struct Collapse
+		{
+			double		cost;
+			int			from;
+			int			to;
+			unsigned	stampFrom;
+			unsigned	stampTo;
+
+			bool operator<(const Collapse& other) const
+			{
+				return cost > other.cost;
+			}
+		};
+
+		void getNeighbours(const int u, std::vector<int>& o_neighbours) const
+		{
+			o_neighbours.clear();
+			for (int t : vertexTriangles_[u])
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					if (triangles_[t][k] != u)
+						o_neighbours.push_back(triangles_[t][k]);
+				}
+			}
+			std::sort(o_neighbours.begin(), o_neighbours.end());
+			o_neighbours.erase(std::unique(o_neighbours.begin(), o_neighbours.end()), o_neighbours.end());
+		}
+
+		void pushCollapses(const int u)
+		{
+			if (removed_[u] || locked_[u])
+				return;
+
+			getNeighbours(u, pushNeighbours_);
+			for (int v : pushNeighbours_)
+			{
+				Quadric quadric = quadrics_[u];
+				quadric.add(quadrics_[v]);
+				queue_.push(Collapse{ quadric.evaluate(points_[v]), u, v, stamps_[u], stamps_[v] });
+			}
+		}
+
+		bool tryCollapse(const int u, const int v, const double maximumError)
+		{
+			if (removed_[u] || removed_[v] || locked_[u])
+				return false;
+
+			std::vector<int>& shared = shared_;
+			std::vector<int>& moved = moved_;
+			shared.clear();
+			moved.clear();
+			for (int t : vertexTriangles_[u])
+			{
+				const buw::Vector3i& face = triangles_[t];
+				if (face[0] == v || face[1] == v || face[2] == v)
+					shared.push_back(t);
+				else
+					moved.push_back(t);
+			}
+			if (shared.empty() || moved.empty())
+				return false;
+
+			// An edge of u is on the border if only one triangle uses it.
+			std::vector<int>& neighboursU = neighboursU_;
+			std::vector<int>& neighboursV = neighboursV_;
+			getNeighbours(u, neighboursU);
+			getNeighbours(v, neighboursV);
+
+			std::vector<int>& border = border_;
+			border.clear();
+			for (int w : neighboursU)
+			{
+				int count = 0;
+				for (int t : vertexTriangles_[u])
+				{
+					const buw::Vector3i& face = triangles_[t];
+					if (face[0] == w || face[1] == w || face[2] == w)
+						count++;
+				}
+				if (count == 1)
+					border.push_back(w);
+			}
+
+			if (border.empty())
+			{
+				if (shared.size() != 2)
+					return false;
+			}
+			else
+			{
+				// A border point may only move along the border and only if the border keeps within the error.
+				if (border.size() != 2 || shared.size() != 1 || (border[0] != v && border[1] != v))
+					return false;
+
+				const buw::Vector3d& w = points_[border[0] == v ? border[1] : border[0]];
+				const buw::Vector2d direction = (w - points_[v]).head<2>();
+				const double length = direction.norm();
+				if (!(length > 0.0) || std::abs(cross2D(points_[v], w, points_[u])) / length > maximumError)
+					return false;
+			}
+
+			// Link condition: u and v may only share the neighbours opposite to their common edge, otherwise the mesh gets folded.
+			std::vector<int>& common = common_;
+			std::vector<int>& opposite = opposite_;
+			common.clear();
+			opposite.clear();
+			std::set_intersection(neighboursU.begin(), neighboursU.end(), neighboursV.begin(), neighboursV.end(), std::back_inserter(common));
+			for (int t : shared)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					if (triangles_[t][k] != u && triangles_[t][k] != v)
+						opposite.push_back(triangles_[t][k]);
+				}
+			}
+			std::sort(opposite.begin(), opposite.end());
+			if (common != opposite)
+				return false;
+
+			// No triangle may flip over or degenerate in the plane.
+			std::vector<buw::Vector3i>& faces = faces_;
+			faces.resize(moved.size());
+			for (size_t i = 0; i < moved.size(); i++)
+			{
+				faces[i] = triangles_[moved[i]];
+				for (int k = 0; k < 3; k++)
+				{
+					if (faces[i][k] == u)
+						faces[i][k] = v;
+				}
+
+				const buw::Vector3d& a = points_[faces[i][0]];
+				const buw::Vector3d& b = points_[faces[i][1]];
+				const buw::Vector3d& c = points_[faces[i][2]];
+				const double scale = std::max((b - a).head<2>().squaredNorm(), (c - a).head<2>().squaredNorm());
+				if (!(cross2D(a, b, c) * orientation_[moved[i]] > 1e-12 * scale))
+					return false;
+			}
+
+			// Every point removed so far around u and u itself has to keep within the error to the new triangles.
+			std::vector<int>& pool = pool_;
+			pool.assign(1, u);
+			for (int t : vertexTriangles_[u])
+				pool.insert(pool.end(), trianglePoints_[t].begin(), trianglePoints_[t].end());
+
+			std::vector<int>& assignment = assignment_;
+			assignment.resize(pool.size());
+			for (size_t i = 0; i < pool.size(); i++)
+			{
+				const buw::Vector3d& p = points_[pool[i]];
+				double best = std::numeric_limits<double>::lowest();
+				double z = 0.0;
+				for (size_t j = 0; j < faces.size(); j++)
+				{
+					const buw::Vector3d& a = points_[faces[j][0]];
+					const buw::Vector3d& b = points_[faces[j][1]];
+					const buw::Vector3d& c = points_[faces[j][2]];
+					const double area = cross2D(a, b, c);
+					const double l0 = cross2D(p, b, c) / area;
+					const double l1 = cross2D(a, p, c) / area;
+					const double l2 = 1.0 - l0 - l1;
+					const double inside = std::min(l0, std::min(l1, l2));
+					if (inside > best)
+					{
+						best = inside;
+						z = l0 * a.z() + l1 * b.z() + l2 * c.z();
+						assignment[i] = static_cast<int>(j);
+						if (inside >= 0.0)
+							break;
+					}
+				}
+
+				if (!(std::abs(z - p.z()) <= maximumError))
+					return false;
+			}
+
+			// Apply the collapse.
+			for (int t : shared)
+			{
+				alive_[t] = 0;
+				trianglePoints_[t].clear();
+			}
+			for (size_t i = 0; i < moved.size(); i++)
+			{
+				triangles_[moved[i]] = faces[i];
+				trianglePoints_[moved[i]].clear();
+			}
+			for (size_t i = 0; i < pool.size(); i++)
+				trianglePoints_[moved[assignment[i]]].push_back(pool[i]);
+
+			std::vector<int>& triangles = vertexTriangles_[v];
+			triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](int t) { return !alive_[t]; }), triangles.end());
+			triangles.insert(triangles.end(), moved.begin(), moved.end());
+			for (int w : opposite)
+			{
+				std::vector<int>& list = vertexTriangles_[w];
+				list.erase(std::remove_if(list.begin(), list.end(), [&](int t) { return !alive_[t]; }), list.end());
+			}
+			std::vector<int>().swap(vertexTriangles_[u]);
+			removed_[u] = 1;
+			quadrics_[v].add(quadrics_[u]);
+
+			// All collapses around v are outdated.
+			getNeighbours(v, neighboursV);
+			stamps_[v]++;
+			for (int w : neighboursV)
+				stamps_[w]++;
+
+			pushCollapses(v);
+			for (int w : neighboursV)
+				pushCollapses(w);
+
+			return true;
+		}
+
+	private:
+		std::vector<buw::Vector3d>			points_;
+		std::vector<buw::Vector3i>			triangles_;
+		std::vector<char>					alive_;
+		std::vector<double>					orientation_;
+		std::vector<std::vector<int>>		trianglePoints_;
+		std::vector<char>					removed_;
+		std::vector<char>					locked_;
+		std::vector<unsigned>				stamps_;
+		std::vector<Quadric>				quadrics_;
+		std::vector<std::vector<int>>		vertexTriangles_;
+		std::priority_queue<Collapse>		queue_;
+
+		// buffers reused by the collapses
+		std::vector<int>					shared_, moved_, neighboursU_, neighboursV_, border_, common_, opposite_, pool_, assignment_, pushNeighbours_;
+		std::vector<buw::Vector3i>			faces_;
+	};
+}
+
+TerrainLOD::TerrainLOD(const Surface& surface, const TerrainLODDescription& desc)
+	: desc_(desc)
+{
+	desc_.levelCount = std::max(1, desc_.levelCount);
+
+	const std::vector<buw::Vector3d>& points = surface.getPoints();
+	const int pointCount = static_cast<int>(points.size());
+
+	std::vector<buw::Vector3i> triangles;
+	triangles.reserve(surface.getTriangleCount());
+	for (const buw::Vector3i& face : surface.getTriangeFaces())
+	{
+		if (face[0] >= 0 && face[0] < pointCount && face[1] >= 0 && face[1] < pointCount && face[2] >= 0 && face[2] < pointCount
+			&& face[0] != face[1] && face[1] != face[2] && face[0] != face[2])
+			triangles.push_back(face);
+	}
+
+	if (triangles.empty())
+		return;
+
+	buw::Vector2d boundsMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	buw::Vector2d boundsMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+	for (const buw::Vector3i& face : triangles)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			boundsMin = boundsMin.cwiseMin(points[face[k]].head<2>());
+			boundsMax = boundsMax.cwiseMax(points[face[k]].head<2>());
+		}
+	}
+
+	// Assign each triangle to the tile containing its centroid.
+	const double width = std::max(boundsMax.x() - boundsMin.x(), 1e-9);
+	const double height = std::max(boundsMax.y() - boundsMin.y(), 1e-9);
+	double tileSize = desc_.tileSize;
+	if (!(tileSize > 0.0))
+		tileSize = std::sqrt(width * height * 16384.0 / triangles.size());
+
+	const int tileCountX = std::max(1, std::min(4096, static_cast<int>(std::ceil(width / tileSize))));
+	const int tileCountY = std::max(1, std::min(4096, static_cast<int>(std::ceil(height / tileSize))));
+
+	std::vector<int> tileOfTriangle(triangles.size());
+	std::vector<int> tileStart(tileCountX * tileCountY + 1, 0);
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		const buw::Vector3i& face = triangles[i];
+		const buw::Vector2d centroid = (points[face[0]].head<2>() + points[face[1]].head<2>() + points[face[2]].head<2>()) / 3.0;
+		const int x = std::max(0, std::min(tileCountX - 1, static_cast<int>((centroid.x() - boundsMin.x()) / tileSize)));
+		const int y = std::max(0, std::min(tileCountY - 1, static_cast<int>((centroid.y() - boundsMin.y()) / tileSize)));
+		tileOfTriangle[i] = y * tileCountX + x;
+		tileStart[tileOfTriangle[i] + 1]++;
+	}
+	for (int i = 0; i < tileCountX * tileCountY; i++)
+		tileStart[i + 1] += tileStart[i];
+
+	std::vector<int> order(triangles.size());
+	std::vector<int> fill(tileStart.begin(), tileStart.end() - 1);
+	for (int i = 0; i < static_cast<int>(triangles.size()); i++)
+		order[fill[tileOfTriangle[i]]++] = i;
+
+	std::vector<int> cells;
+	for (int i = 0; i < tileCountX * tileCountY; i++)
+	{
+		if (tileStart[i + 1] > tileStart[i])
+			cells.push_back(i);
+	}
+	tiles_.resize(cells.size());
+
+	const int threadCount = desc_.threadCount > 0 ? desc_.threadCount : omp_get_max_threads();
+
+#pragma omp parallel num_threads(threadCount)
+	{
+		std::vector<int> local(pointCount, -1);
+
+#pragma omp for schedule(dynamic)
+		for (int i = 0; i < static_cast<int>(cells.size()); i++)
+		{
+			// Copy the triangles of the tile with their points renumbered.
+			std::vector<buw::Vector3d> tilePoints;
+			std::vector<buw::Vector3i> tileTriangles;
+			for (int j = tileStart[cells[i]]; j < tileStart[cells[i] + 1]; j++)
+			{
+				buw::Vector3i face = triangles[order[j]];
+				for (int k = 0; k < 3; k++)
+				{
+					if (local[face[k]] < 0)
+					{
+						local[face[k]] = static_cast<int>(tilePoints.size());
+						tilePoints.push_back(points[face[k]]);
+					}
+					face[k] = local[face[k]];
+				}
+				tileTriangles.push_back(face);
+			}
+
+			for (int j = tileStart[cells[i]]; j < tileStart[cells[i] + 1]; j++)
+			{
+				const buw::Vector3i& face = triangles[order[j]];
+				local[face[0]] = local[face[1]] = local[face[2]] = -1;
+			}
+
+			buildTile(tiles_[i], tilePoints, tileTriangles);
+		}
+	}
+}
+
+TerrainLOD::~TerrainLOD()
+{
+}
+
+void TerrainLOD::buildTile(Tile& tile, const std::vector<buw::Vector3d>& points, const std::vector<buw::Vector3i>& triangles) const
+{
+	tile.boundsMin = buw::Vector3d(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	tile.boundsMax = buw::Vector3d(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+	for (const buw::Vector3d& p : points)
+	{
+		tile.boundsMin = tile.boundsMin.cwiseMin(p);
+		tile.boundsMax = tile.boundsMax.cwiseMax(p);
+	}
+
+	// Each level continues the simplification of the previous one, the removed points are tracked across levels.
+	TileSimplifier simplifier(points, triangles);
+	tile.levels.resize(desc_.levelCount);
+	tile.levels[0] = simplifier.createMesh(0.0, desc_.maximumError * desc_.skirtDepthFactor);
+
+	double error = desc_.maximumError;
+	for (int level = 1; level < desc_.levelCount; level++)
+	{
+		simplifier.simplify(error);
+		tile.levels[level] = simplifier.createMesh(error, error * desc_.skirtDepthFactor);
+		error *= 2.0;
+	}
+}
+
+int TerrainLOD::getTileCount() const
+{
+	return static_cast<int>(tiles_.size());
+}
+
+int TerrainLOD::getLevelCount() const
+{
+	return desc_.levelCount;
+}
+
+const TerrainLODMesh& TerrainLOD::getMesh(const int tile, const int level) const
+{
+	BLUE_ASSERT(tile >= 0 && tile < getTileCount(), "Invalid tile.");
+	BLUE_ASSERT(level >= 0 && level < getLevelCount(), "Invalid level.");
+
+	return tiles_[tile].levels[level];
+}
+
+void TerrainLOD::getTileBounds(const int tile, buw::Vector3d& o_min, buw::Vector3d& o_max) const
+{
+	BLUE_ASSERT(tile >= 0 && tile < getTileCount(), "Invalid tile.");
+
+	o_min = tiles_[tile].boundsMin;
+	o_max = tiles_[tile].boundsMax;
+}
+
+std::vector<int> TerrainLOD::selectLevels(const buw::Vector3d& camera, const double errorPerDistance) const
+{
+	std::vector<int> levels(tiles_.size(), 0);
+	for (size_t i = 0; i < tiles_.size(); i++)
+	{
+		const Tile& tile = tiles_[i];
+		const double distance = (camera.cwiseMax(tile.boundsMin).cwiseMin(tile.boundsMax) - camera).norm();
+		for (int level = desc_.levelCount - 1; level > 0; level--)
+		{
+			if (tile.levels[level].error <= distance * errorPerDistance)
+			{
+				levels[i] = level;
+				break;
+			}
+		}
+	}
+	return levels;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
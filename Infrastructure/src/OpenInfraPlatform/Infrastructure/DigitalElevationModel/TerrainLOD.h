@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_TerrainLOD_3c8f1e52_a6d4_4b97_9e2b_0f7a5d61c8e3_h
+#define OpenInfraPlatform_Infrastructure_TerrainLOD_3c8f1e52_a6d4_4b97_9e2b_0f7a5d61c8e3_h
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_BEGIN
+
+struct TerrainLODDescription
+{
+	//! Edge length of the square tiles, 0 chooses the size for about 16384 triangles per tile.
+	double	tileSize = 0.0;
+
+	//! Number of levels per tile including the unsimplified level 0.
+	int		levelCount = 5;
+
+	//! Maximum vertical error of level 1, each further level doubles it.
+	double	maximumError = 0.1;
+
+	//! Depth of the skirts relative to the error of the level.
+	double	skirtDepthFactor = 2.0;
+
+	//! Number of threads used to build the tiles, 0 uses all available.
+	int		threadCount = 0;
+};
+
+struct TerrainLODMesh
+{
+	//! Points and triangles of the tile including the skirts, the triangles keep the orientation of the surface.
+	std::vector<buw::Vector3d>	points;
+	std::vector<buw::Vector3i>	triangles;
+
+	//! Maximum vertical distance of the removed surface points to this mesh.
+	double						error = 0.0;
+};
+
+//! Splits a surface into tiles and simplifies each tile to several levels of detail. Each level removes points by edge collapses as long as no
+//! point of the original tile deviates more than the error of the level in height. Each mesh gets vertical skirts along its border which hide
+//! the cracks between neighbouring tiles of different levels.
+class BLUEINFRASTRUCTURE_API TerrainLOD
+{
+public:
+	//! Builds all tiles and levels, the tiles are built in parallel.
+	TerrainLOD(const Surface& surface, const TerrainLODDescription& desc = TerrainLODDescription());
+
+	virtual ~TerrainLOD();
+
+	//! Returns the number of tiles, tiles without triangles are left out.
+	int getTileCount() const;
+
+	int getLevelCount() const;
+
+	const TerrainLODMesh& getMesh(const int tile, const int level) const;
+
+	//! Returns the bounding box of the tile without skirts.
+	void getTileBounds(const int tile, buw::Vector3d& o_min, buw::Vector3d& o_max) const;
+
+	//! Selects a level for each tile: the coarsest one whose error does not exceed the distance of the camera to the tile times 'errorPerDistance'.
+	//! With a projection this is the tolerated error in pixels times the size of a pixel at distance 1.
+	std::vector<int> selectLevels(const buw::Vector3d& camera, const double errorPerDistance) const;
+
+private:
+	struct Tile
+	{
+		buw::Vector3d					boundsMin;
+		buw::Vector3d					boundsMax;
+		std::vector<TerrainLODMesh>		levels;
+	};
+
+	void buildTile(Tile& tile, const std::vector<buw::Vector3d>& points, const std::vector<buw::Vector3i>& triangles) const;
+
+private:
+	TerrainLODDescription	desc_;
+	std::vector<Tile>		tiles_;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_INFRASTRUCTURE_END
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::TerrainLODDescription;
+	using OpenInfraPlatform::Infrastructure::TerrainLODMesh;
+	using OpenInfraPlatform::Infrastructure::TerrainLOD;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_TerrainLOD_3c8f1e52_a6d4_4b97_9e2b_0f7a5d61c8e3_h
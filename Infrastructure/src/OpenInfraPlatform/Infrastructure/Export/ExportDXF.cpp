@@ -0,0 +1,81 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ExportDXF.h"
+
+void OpenInfraPlatform::Infrastructure::ExportDXF::addLayer(FILE *fp, const char* name, const int color)
+{
+	fprintf(fp, "0\nLAYER\n2\n%s\n70\n0\n62\n%d\n6\nCONTINUOUS\n", name, color);
+}
+
+void OpenInfraPlatform::Infrastructure::ExportDXF::addPolyline(FILE *fp, const char* layer, const std::vector<buw::Vector3d>& points, const bool closed)
+{
+	// Flag 8 marks a 3D polyline, 1 a closed one.
+	fprintf(fp, "0\nPOLYLINE\n8\n%s\n66\n1\n10\n0.0\n20\n0.0\n30\n0.0\n70\n%d\n", layer, closed ? 9 : 8);
+	for (const auto& p : points)
+	{
+		fprintf(fp, "0\nVERTEX\n8\n%s\n10\n%f\n20\n%f\n30\n%f\n70\n32\n", layer, p.x(), p.y(), p.z());
+	}
+	fprintf(fp, "0\nSEQEND\n8\n%s\n", layer);
+}
+
+OpenInfraPlatform::Infrastructure::ExportDXF::ExportDXF(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename, const buw::ContourDescription& contours) :
+	Export(am, dem, filename)
+{
+	FILE *fp = fopen(filename.c_str(), "w");
+
+	if (!fp)
+		return;
+
+	// Layers
+	fprintf(fp, "0\nSECTION\n2\nTABLES\n0\nTABLE\n2\nLAYER\n70\n3\n");
+	addLayer(fp, "Contours", 33);
+	addLayer(fp, "ContoursMajor", 30);
+	addLayer(fp, "Alignments", 5);
+	fprintf(fp, "0\nENDTAB\n0\nENDSEC\n");
+
+	fprintf(fp, "0\nSECTION\n2\nENTITIES\n");
+
+	// Contours
+	for (const auto& contour : digitalElevationModel_->createContours(contours))
+	{
+		std::vector<buw::Vector3d> points;
+		points.reserve(contour.points.size());
+		for (const auto& p : contour.points)
+		{
+			points.push_back(buw::Vector3d(p.x(), p.y(), contour.height));
+		}
+		addPolyline(fp, contour.major ? "ContoursMajor" : "Contours", points, contour.closed);
+	}
+
+	// Alignments
+	for (const auto& alignment : alignmentModel_->getAlignments())
+	{
+		std::vector<buw::Vector3d> points;
+		for (double s = alignment->getStartStation(); s < alignment->getEndStation(); s += 1.0)
+		{
+			points.push_back(alignment->getPosition(s));
+		}
+		points.push_back(alignment->getPosition(alignment->getEndStation()));
+		addPolyline(fp, "Alignments", points, false);
+	}
+
+	fprintf(fp, "0\nENDSEC\n0\nEOF\n");
+
+	fclose(fp);
+}
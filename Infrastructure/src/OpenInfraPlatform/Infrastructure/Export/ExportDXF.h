@@ -0,0 +1,52 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_ExportDXF_7c1e4a93_2f58_4d6b_b0a7_91e3c5d82f16_h
+#define OpenInfraPlatform_Infrastructure_ExportDXF_7c1e4a93_2f58_4d6b_b0a7_91e3c5d82f16_h
+
+#include "OpenInfraPlatform/Infrastructure/Export/Export.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Contour.h"
+#include <BlueFramework/Core/Math/vector.h>
+#include <cstdio>
+#include <vector>
+
+namespace OpenInfraPlatform
+{
+	namespace Infrastructure
+	{
+		//! Writes the contours of the surfaces and the alignments as 3D polylines to an ASCII DXF file. Contours are on the layers
+		//! "Contours" and "ContoursMajor", alignments are sampled every meter on the layer "Alignments".
+		class BLUEINFRASTRUCTURE_API ExportDXF : public Export
+		{
+		public:
+			ExportDXF(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename, const buw::ContourDescription& contours);
+
+		private:
+			void addLayer(FILE *fp, const char* name, const int color);
+			void addPolyline(FILE *fp, const char* layer, const std::vector<buw::Vector3d>& points, const bool closed);
+		}; // end class ExportDXF
+	} // end namespace Infrastructure
+} // end namespace OpenInfraPlatform
+
+namespace buw
+{
+	using OpenInfraPlatform::Infrastructure::ExportDXF;
+}
+
+#endif // end define OpenInfraPlatform_Infrastructure_ExportDXF_7c1e4a93_2f58_4d6b_b0a7_91e3c5d82f16_h
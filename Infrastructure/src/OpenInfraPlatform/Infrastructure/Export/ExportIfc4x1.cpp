@@ -226,8 +226,12 @@ public:
 
                 buw::ReferenceCounted<buw::Alignment3DBased3D> alignment = std::static_pointer_cast<buw::Alignment3DBased3D>(alignments[ai]);
 
-                for (double s = alignment->getStartStation(); s < alignment->getEndStation(); s += 1.0) {
-                    auto position = alignment->getPosition(s) - centerOffset;
+                const std::vector<buw::Stationing> stations = alignment->getTessellation(0.001);
+                std::vector<buw::Vector3d> positions(stations.size());
+                alignment->getPositions(stations.data(), static_cast<int>(stations.size()), positions.data(), nullptr, nullptr, 0);
+
+                for (const auto& p : positions) {
+                    auto position = p - centerOffset;
 
                     std::vector<shared_ptr<IfcLengthMeasure>> coordinates;
                     for (int i = 0; i < 3; i++) {
@@ -700,8 +704,9 @@ private:
                        buw::Vector3d& centerOffset,
                        shared_ptr<IfcGeometricRepresentationContext> geometricRepresentationContext,
                        shared_ptr<IfcRelContainedInSpatialStructure> c2) {
-        for (int i = 0; i < dem->getSurfaceCount(); i++) {
-            buw::ReferenceCounted<buw::Surface> s = dem->getSurface(i);
+        const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = dem->getTriangulatedSurfaces();
+        for (int i = 0; i < static_cast<int>(surfaces.size()); i++) {
+            buw::ReferenceCounted<buw::Surface> s = surfaces[i];
 
             int tempId = getCurrentEntityId();
             if (settings_.useFixedEntityIdForGeometry) {
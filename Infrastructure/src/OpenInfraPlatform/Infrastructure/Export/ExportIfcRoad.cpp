@@ -190,9 +190,13 @@ public:
 
 						buw::ReferenceCounted<buw::Alignment3DBased3D> alignment = std::static_pointer_cast<buw::Alignment3DBased3D>(alignment);
 
-						for (double s = alignment->getStartStation(); s < alignment->getEndStation(); s += 1.0)
+						const std::vector<buw::Stationing> stations = alignment->getTessellation(0.001);
+						std::vector<buw::Vector3d> positions(stations.size());
+						alignment->getPositions(stations.data(), static_cast<int>(stations.size()), positions.data(), nullptr, nullptr, 0);
+
+						for (const auto& p : positions)
 						{
-							auto position = alignment->getPosition(s) - centerOffset;
+							auto position = p - centerOffset;
 
 							std::vector<buw::ReferenceCounted<IfcLengthMeasure>> coordinates;
 							for (int i = 0; i < 3; i++)
@@ -634,9 +638,10 @@ private:
 		buw::ReferenceCounted<IfcGeometricRepresentationContext> geometricRepresentationContext,
 		buw::ReferenceCounted<IfcRelContainedInSpatialStructure> c2)
 	{
-		for (int i = 0; i < dem->getSurfaceCount(); i++)
+		const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = dem->getTriangulatedSurfaces();
+		for (int i = 0; i < static_cast<int>(surfaces.size()); i++)
 		{
-			buw::ReferenceCounted<buw::Surface> s = dem->getSurface(i);
+			buw::ReferenceCounted<buw::Surface> s = surfaces[i];
 
 			buw::ReferenceCounted<IfcTriangulatedFaceSet> triangluratedFaceSet = std::make_shared<IfcTriangulatedFaceSet>(createEntityId());
 			model_->insertEntity(triangluratedFaceSet);
@@ -73,12 +73,13 @@ OpenInfraPlatform::Infrastructure::ExportLandXML::ExportLandXML(buw::ReferenceCo
 	application.setAttribute("timeStamp", QDateTime::currentDateTime().toString("yyyy-MM-ddThh:mm:ss"));
 
 	// Surfaces
-	for (int i = 0; i < digitalElevationModel_->getSurfaceCount(); i++)
+	const std::vector<buw::ReferenceCounted<buw::Surface>> triangulatedSurfaces = digitalElevationModel_->getTriangulatedSurfaces();
+	for (int i = 0; i < static_cast<int>(triangulatedSurfaces.size()); i++)
 	{
 		QDomElement surfaces = doc.createElement("Surfaces");
 		root.appendChild(surfaces);
 
-		buw::ReferenceCounted<buw::Surface> currentSurface = digitalElevationModel_->getSurface(i);
+		buw::ReferenceCounted<buw::Surface> currentSurface = triangulatedSurfaces[i];
 
 		QDomElement surface = doc.createElement("Surface");
 		surfaces.appendChild(surface);
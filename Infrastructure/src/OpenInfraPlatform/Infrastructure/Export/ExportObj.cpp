@@ -16,8 +16,41 @@
 */
 
 #include "ExportObj.h"
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CorridorMeshBuilder.h"
+#include <fstream>
+#include <iomanip>
 
-OpenInfraPlatform::Infrastructure::ExportObj::ExportObj()
+OpenInfraPlatform::Infrastructure::ExportObj::ExportObj(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename) :
+	Export(am, dem, filename)
 {
+	std::ofstream file(filename_);
+	file << std::fixed << std::setprecision(4);
 
+	// Indices of OBJ files start at 1 and continue over all objects, each point has a texture coordinate with the same index.
+	int offset = 1;
+	for (const auto& alignment : alignmentModel_->getAlignments())
+	{
+		if (alignment->getType() != e3DAlignmentType::e2DBased)
+			continue;
+
+		const buw::CorridorMeshBuilder builder(std::static_pointer_cast<Alignment2DBased3D>(alignment));
+		const buw::CorridorMesh mesh = builder.getMergedMesh();
+		if (mesh.triangles.empty())
+			continue;
+
+		file << "o " << alignment->getName().toStdString() << std::endl;
+		for (const buw::Vector3d& p : mesh.points)
+			file << "v " << p.x() << " " << p.y() << " " << p.z() << "\n";
+		for (const buw::Vector2d& t : mesh.textureCoordinates)
+			file << "vt " << t.x() << " " << t.y() << "\n";
+		for (const buw::Vector3i& triangle : mesh.triangles)
+		{
+			file << "f";
+			for (int corner = 0; corner < 3; corner++)
+				file << " " << triangle[corner] + offset << "/" << triangle[corner] + offset;
+			file << "\n";
+		}
+
+		offset += static_cast<int>(mesh.points.size());
+	}
 }
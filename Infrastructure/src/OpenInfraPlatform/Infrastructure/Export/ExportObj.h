@@ -19,22 +19,21 @@
 #ifndef OpenInfraPlatform_Infrastructure_ObjExport_b64d487c_2700_4abb_8aab_fc866636400a_h
 #define OpenInfraPlatform_Infrastructure_ObjExport_b64d487c_2700_4abb_8aab_fc866636400a_h
 
-#include <boost/noncopyable.hpp>
+#include "OpenInfraPlatform/Infrastructure/Export/Export.h"
 
 namespace OpenInfraPlatform
 {
 	namespace Infrastructure
 	{
-		class ExportObj : private boost::noncopyable
+		//! Wavefront OBJ exporter for the road bodies, one object per alignment with the triangles of its corridor mesh.
+		class BLUEINFRASTRUCTURE_API ExportObj : public Export
 		{
 		public:
-			ExportObj();
+			ExportObj(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename);
 
 			virtual ~ExportObj()
 			{
 			}
-
-		private:
 		}; // end class ObjExport
 	} // end namespace Infrastructure
 } // end namespace BlueFramework
@@ -55,7 +55,7 @@ public:
         version = Oklabi::Version::Erzeuge(majorVersion, minorVersion);
         bestand = Oklabi::Datenbestand::Erzeuge(version);
 
-        if (digitalElevationModel_->getSurfaceCount()) {
+        if (digitalElevationModel_->hasSurfaces()) {
             exportDigitalElevationModel(digitalElevationModel_);
         }
 
@@ -135,8 +135,9 @@ private:
         Oklabi::Fachobjekt* dgm = bestand->FuegeHinzu(Oklabi::Objektart::Gib("DGM", version));
         dgm->Setze("Bezeichnung", Oklabi::AnyType::Erzeuge<Oklabi::Text>("Gelndemodell"));
 
-        for (int i = 0; i < digitalElevationModel->getSurfaceCount(); i++) {
-            buw::ReferenceCounted<buw::Surface> surface = digitalElevationModel->getSurface(i);
+        const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = digitalElevationModel->getTriangulatedSurfaces();
+        for (int i = 0; i < static_cast<int>(surfaces.size()); i++) {
+            buw::ReferenceCounted<buw::Surface> surface = surfaces[i];
 
             const std::vector<buw::Vector3d>& points = surface->getPoints();
             std::vector<Oklabi::Fachobjekt*> punkte;
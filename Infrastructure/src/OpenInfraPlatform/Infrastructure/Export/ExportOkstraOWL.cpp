@@ -598,8 +598,9 @@ public:
 			raptor_free_statement(triple);
 		}
 
-		for (int i = 0; i < dem->getSurfaceCount(); i++) {
-			buw::String name = dem->getSurface(i)->getName();
+		const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = dem->getTriangulatedSurfaces();
+		for (int i = 0; i < static_cast<int>(surfaces.size()); i++) {
+			buw::String name = surfaces[i]->getName();
 
 			std::stringstream dgmUniqueBlankTermName;
 			dgmUniqueBlankTermName << "dgm_" << i << "_element_" << i;
@@ -630,7 +631,7 @@ public:
 
 			// out << "\t" << "okstra:hat_Dreiecke [" << std::endl;
 
-			buw::ReferenceCounted<buw::Surface> surface = dem->getSurface(i);
+			buw::ReferenceCounted<buw::Surface> surface = surfaces[i];
 
 			const std::vector<buw::Vector3d>& points = surface->getPoints();
 
@@ -52,7 +52,10 @@ void OpenInfraPlatform::Infrastructure::ExportSVG::outputToSVG(FILE *fp, buw::Re
 
 		if (he->getAlignmentType() == buw::eHorizontalAlignmentType::Clothoid)
 		{	
-			for (float s = 0.0f; s < 1.0f; s+=0.05f) // use 20 segments to approximate clothoid
+			// approximate the clothoid by chords within 1 cm, denser where it is curved more
+			std::vector<double> lerpParameters;
+			he->getTessellation(0.01, lerpParameters);
+			for (double s : lerpParameters)
 			{
 				buw::Vector2d end = he->getPosition(s);
 				output += "L " + std::to_string(end.x()) + "," + std::to_string(-end.y()) + " ";
@@ -73,10 +76,45 @@ void OpenInfraPlatform::Infrastructure::ExportSVG::addPath(FILE *fp, const buw::
 	fprintf(fp, "<path d=\"M %f,%f L %f,%f L %f,%f z\"/>\n", a.x(), -a.y(), b.x(), -b.y(), c.x(), -c.y());
 }
 
+void OpenInfraPlatform::Infrastructure::ExportSVG::outputContours(FILE *fp, const buw::ContourDescription& desc)
+{
+	fprintf(fp, "<g id=\"Contours\">\n");
+
+	for (const auto& contour : digitalElevationModel_->createContours(desc))
+	{
+		std::string output = "<path class=\"" + std::string(contour.major ? "contourMajor" : "contour") + "\" d=\"M ";
+		for (size_t i = 0; i < contour.points.size(); i++)
+		{
+			output += (i == 0 ? "" : "L ") + std::to_string(contour.points[i].x()) + "," + std::to_string(-contour.points[i].y()) + " ";
+		}
+		output += contour.closed ? "z\"/>\n" : "\"/>\n";
+		fputs(output.c_str(), fp);
+
+		if (contour.major)
+		{
+			const buw::Vector2d& p = contour.points[contour.points.size() / 2];
+			fprintf(fp, "<text x=\"%f\" y=\"%f\" class=\"contourtext\">%g</text>\n", p.x(), -p.y(), contour.height);
+		}
+	}
+
+	fprintf(fp, "</g>\n");
+}
+
 OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename) :
 	Export(am, dem, filename)
 {
-	FILE *fp = fopen(filename.c_str(), "w");
+	write(nullptr);
+}
+
+OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename, const buw::ContourDescription& contours) :
+	Export(am, dem, filename)
+{
+	write(&contours);
+}
+
+void OpenInfraPlatform::Infrastructure::ExportSVG::write(const buw::ContourDescription* contours)
+{
+	FILE *fp = fopen(filename_.c_str(), "w");
 
 	if (!fp)
 		return;
@@ -97,19 +135,21 @@ OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<bu
 		Alignmentsmin = alignmentModel_->getAlignment(0)->getPosition(0);		Alignmentsmax = alignmentModel_->getAlignment(0)->getPosition(0);
 		for (const auto& alignment : alignmentModel_->getAlignments())
 		{
-			for (double s = alignment->getStartStation(); s < alignment->getEndStation(); s += 1.0)
+			const std::vector<buw::Stationing> stations = alignment->getTessellation(0.01);
+			std::vector<buw::Vector3d> positions(stations.size());
+			alignment->getPositions(stations.data(), static_cast<int>(stations.size()), positions.data(), nullptr, nullptr, 0);
+			for (const auto& p : positions)
 			{
-				auto p = alignment->getPosition(s);
 				Alignmentsmin = buw::minimizedVector(Alignmentsmin, p);
-				Alignmentsmax = buw::minimizedVector(Alignmentsmax, p);
+				Alignmentsmax = buw::maximizedVector(Alignmentsmax, p);
 			}
 		}
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0)
+	if (digitalElevationModel_->hasSurfaces())
 	{
 		digitalElevationModel_->getSurfacesExtend(Surfacesmin, Surfacesmax);
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0 && alignmentModel_->getAlignmentCount() != 0)
+	if (digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() != 0)
 	{
 		for (int i = 0; i < 2; i++)
 		{
@@ -125,23 +165,24 @@ OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<bu
 			else pmax[i] = Surfacesmax[i];
 		}
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0 && alignmentModel_->getAlignmentCount() == 0)
+	if (digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() == 0)
 	{
 		pmin = Surfacesmin;	pmax = Surfacesmax;
 	}
-	if (digitalElevationModel_->getSurfaceCount() == 0 && alignmentModel_->getAlignmentCount() != 0)
+	if (!digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() != 0)
 	{
 		pmin = Alignmentsmin;		pmax = Alignmentsmax;
 	}
-	if (alignmentModel_->getAlignmentCount() == 0 && digitalElevationModel_->getSurfaceCount() == 0)
+	if (alignmentModel_->getAlignmentCount() == 0 && !digitalElevationModel_->hasSurfaces())
 	{
 		Alignmentsmax = Alignmentsmin = Surfacesmin = Surfacesmax = pnull;
 	}
 	fprintf(fp, "width=\"1280\" height=\"1024\" viewBox=\" %f %f %f %f \">\n", pmin[0], -pmax[1], abs(pmax[0] - pmin[0]), abs(pmax[1] - pmin[1]));
-	fprintf(fp, "<style type=\"text/css\"><![CDATA[.surface{stroke:black;stroke-width:0.001in;fill:orange;}.parcel{stroke:blue;stroke-width:0.01in;fill:none;}.planFeature{stroke:cyan;stroke-width:0.01in;fill:none;}.alignment{stroke:blue;stroke-width:0.02in;fill:none;}.cgpoint{fill:cyan;}.cgpointtext{font-family:'Verdana';font-size:8%;}]]></style>");
+	fprintf(fp, "<style type=\"text/css\"><![CDATA[.surface{stroke:black;stroke-width:0.001in;fill:orange;}.parcel{stroke:blue;stroke-width:0.01in;fill:none;}.planFeature{stroke:cyan;stroke-width:0.01in;fill:none;}.alignment{stroke:blue;stroke-width:0.02in;fill:none;}.cgpoint{fill:cyan;}.cgpointtext{font-family:'Verdana';font-size:8%;}.contour{stroke:saddlebrown;stroke-width:0.005in;fill:none;}.contourMajor{stroke:saddlebrown;stroke-width:0.01in;fill:none;}.contourtext{font-family:'Verdana';font-size:8%;fill:saddlebrown;}]]></style>");
 
 	// Surfaces
-	for (int i = 0; i < digitalElevationModel_->getSurfaceCount(); i++)
+	const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = digitalElevationModel_->getTriangulatedSurfaces();
+	for (int i = 0; i < static_cast<int>(surfaces.size()); i++)
 	{
 		std::list <int> unsortIDList;
 		std::list <int>::const_iterator iter1;
@@ -149,7 +190,7 @@ OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<bu
 		fprintf(fp, "<g id=\"Surfaces\">\n");
 		fprintf(fp, "<g id=\"SurfaceSet_\" class=\"surface\">\n");
 		fprintf(fp, "<g>");
-		buw::ReferenceCounted<buw::Surface> currentSurface = digitalElevationModel_->getSurface(i);
+		buw::ReferenceCounted<buw::Surface> currentSurface = surfaces[i];
 		int x = 0; // first point has always id 0 - old behaviour was differntly from this  //currentSurface.getPoints()[0].id;
 
 		// the following code until "gaps found" searches for gaps in the point ids
@@ -213,6 +254,12 @@ OpenInfraPlatform::Infrastructure::ExportSVG::ExportSVG(buw::ReferenceCounted<bu
 		fprintf(fp, "</g>\n");
 		fprintf(fp, "</g>\n");
 	}
+
+	// Contours
+	if (contours)
+	{
+		outputContours(fp, *contours);
+	}
 	
 	// Horizontal alignment
 	fprintf(fp, "<g id=\"AlignmentSet_\" class=\"alignment\">\n");
@@ -35,8 +35,13 @@ namespace OpenInfraPlatform
 		{
 		public:
 			ExportSVG(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename);
+
+			//! Additionally draws the contours of the surfaces, major contours are labelled with their height.
+			ExportSVG(buw::ReferenceCounted<buw::AlignmentModel> am, buw::ReferenceCounted<buw::DigitalElevationModel> dem, const std::string& filename, const buw::ContourDescription& contours);
 			
 		private:
+			void write(const buw::ContourDescription* contours);
+			void outputContours(FILE *fp, const buw::ContourDescription& desc);
 			void addPath(FILE *fp, const buw::Vector2d& a, const buw::Vector2d& b, const buw::Vector2d& c);
 			void outputToSVG(FILE *fp, buw::ReferenceCounted<buw::HorizontalAlignment2D> horizontalAlignment);
 		}; // end class SVGExport
@@ -104,11 +104,11 @@ OpenInfraPlatform::Infrastructure::ExportSVGEAdvanced::ExportSVGEAdvanced(buw::R
 			}
 		}
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0)
+	if (digitalElevationModel_->hasSurfaces())
 	{
 		digitalElevationModel_->getSurfacesExtend(Surfacesmin, Surfacesmax);
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0 && alignmentModel_->getAlignmentCount() != 0)
+	if (digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() != 0)
 	{
 		for (int i = 0; i < 2; i++)
 		{
@@ -124,15 +124,15 @@ OpenInfraPlatform::Infrastructure::ExportSVGEAdvanced::ExportSVGEAdvanced(buw::R
 			else pmax[i] = Surfacesmax[i];
 		}
 	}
-	if (digitalElevationModel_->getSurfaceCount() != 0 && alignmentModel_->getAlignmentCount() == 0)
+	if (digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() == 0)
 	{
 		pmin = Surfacesmin;	pmax = Surfacesmax;
 	}
-	if (digitalElevationModel_->getSurfaceCount() == 0 && alignmentModel_->getAlignmentCount() != 0)
+	if (!digitalElevationModel_->hasSurfaces() && alignmentModel_->getAlignmentCount() != 0)
 	{
 		pmin = Alignmentsmin;		pmax = Alignmentsmax;
 	}
-	if (alignmentModel_->getAlignmentCount() == 0 && digitalElevationModel_->getSurfaceCount() == 0)
+	if (alignmentModel_->getAlignmentCount() == 0 && !digitalElevationModel_->hasSurfaces())
 	{
 		Alignmentsmax = Alignmentsmin = Surfacesmin = Surfacesmax = pnull;
 	}
@@ -140,7 +140,8 @@ OpenInfraPlatform::Infrastructure::ExportSVGEAdvanced::ExportSVGEAdvanced(buw::R
 	fprintf(fp, "<style type=\"text/css\"><![CDATA[.surface{stroke:black;stroke-width:0.001in;fill:orange;}.parcel{stroke:blue;stroke-width:0.01in;fill:none;}.planFeature{stroke:cyan;stroke-width:0.01in;fill:none;}.alignment{stroke:blue;stroke-width:0.02in;fill:none;}.cgpoint{fill:cyan;}.cgpointtext{font-family:'Verdana';font-size:8%;}]]></style>");
 
 	// Surfaces
-	for (int i = 0; i < digitalElevationModel_->getSurfaceCount(); i++)
+	const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = digitalElevationModel_->getTriangulatedSurfaces();
+	for (int i = 0; i < static_cast<int>(surfaces.size()); i++)
 	{
 		std::list <int> unsortIDList;
 		std::list <int>::const_iterator iter1;
@@ -148,7 +149,7 @@ OpenInfraPlatform::Infrastructure::ExportSVGEAdvanced::ExportSVGEAdvanced(buw::R
 		fprintf(fp, "<g id=\"Surfaces\">\n");
 		fprintf(fp, "<g id=\"SurfaceSet_\" class=\"surface\">\n");
 		fprintf(fp, "<g>");
-		buw::ReferenceCounted<buw::Surface> currentSurface = digitalElevationModel_->getSurface(i);
+		buw::ReferenceCounted<buw::Surface> currentSurface = surfaces[i];
 		int x = 0; // first point has always id 0 - old behaviour was differntly from this  // currentSurface.getPoints()[0].id;
 
 		// the following code until "gaps found" searches for gaps in the point ids
@@ -18,6 +18,8 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include "Octree.h"
 #include <ccPointCloud.h>
 
+#include <algorithm>
+
 OpenInfraPlatform::Infrastructure::Octree::Octree(CCLib::GenericIndexedCloudPersist * cloud) : CCLib::DgmOctree(cloud)
 {
 }
@@ -43,5 +45,101 @@ std::vector<Tuple3i> OpenInfraPlatform::Infrastructure::Octree::getNeighborCellP
 	return positions;
 }
 
+void OpenInfraPlatform::Infrastructure::Octree::remapIndices(const std::vector<int>& remap)
+{
+	// Drop the codes of removed points and renumber the others, the relative order is kept so the codes stay sorted.
+	size_t count = 0;
+	for(size_t i = 0; i < m_thePointsAndTheirCellCodes.size(); i++) {
+		IndexAndCode entry = m_thePointsAndTheirCellCodes[i];
+		int index = entry.theIndex < remap.size() ? remap[entry.theIndex] : -1;
+		if(index >= 0) {
+			entry.theIndex = (unsigned)index;
+			m_thePointsAndTheirCellCodes[count++] = entry;
+		}
+	}
+
+	m_thePointsAndTheirCellCodes.resize(count);
+	m_numberOfProjectedPoints = (unsigned)count;
+
+	// Update the fill indexes and the cell statistics of all levels.
+	updateMinAndMaxTables();
+	updateCellCountTable();
+}
+
+bool OpenInfraPlatform::Infrastructure::Octree::insertPoints(unsigned firstIndex)
+{
+	const unsigned numPoints = m_theAssociatedCloud->size();
+	if(firstIndex >= numPoints)
+		return true;
+
+	CCVector3 bbMin, bbMax;
+	getBoundingBox(bbMin, bbMax);
+	const int maxCellPos = (1 << MAX_OCTREE_LEVEL) - 1;
+
+	// Compute the codes of the new points at the deepest level, the cube of the octree is not changed so existing codes stay valid.
+	cellsContainer inserted = cellsContainer();
+	inserted.reserve(numPoints - firstIndex);
+	CCVector3 pointsMin = m_pointsMin, pointsMax = m_pointsMax;
+	for(unsigned i = firstIndex; i < numPoints; i++) {
+		const CCVector3* P = m_theAssociatedCloud->getPoint(i);
+		if(P->x < bbMin.x || P->y < bbMin.y || P->z < bbMin.z || P->x > bbMax.x || P->y > bbMax.y || P->z > bbMax.z)
+			return false;
+
+		Tuple3i cellPos;
+		getTheCellPosWhichIncludesThePoint(P, cellPos);
+		cellPos.x = std::min(maxCellPos, std::max(0, cellPos.x));
+		cellPos.y = std::min(maxCellPos, std::max(0, cellPos.y));
+		cellPos.z = std::min(maxCellPos, std::max(0, cellPos.z));
+		inserted.emplace_back(i, GenerateCellCode(cellPos, MAX_OCTREE_LEVEL));
+
+		pointsMin = CCVector3(std::min(pointsMin.x, P->x), std::min(pointsMin.y, P->y), std::min(pointsMin.z, P->z));
+		pointsMax = CCVector3(std::max(pointsMax.x, P->x), std::max(pointsMax.y, P->y), std::max(pointsMax.z, P->z));
+	}
+
+	// Only the new codes have to be sorted, merging them with the sorted existing codes is linear.
+	std::sort(inserted.begin(), inserted.end(), IndexAndCode::codeComp);
+	size_t middle = m_thePointsAndTheirCellCodes.size();
+	m_thePointsAndTheirCellCodes.insert(m_thePointsAndTheirCellCodes.end(), inserted.begin(), inserted.end());
+	std::inplace_merge(m_thePointsAndTheirCellCodes.begin(), m_thePointsAndTheirCellCodes.begin() + middle, m_thePointsAndTheirCellCodes.end(), IndexAndCode::codeComp);
+
+	m_numberOfProjectedPoints = (unsigned)m_thePointsAndTheirCellCodes.size();
+	m_pointsMin = pointsMin;
+	m_pointsMax = pointsMax;
+
+	// Update the fill indexes and the cell statistics of all levels.
+	updateMinAndMaxTables();
+	updateCellCountTable();
+	return true;
+}
+
+const CCLib::DgmOctree::cellsContainer &OpenInfraPlatform::Infrastructure::Octree::getPointsAndCellCodes(CCVector3 &o_dimMin, CCVector3 &o_dimMax, CCVector3 &o_pointsMin, CCVector3 &o_pointsMax) const
+{
+	o_dimMin = m_dimMin;
+	o_dimMax = m_dimMax;
+	o_pointsMin = m_pointsMin;
+	o_pointsMax = m_pointsMax;
+	return m_thePointsAndTheirCellCodes;
+}
+
+bool OpenInfraPlatform::Infrastructure::Octree::restore(const CCVector3 &dimMin, const CCVector3 &dimMax, const CCVector3 &pointsMin, const CCVector3 &pointsMax, cellsContainer &&codes)
+{
+	const unsigned numPoints = m_theAssociatedCloud ? m_theAssociatedCloud->size() : 0;
+	for(const IndexAndCode &entry : codes) {
+		if(entry.theIndex >= numPoints)
+			return false;
+	}
 
+	clear();
+	m_dimMin = dimMin;
+	m_dimMax = dimMax;
+	m_pointsMin = pointsMin;
+	m_pointsMax = pointsMax;
+	m_thePointsAndTheirCellCodes = std::move(codes);
+	m_numberOfProjectedPoints = (unsigned)m_thePointsAndTheirCellCodes.size();
 
+	// Recompute the cell sizes from the cube and the fill indexes and cell statistics of all levels from the codes, the same way 'build' does after sorting.
+	updateCellSizeTable();
+	updateMinAndMaxTables();
+	updateCellCountTable();
+	return true;
+}
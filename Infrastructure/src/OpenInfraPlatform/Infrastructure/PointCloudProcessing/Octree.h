@@ -37,6 +37,20 @@ namespace OpenInfraPlatform {
 			CCLib::DgmOctree::CellCode getTruncatedCellCode(const Tuple3i &cellPos, const unsigned char level);
 
 			std::vector<Tuple3i> getNeighborCellPositionsAround(const Tuple3i& cellPos, int neighbourhoodLength, unsigned char level) const;
+
+			// Updates the point indices after the associated cloud has been compacted, points mapped to -1 are removed. The cell codes stay valid since the bounding box is kept.
+			void remapIndices(const std::vector<int> &remap);
+
+			// Sorts the points of the associated cloud starting at 'firstIndex' into the existing cells. Returns false if a point lies outside of the
+			// bounding box of the octree, in this case nothing is changed and the octree has to be rebuilt.
+			bool insertPoints(unsigned firstIndex);
+
+			// Returns the sorted codes of all points together with the cube of the octree and the bounding box of the points, used to store the octree in a cache.
+			const cellsContainer &getPointsAndCellCodes(CCVector3 &o_dimMin, CCVector3 &o_dimMax, CCVector3 &o_pointsMin, CCVector3 &o_pointsMax) const;
+
+			// Restores an octree from codes returned by 'getPointsAndCellCodes' without sorting the points again. Returns false if a code refers to a point
+			// which is not part of the associated cloud, in this case nothing is changed and the octree has to be built.
+			bool restore(const CCVector3 &dimMin, const CCVector3 &dimMax, const CCVector3 &pointsMin, const CCVector3 &pointsMax, cellsContainer &&codes);
 		};
 	}
 }
@@ -0,0 +1,183 @@
+/*
+Copyright (c) 2018 Technical University of Munich
+Chair of Computational Modeling and Simulation.
+
+TUM Open Infra Platform is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License Version 3
+as published by the Free Software Foundation.
+
+TUM Open Infra Platform is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Percentile.h"
+
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+OpenInfraPlatform::Infrastructure::PercentileSketch::PercentileSketch(const double compression)
+	: compression_(std::max(10.0, compression)), totalWeight_(0), bufferedWeight_(0),
+	min_(std::numeric_limits<double>::max()), max_(std::numeric_limits<double>::lowest())
+{
+	// Buffer a multiple of the compression before merging to amortize the sorting.
+	buffer_.reserve((size_t)(5 * compression_));
+	centroids_.reserve((size_t)(2 * compression_));
+}
+
+void OpenInfraPlatform::Infrastructure::PercentileSketch::add(const double value, const double weight)
+{
+	if(weight <= 0 || std::isnan(value))
+		return;
+
+	min_ = std::min(min_, value);
+	max_ = std::max(max_, value);
+
+	buffer_.push_back({ value, weight });
+	bufferedWeight_ += weight;
+
+	if(buffer_.size() >= (size_t)(5 * compression_))
+		compress();
+}
+
+void OpenInfraPlatform::Infrastructure::PercentileSketch::merge(const PercentileSketch & other)
+{
+	if(other.isEmpty())
+		return;
+
+	min_ = std::min(min_, other.min_);
+	max_ = std::max(max_, other.max_);
+
+	// Treat the centroids of the other sketch like buffered values and merge them on the next compression.
+	for(const auto &centroid : other.centroids_) {
+		buffer_.push_back(centroid);
+		bufferedWeight_ += centroid.weight;
+	}
+	for(const auto &centroid : other.buffer_) {
+		buffer_.push_back(centroid);
+		bufferedWeight_ += centroid.weight;
+	}
+
+	compress();
+}
+
+double OpenInfraPlatform::Infrastructure::PercentileSketch::getPercentile(const double percentile)
+{
+	compress();
+
+	if(centroids_.empty())
+		return std::numeric_limits<double>::quiet_NaN();
+
+	if(centroids_.size() == 1 || percentile <= 0)
+		return percentile <= 0 ? min_ : centroids_.front().mean;
+
+	if(percentile >= 1)
+		return max_;
+
+	// The centroid means are interpreted as samples at the center of their weight, interpolate linearly between them.
+	const double index = percentile * totalWeight_;
+
+	const Centroid &first = centroids_.front();
+	if(index < first.weight / 2.0)
+		return min_ + (first.mean - min_) * (index / (first.weight / 2.0));
+
+	double weightSoFar = first.weight / 2.0;
+	for(size_t i = 0; i < centroids_.size() - 1; i++) {
+		const Centroid &left = centroids_[i];
+		const Centroid &right = centroids_[i + 1];
+		const double distance = (left.weight + right.weight) / 2.0;
+
+		if(weightSoFar + distance > index) {
+			const double t = (index - weightSoFar) / distance;
+			return left.mean + t * (right.mean - left.mean);
+		}
+
+		weightSoFar += distance;
+	}
+
+	const Centroid &last = centroids_.back();
+	const double remaining = totalWeight_ - weightSoFar;
+	if(remaining <= 0)
+		return last.mean;
+
+	const double t = std::min(1.0, (index - weightSoFar) / remaining);
+	return last.mean + t * (max_ - last.mean);
+}
+
+double OpenInfraPlatform::Infrastructure::PercentileSketch::getMinimum() const
+{
+	return min_;
+}
+
+double OpenInfraPlatform::Infrastructure::PercentileSketch::getMaximum() const
+{
+	return max_;
+}
+
+double OpenInfraPlatform::Infrastructure::PercentileSketch::getTotalWeight() const
+{
+	return totalWeight_ + bufferedWeight_;
+}
+
+bool OpenInfraPlatform::Infrastructure::PercentileSketch::isEmpty() const
+{
+	return centroids_.empty() && buffer_.empty();
+}
+
+void OpenInfraPlatform::Infrastructure::PercentileSketch::clear()
+{
+	centroids_.clear();
+	buffer_.clear();
+	totalWeight_ = 0;
+	bufferedWeight_ = 0;
+	min_ = std::numeric_limits<double>::max();
+	max_ = std::numeric_limits<double>::lowest();
+}
+
+void OpenInfraPlatform::Infrastructure::PercentileSketch::compress()
+{
+	if(buffer_.empty())
+		return;
+
+	buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+	std::sort(buffer_.begin(), buffer_.end(), [](const Centroid &lhs, const Centroid &rhs) -> bool { return lhs.mean < rhs.mean; });
+
+	totalWeight_ += bufferedWeight_;
+	bufferedWeight_ = 0;
+
+	// Scale function k(q) = delta / (2 pi) * asin(2q - 1) and its inverse, a centroid may span at most one unit of k.
+	const double normalizer = compression_ / (2.0 * M_PI);
+	auto k = [&](const double q) -> double { return normalizer * std::asin(2.0 * std::min(1.0, std::max(0.0, q)) - 1.0); };
+	auto kInverse = [&](const double value) -> double { return (std::sin(std::min(M_PI / 2.0, value / normalizer)) + 1.0) / 2.0; };
+
+	centroids_.clear();
+	Centroid current = buffer_.front();
+	double weightSoFar = 0;
+	double limit = totalWeight_ * kInverse(k(0) + 1.0);
+
+	for(size_t i = 1; i < buffer_.size(); i++) {
+		const Centroid &next = buffer_[i];
+
+		if(weightSoFar + current.weight + next.weight <= limit) {
+			// Merge the next centroid into the current one, weighted mean keeps the sum exact.
+			current.weight += next.weight;
+			current.mean += (next.mean - current.mean) * next.weight / current.weight;
+		}
+		else {
+			weightSoFar += current.weight;
+			centroids_.push_back(current);
+			limit = totalWeight_ * kInverse(k(weightSoFar / totalWeight_) + 1.0);
+			current = next;
+		}
+	}
+
+	centroids_.push_back(current);
+	buffer_.clear();
+}
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2018 Technical University of Munich
+Chair of Computational Modeling and Simulation.
+
+TUM Open Infra Platform is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License Version 3
+as published by the Free Software Foundation.
+
+TUM Open Infra Platform is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_PointCloudProcessing_Percentile_5E0B2C4A_7F31_4D8E_9B6A_1C3F0E8D2A47_h
+#define OpenInfraPlatform_Infrastructure_PointCloudProcessing_Percentile_5E0B2C4A_7F31_4D8E_9B6A_1C3F0E8D2A47_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+namespace OpenInfraPlatform {
+	namespace Infrastructure {
+
+		// Returns the index of the given percentile in a sorted sequence of 'count' values, clamped to the last element.
+		inline size_t getPercentileIndex(const double percentile, const size_t count)
+		{
+			if(count == 0)
+				return 0;
+			return std::min(count - 1, (size_t)std::floor(std::max(0.0, percentile) * count));
+		}
+
+		// Returns the value at the given percentile without sorting the whole range. The range is reordered.
+		template<typename T> T selectPercentile(std::vector<T> &values, const double percentile)
+		{
+			if(values.empty())
+				return T();
+
+			auto nth = values.begin() + getPercentileIndex(percentile, values.size());
+			std::nth_element(values.begin(), nth, values.end());
+			return *nth;
+		}
+
+		struct PercentileRange {
+			double minimum = 0.0, lower = 0.0, upper = 0.0, maximum = 0.0;
+
+			// Position of the upper percentile, all elements from here to the end are not smaller than 'upper'.
+			size_t upperIndex = 0;
+		};
+
+		// Partially orders [first, last) by 'key' using two selections instead of a full sort. Afterwards the elements at the lower and upper
+		// percentile are the ones a sort would place there and all elements in [first + upperIndex, last) form the upper percentile.
+		template<typename Iterator, typename Key> PercentileRange selectPercentileRange(Iterator first, Iterator last, const double lowerPercentile, const double upperPercentile, const Key &key)
+		{
+			typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+			PercentileRange range;
+			const size_t count = std::distance(first, last);
+			if(count == 0)
+				return range;
+
+			auto compare = [&](const value_type &lhs, const value_type &rhs) -> bool { return key(lhs) < key(rhs); };
+
+			const size_t idxUpper = getPercentileIndex(upperPercentile, count);
+			const size_t idxLower = std::min(getPercentileIndex(lowerPercentile, count), idxUpper);
+
+			std::nth_element(first, first + idxUpper, last, compare);
+			std::nth_element(first, first + idxLower, first + idxUpper, compare);
+
+			range.lower = key(*(first + idxLower));
+			range.upper = key(*(first + idxUpper));
+			range.minimum = key(*std::min_element(first, first + idxLower + 1, compare));
+			range.maximum = key(*std::max_element(first + idxUpper, last, compare));
+			range.upperIndex = idxUpper;
+			return range;
+		}
+
+		// Streaming percentile estimator based on a merging t-digest. Values are buffered and merged into centroids whose
+		// size is bounded by the arcsine scale function so that the tails are kept more accurate than the center.
+		// Sketches can be merged, which allows to build one sketch per thread or per cell and combine them afterwards.
+		class BLUEINFRASTRUCTURE_API PercentileSketch {
+		public:
+			PercentileSketch(const double compression = 100.0);
+
+			void add(const double value, const double weight = 1.0);
+
+			void merge(const PercentileSketch &other);
+
+			// Returns the estimated value at the given percentile in [0, 1].
+			double getPercentile(const double percentile);
+
+			double getMinimum() const;
+
+			double getMaximum() const;
+
+			double getTotalWeight() const;
+
+			bool isEmpty() const;
+
+			void clear();
+
+		private:
+			struct Centroid {
+				double mean, weight;
+			};
+
+			void compress();
+
+		private:
+			double compression_;
+			double totalWeight_, bufferedWeight_;
+			double min_, max_;
+			std::vector<Centroid> centroids_, buffer_;
+		};
+	}
+}
+
+namespace buw {
+	using OpenInfraPlatform::Infrastructure::PercentileSketch;
+	using OpenInfraPlatform::Infrastructure::getPercentileIndex;
+	using OpenInfraPlatform::Infrastructure::selectPercentile;
+	using OpenInfraPlatform::Infrastructure::selectPercentileRange;
+	using OpenInfraPlatform::Infrastructure::PercentileRange;
+}
+
+#endif
@@ -18,6 +18,8 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include "PointCloud.h"
 
 #include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/PointCloudSection.h"
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/Percentile.h"
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/UnionFind.h"
 
 #include <BlueFramework/Core/Diagnostics/log.h>
 
@@ -31,9 +33,119 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <liblas/liblas.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <numeric>
 
 #include <QDateTime>
 #include <QDir>
+#include <QFile>
+
+// Logs the duration of a processing stage and passes it to the callback.
+static void reportStageTiming(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback, const std::string &stage, const std::chrono::steady_clock::time_point &start)
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::string info = stage + " took " + std::to_string(seconds) + "s.";
+	BLUE_LOG(trace) << info;
+	if(callback)
+		callback->setInfo(info.data());
+}
+
+// Header of the point cloud cache. All following blocks are stored in native byte order and padded to 8 bytes, so that arrays can be used directly from the mapped file.
+struct PointCloudCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t flags;
+	uint32_t numScalarFields;
+	uint64_t numPoints;
+	// Sizes of the stored types, a cache written by a build with different types is rejected.
+	uint32_t coordinateSize, scalarSize, indexAndCodeSize, reserved;
+	float mainAxis[3];
+	uint32_t reserved2;
+};
+
+static const char cacheMagic[4] = { 'O', 'I', 'P', 'C' };
+static const uint32_t cacheVersion = 1;
+static const uint32_t cacheHasColors = 1 << 0, cacheHasOctree = 1 << 1, cacheHasPairs = 1 << 2, cacheHasCenterline = 1 << 3;
+
+// Writes the blocks of the point cloud cache sequentially.
+class PointCloudCacheWriter {
+public:
+	PointCloudCacheWriter(QFile &file) : file_(file) {}
+
+	template<typename T> void writeArray(const T* data, size_t count) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored in the cache.");
+		static const char padding[8] = { 0 };
+		const qint64 bytes = (qint64)(sizeof(T) * count);
+		const qint64 pad = (8 - bytes % 8) % 8;
+		if(bytes > 0 && file_.write(reinterpret_cast<const char*>(data), bytes) != bytes)
+			bFailed_ = true;
+		if(pad > 0 && file_.write(padding, pad) != pad)
+			bFailed_ = true;
+	}
+
+	template<typename T> void writeValue(const T &value) {
+		writeArray(&value, 1);
+	}
+
+	template<typename T> void writeVector(const std::vector<T> &data) {
+		writeValue((uint64_t)data.size());
+		writeArray(data.data(), data.size());
+	}
+
+	bool failed() const {
+		return bFailed_;
+	}
+
+private:
+	QFile &file_;
+	bool bFailed_ = false;
+};
+
+// Reads the blocks of a mapped point cloud cache sequentially, every read is checked against the size of the file.
+class PointCloudCacheReader {
+public:
+	PointCloudCacheReader(const uchar* data, qint64 size) : data_(data), size_(size) {}
+
+	// Returns a pointer to 'count' elements in the mapped file or nullptr if the file is too short.
+	template<typename T> const T* view(size_t count) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored in the cache.");
+		if(bFailed_ || count > (uint64_t)(size_ - offset_) / sizeof(T)) {
+			bFailed_ = true;
+			return nullptr;
+		}
+		const qint64 bytes = (qint64)(sizeof(T) * count);
+		const T* result = reinterpret_cast<const T*>(data_ + offset_);
+		offset_ = std::min(size_, offset_ + bytes + (8 - bytes % 8) % 8);
+		return result;
+	}
+
+	template<typename T> bool readValue(T &o_value) {
+		const T* value = view<T>(1);
+		if(value)
+			std::memcpy(&o_value, value, sizeof(T));
+		return value != nullptr;
+	}
+
+	template<typename T> bool readVector(std::vector<T> &o_data) {
+		uint64_t count = 0;
+		if(!readValue(count))
+			return false;
+		const T* values = view<T>(count);
+		if(values)
+			o_data.assign(values, values + count);
+		return values != nullptr;
+	}
+
+	bool failed() const {
+		return bFailed_;
+	}
+
+private:
+	const uchar* data_;
+	qint64 size_, offset_ = 0;
+	bool bFailed_ = false;
+};
 
 buw::ReferenceCounted<buw::PointCloud> OpenInfraPlatform::Infrastructure::PointCloud::FromFile(const char *filename) {
 	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>(QString(filename));
@@ -138,6 +250,323 @@ buw::ReferenceCounted<buw::PointCloud> OpenInfraPlatform::Infrastructure::PointC
 	return pointCloud;
 }
 
+buw::ReferenceCounted<buw::PointCloud> OpenInfraPlatform::Infrastructure::PointCloud::FromCache(const char *filename, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	QFile file(filename);
+	if(!file.open(QIODevice::ReadOnly)) {
+		BLUE_LOG(error) << "Could not open point cloud cache " << filename << ".";
+		return nullptr;
+	}
+
+	// Map the whole file, the blocks are copied from the mapping into the arrays of the cloud without parsing.
+	const uchar* data = file.map(0, file.size());
+	if(!data) {
+		BLUE_LOG(error) << "Could not map point cloud cache " << filename << ".";
+		return nullptr;
+	}
+
+	if(callback) {
+		callback->start();
+		callback->setMethodTitle("Loading point cloud cache");
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	PointCloudCacheReader reader = PointCloudCacheReader(data, file.size());
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>(QString(filename));
+
+	auto read = [&]() -> bool {
+		PointCloudCacheHeader header;
+		if(!reader.readValue(header) || std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion) {
+			BLUE_LOG(error) << filename << " is no point cloud cache of version " << cacheVersion << ".";
+			return false;
+		}
+		if(header.coordinateSize != sizeof(PointCoordinateType) || header.scalarSize != sizeof(ScalarType) || header.indexAndCodeSize != sizeof(CCLib::DgmOctree::IndexAndCode)) {
+			BLUE_LOG(error) << "Point cloud cache " << filename << " was written with different coordinate, scalar or cell code types.";
+			return false;
+		}
+
+		const long numPoints = (long)header.numPoints;
+		const PointCoordinateType* coordinates = reader.view<PointCoordinateType>(3 * header.numPoints);
+		if(!coordinates || !pointCloud->resize((unsigned)numPoints))
+			return false;
+
+#pragma omp parallel for
+		for(long i = 0; i < numPoints; i++)
+			*pointCloud->point(i) = CCVector3(coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+
+		if(callback)
+			callback->update(10);
+
+		if(header.flags & cacheHasColors) {
+			const ColorCompType* colors = reader.view<ColorCompType>(3 * header.numPoints);
+			if(!colors || !pointCloud->resizeTheRGBTable(false))
+				return false;
+
+#pragma omp parallel for
+			for(long i = 0; i < numPoints; i++)
+				pointCloud->setPointColor(i, ccColor::Rgb(colors + 3 * i));
+		}
+
+		if(callback)
+			callback->update(20);
+
+		// Restore all named scalar fields with their values.
+		for(uint32_t k = 0; k < header.numScalarFields; k++) {
+			uint64_t nameLength = 0;
+			const char* name = reader.readValue(nameLength) ? reader.view<char>(nameLength) : nullptr;
+			const ScalarType* values = name ? reader.view<ScalarType>(header.numPoints) : nullptr;
+			if(!values)
+				return false;
+
+			int idx = pointCloud->addScalarField(std::string(name, nameLength).data());
+			if(idx == -1)
+				return false;
+
+			CCLib::ScalarField* field = pointCloud->getScalarField(idx);
+#pragma omp parallel for
+			for(long i = 0; i < numPoints; i++)
+				field->setValue(i, values[i]);
+			field->computeMinAndMax();
+		}
+
+		if(callback)
+			callback->update(50);
+
+		pointCloud->mainAxis_ = CCVector3(header.mainAxis[0], header.mainAxis[1], header.mainAxis[2]);
+
+		auto isValid = [&](const std::vector<uint32_t> &indices) -> bool { return std::all_of(indices.begin(), indices.end(), [&](uint32_t i) { return i < numPoints; }); };
+		if(!reader.readVector(pointCloud->remainingIndices_) || !reader.readVector(pointCloud->filteredIndices_) || !reader.readVector(pointCloud->segmentedIndices_))
+			return false;
+		if(!isValid(pointCloud->remainingIndices_) || !isValid(pointCloud->filteredIndices_) || !isValid(pointCloud->segmentedIndices_))
+			return false;
+
+		// Restore the grid with the description it was computed with.
+		uint64_t numCells = 0;
+		if(!reader.readValue(pointCloud->gridDescription_) || !reader.readValue(numCells))
+			return false;
+		for(uint64_t c = 0; c < numCells; c++) {
+			int32_t key[2];
+			PointCoordinateType center[3], axis[2];
+			std::vector<uint32_t> indices;
+			if(!reader.readValue(key) || !reader.readValue(center) || !reader.readValue(axis) || !reader.readVector(indices) || !isValid(indices))
+				return false;
+			pointCloud->grid_[std::pair<int, int>(key[0], key[1])] = std::make_tuple(std::move(indices), CCVector3(center[0], center[1], center[2]), CCVector2(axis[0], axis[1]));
+		}
+
+		if(!reader.readValue(pointCloud->centerlineDescription_))
+			return false;
+		pointCloud->bHasPairs_ = (header.flags & cacheHasPairs) != 0;
+		pointCloud->bHasCenterline_ = (header.flags & cacheHasCenterline) != 0;
+
+		// Restore the sorted cell codes instead of building the octree again, if this fails we fall back to building it.
+		pointCloud->octree_ = buw::makeReferenceCounted<buw::Octree>(pointCloud.get());
+		bool bOctreeRestored = false;
+		if(header.flags & cacheHasOctree) {
+			PointCoordinateType bounds[4][3];
+			CCLib::DgmOctree::cellsContainer codes;
+			if(!reader.readValue(bounds) || !reader.readVector(codes))
+				return false;
+
+			auto toVector = [](const PointCoordinateType* v) { return CCVector3(v[0], v[1], v[2]); };
+			bOctreeRestored = pointCloud->octree_->restore(toVector(bounds[0]), toVector(bounds[1]), toVector(bounds[2]), toVector(bounds[3]), std::move(codes));
+		}
+		if(!bOctreeRestored) {
+			BLUE_LOG(warning) << "Point cloud cache " << filename << " contains no valid octree. Building the octree.";
+			pointCloud->octree_->build();
+		}
+
+		if(callback)
+			callback->update(70);
+
+		// Restore the sections with their points and pairs.
+		uint64_t numSections = 0;
+		if(!reader.readValue(numSections))
+			return false;
+		pointCloud->sections_.reserve(std::min(numSections, (uint64_t)numPoints));
+		for(uint64_t s = 0; s < numSections; s++) {
+			double length = 0.0;
+			uint64_t cellCode = 0;
+			std::vector<uint32_t> indices;
+			std::vector<uint64_t> pairs;
+			if(!reader.readValue(length) || !reader.readValue(cellCode) || !reader.readVector(indices) || !reader.readVector(pairs) || !isValid(indices))
+				return false;
+
+			auto section = buw::makeReferenceCounted<buw::PointCloudSection>(static_cast<GenericIndexedCloudPersist *>(pointCloud.get()));
+			section->setLength(length);
+			section->cellCode_ = (CCLib::DgmOctree::CellCode)cellCode;
+			section->reserve((unsigned)indices.size());
+			for(uint32_t index : indices)
+				section->addPointIndex(index);
+
+			std::vector<std::pair<size_t, size_t>> sectionPairs = std::vector<std::pair<size_t, size_t>>(pairs.size() / 2);
+			for(size_t p = 0; p < sectionPairs.size(); p++)
+				sectionPairs[p] = std::pair<size_t, size_t>(pairs[2 * p], pairs[2 * p + 1]);
+			section->setPairs(sectionPairs);
+
+			pointCloud->sections_.push_back(section);
+		}
+
+		if(callback)
+			callback->update(90);
+
+		return !reader.failed();
+	};
+
+	const bool bValid = read();
+	file.unmap(const_cast<uchar*>(data));
+	file.close();
+
+	if(bValid) {
+		pointCloud->setName(filename);
+		pointCloud->invalidateBoundingBox();
+		reportStageTiming(callback, "Loading the point cloud cache", start);
+	}
+	else {
+		BLUE_LOG(error) << "Point cloud cache " << filename << " is truncated or corrupted.";
+	}
+
+	if(callback)
+		callback->stop();
+
+	return bValid ? pointCloud : nullptr;
+}
+
+int OpenInfraPlatform::Infrastructure::PointCloud::saveCache(const char *filename, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	QFile file(filename);
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		BLUE_LOG(error) << "Could not open point cloud cache " << filename << " for writing.";
+		return -1;
+	}
+
+	if(callback) {
+		callback->start();
+		callback->setMethodTitle("Writing point cloud cache");
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	PointCloudCacheWriter writer = PointCloudCacheWriter(file);
+	const long numPoints = size();
+	const bool bHasColors = rgbColors() != nullptr;
+	const bool bHasOctree = octree_ && octree_->getNumberOfProjectedPoints() > 0;
+
+	PointCloudCacheHeader header = PointCloudCacheHeader();
+	std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = cacheVersion;
+	header.flags = (bHasColors ? cacheHasColors : 0) | (bHasOctree ? cacheHasOctree : 0) | (bHasPairs_ ? cacheHasPairs : 0) | (bHasCenterline_ ? cacheHasCenterline : 0);
+	header.numScalarFields = getNumberOfScalarFields();
+	header.numPoints = (uint64_t)numPoints;
+	header.coordinateSize = sizeof(PointCoordinateType);
+	header.scalarSize = sizeof(ScalarType);
+	header.indexAndCodeSize = sizeof(CCLib::DgmOctree::IndexAndCode);
+	header.mainAxis[0] = mainAxis_.x;
+	header.mainAxis[1] = mainAxis_.y;
+	header.mainAxis[2] = mainAxis_.z;
+	writer.writeValue(header);
+
+	// Gather the coordinates into one block so that they can be written and mapped at once.
+	std::vector<PointCoordinateType> coordinates = std::vector<PointCoordinateType>(3 * numPoints);
+#pragma omp parallel for
+	for(long i = 0; i < numPoints; i++) {
+		const CCVector3* P = getPoint(i);
+		coordinates[3 * i] = P->x;
+		coordinates[3 * i + 1] = P->y;
+		coordinates[3 * i + 2] = P->z;
+	}
+	writer.writeArray(coordinates.data(), coordinates.size());
+	coordinates = std::vector<PointCoordinateType>();
+
+	if(bHasColors) {
+		std::vector<ColorCompType> colors = std::vector<ColorCompType>(3 * numPoints);
+#pragma omp parallel for
+		for(long i = 0; i < numPoints; i++)
+			std::memcpy(colors.data() + 3 * i, getPointColor(i), 3 * sizeof(ColorCompType));
+		writer.writeArray(colors.data(), colors.size());
+	}
+
+	if(callback)
+		callback->update(20);
+
+	std::vector<ScalarType> values = std::vector<ScalarType>(numPoints);
+	for(uint32_t k = 0; k < header.numScalarFields; k++) {
+		const std::string name = getScalarFieldName(k);
+		writer.writeValue((uint64_t)name.size());
+		writer.writeArray(name.data(), name.size());
+
+		CCLib::ScalarField* field = getScalarField(k);
+#pragma omp parallel for
+		for(long i = 0; i < numPoints; i++)
+			values[i] = field->getValue(i);
+		writer.writeArray(values.data(), values.size());
+	}
+	values = std::vector<ScalarType>();
+
+	if(callback)
+		callback->update(50);
+
+	writer.writeVector(remainingIndices_);
+	writer.writeVector(filteredIndices_);
+	writer.writeVector(segmentedIndices_);
+
+	writer.writeValue(gridDescription_);
+	writer.writeValue((uint64_t)grid_.size());
+	for(const auto &cell : grid_) {
+		const CCVector3 &center = std::get<1>(cell.second);
+		const CCVector2 &axis = std::get<2>(cell.second);
+		const int32_t key[2] = { cell.first.first, cell.first.second };
+		const PointCoordinateType centerValues[3] = { center.x, center.y, center.z };
+		const PointCoordinateType axisValues[2] = { axis.x, axis.y };
+		writer.writeValue(key);
+		writer.writeValue(centerValues);
+		writer.writeValue(axisValues);
+		writer.writeVector(std::get<0>(cell.second));
+	}
+
+	writer.writeValue(centerlineDescription_);
+
+	if(bHasOctree) {
+		CCVector3 dimMin, dimMax, pointsMin, pointsMax;
+		const CCLib::DgmOctree::cellsContainer &codes = octree_->getPointsAndCellCodes(dimMin, dimMax, pointsMin, pointsMax);
+		const PointCoordinateType bounds[4][3] = { { dimMin.x, dimMin.y, dimMin.z }, { dimMax.x, dimMax.y, dimMax.z }, { pointsMin.x, pointsMin.y, pointsMin.z }, { pointsMax.x, pointsMax.y, pointsMax.z } };
+		writer.writeValue(bounds);
+		writer.writeVector(codes);
+	}
+
+	if(callback)
+		callback->update(70);
+
+	writer.writeValue((uint64_t)sections_.size());
+	for(const auto &section : sections_) {
+		std::vector<uint32_t> indices = std::vector<uint32_t>(section->size());
+		for(unsigned i = 0; i < section->size(); i++)
+			indices[i] = section->getPointGlobalIndex(i);
+
+		std::vector<uint64_t> pairs = std::vector<uint64_t>();
+		for(const auto &pair : section->getPairs()) {
+			pairs.push_back(pair.first);
+			pairs.push_back(pair.second);
+		}
+
+		writer.writeValue(section->getLength());
+		writer.writeValue((uint64_t)section->cellCode_);
+		writer.writeVector(indices);
+		writer.writeVector(pairs);
+	}
+
+	file.close();
+	const bool bFailed = writer.failed() || file.error() != QFileDevice::NoError;
+	if(bFailed) {
+		BLUE_LOG(error) << "Writing point cloud cache " << filename << " failed.";
+		file.remove();
+	}
+	else {
+		reportStageTiming(callback, "Writing the point cloud cache", start);
+	}
+
+	if(callback)
+		callback->stop();
+
+	return bFailed ? -2 : 0;
+}
+
 OpenInfraPlatform::Infrastructure::PointCloud::PointCloud(PointCloud & other)
 {
 	// Copy base class attributes.
@@ -158,6 +587,7 @@ OpenInfraPlatform::Infrastructure::PointCloud::PointCloud(PointCloud & other)
 
 	// Copy other remaining members.
 	grid_ = other.grid_;
+	gridDescription_ = other.gridDescription_;
 	mainAxis_ = other.mainAxis_;
 	bHasPairs_ = other.bHasPairs_;
 	bHasCenterline_ = other.bHasCenterline_;
@@ -194,59 +624,71 @@ int OpenInfraPlatform::Infrastructure::PointCloud::add(const buw::ReferenceCount
 	if(!color)
 		color = white;
 
-	bool result = true;
-	result &= this->reserve(this->size() + other->size());
+	const unsigned startIndex = this->size();
+	const long numPoints = other->size();
 
-	// If we have an error, return -1.
-	if(!result)
+	// Grow all arrays once instead of appending point by point, if we have an error, return -1.
+	if(!this->resize(startIndex + numPoints)) {
+		if(callback)
+			callback->stop();
 		return -1;
+	}
 
-	result &= this->reserveTheRGBTable();
-
-	// If we have an error, return -2.
-	if(!result)
+	// If we have no colors yet, add the color table filled with white, if we have an error, return -2.
+	if(rgbColors() == nullptr && !this->resizeTheRGBTable(true)) {
+		if(callback)
+			callback->stop();
 		return -2;
+	}
 
-	std::vector<std::pair<int, int>> commonScalarFields = std::vector<std::pair<int, int>>();
+	std::vector<std::pair<CCLib::ScalarField*, CCLib::ScalarField*>> commonScalarFields = std::vector<std::pair<CCLib::ScalarField*, CCLib::ScalarField*>>();
+	bool bHasChainage = false;
 	uint numScalarFields = this->getNumberOfScalarFields();
 	for(size_t idxThis = 0; idxThis < numScalarFields; idxThis++) {
 		std::string name = getScalarFieldName(idxThis);
 		int idxOther = other->getScalarFieldIndexByName(name.data());
-		if(idxOther != -1)
-			commonScalarFields.push_back(std::pair<int, int>(idxThis, idxOther));
+		if(idxOther != -1) {
+			commonScalarFields.push_back(std::pair<CCLib::ScalarField*, CCLib::ScalarField*>(getScalarField(idxThis), other->getScalarField(idxOther)));
+			bHasChainage |= name == "Chainage";
+		}
 	}
 
+	// Copy coordinates, color and common scalar values of the new points in parallel, the arrays have already been resized.
+	const ccColor::Rgb newColor = ccColor::Rgb(color);
+	int tid = 0;
+#pragma omp parallel private(tid) firstprivate(callback)
+	{
+		tid = omp_get_thread_num();
+		long pointsPerPercent = std::max(1l, numPoints / omp_get_num_threads() / 100);
+		long processedPoints = 0;
+		short percentageCompleted = 0;
 
+#pragma omp for
+		for(long i = 0; i < numPoints; i++) {
+			*point(startIndex + i) = *other->getPoint(i);
+			setPointColor(startIndex + i, newColor);
+			for(auto &fields : commonScalarFields)
+				fields.first->setValue(startIndex + i, fields.second->getValue(i));
 
-	long processedPoints = 0;
-	long numPoints = other->size();
-	long pointsPerPercent = std::max(1l, numPoints / 100);
-	short percentageCompleted = 0;
-	size_t startIndex = this->size();
-	ColorCompType red[3] = { 255,0,0 };
-	for(long i = 0; i < numPoints; i++) {
-		this->addPoint(*other->getPoint(i));
-		this->addRGBColor(other->getPointColor(i));		
-		this->setPointColor(startIndex + i, ccColor::Rgb(color));
-		processedPoints++;
-		if(processedPoints % pointsPerPercent == 0) {
-			percentageCompleted++;
-			if(callback)
+			processedPoints++;
+			if(tid == 0 && callback && processedPoints % pointsPerPercent == 0) {
+				percentageCompleted++;
 				callback->update(percentageCompleted);
+			}
 		}
 	}
 
-	this->resize(startIndex + processedPoints);
+	for(auto &fields : commonScalarFields)
+		fields.first->computeMinAndMax();
 
-	for(auto indices : commonScalarFields) {
-		this->setCurrentInScalarField(indices.first);
-		other->setCurrentOutScalarField(indices.second);
+	invalidateBoundingBox();
 
-		for(long i = 0; i < processedPoints; i++) {
-			ScalarType value = other->getPointScalarValue(i);
-			this->setPointScalarValue(startIndex + i, value);
-		}
-	}
+	// Sort the new points into the existing octree, grid and sections instead of initializing the whole cloud again.
+	// An empty cloud has no octree, main axis or index buffers yet, so it is initialized completely.
+	if(startIndex == 0)
+		init();
+	else
+		insertAppendedPoints(startIndex, bHasChainage);
 
 	if(callback)
 		callback->stop();
@@ -254,6 +696,105 @@ int OpenInfraPlatform::Infrastructure::PointCloud::add(const buw::ReferenceCount
 	return 0;
 }
 
+void OpenInfraPlatform::Infrastructure::PointCloud::insertAppendedPoints(const unsigned firstIndex, const bool bHasChainage) {
+	const unsigned numPoints = this->size();
+	if(firstIndex >= numPoints)
+		return;
+
+	// New points are unfiltered unless their filter value has been copied.
+	int idx_filtered = getScalarFieldIndexByName("Filtered");
+	CCLib::ScalarField* filtered = idx_filtered != -1 ? getScalarField(idx_filtered) : nullptr;
+	for(uint32_t i = firstIndex; i < numPoints; i++) {
+		if(filtered && filtered->getValue(i) > 0)
+			filteredIndices_.push_back(i);
+		else
+			remainingIndices_.push_back(i);
+	}
+
+	// Insert the new points into the octree if it has been built, only rebuild it if the new points are outside of its bounding box.
+	if(octree_ && octree_->getNumberOfProjectedPoints() > 0 && !octree_->insertPoints(firstIndex)) {
+		BLUE_LOG(trace) << "Added points exceed the octree bounds. Rebuilding octree.";
+		octree_ = buw::makeReferenceCounted<buw::Octree>(this);
+		octree_->build();
+	}
+
+	// Sort the new points into the grid and only recompute center and axis of the affected cells.
+	if(!grid_.empty()) {
+		std::map<std::pair<int, int>, bool> affectedCells = std::map<std::pair<int, int>, bool>();
+		for(uint32_t i = firstIndex; i < numPoints; i++) {
+			auto pos = getPoint(i);
+			std::pair<int, int> key = std::pair<int, int>((int)(pos->x / gridDescription_.size), (int)(pos->y / gridDescription_.size));
+			if(grid_.count(key) == 0) {
+				std::tuple<std::vector<uint32_t>, CCVector3, CCVector2> value = { std::vector<uint32_t>(), CCVector3(0,0,0), CCVector2(0,0) };
+				grid_.insert({ key, value });
+			}
+
+			std::get<0>(grid_[key]).push_back(i);
+			affectedCells[key] = true;
+		}
+
+		std::vector<std::pair<int, int>> keys = std::vector<std::pair<int, int>>();
+		for(auto &cell : affectedCells)
+			keys.push_back(cell.first);
+
+		computeGridCells(keys);
+	}
+
+	// Sections are defined by the chainage, so new points can only be sorted into them if their chainage has been copied.
+	if(!sections_.empty() && bHasChainage) {
+		const double length = getSectionLength();
+		CCLib::ScalarField* chainage = getScalarField(getScalarFieldIndexByName("Chainage"));
+		auto getSectionId = [&](unsigned index) -> long { return (long)std::floor(length * chainage->getValue(index)); };
+
+		// Map the existing sections to their id, all points of a section share the same id.
+		std::map<long, buw::ReferenceCounted<buw::PointCloudSection>> sectionsById = std::map<long, buw::ReferenceCounted<buw::PointCloudSection>>();
+		for(auto &section : sections_) {
+			if(section->size() > 0)
+				sectionsById[getSectionId(section->getPointGlobalIndex(0))] = section;
+		}
+
+		// Add the new points and remember the previous size of each affected section.
+		std::map<long, unsigned> affectedSections = std::map<long, unsigned>();
+		for(uint32_t i = firstIndex; i < numPoints; i++) {
+			long id = getSectionId(i);
+			auto &section = sectionsById[id];
+			if(!section) {
+				section = buw::makeReferenceCounted<buw::PointCloudSection>(static_cast<GenericIndexedCloudPersist *>(this));
+				section->setLength(length);
+			}
+
+			if(affectedSections.count(id) == 0)
+				affectedSections[id] = section->size();
+
+			section->addPointIndex(i);
+		}
+
+		sections_.clear();
+		for(auto &section : sectionsById)
+			sections_.push_back(section.second);
+
+		std::vector<std::pair<buw::ReferenceCounted<buw::PointCloudSection>, unsigned>> affected = std::vector<std::pair<buw::ReferenceCounted<buw::PointCloudSection>, unsigned>>();
+		for(auto &it : affectedSections)
+			affected.push_back({ sectionsById[it.first], it.second });
+
+		// Recompute the median of the affected sections and remove the new points which are too far away from it as in computeSections.
+		// Existing points are kept so that their pairs stay valid.
+#pragma omp parallel for
+		for(long i = 0; i < affected.size(); i++) {
+			auto &section = affected[i].first;
+			unsigned previousSize = affected[i].second;
+			auto median = section->computeMedianCenter();
+
+			unsigned count = previousSize;
+			for(unsigned ii = previousSize; ii < section->size(); ii++) {
+				if(std::abs(median.z - section->getPoint(ii)->z) <= 0.25f)
+					section->setPointIndex(count++, section->getPointGlobalIndex(ii));
+			}
+			section->resize(count);
+		}
+	}
+}
+
 void OpenInfraPlatform::Infrastructure::PointCloud::computeSections(const float length, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 
 	if(callback)
@@ -867,6 +1408,7 @@ std::vector<std::pair<CCVector3, ScalarType>> OpenInfraPlatform::Infrastructure:
 void OpenInfraPlatform::Infrastructure::PointCloud::computeGrid(buw::GridComputationDescription desc, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 	grid_.clear();
 	grid_ = std::map<std::pair<int, int>, std::tuple<std::vector<uint32_t>,CCVector3, CCVector2>>();
+	gridDescription_ = desc;
 
 	// Sort all points into the grid given their position.
 	for_each([&](size_t i) {
@@ -880,6 +1422,15 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeGrid(buw::GridComputa
 		std::get<0>(grid_[key]).push_back(i);		
 	});
 
+	// Compute center and axis of all cells.
+	std::vector<std::pair<int, int>> keys = std::vector<std::pair<int, int>>();
+	for(auto &cell : grid_)
+		keys.push_back(cell.first);
+
+	computeGridCells(keys, callback);
+}
+
+void OpenInfraPlatform::Infrastructure::PointCloud::computeGridCells(const std::vector<std::pair<int, int>> &keys, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 	// Lambda function which computes the center of mass of the given indices.
 	auto computeCenter = [&](std::vector<uint32_t> indices)->CCVector3 {
 		CCVector3 center = CCVector3(0, 0, 0);
@@ -889,6 +1440,8 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeGrid(buw::GridComputa
 		return center;
 	};
 
+	const buw::GridComputationDescription &desc = gridDescription_;
+
 	// Find the best level for extraction given kernel radius.
 	unsigned char level = octree_->findBestLevelForAGivenNeighbourhoodSizeExtraction(desc.kernelRadius);
 	int tid = 0;
@@ -900,7 +1453,7 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeGrid(buw::GridComputa
 	{
 		// Setup variables for progress callback.
 		tid = omp_get_thread_num();
-		long numCells = grid_.size();
+		long numCells = keys.size();
 		long numCellsPerThread = numCells / omp_get_num_threads();
 		long numCellsPerPercent = numCellsPerThread / 100;
 
@@ -911,11 +1464,10 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeGrid(buw::GridComputa
 		auto octree = buw::Octree(*octree_);
 
 #pragma omp for schedule(dynamic, 20)
-		for(int i = 0; i < grid_.size(); i++) {
+		for(int i = 0; i < keys.size(); i++) {
 
-			// Move the iterator to the cell processed by this thread.
-			auto &cell = grid_.begin();
-			advance(cell, i);
+			// Get the cell processed by this thread.
+			auto cell = grid_.find(keys[i]);
 
 			//Number of points in the cell.
 			long cellSize = std::get<0>(cell->second).size();
@@ -1188,6 +1740,232 @@ int OpenInfraPlatform::Infrastructure::PointCloud::applyRelativeHeightWithGridFi
 	return 0;
 }
 
+int OpenInfraPlatform::Infrastructure::PointCloud::applyFilterPipeline(const buw::FilterPipelineDescription &desc, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback)
+{
+	// Evaluation order of the stage types, comparisons of the point itself come before neighbourhood searches.
+	auto getCost = [](const buw::FilterPipelineStageDescription &stage) -> int {
+		switch(stage.type) {
+		case Enums::ePointCloudFilterType::PositionFilter: return 0;
+		case Enums::ePointCloudFilterType::RelativeHeightFilter: return 1;
+		case Enums::ePointCloudFilterType::DuplicateFilter: return stage.duplicate.dim == Enums::ePointCloudFilterDimension::Volume3D ? 2 : 1;
+		default: return stage.localDensity.dim == Enums::ePointCloudFilterDimension::Volume3D ? 3 : 1;
+		}
+	};
+
+	std::vector<buw::FilterPipelineStageDescription> stages = desc.stages;
+	std::stable_sort(stages.begin(), stages.end(), [&](const buw::FilterPipelineStageDescription &lhs, const buw::FilterPipelineStageDescription &rhs) -> bool {
+		return getCost(lhs) < getCost(rhs);
+	});
+
+	for(const auto &stage : stages) {
+		if(stage.type == Enums::ePointCloudFilterType::PositionFilter && (stage.position.dimension < 0 || stage.position.dimension > 2)) {
+			BLUE_LOG(warning) << "Invalid dimension number " << QString::number(stage.position.dimension).toStdString() << " specified. Choose X=0, Y=1 or Z=2.";
+			return -1;
+		}
+	}
+
+	if(callback) {
+		callback->start();
+		callback->setMethodTitle("Applying filter pipeline");
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	const long numPoints = size();
+
+	// The pass follows the sorted cell codes, so the octree has to contain every point.
+	if(!octree_ || octree_->getNumberOfProjectedPoints() != numPoints) {
+		octree_ = buw::makeReferenceCounted<buw::Octree>(this);
+		octree_->build();
+	}
+
+	// Stages on sections need the projected section clouds, they write their scalar fields per section and are only read in the pass.
+	std::vector<CCLib::ScalarField*> stageFields = std::vector<CCLib::ScalarField*>(stages.size(), nullptr);
+	std::vector<unsigned char> stageLevels = std::vector<unsigned char>(stages.size(), 0);
+	std::vector<float> referenceHeights = std::vector<float>();
+	for(size_t s = 0; s < stages.size(); s++) {
+		const auto &stage = stages[s];
+		if(stage.type == Enums::ePointCloudFilterType::DuplicateFilter) {
+			if(stage.duplicate.dim == Enums::ePointCloudFilterDimension::Volume3D) {
+				stageLevels[s] = octree_->findBestLevelForAGivenNeighbourhoodSizeExtraction(stage.duplicate.minDistance);
+			}
+			else {
+				for(auto &section : sections_)
+					section->flagDuplicatePoints(stage.duplicate.minDistance);
+				int idx = getScalarFieldIndexByName("Duplicate");
+				stageFields[s] = idx != -1 ? getScalarField(idx) : nullptr;
+			}
+		}
+		else if(stage.type == Enums::ePointCloudFilterType::LocalDensityFilter) {
+			if(stage.localDensity.dim == Enums::ePointCloudFilterDimension::Volume3D) {
+				stageLevels[s] = octree_->findBestLevelForAGivenNeighbourhoodSizeExtraction(stage.localDensity.kernelRadius);
+			}
+			else {
+				// We don't check the error code since it sometimes fails with sparse sections.
+				for(auto &section : sections_)
+					section->computeLocalDensity(stage.localDensity.density, stage.localDensity.kernelRadius, nullptr);
+				int idx = getScalarFieldIndexByName("Density");
+				stageFields[s] = idx != -1 ? getScalarField(idx) : nullptr;
+			}
+		}
+		else if(stage.type == Enums::ePointCloudFilterType::RelativeHeightFilter && referenceHeights.empty()) {
+			// The reference height of a point is the median height of its grid cell, points outside of the grid keep NaN and are never filtered.
+			referenceHeights = std::vector<float>(numPoints, std::numeric_limits<float>::quiet_NaN());
+			std::vector<const std::vector<uint32_t>*> cells = std::vector<const std::vector<uint32_t>*>();
+			for(const auto &gridCell : grid_)
+				cells.push_back(&std::get<0>(gridCell.second));
+
+#pragma omp parallel for schedule(dynamic, 16)
+			for(long c = 0; c < cells.size(); c++) {
+				if(cells[c]->empty())
+					continue;
+
+				std::vector<uint32_t> cell = *cells[c];
+				std::nth_element(cell.begin(), cell.begin() + cell.size() / 2, cell.end(), [&](const uint32_t lhs, const uint32_t rhs) -> bool { return getPoint(lhs)->z < getPoint(rhs)->z; });
+				const float median = getPoint(cell[cell.size() / 2])->z;
+				for(uint32_t index : cell)
+					referenceHeights[index] = median;
+			}
+		}
+	}
+
+	if(callback)
+		callback->update(10);
+
+	int idx_pipeline = getScalarFieldIndexByName("FilterPipeline");
+	if(idx_pipeline == -1)
+		idx_pipeline = addScalarField("FilterPipeline");
+
+	int idx_filtered = getScalarFieldIndexByName("Filtered");
+	if(idx_filtered == -1)
+		idx_filtered = addScalarField("Filtered");
+
+	CCLib::ScalarField* pipelineField = getScalarField(idx_pipeline);
+	CCLib::ScalarField* filteredField = getScalarField(idx_filtered);
+
+	// Filter fields written by the single filter functions are still combined into "Filtered" like in computeIndices.
+	std::vector<CCLib::ScalarField*> filterFields = std::vector<CCLib::ScalarField*>();
+	for(const char* name : { "Duplicate", "Density", "Coord. X", "Coord. Y", "Coord. Z" }) {
+		int idx = getScalarFieldIndexByName(name);
+		if(idx != -1)
+			filterFields.push_back(getScalarField(idx));
+	}
+
+	CCVector3 dimMin, dimMax, pointsMin, pointsMax;
+	const CCLib::DgmOctree::cellsContainer &codes = octree_->getPointsAndCellCodes(dimMin, dimMax, pointsMin, pointsMax);
+	std::vector<uint8_t> mask = std::vector<uint8_t>(numPoints, 0);
+
+	int tid = 0;
+#pragma omp parallel private(tid) firstprivate(callback)
+	{
+		tid = omp_get_thread_num();
+		long pointsPerPercent = std::max(1l, numPoints / omp_get_num_threads() / 80);
+		long processedPoints = 0;
+		short percentageCompleted = 10;
+
+		// Initialize octree as copy of the original one.
+		auto octree = buw::Octree(*octree_);
+		CCLib::DgmOctree::NeighboursSet neighbours = CCLib::DgmOctree::NeighboursSet();
+
+		// Points of the same cell are neighbours in the code array, so consecutive neighbourhood searches hit the same cells.
+#pragma omp for schedule(dynamic, 1024)
+		for(long p = 0; p < (long)codes.size(); p++) {
+			const unsigned index = codes[p].theIndex;
+			const CCVector3* point = getPoint(index);
+			bool bFiltered = false;
+
+			for(size_t s = 0; s < stages.size(); s++) {
+				const auto &stage = stages[s];
+
+				// Stages which only read their field are always evaluated, since the density threshold is written back for computeIndices.
+				if(bFiltered && !stageFields[s])
+					continue;
+
+				switch(stage.type) {
+				case Enums::ePointCloudFilterType::PositionFilter: {
+					const ScalarType value = (*point)[stage.position.dimension];
+					bFiltered |= value < stage.position.minValue || value > stage.position.maxValue;
+					break;
+				}
+				case Enums::ePointCloudFilterType::RelativeHeightFilter: {
+					const float reference = referenceHeights[index];
+					bFiltered |= point->z < (reference - stage.relativeHeight.lowerBound) || point->z > (reference + stage.relativeHeight.upperBound);
+					break;
+				}
+				case Enums::ePointCloudFilterType::DuplicateFilter: {
+					if(stageFields[s]) {
+						bFiltered |= stageFields[s]->getValue(index) > 0;
+						break;
+					}
+
+					// Of several points closer than the minimal distance, the one with the smallest index is kept so the result does not depend on the thread order.
+					neighbours.clear();
+					octree.getPointsInSphericalNeighbourhood(*point, stage.duplicate.minDistance, neighbours, stageLevels[s]);
+					bFiltered |= std::any_of(neighbours.begin(), neighbours.end(), [&](const CCLib::DgmOctree::PointDescriptor &n) { return n.pointIndex < index; });
+					break;
+				}
+				case Enums::ePointCloudFilterType::LocalDensityFilter: {
+					if(stageFields[s]) {
+						const ScalarType thresholded = (ScalarType)(stageFields[s]->getValue(index) < stage.localDensity.minThreshold);
+						stageFields[s]->setValue(index, thresholded);
+						bFiltered |= thresholded > 0;
+						break;
+					}
+
+					// The point itself is not counted, like in CCLib::GeometricalAnalysisTools::computeLocalDensity used by applyLocalDensityFilter.
+					neighbours.clear();
+					const float radius = stage.localDensity.kernelRadius;
+					float density = (float)(octree.getPointsInSphericalNeighbourhood(*point, radius, neighbours, stageLevels[s]) - 1);
+					if(stage.localDensity.density == CCLib::GeometricalAnalysisTools::Density::DENSITY_2D)
+						density /= (float)M_PI * radius * radius;
+					else if(stage.localDensity.density == CCLib::GeometricalAnalysisTools::Density::DENSITY_3D)
+						density /= 4.0f / 3.0f * (float)M_PI * radius * radius * radius;
+					bFiltered |= density < stage.localDensity.minThreshold;
+					break;
+				}
+				}
+			}
+
+			pipelineField->setValue(index, bFiltered ? 1.0f : 0.0f);
+
+			// Combine with the fields of the single filters, the same way computeIndices does.
+			for(CCLib::ScalarField* field : filterFields)
+				bFiltered |= field->getValue(index) > 0;
+			filteredField->setValue(index, bFiltered ? 1.0f : 0.0f);
+			mask[index] = bFiltered ? 1 : 0;
+
+			processedPoints++;
+			if(tid == 0 && callback && processedPoints % pointsPerPercent == 0) {
+				percentageCompleted++;
+				callback->update(percentageCompleted);
+			}
+		}
+	}
+
+	pipelineField->computeMinAndMax();
+	filteredField->computeMinAndMax();
+	for(CCLib::ScalarField* field : stageFields) {
+		if(field)
+			field->computeMinAndMax();
+	}
+
+	// Fill the index buffers from the mask, both stay sorted by point index.
+	remainingIndices_.clear();
+	filteredIndices_.clear();
+	for(uint32_t i = 0; i < (uint32_t)numPoints; i++) {
+		if(mask[i])
+			filteredIndices_.push_back(i);
+		else
+			remainingIndices_.push_back(i);
+	}
+
+	reportStageTiming(callback, "Filter pipeline", start);
+
+	if(callback)
+		callback->stop();
+
+	return 0;
+}
+
 int OpenInfraPlatform::Infrastructure::PointCloud::resetPositionFilter() {
 	deleteScalarField(getScalarFieldIndexByName("Coord. X"));
 	deleteScalarField(getScalarFieldIndexByName("Coord. Y"));
@@ -1307,6 +2085,9 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeIndices() {
 	int idx_coordY = getScalarFieldIndexByName("Coord. Y");
 	int idx_coordZ = getScalarFieldIndexByName("Coord. Z");
 
+	// Get the combined result of the filter pipeline.
+	int idx_pipeline = getScalarFieldIndexByName("FilterPipeline");
+
 	// For each point, check it's Density and Duplicate field and if one of them is true, filter the point.
 	//for_each([&, idx_duplicate, idx_density, idx_coordX, idx_coordY, idx_coordZ](size_t i) {
 	//	ScalarType filtered = 0;
@@ -1371,6 +2152,11 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computeIndices() {
 			filtered += getPointScalarValue(i);
 		}
 
+		if(idx_pipeline != -1) {
+			setCurrentOutScalarField(idx_pipeline);
+			filtered += getPointScalarValue(i);
+		}
+
 		setPointScalarValue(i, filtered);
 
 		if(filtered > 0) {
@@ -1444,6 +2230,7 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computePairs(const buw::Pair
 
 	if(sections_.size() > 0) {
 		BLUE_LOG(trace) << "Computing pairs.";
+		auto stageStart = std::chrono::steady_clock::now();
 
 		// If we have a callback, call start to init the GUI.
 		if(callback) {
@@ -1457,9 +2244,11 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computePairs(const buw::Pair
 			idx = addScalarField("Railway");
 		setCurrentInScalarField(idx);
 
-		// Create a global list of all point pairs.
+		// Each section stores its pairs in its own slot so that the result does not depend on the scheduling of the threads.
+		std::vector<std::vector<std::pair<size_t, size_t>>> sectionPairs = std::vector<std::vector<std::pair<size_t, size_t>>>(sections_.size());
+
 		int tid = 0;
-		//#pragma omp parallel private(tid)
+#pragma omp parallel private(tid) firstprivate(callback)
 		{
 			// Setup callback update variables.
 			tid = omp_get_thread_num();
@@ -1468,63 +2257,170 @@ void OpenInfraPlatform::Infrastructure::PointCloud::computePairs(const buw::Pair
 			int processedSections = 0;
 			int percentageCompleted = 0;
 
-			// We iterate over all sections and calculate the pairs of matching points.
-			std::vector<std::pair<size_t, size_t>> pairs = std::vector<std::pair<size_t, size_t>>();
-			//#pragma omp for
-			for(long i = 0; i < sections_.size() - 1; i++) {
-				if(sections_[i]) {
-					// Insert all pairs in our local vector.
-					auto result = sections_[i + 1] ? sections_[i]->computePairs(desc, sections_[i + 1]) : sections_[i]->computePairs(desc);
-					if(result.size() > 0) {
-						pairs.insert(pairs.end(), result.begin(), result.end());
-					}
-				}
-				else {
-					BLUE_LOG(warning) << "Null section detected. Nr: " << i;
-				}
+			// We iterate over all sections and calculate the pairs of matching points. The cloud is not modified here since a pair can reference the next section.
+#pragma omp for schedule(dynamic)
+			for(long i = 0; i < (long)sections_.size() - 1; i++) {
+				if(sections_[i]) {
+					sectionPairs[i] = sections_[i + 1] ? sections_[i]->computePairs(desc, sections_[i + 1], false) : sections_[i]->computePairs(desc, nullptr, false);
+				}
+				else {
+#pragma omp critical
+					BLUE_LOG(warning) << "Null section detected. Nr: " << i;
+				}
+
+				// Update our callback.
+				processedSections++;
+				if(processedSections >= numSectionsPerPercent) {
+					percentageCompleted++;
+					processedSections = 0;
+
+					if(tid == 0 && callback) {
+						callback->update(percentageCompleted);
+					}
+				}
+			}
+		}
+
+		// Merge the pairs and mark them in the cloud in section order, which gives the same result as the sequential computation.
+		for(long i = 0; i < (long)sections_.size() - 1; i++) {
+			if(sections_[i] && !sectionPairs[i].empty()) {
+				sections_[i]->markPairs();
+				o_pairs.insert(o_pairs.end(), sectionPairs[i].begin(), sectionPairs[i].end());
+			}
+		}
+
+		reportStageTiming(callback, "Pair computation", stageStart);
+
+		// Stop our callback.
+		if(callback)
+			callback->stop();
+
+		BLUE_LOG(trace) << "Done.";
+		bHasPairs_ = true;
+	}
+	else {
+		BLUE_LOG(warning) << "Aborting. No sections found.";
+	}
+}
+
+std::vector<buw::ReferenceCounted<CCLib::ReferenceCloud>> OpenInfraPlatform::Infrastructure::PointCloud::extractConnectedComponents(ScalarType kernelRadius, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback)
+{
+	// Vector that holds the individual components.
+	std::vector<buw::ReferenceCounted<CCLib::ReferenceCloud>> components;
+
+	if(this->size() == 0 || !octree_ || octree_->getNumberOfProjectedPoints() == 0) {
+		BLUE_LOG(warning) << "Aborting. No points or octree found.";
+		return components;
+	}
+
+	if(callback) {
+		callback->start();
+		callback->setMethodTitle("Extracting connected components...");
+	}
+
+	auto stageStart = std::chrono::steady_clock::now();
+
+	// Only points which have not been filtered take part in the components.
+	std::vector<uint8_t> included = std::vector<uint8_t>(this->size(), 0);
+	for(auto index : remainingIndices_)
+		included[index] = 1;
+
+	// Call this once to find the best level for the radius.
+	unsigned char level = octree_->findBestLevelForAGivenNeighbourhoodSizeExtraction(kernelRadius);
+
+	// Get the octree cell indices to iterate over the cells, return no components if an error occurs.
+	std::vector<uint32_t> dgmOctreeCells;
+	if(!octree_->getCellIndexes(level, dgmOctreeCells)) {
+		if(callback)
+			callback->stop();
+		return components;
+	}
+
+	// Connect all points which are closer than the kernel radius. The union find can be updated by all threads concurrently.
+	buw::ConcurrentUnionFind unionFind = buw::ConcurrentUnionFind(this->size());
+	int numCells = dgmOctreeCells.size();
+	int tid = 0;
+
+#pragma omp parallel private(tid) firstprivate(callback) shared(level, dgmOctreeCells, numCells, unionFind)
+	{
+		tid = omp_get_thread_num();
+		auto octree = buw::Octree(*octree_);
+		int numCellsPerThread = numCells / omp_get_num_threads();
+		int processedCells = 0;
+		int numCellsPerPercent = std::max(1, numCellsPerThread / 100);
+		int percentageCompleted = 0;
+
+#pragma omp for schedule(dynamic, 50)
+		for(long idx = 0; idx < dgmOctreeCells.size(); idx++) {
+			auto cell = dgmOctreeCells[idx];
+			auto code = octree.getCellCode(cell);
+
+			// Create and initialize the nearest neighbour search struct as far as possible.
+			CCLib::DgmOctree::NearestNeighboursSphericalSearchStruct nss;
+			nss.level = level;
+			nss.maxSearchSquareDistd = std::pow(kernelRadius, 2);
+			nss.alreadyVisitedNeighbourhoodSize = 0;
+			nss.minNumberOfNeighbors = 0;
+
+			std::shared_ptr<CCLib::ReferenceCloud> points = std::make_shared<CCLib::ReferenceCloud>(this);
+			if(octree.getPointsInCellByCellIndex(points.get(), cell, level)) {
+				octree.getCellPos(code, level, nss.cellPos, false);
+				octree.computeCellCenter(nss.cellPos, level, nss.cellCenter);
 
-				// Update our callback.
-				processedSections++;
-				if(processedSections >= numSectionsPerPercent) {
-					percentageCompleted++;
-					processedSections = 0;
+				for(unsigned i = 0; i < points->size(); i++) {
+					uint32_t index = points->getPointGlobalIndex(i);
+					if(!included[index])
+						continue;
 
-					if(tid == 0 && callback) {
-						callback->update(percentageCompleted);
+					nss.queryPoint = *(points->getPoint(i));
+					int numPoints = octree.findNeighborsInASphereStartingFromCell(nss, kernelRadius, false);
+
+					// Every edge is seen from both sides, so only unite with neighbours having a larger index.
+					for(int ii = 0; ii < numPoints; ii++) {
+						uint32_t neighbour = nss.pointsInNeighbourhood[ii].pointIndex;
+						if(neighbour > index && included[neighbour])
+							unionFind.unite(index, neighbour);
 					}
 				}
 			}
 
-			// Merge the local vectors in the master vector.
-//#pragma omp critical
-			{
-				if(pairs.size() > 0) {
-					o_pairs.insert(o_pairs.end(), pairs.begin(), pairs.end());
-				}
-				else {
-					// BLUE_LOG(info) << "No pairs by thread #" << omp_get_thread_num() << " detected.";
-				}
+			processedCells++;
+			if(processedCells >= numCellsPerPercent) {
+				percentageCompleted++;
+				processedCells = 0;
+				if(tid == 0 && callback)
+					callback->update(percentageCompleted);
 			}
 		}
+	}
 
-		// Stop our callback.
-		if(callback)
-			callback->stop();
+	reportStageTiming(callback, "Connecting points", stageStart);
+	stageStart = std::chrono::steady_clock::now();
 
-		BLUE_LOG(trace) << "Done.";
-		bHasPairs_ = true;
+	// The root of each component is its smallest index, so numbering the roots in index order gives deterministic component ids.
+	std::vector<int> componentIds = std::vector<int>(this->size(), -1);
+	int numComponents = 0;
+	for(uint32_t i = 0; i < this->size(); i++) {
+		if(included[i] && unionFind.find(i) == i)
+			componentIds[i] = numComponents++;
 	}
-	else {
-		BLUE_LOG(warning) << "Aborting. No sections found.";
+
+	components.resize(numComponents);
+	for(int i = 0; i < numComponents; i++)
+		components[i] = buw::makeReferenceCounted<CCLib::ReferenceCloud>(this);
+
+	// Points are added in ascending index order to their component.
+	for(uint32_t i = 0; i < this->size(); i++) {
+		if(included[i])
+			components[componentIds[unionFind.find(i)]]->addPointIndex(i);
 	}
-}
 
-std::vector<buw::ReferenceCounted<CCLib::ReferenceCloud>> OpenInfraPlatform::Infrastructure::PointCloud::extractConnectedComponents(ScalarType kernelRadius, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback)
-{
-	// Vector that holds the individual components.
-	std::vector<buw::ReferenceCounted<CCLib::ReferenceCloud>> components;
+	reportStageTiming(callback, "Collecting components", stageStart);
+	BLUE_LOG(trace) << "Found " << numComponents << " connected components.";
+
+	if(callback)
+		callback->stop();
 
-	// TODO
 	return components;
 }
 
@@ -1559,6 +2455,10 @@ const std::tuple<size_t, size_t> OpenInfraPlatform::Infrastructure::PointCloud::
 
 int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentation(buw::PercentileSegmentationDescription desc,
                                                                                 buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	// The approximate method evaluates one sketch per octree cell instead of one neighbourhood per point.
+	if (desc.method == Enums::ePercentileComputationMethod::Approximate)
+		return applyPercentilesSegmentationApproximate(desc, true, callback);
+
 	// If we have a callback, call start to init the GUI.
 	if (callback)
 		callback->start();
@@ -1600,31 +2500,27 @@ int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentation(
 			CCLib::DgmOctree::NeighboursSet neighbours = CCLib::DgmOctree::NeighboursSet();
 			int numPoints = octree.getPointsInSphericalNeighbourhood(*getPoint(index), desc.kernelRadius, neighbours, level);
 
-			// Sort points in neighbourhood according to height.
-			std::sort(neighbours.begin(), neighbours.end(),
-			          [](const CCLib::DgmOctree::PointDescriptor &lhs, const CCLib::DgmOctree::PointDescriptor &rhs) -> bool { return lhs.point->z < rhs.point->z; });
-
 			// Remove points which have actually been removed due to filtering.
 			auto isFilteredPoint = [&](const CCLib::DgmOctree::PointDescriptor point) -> bool { return getPointScalarValue(point.pointIndex) > 0; };
 			auto end = std::remove_if(neighbours.begin(), neighbours.end(), isFilteredPoint);
 			neighbours.erase(end, neighbours.end());
 			numPoints = neighbours.size();
 
-			// Calculate the 98 percentile as the index of the upper % point after sorting in ascending order, same for the lower % point.
-			int idxUpper = (int)std::floor(desc.upperPercentile * numPoints);
-			int idxLower = (int)std::floor(desc.lowerPercentile * numPoints);
-			float percentileUpper = neighbours[idxUpper].point->z;
-			float percentileLower = neighbours[idxLower].point->z;
-
-			// Calculate the absolute difference between the percentiles and if it is larger than 10cm segment the point as rail point.
-			float diff = std::fabsf(percentileLower - percentileUpper);
-			float totalDiff = std::fabsf((neighbours.front().point->z) - (neighbours.back().point->z));
-
-			// If the diff is larger than the minThreshold and the totalDiff smaller than the maxThreshold, mark all points in the upper percentile.
-			if (diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
-				for (int ii = idxUpper; ii < neighbours.size(); ii++) {
-					int index_ii = neighbours[ii].pointIndex;
-					setPointScalarValue(index_ii, 1.0f);
+			// Select the lower and upper percentile according to height, only the upper percentile has to be separated from the rest so no full sort is needed.
+			if (numPoints > 0) {
+				buw::PercentileRange range = buw::selectPercentileRange(neighbours.begin(), neighbours.end(), desc.lowerPercentile, desc.upperPercentile,
+				                                                        [](const CCLib::DgmOctree::PointDescriptor &p) -> float { return p.point->z; });
+
+				// Calculate the absolute difference between the percentiles and if it is larger than 10cm segment the point as rail point.
+				float diff = std::fabsf(range.lower - range.upper);
+				float totalDiff = std::fabsf(range.minimum - range.maximum);
+
+				// If the diff is larger than the minThreshold and the totalDiff smaller than the maxThreshold, mark all points in the upper percentile.
+				if (diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
+					for (size_t ii = range.upperIndex; ii < neighbours.size(); ii++) {
+						int index_ii = neighbours[ii].pointIndex;
+						setPointScalarValue(index_ii, 1.0f);
+					}
 				}
 			}
 
@@ -1647,6 +2543,10 @@ int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentation(
 
 int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentationHP(const buw::PercentileSegmentationDescription &desc,
                                                                                   buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	// The approximate method evaluates one sketch per octree cell instead of one neighbourhood per point.
+	if (desc.method == Enums::ePercentileComputationMethod::Approximate)
+		return applyPercentilesSegmentationApproximate(desc, false, callback);
+
 	// If we have a callback, call start to init the GUI.
 	if (callback)
 		callback->start();
@@ -1708,24 +2608,20 @@ int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentationH
 				for (int i = 0; i < points->size(); i++) {
 					nss.queryPoint = *(points->getPoint(i));
 					int numPoints = octree.findNeighborsInASphereStartingFromCell(nss, desc.kernelRadius, false);
+					if (numPoints <= 0)
+						continue;
 
-					// Sort points in neighbourhood according to height.
-					std::sort(nss.pointsInNeighbourhood.begin(), nss.pointsInNeighbourhood.begin() + numPoints,
-					          [](const CCLib::DgmOctree::PointDescriptor &lhs, const CCLib::DgmOctree::PointDescriptor &rhs) -> bool { return lhs.point->z < rhs.point->z; });
-
-					// Calculate the upper percentile as the index of the upper % point after sorting in ascending order, same for the lower % point.
-					int idxUpper = (int)std::floor(desc.upperPercentile * numPoints);
-					int idxLower = (int)std::floor(desc.lowerPercentile * numPoints);
-					float percentileUpper = nss.pointsInNeighbourhood[idxUpper].point->z;
-					float percentileLower = nss.pointsInNeighbourhood[idxLower].point->z;
+					// Select the upper and lower percentile according to height, this partitions the neighbourhood so that the upper percentile is at the end.
+					buw::PercentileRange range = buw::selectPercentileRange(nss.pointsInNeighbourhood.begin(), nss.pointsInNeighbourhood.begin() + numPoints, desc.lowerPercentile, desc.upperPercentile,
+					                                                        [](const CCLib::DgmOctree::PointDescriptor &p) -> float { return p.point->z; });
 
 					// Calculate the absolute difference between the percentiles and if it is larger than the specified threshold, segment the point as rail point.
-					float diff = std::fabsf(percentileLower - percentileUpper);
-					float totalDiff = std::fabsf((nss.pointsInNeighbourhood[0].point->z) - (nss.pointsInNeighbourhood[numPoints - 1].point->z));
+					float diff = std::fabsf(range.lower - range.upper);
+					float totalDiff = std::fabsf(range.minimum - range.maximum);
 
 					// If the diff is larger than the minThreshold and the totalDiff smaller than the maxThreshold, mark all points in the upper percentile.
 					if (diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
-						for (int ii = idxUpper; ii < numPoints; ii++) {
+						for (int ii = (int)range.upperIndex; ii < numPoints; ii++) {
 							size_t index_ii = nss.pointsInNeighbourhood[ii].pointIndex;
 							this->setPointScalarValue(index_ii, 1.0f);
 						}
@@ -1758,6 +2654,127 @@ int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentationH
 	return err;
 }
 
+int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesSegmentationApproximate(const buw::PercentileSegmentationDescription &desc, bool bExcludeFiltered,
+                                                                                           buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	// If we have a callback, call start to init the GUI.
+	if (callback)
+		callback->start();
+
+	// Get the filtered scalar field if filtered points should be ignored.
+	int idx_filtered = getScalarFieldIndexByName("Filtered");
+	if (bExcludeFiltered && idx_filtered == -1)
+		idx_filtered = addScalarField("Filtered");
+
+	// Get the segmented percentile scalar field.
+	int idx_segmented = getScalarFieldIndexByName("SegmentedPercentile");
+	if (idx_segmented == -1)
+		idx_segmented = addScalarField("SegmentedPercentile");
+	setCurrentInScalarField(idx_segmented);
+
+	// Initialize all scalar values in the field to 0.
+	for_each([&](size_t i) { this->setPointScalarValue(i, 0); });
+
+	// Write to the scalar fields directly since the threads only touch the points of their own cells.
+	CCLib::ScalarField* filtered = bExcludeFiltered ? getScalarField(idx_filtered) : nullptr;
+	CCLib::ScalarField* segmented = getScalarField(idx_segmented);
+
+	// Call this once to find the best level for the radius.
+	unsigned char level = octree_->findBestLevelForAGivenNeighbourhoodSizeExtraction(desc.kernelRadius);
+
+	// Get the octree cell indices to iterate over the cells, return -1 if an error occurs.
+	std::vector<uint32_t> dgmOctreeCells;
+	bool success = octree_->getCellIndexes(level, dgmOctreeCells);
+	if (!success)
+		return -1;
+
+	// Initialize counter variables for our callback update.
+	int numCells = dgmOctreeCells.size();
+	int tid = 0;
+	int err = 0;
+
+#pragma omp parallel private(tid) firstprivate(callback) shared(level, dgmOctreeCells, desc, numCells, err)
+	{
+		// Initialize our variables for callback updates.
+		tid = omp_get_thread_num();
+		auto octree = buw::Octree(*octree_);
+		int numCellsPerThread = numCells / omp_get_num_threads();
+		int processedCells = 0;
+		int numCellsPerPercent = numCellsPerThread / 100;
+		int percentageCompleted = 0;
+
+		// One sketch per thread which is cleared for every cell to reuse its buffers.
+		buw::PercentileSketch sketch = buw::PercentileSketch(desc.sketchCompression);
+
+#pragma omp for schedule(dynamic, 50)
+		for (long idx = 0; idx < dgmOctreeCells.size(); idx++) {
+			auto cell = dgmOctreeCells[idx];
+			auto code = octree.getCellCode(cell);
+
+			// Create and initialize the nearest neighbour search struct as far as possible.
+			CCLib::DgmOctree::NearestNeighboursSphericalSearchStruct nss;
+			nss.level = level;
+			nss.maxSearchSquareDistd = std::pow(desc.kernelRadius, 2);
+			nss.alreadyVisitedNeighbourhoodSize = 0;
+			nss.minNumberOfNeighbors = 0;
+
+			// Get the points in the cell specified by the index and compute the cell position and center.
+			std::shared_ptr<CCLib::ReferenceCloud> points = std::make_shared<CCLib::ReferenceCloud>(this);
+			const bool bCellFound = octree.getPointsInCellByCellIndex(points.get(), cell, level);
+			octree.getCellPos(code, level, nss.cellPos, false);
+			octree.computeCellCenter(nss.cellPos, level, nss.cellCenter);
+
+			if (bCellFound) {
+				// Search the neighbourhood only once around the cell center and feed the heights into the sketch.
+				nss.queryPoint = nss.cellCenter;
+				int numPoints = octree.findNeighborsInASphereStartingFromCell(nss, desc.kernelRadius, false);
+
+				sketch.clear();
+				for (int i = 0; i < numPoints; i++) {
+					unsigned index = nss.pointsInNeighbourhood[i].pointIndex;
+					if (!filtered || filtered->getValue(index) <= 0)
+						sketch.add(nss.pointsInNeighbourhood[i].point->z);
+				}
+
+				if (!sketch.isEmpty()) {
+					const double lower = sketch.getPercentile(desc.lowerPercentile);
+					const double upper = sketch.getPercentile(desc.upperPercentile);
+					const double diff = std::abs(upper - lower);
+					const double totalDiff = std::abs(sketch.getMaximum() - sketch.getMinimum());
+
+					// If the diff is larger than the minThreshold and the totalDiff smaller than the maxThreshold, mark all points of the cell in the upper percentile
+					// which have not been filtered.
+					if (diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
+						for (unsigned i = 0; i < points->size(); i++) {
+							const unsigned index = points->getPointGlobalIndex(i);
+							if (points->getPoint(i)->z >= upper && (!filtered || filtered->getValue(index) <= 0))
+								segmented->setValue(index, 1.0f);
+						}
+					}
+				}
+
+				// Update our callback.
+				processedCells++;
+				if (processedCells >= numCellsPerPercent) {
+					percentageCompleted++;
+					processedCells = 0;
+					if (tid == 0 && callback)
+						callback->update(percentageCompleted);
+				}
+			} else {
+#pragma omp critical
+				err = -2;
+			}
+		}
+	}
+
+	computeIndices();
+
+	if (callback)
+		callback->stop();
+
+	return err;
+}
+
 int OpenInfraPlatform::Infrastructure::PointCloud::applyPercentilesOnGridSegmentation(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 	// If we have a callback, call start to init the GUI.
 	if (callback)
@@ -1984,7 +3001,6 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 	}
 
 	centerpointsPointCloud->setCurrentInScalarField(idxCPC_chainage);
-	centerpointsPointCloud->getCurrentInScalarField()->resize(pointPairs.size());
 
 	// Get chainage scalar field from original point cloud to read from.
 	int idx_chainage = getScalarFieldIndexByName("Chainage");
@@ -1993,19 +3009,32 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 	}
 	setCurrentOutScalarField(idx_chainage);
 
+	auto stageStart = std::chrono::steady_clock::now();
+
+	// Resize the cloud once so that the centerpoints can be computed in parallel.
+	if(!centerpointsPointCloud->resize(pointPairs.size()))
+		return -3;
+
+	CCLib::ScalarField* centerpointsChainage = centerpointsPointCloud->getScalarField(idxCPC_chainage);
+	CCLib::ScalarField* chainageField = getScalarField(idx_chainage);
+
 	// Compute centerpoints witch chanaige and add the computed points to the centerpointsPointCloud.
+#pragma omp parallel for
 	for(long i = 0; i < pointPairs.size(); i++) {
 		auto pair = pointPairs[i];
 
 		CCVector3 start = *(getPoint(pair.first));
 		CCVector3 end = *(getPoint(pair.second));
-		ScalarType chainage = 0.5f * (getPointScalarValue(pair.first) + getPointScalarValue(pair.second));
+		ScalarType chainage = 0.5f * (chainageField->getValue(pair.first) + chainageField->getValue(pair.second));
 		CCVector3 center = 0.5f * (end + start);
 
-		centerpointsPointCloud->addPoint(center);
-		centerpointsPointCloud->setPointScalarValue(i, chainage);
+		*centerpointsPointCloud->point(i) = center;
+		centerpointsChainage->setValue(i, chainage);
 	}
 
+	centerpointsPointCloud->invalidateBoundingBox();
+	reportStageTiming(callback, "Centerpoint computation", stageStart);
+
 	// Defaults to false.
 	bool useSubsampling = false;
 
@@ -2033,10 +3062,10 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 		idxCPC_chainage = idxSS_chainage;
 	}
 
+	stageStart = std::chrono::steady_clock::now();
 	centerpointsPointCloud->getDGMOctree()->build(callback.get());
 	centerpointsPointCloud->computeIndices();
 
-	
 
 	if(desc.filterDuplicates) {
 		// Remove points closer than 1mm to avoid "black holes" of insane density.
@@ -2067,6 +3096,8 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 	}
 
 	auto centerpoints = centerpointsPointCloud->getAllPointsAndScalarFieldValue(idxCPC_chainage);
+	reportStageTiming(callback, "Centerpoint filtering", stageStart);
+	stageStart = std::chrono::steady_clock::now();
 	
 	//centerpointsPointCloud = nullptr;
 		
@@ -2160,6 +3191,7 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 	// Split the centerpoints into different rails and recognize different rails. Only store indices to save memory.
 	std::vector<std::vector<size_t>> centerlines = std::vector<std::vector<size_t>>();
 	sortCenterpointsIntoCenterlines(centerpoints, centerlines, callback);
+	reportStageTiming(callback, "Centerpoint sorting", stageStart);
 
 	std::sort(centerlines.begin(), centerlines.end(), [&](std::vector<size_t> &lhs, std::vector<size_t> &rhs) -> bool {
 		return centerpoints[lhs.front()].second < centerpoints[rhs.front()].second;
@@ -2238,6 +3270,8 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 	});
 	
 	
+	stageStart = std::chrono::steady_clock::now();
+
 	// Collapse tracks to have a uniform density.
 	std::vector<std::vector<std::pair<CCVector3, ScalarType>>> alignments = std::vector<std::vector<std::pair<CCVector3, ScalarType>>>(centerlines.size());
 	
@@ -2336,7 +3370,7 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 			double segmentLength = desc.samplingLengthForPCA / 2.0;
 
 			// Pull the lambda declaration into the loop for the openmp construct
-			auto getPCA = [&](std::vector<size_t> alignment, size_t start, size_t end) -> CCVector3 {
+			auto getPCA = [&](const std::vector<size_t> &alignment, size_t start, size_t end) -> CCVector3 {
 				// Matrix which is capable of holding all points for PCA.
 				Eigen::MatrixX3d mat;
 				mat.resize(end - start, 3);
@@ -2519,14 +3553,18 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlines(const buw:
 			callback->stop();
 	}
 
-	std::sort(alignments.begin(), alignments.end(), [&](std::vector<std::pair<CCVector3, ScalarType>> &lhs, std::vector<std::pair<CCVector3, ScalarType>> &rhs) -> bool {
-		return lhs.front().second < rhs.front().second;
-	});
+	reportStageTiming(callback, "Centerline smoothing", stageStart);
 
-	std::for_each(alignments.begin(), alignments.end(), [](std::vector<std::pair<CCVector3, ScalarType>> &line) {
-		std::sort(line.begin(), line.end(), [&](std::pair<CCVector3, ScalarType> &lhs, std::pair<CCVector3, ScalarType> &rhs) -> bool {
+	// Sort each alignment in parallel, then order the alignments by their start.
+#pragma omp parallel for schedule(dynamic)
+	for(long i = 0; i < alignments.size(); i++) {
+		std::sort(alignments[i].begin(), alignments[i].end(), [](const std::pair<CCVector3, ScalarType> &lhs, const std::pair<CCVector3, ScalarType> &rhs) -> bool {
 			return lhs.second < rhs.second;
 		});
+	}
+
+	std::sort(alignments.begin(), alignments.end(), [&](std::vector<std::pair<CCVector3, ScalarType>> &lhs, std::vector<std::pair<CCVector3, ScalarType>> &rhs) -> bool {
+		return lhs.front().second < rhs.front().second;
 	});
 
 	if(desc.fuseAlignments) {
@@ -2834,6 +3872,8 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 			//std::vector<double> curvaturesFiltered = std::vector<double>(numCurvatures);
 			//std::vector<double> curvaturesSmoothed = std::vector<double>(numCurvaturesSmoothed);
 
+			auto stageStart = std::chrono::steady_clock::now();
+
 			int tid = 0;
 			// Compute the bearing for all points as the angle between the principal axis of bearingComputationSegmentLength consecutive centerline points and the NORTH direction.
 #pragma omp parallel private(tid) firstprivate(callback) shared(bearings, curvatures, chainages)
@@ -2846,7 +3886,7 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 				//buw::CenterlineCurvatureComputationDescription desc = buw::CenterlineCurvatureComputationDescription(description);
 
 				// Pull the lambda declaration into the loop for the openmp construct
-				auto getPCA = [&](std::vector<size_t> alignment, size_t start, size_t end) -> Eigen::Matrix<double, 2, 1> {
+				auto getPCA = [&](const std::vector<size_t> &alignment, size_t start, size_t end) -> Eigen::Matrix<double, 2, 1> {
 					// Matrix which is capable of holding all points for PCA.
 					Eigen::MatrixX2d mat;
 					mat.resize(end - start, 2);
@@ -2932,6 +3972,9 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 				//}
 
 
+				reportStageTiming(callback, "Bearing computation of alignment #" + std::to_string(idx), stageStart);
+				stageStart = std::chrono::steady_clock::now();
+
 				if(desc.numPointsForMedianBearing > 1) {
 					// Copy bearings values to allow for median filtering.
 					std::vector<double> bearingsOld = std::vector<double>(bearings.size());
@@ -2953,9 +3996,11 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 							values.push_back(bearingsOld[ii]);
 						}
 						
-						std::sort(values.begin(), values.end(), [](const double &lhs, const double &rhs)->bool { return lhs < rhs; });
+						// Select the median instead of sorting the window.
+						auto median = values.begin() + ((int)std::ceilf((float)values.size() / 2.0f) - 1);
+						std::nth_element(values.begin(), median, values.end());
 
-						double bearing = values[(int)std::ceilf((float)values.size() / 2.0f) - 1];
+						double bearing = *median;
 						
 						bearings[i] = bearing;							
 					}
@@ -3024,9 +4069,11 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 							values.push_back(curvaturesOld[ii]);
 						}
 
-						std::sort(values.begin(), values.end(), [](const double &lhs, const double &rhs)->bool { return lhs < rhs; });
+						// Select the median instead of sorting the window.
+						auto median = values.begin() + ((int)std::ceilf((float)values.size() / 2.0f) - 1);
+						std::nth_element(values.begin(), median, values.end());
 
-						curvatures[i] = values[(int)std::ceilf((float)values.size() / 2.0f) - 1];
+						curvatures[i] = *median;
 					}
 					
 				}
@@ -3111,6 +4158,8 @@ int OpenInfraPlatform::Infrastructure::PointCloud::computeCenterlineCurvature(co
 					//	file.write(text.toStdString().data());
 					//}
 
+			reportStageTiming(callback, "Curvature estimation of alignment #" + std::to_string(idx), stageStart);
+
 			for(size_t i = 0; i < deltaCurvatures.size(); i++) {
 				QString text = QString::number(chainages[i], 'g', 20)
 					.append("\t")
@@ -3206,74 +4255,201 @@ int OpenInfraPlatform::Infrastructure::PointCloud::resetRailwaySegmentation() {
 	return 0;
 }
 
-void OpenInfraPlatform::Infrastructure::PointCloud::removeNotSegmentedPoints() {
+std::vector<int> OpenInfraPlatform::Infrastructure::PointCloud::removeNotSegmentedPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 	int idx_segmented = getScalarFieldIndexByName("Segmented");
 
-	// Abort if we have no filtered points.
+	// Abort if we have no segmented points.
 	if (idx_segmented == -1)
-		return;
-
-	// Set the scalar field to read from and filter all points with non 0 value, choose 0.1f due to accuracy issues.
-	setCurrentOutScalarField(idx_segmented);
-	float epsilon = 0.0001f;
-	ccPointCloud *segmented = filterPointsByScalarValue(0, epsilon, true);
+		return std::vector<int>();
 
-	// Clear all points from the point cloud.
-	clear();
+	if (callback)
+		callback->start();
 
-	// Clear the index buffers.
-	remainingIndices_.clear();
-	filteredIndices_.clear();
-	segmentedIndices_.clear();
+	// Keep all points with a non 0 value, choose 0.0001f due to accuracy issues.
+	CCLib::ScalarField* segmented = getScalarField(idx_segmented);
+	float epsilon = 0.0001f;
+	std::vector<uint8_t> keep = std::vector<uint8_t>(size());
 
-	// Clear all sections.
-	sections_.clear();
+#pragma omp parallel for
+	for (long i = 0; i < keep.size(); i++) {
+		ScalarType value = segmented->getValue(i);
+		keep[i] = value < 0 || value > epsilon;
+	}
 
-	// Remove all scalar fields.
-	deleteAllScalarFields();
+	std::vector<int> remap = compactPoints(keep, callback);
 
-	// Append the filtered cloud and initialize the cloud.
-	append(segmented, 0);
+	if (callback)
+		callback->stop();
 
-	init();
+	return remap;
 }
 
-void OpenInfraPlatform::Infrastructure::PointCloud::removeFilteredPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
-	if (callback)
-		callback->start();
-
+std::vector<int> OpenInfraPlatform::Infrastructure::PointCloud::removeFilteredPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
 	int idx_filtered = getScalarFieldIndexByName("Filtered");
 
 	// Abort if we have no filtered points.
 	if (idx_filtered == -1)
-		return;
+		return std::vector<int>();
 
-	// Set the scalar field to read from and filter all points with non 0 value, choose 0.1f due to accuracy issues.
-	setCurrentOutScalarField(idx_filtered);
+	if (callback)
+		callback->start();
+
+	// Keep all points with value 0, choose 0.0001f due to accuracy issues.
+	CCLib::ScalarField* filtered = getScalarField(idx_filtered);
 	float epsilon = 0.0001f;
-	ccPointCloud *filtered = filterPointsByScalarValue(0, epsilon);
+	std::vector<uint8_t> keep = std::vector<uint8_t>(size());
 
-	// Clear all points from the point cloud.
-	clear();
+#pragma omp parallel for
+	for (long i = 0; i < keep.size(); i++) {
+		ScalarType value = filtered->getValue(i);
+		keep[i] = value >= 0 && value <= epsilon;
+	}
 
-	// Clear the index buffers.
-	remainingIndices_.clear();
-	filteredIndices_.clear();
-	segmentedIndices_.clear();
+	std::vector<int> remap = compactPoints(keep, callback);
 
-	// Clear all sections.
-	sections_.clear();
+	if (callback)
+		callback->stop();
 
-	// Remove all scalar fields.
-	deleteAllScalarFields();
+	return remap;
+}
 
-	// Append the filtered cloud and initialize the cloud.
-	append(filtered, 0);
+std::vector<int> OpenInfraPlatform::Infrastructure::PointCloud::compactPoints(const std::vector<uint8_t> &keep, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback) {
+	const long numPoints = (long)size();
+	std::vector<int> remap = std::vector<int>(numPoints, -1);
 
-	init();
+	// Compute the new indices with a parallel prefix sum: count the remaining points per block, then offset each block by its predecessors.
+	const int numBlocks = std::max(1, omp_get_max_threads());
+	const long blockSize = (numPoints + numBlocks - 1) / numBlocks;
+	std::vector<long> offsets = std::vector<long>(numBlocks + 1, 0);
+
+#pragma omp parallel for
+	for (int block = 0; block < numBlocks; block++) {
+		const long begin = std::min(numPoints, block * blockSize), end = std::min(numPoints, begin + blockSize);
+		long count = 0;
+		for (long i = begin; i < end; i++)
+			count += keep[i] ? 1 : 0;
+		offsets[block + 1] = count;
+	}
 
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+#pragma omp parallel for
+	for (int block = 0; block < numBlocks; block++) {
+		const long begin = std::min(numPoints, block * blockSize), end = std::min(numPoints, begin + blockSize);
+		long next = offsets[block];
+		for (long i = begin; i < end; i++) {
+			if (keep[i])
+				remap[i] = (int)next++;
+		}
+	}
+
+	const long remainingPoints = offsets.back();
 	if (callback)
-		callback->stop();
+		callback->update(25);
+
+	// Nothing to remove, all indices stay the same.
+	if (remainingPoints == numPoints)
+		return remap;
+
+	// Everything before the first removed point is already in place.
+	long firstRemoved = 0;
+	while (firstRemoved < numPoints && remap[firstRemoved] == firstRemoved)
+		firstRemoved++;
+
+	// Move the remaining points to the front. New indices are never larger than the old ones, so a forward pass per attribute works in place and the attributes
+	// (coordinates, colors, normals and each scalar field) are independent of each other and can be compacted in parallel.
+	const int numScalarFields = (int)getNumberOfScalarFields();
+	const bool bHasColors = rgbColors() != nullptr;
+	const bool bHasNormals = hasNormals();
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for (int task = 0; task < 3 + numScalarFields; task++) {
+		if (task == 0) {
+			for (long i = firstRemoved; i < numPoints; i++) {
+				if (remap[i] >= 0)
+					*point(remap[i]) = *point(i);
+			}
+		}
+		else if (task == 1 && bHasColors) {
+			for (long i = firstRemoved; i < numPoints; i++) {
+				if (remap[i] >= 0)
+					setPointColor(remap[i], ccColor::Rgb(getPointColor(i)));
+			}
+		}
+		else if (task == 2 && bHasNormals) {
+			for (long i = firstRemoved; i < numPoints; i++) {
+				if (remap[i] >= 0)
+					setPointNormalIndex(remap[i], getPointNormalIndex(i));
+			}
+		}
+		else if (task >= 3) {
+			CCLib::ScalarField* field = getScalarField(task - 3);
+			for (long i = firstRemoved; i < numPoints; i++) {
+				if (remap[i] >= 0)
+					field->setValue(remap[i], field->getValue(i));
+			}
+		}
+	}
+
+	if (callback)
+		callback->update(75);
+
+	// Truncate all attributes to the remaining points.
+	if (!resize((unsigned)remainingPoints))
+		BLUE_LOG(warning) << "Resizing the point cloud after compaction failed.";
+
+	if (isVisibilityTableInstantiated())
+		unallocateVisibilityArray();
+
+	for (int i = 0; i < numScalarFields; i++)
+		getScalarField(i)->computeMinAndMax();
+
+	invalidateBoundingBox();
+
+	// Update everything which references points instead of rebuilding it.
+	remapIndices(remap);
+	computeMainAxis();
+
+	if (callback)
+		callback->update(100);
+
+	return remap;
+}
+
+void OpenInfraPlatform::Infrastructure::PointCloud::remapIndices(const std::vector<int> &remap) {
+	// Renumber an index buffer and drop the removed points, the buffers stay sorted.
+	auto remapIndexBuffer = [&](std::vector<uint32_t> &indices) {
+		size_t count = 0;
+		for (size_t i = 0; i < indices.size(); i++) {
+			if (remap[indices[i]] >= 0)
+				indices[count++] = (uint32_t)remap[indices[i]];
+		}
+		indices.resize(count);
+	};
+
+	remapIndexBuffer(remainingIndices_);
+	remapIndexBuffer(filteredIndices_);
+	remapIndexBuffer(segmentedIndices_);
+
+	// Update the grid cells and remove the ones which became empty.
+	for (auto it = grid_.begin(); it != grid_.end();) {
+		remapIndexBuffer(std::get<0>(it->second));
+		if (std::get<0>(it->second).empty())
+			it = grid_.erase(it);
+		else
+			it++;
+	}
+
+	// Update the sections and their pairs in parallel and remove the ones which became empty.
+#pragma omp parallel for
+	for (long i = 0; i < sections_.size(); i++)
+		sections_[i]->remapIndices(remap);
+
+	auto end = std::remove_if(sections_.begin(), sections_.end(), [](const buw::ReferenceCounted<buw::PointCloudSection> &section) -> bool { return section->size() == 0; });
+	sections_.erase(end, sections_.end());
+
+	if (octree_)
+		octree_->remapIndices(remap);
 }
 
 const CCVector3 OpenInfraPlatform::Infrastructure::PointCloud::getMainAxis() const {
@@ -45,6 +45,12 @@ namespace OpenInfraPlatform {
 			// Dont use, prototype implementation.
 			static buw::ReferenceCounted<PointCloud> FromFile(const char* filename);
 
+			// Loads a point cloud stored with 'saveCache' including scalar fields, index buffers, octree, grid, sections and pairs. Returns nullptr if the file is no valid cache.
+			static buw::ReferenceCounted<PointCloud> FromCache(const char* filename, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
+			// Stores the current processing state in a binary cache which can be mapped into memory when loading. Returns 0 on success and a negative value if writing failed.
+			int saveCache(const char* filename, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
 			PointCloud() : ccPointCloud(), octree_(std::make_shared<Octree>(this)) { }
 
 			PointCloud(QString name) : ccPointCloud(name) { }
@@ -53,6 +59,7 @@ namespace OpenInfraPlatform {
 
 			virtual ~PointCloud();
 
+			// Appends the points of 'other' and sorts them into the existing octree, grid and sections without initializing the cloud again. An empty cloud is initialized.
 			int add(const buw::ReferenceCounted<ccPointCloud> &other, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr, ColorCompType* color = nullptr);
 
 			void computeSections(const float length, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
@@ -81,6 +88,10 @@ namespace OpenInfraPlatform {
 
 			int resetPositionFilter();
 
+			// Evaluates all stages in one parallel pass over the points in octree cell order, cheap stages first, and writes the combined result to "FilterPipeline"
+			// and "Filtered". Stages on sections are prepared per section and combined in the same pass.
+			int applyFilterPipeline(const buw::FilterPipelineDescription &desc, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
 			int applyPercentilesSegmentation(buw::PercentileSegmentationDescription desc, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
 
 			int applyPercentilesSegmentationHP(const buw::PercentileSegmentationDescription &desc, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
@@ -113,9 +124,11 @@ namespace OpenInfraPlatform {
 
 			int resetRailwaySegmentation();
 
-			void removeNotSegmentedPoints();
+			// Removes all points which are not segmented in place and keeps the scalar fields. Returns the new index of each old point or -1 if it was removed.
+			std::vector<int> removeNotSegmentedPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
 
-			void removeFilteredPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+			// Removes all filtered points in place and keeps the scalar fields. Returns the new index of each old point or -1 if it was removed.
+			std::vector<int> removeFilteredPoints(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
 
 			void resetScalarField(const char* name);	
 
@@ -172,6 +185,17 @@ namespace OpenInfraPlatform {
 			
 			void init();
 
+			// Moves all points with keep[i] != 0 to the front, truncates the cloud and updates sections, pairs, grid, index buffers and octree.
+			std::vector<int> compactPoints(const std::vector<uint8_t> &keep, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
+			void remapIndices(const std::vector<int> &remap);
+
+			// Updates index buffers, octree, grid and sections for the points appended starting at 'firstIndex'.
+			void insertAppendedPoints(const unsigned firstIndex, const bool bHasChainage);
+
+			// Computes center and axis of the given grid cells.
+			void computeGridCells(const std::vector<std::pair<int, int>> &keys, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
 			void computeChainageOctreeBased(buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
 
 			void computeChainageGridBased(Enums::eChainageComputationInterpolationMethod method, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
@@ -181,6 +205,9 @@ namespace OpenInfraPlatform {
 
 			const std::tuple<size_t, size_t> getScalarFieldMinAndMaxIndex(int idx);
 
+			// Estimates the percentiles once per octree cell with a streaming sketch instead of once per point.
+			int applyPercentilesSegmentationApproximate(const buw::PercentileSegmentationDescription &desc, bool bExcludeFiltered, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
+
 
 		public:
 
@@ -189,6 +216,7 @@ namespace OpenInfraPlatform {
 			std::vector<uint32_t> remainingIndices_, filteredIndices_, segmentedIndices_;
 			std::vector<buw::ReferenceCounted<PointCloudSection>> sections_;
 			std::map<std::pair<int, int>, std::tuple<std::vector<uint32_t>, CCVector3, CCVector2>> grid_;
+			buw::GridComputationDescription gridDescription_;
 			buw::ReferenceCounted<Octree> octree_ = nullptr;
 			bool bHasPairs_ = false, bHasCenterline_ = false;
 
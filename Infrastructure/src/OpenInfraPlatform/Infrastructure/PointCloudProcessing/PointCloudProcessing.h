@@ -55,6 +55,18 @@ namespace OpenInfraPlatform
 				Barycentric = 1,
 				Linear = 2
 			};
+
+			enum ePercentileComputationMethod {
+				Exact = 0,
+				Approximate = 1
+			};
+
+			enum ePointCloudFilterType {
+				DuplicateFilter = 0,
+				LocalDensityFilter = 1,
+				PositionFilter = 2,
+				RelativeHeightFilter = 3
+			};
 		}
 
 		struct LaserPoint
@@ -105,6 +117,21 @@ namespace OpenInfraPlatform
 			RelativeHeightFilterDescription() = default;
 		};
 
+		// One stage of a filter pipeline, only the description matching 'type' is used.
+		struct FilterPipelineStageDescription {
+			Enums::ePointCloudFilterType type;
+
+			DuplicateFilterDescription duplicate;
+			LocalDensityFilterDescription localDensity;
+			PositionFilterDescription position;
+			RelativeHeightFilterDescription relativeHeight;
+		};
+
+		// Filters which are evaluated together in a single pass, a point is filtered if any stage filters it.
+		struct FilterPipelineDescription {
+			std::vector<FilterPipelineStageDescription> stages;
+		};
+
 		struct RateOfChangeSegmentationDescription {
 			int dim;
 			float maxNeighbourDistance;
@@ -114,6 +141,10 @@ namespace OpenInfraPlatform
 		struct PercentileSegmentationDescription {
 			float minThreshold, maxThreshold, kernelRadius;
 			double lowerPercentile, upperPercentile;
+
+			// Exact uses selection per neighbourhood, Approximate evaluates one streaming sketch per octree cell.
+			Enums::ePercentileComputationMethod method = Enums::ePercentileComputationMethod::Exact;
+			double sketchCompression = 100.0;
 		};
 
 		struct CenterlineComputationDescription {
@@ -202,6 +233,8 @@ namespace buw
 	using OpenInfraPlatform::Infrastructure::LocalDensityFilterDescription;
 	using OpenInfraPlatform::Infrastructure::PositionFilterDescription;
 	using OpenInfraPlatform::Infrastructure::RelativeHeightFilterDescription;
+	using OpenInfraPlatform::Infrastructure::FilterPipelineStageDescription;
+	using OpenInfraPlatform::Infrastructure::FilterPipelineDescription;
 	using OpenInfraPlatform::Infrastructure::RateOfChangeSegmentationDescription;
 	using OpenInfraPlatform::Infrastructure::PercentileSegmentationDescription;
 	using OpenInfraPlatform::Infrastructure::RailwaySegmentationDescription;
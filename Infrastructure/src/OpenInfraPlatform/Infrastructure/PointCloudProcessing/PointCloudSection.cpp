@@ -17,6 +17,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include "PointCloudSection.h"
 #include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/PointCloud.h"
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/Percentile.h"
 
 #include <ccScalarField.h>
 
@@ -64,9 +65,54 @@ int OpenInfraPlatform::Infrastructure::PointCloudSection::computeLocalDensity(CC
 	return err;
 }
 
-int OpenInfraPlatform::Infrastructure::PointCloudSection::computePercentiles(float kernelRadius)
+int OpenInfraPlatform::Infrastructure::PointCloudSection::computePercentiles(const buw::PercentileSegmentationDescription &desc)
 {
-	//TODO
+	if(this->size() == 0)
+		return 0;
+
+	buw::PointCloud* associatedCloud = dynamic_cast<buw::PointCloud*>(getAssociatedCloud());
+
+	// Write to the scalar field directly instead of the current in field so that sections can be processed in parallel.
+	int idx = associatedCloud->getScalarFieldIndexByName("SegmentedPercentile");
+	if(idx == -1)
+		return -1;
+
+	CCLib::ScalarField* segmented = associatedCloud->getScalarField(idx);
+
+	if(desc.method == Enums::ePercentileComputationMethod::Approximate) {
+		// Single pass over the section heights, no copy of the coordinates.
+		buw::PercentileSketch sketch = buw::PercentileSketch(desc.sketchCompression);
+		for_each([&](size_t i) { sketch.add(getPoint(i)->z); });
+
+		const double lower = sketch.getPercentile(desc.lowerPercentile);
+		const double upper = sketch.getPercentile(desc.upperPercentile);
+		const double diff = std::abs(upper - lower);
+		const double totalDiff = std::abs(sketch.getMaximum() - sketch.getMinimum());
+
+		if(diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
+			for_each([&](size_t i) {
+				if(getPoint(i)->z >= upper)
+					segmented->setValue(getPointGlobalIndex(i), 1.0f);
+			});
+		}
+	}
+	else {
+		// Select the percentiles on (height, global index) pairs so that the upper percentile can be marked without a full sort.
+		std::vector<std::pair<float, unsigned>> heights = std::vector<std::pair<float, unsigned>>(this->size());
+		for_each([&](size_t i) { heights[i] = std::pair<float, unsigned>(getPoint(i)->z, getPointGlobalIndex(i)); });
+
+		buw::PercentileRange range = buw::selectPercentileRange(heights.begin(), heights.end(), desc.lowerPercentile, desc.upperPercentile,
+			[](const std::pair<float, unsigned> &value) -> float { return value.first; });
+
+		const double diff = std::abs(range.upper - range.lower);
+		const double totalDiff = std::abs(range.maximum - range.minimum);
+
+		if(diff >= desc.minThreshold && totalDiff < desc.maxThreshold) {
+			for(size_t i = range.upperIndex; i < heights.size(); i++)
+				segmented->setValue(heights[i].second, 1.0f);
+		}
+	}
+
 	return 0;
 }
 
@@ -93,20 +139,20 @@ CCVector3 OpenInfraPlatform::Infrastructure::PointCloudSection::computeCenter()
 
 CCVector3 OpenInfraPlatform::Infrastructure::PointCloudSection::computeMedianCenter()
 {
-	std::vector<float> x,y,z;
+	if(this->size() == 0)
+		return CCVector3();
+
+	std::vector<float> x = std::vector<float>(this->size()), y = std::vector<float>(this->size()), z = std::vector<float>(this->size());
 
 	for_each([&](size_t i) {
 		auto point = getPoint(i);
-		x.push_back(point->x);
-		y.push_back(point->y);
-		z.push_back(point->z);
+		x[i] = point->x;
+		y[i] = point->y;
+		z[i] = point->z;
 	});
 
-	std::sort(x.begin(), x.end());
-	std::sort(y.begin(), y.end());
-	std::sort(z.begin(), z.end());
-
-	return CCVector3(x[std::floor(x.size() / 2.0)], y[std::floor(y.size() / 2.0)], z[std::floor(z.size() / 2.0)]);
+	// Only the median is needed, so select it in linear time instead of sorting each coordinate.
+	return CCVector3(buw::selectPercentile(x, 0.5), buw::selectPercentile(y, 0.5), buw::selectPercentile(z, 0.5));
 }
 
 Eigen::Matrix3d OpenInfraPlatform::Infrastructure::PointCloudSection::getOrientation()
@@ -119,7 +165,7 @@ Eigen::Matrix3d OpenInfraPlatform::Infrastructure::PointCloudSection::getOrienta
 	return orientation;
 }
 
-std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointCloudSection::computePairs(buw::PairComputationDescription desc, buw::ReferenceCounted<PointCloudSection> nextSection)
+std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointCloudSection::computePairs(buw::PairComputationDescription desc, buw::ReferenceCounted<PointCloudSection> nextSection, bool bMarkPairs)
 {
 	if(this->size() > 0) {
 		// Project all points in this section onto the LS plane to get 2D coordinates.
@@ -132,8 +178,6 @@ std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointC
 			return std::vector<std::pair<size_t, size_t>>();
 		}
 
-		associatedCloud->setCurrentInScalarField(idx);
-		
 		// Set up our pairs as set so that every pair is only contained once.
 		std::vector<std::pair<size_t, size_t>> pairs = std::vector<std::pair<size_t, size_t>>();
 		// Allow 0.1cm of error, standard gauge witdth is 1.435m and the width of the track head itself is 67mm.
@@ -260,11 +304,6 @@ std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointC
 				cloud3D = nullptr;
 			}
 
-			// Color the pair points and set the scalar value.
-			const ColorCompType red[3] = { 255,0,0 };
-			const ColorCompType green[3] = { 0,255,0 };
-			const ColorCompType yellow[3] = { 255, 255, 0 };
-
 			auto orientation = getOrientation();
 			CCVector3 mainAxis = CCVector3(orientation.col(0)[0], orientation.col(0)[1], orientation.col(0)[2]);
 
@@ -341,20 +380,11 @@ std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointC
 					offset++;
 				}
 			}
-
-			if(!pairs.empty()) {
-				for(auto pair : pairs) {
-					if(associatedCloud->rgbColors() != nullptr) {
-						associatedCloud->setPointColor(pair.first, ccColor::Rgb(green));
-						associatedCloud->setPointColor(pair.second, ccColor::Rgb(red));
-					}
-
-					associatedCloud->setPointScalarValue(pair.first, -1);
-					associatedCloud->setPointScalarValue(pair.second, 1);
-				}
-			}
 		}
 		pairs_ = pairs;
+
+		if(bMarkPairs)
+			markPairs();
 	}
 	else {
 		//BLUE_LOG(warning) << "Empty section found.";
@@ -363,16 +393,64 @@ std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointC
 	return getPairs();
 }
 
+void OpenInfraPlatform::Infrastructure::PointCloudSection::markPairs()
+{
+	buw::PointCloud* associatedCloud = dynamic_cast<buw::PointCloud*>(getAssociatedCloud());
+
+	int idx = associatedCloud->getScalarFieldIndexByName("Railway");
+	if(idx == -1)
+		return;
+
+	CCLib::ScalarField* railway = associatedCloud->getScalarField(idx);
+
+	// Color the pair points and set the scalar value.
+	const ColorCompType red[3] = { 255,0,0 };
+	const ColorCompType green[3] = { 0,255,0 };
+
+	for(auto pair : pairs_) {
+		if(associatedCloud->rgbColors() != nullptr) {
+			associatedCloud->setPointColor(pair.first, ccColor::Rgb(green));
+			associatedCloud->setPointColor(pair.second, ccColor::Rgb(red));
+		}
+
+		railway->setValue(pair.first, -1);
+		railway->setValue(pair.second, 1);
+	}
+}
+
 void OpenInfraPlatform::Infrastructure::PointCloudSection::resetPairs()
 {
 	pairs_.clear();
 }
 
+void OpenInfraPlatform::Infrastructure::PointCloudSection::remapIndices(const std::vector<int>& remap)
+{
+	// Compact the references in place, the new indices keep the order of the old ones.
+	unsigned count = 0;
+	for(unsigned i = 0; i < size(); i++) {
+		int index = remap[getPointGlobalIndex(i)];
+		if(index >= 0)
+			setPointIndex(count++, (unsigned)index);
+	}
+	resize(count);
+
+	// Pairs are only kept if both points survived.
+	auto end = std::remove_if(pairs_.begin(), pairs_.end(), [&](const std::pair<size_t, size_t> &pair) -> bool { return remap[pair.first] < 0 || remap[pair.second] < 0; });
+	pairs_.erase(end, pairs_.end());
+	for(auto &pair : pairs_)
+		pair = std::pair<size_t, size_t>(remap[pair.first], remap[pair.second]);
+}
+
 std::vector<std::pair<size_t, size_t>> OpenInfraPlatform::Infrastructure::PointCloudSection::getPairs()
 {
 	return pairs_;
 }
 
+void OpenInfraPlatform::Infrastructure::PointCloudSection::setPairs(const std::vector<std::pair<size_t, size_t>> &pairs)
+{
+	pairs_ = pairs;
+}
+
 void OpenInfraPlatform::Infrastructure::PointCloudSection::getAxisAlignedBoundingBox(CCVector3 & min, CCVector3 & max)
 {
 	// Initialize min to maximal possible value and max to minimal possible value.
@@ -54,7 +54,8 @@ namespace OpenInfraPlatform {
 
 			int computeLocalDensity(CCLib::GeometricalAnalysisTools::Density metric, ScalarType kernelRadius, buw::ReferenceCounted<CCLib::GenericProgressCallback> callback = nullptr);
 
-			int computePercentiles(float kernelRadius);
+			// Marks the points of this section in the upper height percentile in the "SegmentedPercentile" field of the associated cloud.
+			int computePercentiles(const buw::PercentileSegmentationDescription &desc);
 
 			CCVector3 computeCenterOfMass();
 
@@ -64,12 +65,22 @@ namespace OpenInfraPlatform {
 
 			Eigen::Matrix3d getOrientation();
 
-			std::vector<std::pair<size_t, size_t>> computePairs(buw::PairComputationDescription desc, buw::ReferenceCounted<PointCloudSection> nextSection = nullptr);
+			// Computes the pairs of matching rail points. If 'bMarkPairs' is false, the associated cloud is not modified so that sections can be processed in parallel.
+			std::vector<std::pair<size_t, size_t>> computePairs(buw::PairComputationDescription desc, buw::ReferenceCounted<PointCloudSection> nextSection = nullptr, bool bMarkPairs = true);
+
+			// Colors the pair points and sets their "Railway" scalar value in the associated cloud.
+			void markPairs();
 
 			void resetPairs();
 
+			// Updates the point indices and pairs after the associated cloud has been compacted, points mapped to -1 are removed.
+			void remapIndices(const std::vector<int> &remap);
+
 			std::vector<std::pair<size_t, size_t>> getPairs();
 
+			// Replaces the pairs without marking them in the associated cloud, used when restoring a section from a cache.
+			void setPairs(const std::vector<std::pair<size_t, size_t>> &pairs);
+
 			void getAxisAlignedBoundingBox(CCVector3 &min, CCVector3 &max);
 
 			void getObjectOrientedBoundingBox(CCVector3 &min, CCVector3 &max);
@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2018 Technical University of Munich
+Chair of Computational Modeling and Simulation.
+
+TUM Open Infra Platform is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License Version 3
+as published by the Free Software Foundation.
+
+TUM Open Infra Platform is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_Infrastructure_PointCloudProcessing_UnionFind_9C2E7A15_3B64_4F0D_A8E1_6D5B2F93C4A0_h
+#define OpenInfraPlatform_Infrastructure_PointCloudProcessing_UnionFind_9C2E7A15_3B64_4F0D_A8E1_6D5B2F93C4A0_h
+
+#include "OpenInfraPlatform/Infrastructure/namespace.h"
+#include "OpenInfraPlatform/Infrastructure/OIPInfrastructure.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OpenInfraPlatform {
+	namespace Infrastructure {
+
+		// Lock-free disjoint set which can be used concurrently from multiple threads. Roots are always linked below the root with the smaller
+		// index, so the parent of an element never has a larger index, no cycles can occur and the root of each set is its smallest element.
+		class ConcurrentUnionFind {
+		public:
+			ConcurrentUnionFind(const size_t size) : parents_(size)
+			{
+				for(size_t i = 0; i < size; i++)
+					parents_[i].store((uint32_t)i, std::memory_order_relaxed);
+			}
+
+			// Returns the root of the set containing 'element' and halves the path to it.
+			uint32_t find(uint32_t element)
+			{
+				while(true) {
+					uint32_t parent = parents_[element].load(std::memory_order_acquire);
+					if(parent == element)
+						return element;
+
+					// Concurrent updates only ever move an element closer to its root, so a failed exchange can be ignored.
+					uint32_t grandparent = parents_[parent].load(std::memory_order_acquire);
+					if(parent != grandparent)
+						parents_[element].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+
+					element = grandparent;
+				}
+			}
+
+			// Merges the sets containing 'a' and 'b'.
+			void unite(uint32_t a, uint32_t b)
+			{
+				while(true) {
+					a = find(a);
+					b = find(b);
+					if(a == b)
+						return;
+
+					if(a < b)
+						std::swap(a, b);
+
+					// Link the larger root below the smaller one, retry if another thread has linked it in the meantime.
+					uint32_t expected = a;
+					if(parents_[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel))
+						return;
+				}
+			}
+
+			size_t size() const
+			{
+				return parents_.size();
+			}
+
+		private:
+			std::vector<std::atomic<uint32_t>> parents_;
+		};
+	}
+}
+
+namespace buw {
+	using OpenInfraPlatform::Infrastructure::ConcurrentUnionFind;
+}
+
+#endif
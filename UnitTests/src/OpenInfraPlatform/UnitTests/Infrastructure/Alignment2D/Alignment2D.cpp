@@ -0,0 +1,425 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignment2D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DArc.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DClothoid.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DLine.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignment2D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignmentElement2DArc.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignmentElement2DLine.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignmentElement2DParabola.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Lines along the x-axis with lengths 1, 2, 3, 1, 2, 3, ...
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> createHorizontalAlignment(const int elementCount, std::vector<double>& o_ends)
+	{
+		buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::make_shared<buw::HorizontalAlignment2D>(100.0);
+		double x = 0.0;
+		o_ends.clear();
+		for (int i = 0; i < elementCount; i++)
+		{
+			const double length = 1.0 + i % 3;
+			ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(x, 0.0), buw::Vector2d(x + length, 0.0)));
+			x += length;
+			o_ends.push_back(100.0 + x);
+		}
+		return ha;
+	}
+
+	// Line, left turn, line and right turn over the vertical elements line, parabola, arc and line ending before the horizontal alignment.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> createAlignment()
+	{
+		buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::make_shared<buw::HorizontalAlignment2D>(0.0);
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(0, 0), buw::Vector2d(100, 0)));
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DArc>(buw::Vector2d(100, 50), buw::Vector2d(100, 0), buw::Vector2d(150, 50), false));
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(150, 50), buw::Vector2d(150, 150)));
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DArc>(buw::Vector2d(200, 150), buw::Vector2d(150, 150), buw::Vector2d(200, 200), true));
+
+		buw::ReferenceCounted<buw::VerticalAlignment2D> va = std::make_shared<buw::VerticalAlignment2D>();
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(0, 10), buw::Vector2d(50, 11)));
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DParabola>(buw::Vector2d(50, 11), buw::Vector2d(150, 11), 0.02, -0.02));
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DArc>(buw::Vector2d(150, 11), buw::Vector2d(200, 11.5), 1000.0, 0.0, true));
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(200, 11.5), buw::Vector2d(250, 12)));
+
+		return std::make_shared<buw::Alignment2DBased3D>(ha, va);
+	}
+
+	// Bounds of the element sampled densely, the extremes between the samples are closer than the tolerance of the tests.
+	void sampleExtends(const buw::HorizontalAlignmentElement2D& element, buw::Vector2d& minimum, buw::Vector2d& maximum)
+	{
+		const int count = 200001;
+		std::vector<double> lerpParameters(count);
+		for (int i = 0; i < count; i++)
+			lerpParameters[i] = static_cast<double>(i) / (count - 1);
+		std::vector<buw::Vector2d> positions(count);
+		element.getPositions(lerpParameters.data(), count, positions.data());
+
+		minimum = maximum = positions[0];
+		for (const buw::Vector2d& p : positions)
+		{
+			minimum = buw::minimizedVector(minimum, p);
+			maximum = buw::maximizedVector(maximum, p);
+		}
+	}
+
+	void expectExtendsMatchSamples(const buw::HorizontalAlignmentElement2D& element)
+	{
+		buw::Vector2d minimum, maximum, sampledMinimum, sampledMaximum;
+		element.getExtends(minimum, maximum);
+		sampleExtends(element, sampledMinimum, sampledMaximum);
+		EXPECT_NEAR(0.0, (minimum - sampledMinimum).norm(), 1e-6);
+		EXPECT_NEAR(0.0, (maximum - sampledMaximum).norm(), 1e-6);
+		EXPECT_LE(minimum.x(), sampledMinimum.x() + 1e-9);
+		EXPECT_LE(minimum.y(), sampledMinimum.y() + 1e-9);
+		EXPECT_GE(maximum.x(), sampledMaximum.x() - 1e-9);
+		EXPECT_GE(maximum.y(), sampledMaximum.y() - 1e-9);
+	}
+
+	// Largest distance of the element between two lerp parameters to the chord between them.
+	double chordDeviation(const buw::HorizontalAlignmentElement2D& element, const double a, const double b)
+	{
+		const buw::Vector2d start = element.getPosition(a);
+		const buw::Vector2d chord = element.getPosition(b) - start;
+		double deviation = 0.0;
+		for (int i = 0; i <= 200; i++)
+		{
+			const buw::Vector2d offset = element.getPosition(a + (b - a) * i / 200.0) - start;
+			const double t = chord.squaredNorm() > 0.0 ? std::min(std::max(offset.dot(chord) / chord.squaredNorm(), 0.0), 1.0) : 0.0;
+			deviation = std::max(deviation, (offset - t * chord).norm());
+		}
+		return deviation;
+	}
+
+	// The chords of the tessellation stay within the tolerance, the number of vertices is returned.
+	int expectTessellationWithinTolerance(const buw::HorizontalAlignmentElement2D& element, const double chordTolerance)
+	{
+		std::vector<double> lerpParameters = { 0.0 };
+		element.getTessellation(chordTolerance, lerpParameters);
+		lerpParameters.push_back(1.0);
+
+		for (size_t i = 0; i + 1 < lerpParameters.size(); i++)
+		{
+			EXPECT_LT(lerpParameters[i], lerpParameters[i + 1]);
+			EXPECT_LE(chordDeviation(element, lerpParameters[i], lerpParameters[i + 1]), chordTolerance * (1.0 + 1e-6));
+		}
+		return static_cast<int>(lerpParameters.size());
+	}
+}
+
+TEST(HorizontalAlignment2D, StationLookupFindsElement)
+{
+	std::vector<double> ends;
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = createHorizontalAlignment(60, ends);
+	EXPECT_DOUBLE_EQ(120.0, ha->getLength());
+	EXPECT_DOUBLE_EQ(220.0, ha->getEndStation());
+	EXPECT_DOUBLE_EQ(100.0, ha->getStartStation(0));
+	EXPECT_DOUBLE_EQ(ends[9], ha->getStartStation(10));
+
+	// Forwards, backwards and jumping, stations at the end of an element belong to it.
+	std::vector<double> stations;
+	for (double s = 100.0; s <= 220.0; s += 0.25)
+		stations.push_back(s);
+	for (double s = 220.0; s >= 100.0; s -= 0.5)
+		stations.push_back(s);
+	for (int i = 0; i < 200; i++)
+		stations.push_back(100.0 + (i * 37) % 120);
+
+	for (double s : stations)
+	{
+		int expected = 0;
+		while (ends[expected] < s)
+			expected++;
+
+		double lerp = -1.0;
+		buw::ReferenceCounted<buw::HorizontalAlignmentElement2D> element = ha->getAlignmentElementByStationing(s, &lerp);
+		EXPECT_EQ(ha->getAlignmentElementByIndex(expected), element);
+		EXPECT_EQ(expected, ha->getAlignmentElementIndexByStationing(s));
+		EXPECT_EQ(expected, ha->getAlignmentElementIndexByStationing(s, expected - 1));
+		EXPECT_NEAR(s - 100.0, ha->getPosition(s).x(), 1e-9);
+		EXPECT_GE(lerp, 0.0);
+		EXPECT_LE(lerp, 1.0);
+	}
+
+	// Stations out of range get the first or last element.
+	EXPECT_EQ(0, ha->getAlignmentElementIndexByStationing(50.0));
+	EXPECT_EQ(59, ha->getAlignmentElementIndexByStationing(300.0, 3));
+
+	buw::HorizontalAlignment2D empty;
+	EXPECT_EQ(-1, empty.getAlignmentElementIndexByStationing(0.0));
+	EXPECT_EQ(nullptr, empty.getAlignmentElementByStationing(0.0));
+}
+
+TEST(Alignment2DBased3D, BatchEvaluationMatchesPositions)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = alignment->getHorizontalAlignment();
+
+	// Stations out of range of both alignments are included.
+	std::vector<double> stations;
+	for (double s = -5.0; s < alignment->getEndStation() + 5.0; s += 0.37)
+		stations.push_back(s);
+	const int count = static_cast<int>(stations.size());
+
+	std::vector<double> borders = { 0.0, 50.0, 150.0, 200.0, 250.0, alignment->getEndStation() };
+	for (int i = 1; i < ha->getAlignmentElementCount(); i++)
+		borders.push_back(ha->getStartStation(i));
+
+	for (int threads = 1; threads <= 4; threads *= 4)
+	{
+		std::vector<buw::Vector3d> positions(count), tangents(count), normals(count);
+		alignment->getPositions(stations.data(), count, positions.data(), tangents.data(), normals.data(), threads);
+
+		for (int i = 0; i < count; i++)
+		{
+			const double s = stations[i];
+			EXPECT_NEAR(0.0, (alignment->getPosition(s) - positions[i]).norm(), 1e-9);
+			EXPECT_NEAR(1.0, tangents[i].norm(), 1e-12);
+			EXPECT_NEAR(0.0, (ha->getNormal(s) - normals[i].block<2, 1>(0, 0)).norm(), 1e-9);
+			EXPECT_EQ(0.0, normals[i].z());
+
+			// The tangent follows the positions away from the borders of the elements.
+			const double delta = 1e-4;
+			bool bInside = s - delta > 0.0 && s + delta < alignment->getEndStation();
+			for (double border : borders)
+				bInside = bInside && std::abs(s - border) > 2 * delta;
+			if (bInside)
+				EXPECT_NEAR(0.0, ((alignment->getPosition(s + delta) - alignment->getPosition(s - delta)).normalized() - tangents[i]).norm(), 1e-6);
+		}
+	}
+
+	// Stations in any order give the same result, positions only are computed as well.
+	std::vector<double> reversed(stations.rbegin(), stations.rend());
+	std::vector<buw::Vector3d> positions(count);
+	alignment->getPositions(reversed.data(), count, positions.data());
+	for (int i = 0; i < count; i++)
+		EXPECT_NEAR(0.0, (alignment->getPosition(reversed[i]) - positions[i]).norm(), 1e-9);
+
+	const std::vector<double> sweep = buw::createStations(0.0, 2.5, 1.0);
+	EXPECT_EQ(std::vector<double>({ 0.0, 1.0, 2.0, 2.5 }), sweep);
+
+	const buw::AxisAlignedBoundingBox3d extends = buw::getExtends(alignment);
+	EXPECT_NEAR(0.0, extends.getMinimum().y(), 1e-9);
+	EXPECT_NEAR(200.0, extends.getMaximum().y(), 1e-9);
+	EXPECT_NEAR(10.0, extends.getMinimum().z(), 1e-9);
+}
+
+TEST(HorizontalAlignmentElement2D, ExtendsMatchDenseSampling)
+{
+	expectExtendsMatchSamples(buw::HorizontalAlignmentElement2DLine(buw::Vector2d(3, -2), buw::Vector2d(-7, 5)));
+
+	// Arcs starting in each quadrant with sweeps passing none up to all of the axes in both directions.
+	for (double startAngle : { 0.3, 1.9, 3.5, 5.1, 0.0 })
+	{
+		for (double sweep : { 0.4, 1.4, 2.9, 4.6, 6.0 })
+		{
+			for (bool clockWise : { false, true })
+			{
+				const buw::Vector2d center(1000.0, -500.0);
+				const double endAngle = startAngle + (clockWise ? -sweep : sweep);
+				const buw::Vector2d start = center + 50.0 * buw::Vector2d(std::cos(startAngle), std::sin(startAngle));
+				const buw::Vector2d end = center + 50.0 * buw::Vector2d(std::cos(endAngle), std::sin(endAngle));
+				expectExtendsMatchSamples(buw::HorizontalAlignmentElement2DArc(center, start, end, clockWise));
+			}
+		}
+	}
+
+	// Entries and exits turning both ways, the long ones turn by more than 180 degrees.
+	for (double length : { 40.0, 150.0, 300.0, 500.0 })
+	{
+		for (double startDirection : { 0.2, 2.0, -1.3 })
+		{
+			for (bool counterClockwise : { true, false })
+			{
+				expectExtendsMatchSamples(buw::HorizontalAlignmentElement2DClothoid(
+					buw::clothoidDescription(buw::Vector2d(200, 300), startDirection, 0.0, counterClockwise, 150.0, true, length)));
+				expectExtendsMatchSamples(buw::HorizontalAlignmentElement2DClothoid(
+					buw::clothoidDescription(buw::Vector2d(200, 300), startDirection, length / (150.0 * 150.0), counterClockwise, 150.0, false, length)));
+			}
+		}
+	}
+}
+
+TEST(Alignment2DBased3D, ExtendsMatchDenseSampling)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+
+	// The horizontal bounds are merged from the ones of the elements.
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = alignment->getHorizontalAlignment();
+	buw::Vector2d minimum, maximum;
+	ASSERT_TRUE(ha->getExtends(minimum, maximum));
+	EXPECT_NEAR(0.0, (minimum - buw::Vector2d(0, 0)).norm(), 1e-9);
+	EXPECT_NEAR(0.0, (maximum - buw::Vector2d(200, 200)).norm(), 1e-9);
+	ha->getElementExtends(1, minimum, maximum);
+	EXPECT_NEAR(0.0, (minimum - buw::Vector2d(100, 0)).norm(), 1e-9);
+	EXPECT_NEAR(0.0, (maximum - buw::Vector2d(150, 50)).norm(), 1e-9);
+
+	const std::vector<double> stations = buw::createStations(alignment->getStartStation(), alignment->getEndStation(), 0.001);
+	std::vector<buw::Vector3d> positions(stations.size());
+	alignment->getPositions(stations.data(), static_cast<int>(stations.size()), positions.data());
+	buw::Vector3d sampledMinimum = positions[0], sampledMaximum = positions[0];
+	for (const buw::Vector3d& p : positions)
+	{
+		sampledMinimum = buw::minimizedVector(sampledMinimum, p);
+		sampledMaximum = buw::maximizedVector(sampledMaximum, p);
+	}
+
+	const buw::AxisAlignedBoundingBox3d extends = buw::getExtends(alignment);
+	EXPECT_NEAR(0.0, (extends.getMinimum() - sampledMinimum).norm(), 1e-6);
+	EXPECT_NEAR(0.0, (extends.getMaximum() - sampledMaximum).norm(), 1e-6);
+
+	// The crest of the parabola at station 100 and the valley of the arc below its center are inside of the range.
+	buw::ReferenceCounted<buw::VerticalAlignment2D> va = alignment->getVerticalAlignment();
+	const buw::Vector2d center = std::static_pointer_cast<buw::VerticalAlignmentElement2DArc>(va->getAlignmentElementByIndex(2))->getCenter();
+	double lowest, highest;
+	ASSERT_TRUE(va->getHeightRange(60.0, 170.0, lowest, highest));
+	EXPECT_NEAR(11.5, highest, 1e-9);
+	EXPECT_NEAR(center.y() - 1000.0, lowest, 1e-9);
+	ASSERT_TRUE(va->getHeightRange(60.0, 160.0, lowest, highest));
+	EXPECT_NEAR(va->getPosition(160.0).y(), lowest, 1e-9);
+	EXPECT_FALSE(va->getHeightRange(300.0, 400.0, lowest, highest));
+
+	const buw::AxisAlignedBoundingBox3d vertical = alignment->getVerticalAlignmentExtends();
+	EXPECT_DOUBLE_EQ(0.0, vertical.getMinimum().x());
+	EXPECT_DOUBLE_EQ(250.0, vertical.getMaximum().x());
+	EXPECT_DOUBLE_EQ(10.0, vertical.getMinimum().z());
+	EXPECT_NEAR(12.0, vertical.getMaximum().z(), 1e-9);
+
+	std::vector<buw::ReferenceCounted<buw::IAlignment3D>> alignments = { alignment };
+	const buw::AxisAlignedBoundingBox3d all = buw::getExtends(alignments);
+	EXPECT_NEAR(0.0, (all.getMaximum() - extends.getMaximum()).norm(), 1e-12);
+}
+
+TEST(HorizontalAlignmentElement2D, TessellationStaysWithinChordTolerance)
+{
+	for (double chordTolerance : { 0.001, 0.01, 0.1 })
+	{
+		// Lines need their end points only.
+		EXPECT_EQ(2, expectTessellationWithinTolerance(buw::HorizontalAlignmentElement2DLine(buw::Vector2d(10, 20), buw::Vector2d(130, -40)), chordTolerance));
+
+		// Arcs have equal angles, the sagitta of each is just below the tolerance.
+		const buw::Vector2d center(500, 300);
+		buw::HorizontalAlignmentElement2DArc arc(center, center + buw::Vector2d(80, 0), center + 80.0 * buw::Vector2d(std::cos(4.0), -std::sin(4.0)), true);
+		const int arcVertices = expectTessellationWithinTolerance(arc, chordTolerance);
+		EXPECT_EQ(static_cast<int>(std::ceil(4.0 / (2.0 * std::acos(1.0 - chordTolerance / 80.0)))) + 1, arcVertices);
+
+		// Clothoids get denser with the curvature, fewer vertices than bisection need.
+		for (double length : { 60.0, 450.0 })
+		{
+			for (bool counterClockwise : { true, false })
+			{
+				buw::HorizontalAlignmentElement2DClothoid entry(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 0.0, counterClockwise, 150.0, true, length));
+				const int clothoidVertices = expectTessellationWithinTolerance(entry, chordTolerance);
+				std::vector<double> bisection;
+				entry.HorizontalAlignmentElement2D::getTessellation(chordTolerance, bisection);
+				EXPECT_LE(clothoidVertices, static_cast<int>(bisection.size()) + 2);
+
+				expectTessellationWithinTolerance(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, length / (150.0 * 150.0), counterClockwise, 150.0, false, length)), chordTolerance);
+			}
+		}
+		expectTessellationWithinTolerance(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 150.0, -80.0, 120.0, true)), chordTolerance);
+	}
+}
+
+TEST(Alignment2DBased3D, TessellationMergesVerticalBreakpoints)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	const double chordTolerance = 0.001;
+	const std::vector<buw::Stationing> stations = alignment->getTessellation(chordTolerance, 20.0);
+	ASSERT_GE(stations.size(), 2u);
+	EXPECT_EQ(alignment->getStartStation(), stations.front());
+	EXPECT_EQ(alignment->getEndStation(), stations.back());
+
+	// The element starts of both alignments are vertices, no segment is longer than the limit.
+	const double quarter = 25.0 * buw::constantsd::pi();
+	for (double breakpoint : { 50.0, 100.0, 100.0 + quarter, 150.0, 200.0, 200.0 + quarter, 250.0 })
+	{
+		EXPECT_TRUE(std::any_of(stations.begin(), stations.end(), [&](const buw::Stationing s) { return std::abs(s - breakpoint) < 1e-9; })) << breakpoint;
+	}
+	for (size_t i = 0; i + 1 < stations.size(); i++)
+	{
+		EXPECT_LT(stations[i], stations[i + 1]);
+		EXPECT_LE(stations[i + 1] - stations[i], 20.0 + 1e-9);
+	}
+
+	// Between two vertices the horizontal position stays within the tolerance of the chord and the height within the one of the linear
+	// interpolation, beyond the vertical alignment the height falls back to its start.
+	const double verticalEnd = alignment->getVerticalAlignment()->getEndStation();
+	std::vector<buw::Vector3d> vertices(stations.size());
+	alignment->getPositions(stations.data(), static_cast<int>(stations.size()), vertices.data());
+	for (size_t i = 0; i + 1 < stations.size(); i++)
+	{
+		const buw::Vector2d start = vertices[i].head<2>();
+		const buw::Vector2d chord = vertices[i + 1].head<2>() - start;
+		for (int j = 1; j < 50; j++)
+		{
+			const double t = j / 50.0;
+			const buw::Vector3d p = alignment->getPosition(stations[i] + t * (stations[i + 1] - stations[i]));
+			const buw::Vector2d offset = p.head<2>() - start;
+			EXPECT_LE(std::abs(chord.x() * offset.y() - chord.y() * offset.x()) / chord.norm(), chordTolerance * (1.0 + 1e-6));
+			if (stations[i + 1] <= verticalEnd)
+				EXPECT_LE(std::abs(p.z() - (vertices[i].z() + t * (vertices[i + 1].z() - vertices[i].z()))), chordTolerance * (1.0 + 1e-6));
+		}
+	}
+
+	// At a centimeter far fewer vertices than sampling every meter, the lines over the first vertical line need none in between.
+	EXPECT_LT(alignment->getTessellation(0.01).size(), static_cast<size_t>(alignment->getLength() / 2.0));
+	const std::vector<buw::Stationing> unlimited = alignment->getTessellation(chordTolerance);
+	EXPECT_EQ(0, std::count_if(unlimited.begin(), unlimited.end(), [](const buw::Stationing s) { return s > 0.0 && s < 50.0; }));
+
+	// The results are cached per tolerance until an alignment changes, which drops all of them.
+	const std::vector<buw::Stationing> coarse = alignment->getTessellation(0.01);
+	EXPECT_EQ(stations, alignment->getTessellation(chordTolerance, 20.0));
+	EXPECT_EQ(unlimited, alignment->getTessellation(chordTolerance));
+	alignment->getHorizontalAlignment()->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(200, 200), buw::Vector2d(200, 300)));
+	const std::vector<buw::Stationing> extended = alignment->getTessellation(chordTolerance, 20.0);
+	EXPECT_EQ(alignment->getEndStation(), extended.back());
+	EXPECT_GT(extended.size(), stations.size());
+	EXPECT_EQ(alignment->getEndStation(), alignment->getTessellation(0.01).back());
+	EXPECT_GT(alignment->getTessellation(0.01).size(), coarse.size());
+}
+
+TEST(VerticalAlignment2D, StationLookupFindsElement)
+{
+	buw::VerticalAlignment2D va;
+	for (int i = 0; i < 50; i++)
+		va.addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(10.0 * i, i % 2), buw::Vector2d(10.0 * (i + 1), (i + 1) % 2)));
+
+	for (double s = -5.0; s < 510.0; s += 0.5)
+	{
+		const int expected = s >= 0.0 && s < 500.0 ? static_cast<int>(s / 10.0) : -1;
+		EXPECT_EQ(expected, va.getAlignmentElementIndexByStationing(s));
+		EXPECT_EQ(expected, va.getAlignmentElementIndexByStationing(s, 7));
+		EXPECT_EQ(expected < 0 ? nullptr : va.getAlignmentElementByIndex(expected), va.getAlignmentElementByStationing(s));
+	}
+
+	// Elements out of order are searched linearly, the first one containing the station is found.
+	buw::VerticalAlignment2D unordered;
+	unordered.addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(10.0, 0.0), buw::Vector2d(20.0, 0.0)));
+	unordered.addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(0.0, 0.0), buw::Vector2d(15.0, 0.0)));
+	EXPECT_EQ(1, unordered.getAlignmentElementIndexByStationing(5.0));
+	EXPECT_EQ(0, unordered.getAlignmentElementIndexByStationing(12.0, 1));
+	EXPECT_EQ(-1, unordered.getAlignmentElementIndexByStationing(20.0));
+}
@@ -0,0 +1,192 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment3DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Core/CatmullRomSpline.h"
+#include "OpenInfraPlatform/Infrastructure/Core/Polyline.h"
+
+#include <cmath>
+#include <vector>
+
+TEST(Polyline, ArcLengthFollowsUnevenSegments)
+{
+	// Segments of length 1, 10, 0 and 5.
+	buw::Polyline3d polyline;
+	polyline.AddPoint(buw::Vector3d(0, 0, 0));
+	polyline.AddPoints({ buw::Vector3d(1, 0, 0), buw::Vector3d(1, 10, 0), buw::Vector3d(1, 10, 0), buw::Vector3d(4, 14, 0) });
+	EXPECT_DOUBLE_EQ(16.0, polyline.Length());
+
+	EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(0.5) - buw::Vector3d(0.5, 0, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(6.0) - buw::Vector3d(1, 5, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(13.5) - buw::Vector3d(2.5, 12, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.TangentAtLength(6.0) - buw::Vector3d(0, 1, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.TangentAtLength(13.5) - buw::Vector3d(0.6, 0.8, 0)).norm(), 1e-12);
+
+	// Arc lengths out of range are clamped, the parameter of Interpolate is uniform over the points.
+	EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(-3.0) - buw::Vector3d(0, 0, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(20.0) - buw::Vector3d(4, 14, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.Interpolate(1.0) - buw::Vector3d(4, 14, 0)).norm(), 1e-12);
+	EXPECT_NEAR(0.0, (polyline.Interpolate(0.125) - buw::Vector3d(0.5, 0, 0)).norm(), 1e-12);
+
+	// Ascending and descending arc lengths give the same as single lookups.
+	std::vector<double> lengths;
+	for (double s = -1.0; s <= 17.0; s += 0.25)
+		lengths.push_back(s);
+	for (double s = 17.0; s >= -1.0; s -= 0.75)
+		lengths.push_back(s);
+	std::vector<buw::Vector3d> points(lengths.size()), tangents(lengths.size());
+	polyline.InterpolateAtLengths(lengths.data(), static_cast<int>(lengths.size()), points.data(), tangents.data());
+	for (size_t i = 0; i < lengths.size(); i++)
+	{
+		EXPECT_NEAR(0.0, (polyline.InterpolateAtLength(lengths[i]) - points[i]).norm(), 1e-12);
+		EXPECT_NEAR(0.0, (polyline.TangentAtLength(lengths[i]) - tangents[i]).norm(), 1e-12);
+		EXPECT_NEAR(1.0, tangents[i].norm(), 1e-12);
+	}
+}
+
+TEST(CatmullRomSpline3, ArcLengthParameterization)
+{
+	// Unevenly spaced points on a straight line, the spline stays on it, so the arc length is the x coordinate.
+	buw::CatmullRomSpline3d line;
+	line.AddSplinePoints({ buw::Vector3d(0, 0, 0), buw::Vector3d(1, 0, 0), buw::Vector3d(3, 0, 0), buw::Vector3d(4, 0, 0), buw::Vector3d(7, 0, 0), buw::Vector3d(8, 0, 0) });
+	EXPECT_NEAR(8.0, line.Length(), 1e-9);
+	for (double s = 0.0; s <= 8.0; s += 0.1)
+	{
+		EXPECT_NEAR(s, line.GetSplinePointAtLength(s).x(), 1e-9);
+		EXPECT_NEAR(1.0, line.GetSplineTangentAtLength(s).x(), 1e-12);
+	}
+
+	// Points added one by one along a helix, spaced unevenly.
+	buw::CatmullRomSpline3d spline;
+	for (int i = 0; i < 40; i++)
+	{
+		const double angle = 0.05 * i + 0.01 * (i % 3);
+		spline.AddSplinePoint(buw::Vector3d(100.0 * std::cos(angle), 100.0 * std::sin(angle), 0.5 * i));
+	}
+
+	// The length matches the sum of the chords of a dense sampling.
+	double chords = 0.0;
+	const int samples = 200000;
+	for (int i = 0; i < samples; i++)
+		chords += (spline.GetInterpolatedSplinePoint((i + 1.0) / samples) - spline.GetInterpolatedSplinePoint(static_cast<double>(i) / samples)).norm();
+	EXPECT_NEAR(chords, spline.Length(), 1e-6);
+
+	// A copy has the same table.
+	buw::CatmullRomSpline3d copy;
+	copy = spline;
+	EXPECT_EQ(spline.Length(), copy.Length());
+
+	std::vector<double> lengths;
+	for (double s = 0.0; s < spline.Length(); s += 0.5)
+		lengths.push_back(s);
+	std::vector<buw::Vector3d> points(lengths.size()), tangents(lengths.size());
+	copy.GetSplinePointsAtLengths(lengths.data(), static_cast<int>(lengths.size()), points.data(), tangents.data());
+
+	for (size_t i = 0; i < lengths.size(); i++)
+	{
+		// Consistent with the uniform parameter and the single lookups.
+		const double t = spline.GetParameterAtLength(lengths[i]);
+		EXPECT_NEAR(0.0, (spline.GetInterpolatedSplinePoint(t) - points[i]).norm(), 1e-9);
+		EXPECT_NEAR(0.0, (spline.GetSplinePointAtLength(lengths[i]) - points[i]).norm(), 1e-12);
+		EXPECT_NEAR(1.0, tangents[i].norm(), 1e-12);
+
+		// Equal steps of arc length, the chord of 0.5 is slightly shorter on the curve.
+		if (i > 0)
+		{
+			EXPECT_NEAR(0.5, (points[i] - points[i - 1]).norm(), 1e-4);
+			EXPECT_LT((points[i] - points[i - 1]).norm(), 0.5);
+		}
+	}
+}
+
+TEST(Alignment3DBased3D, ExtendsMatchDenseSampling)
+{
+	// A spline through a zigzag overshoots its points, the polyline does not.
+	const std::vector<buw::Vector3d> points = { buw::Vector3d(0, 0, 0), buw::Vector3d(10, 8, 1), buw::Vector3d(20, -3, 4), buw::Vector3d(24, 12, 2), buw::Vector3d(40, 0, -1) };
+	for (buw::Alignment3DBased3DType type : { buw::Alignment3DBased3DType::Polyline, buw::Alignment3DBased3DType::Spline })
+	{
+		buw::Alignment3DBased3D alignment(0.0, type);
+		buw::Vector3d minimum, maximum;
+		EXPECT_FALSE(alignment.getExtends(minimum, maximum));
+		for (const buw::Vector3d& p : points)
+			alignment.addPoint(p);
+		ASSERT_TRUE(alignment.getExtends(minimum, maximum));
+
+		const std::vector<double> stations = buw::createStations(alignment.getStartStation(), alignment.getEndStation(), 0.0005);
+		std::vector<buw::Vector3d> positions(stations.size());
+		alignment.getPositions(stations.data(), static_cast<int>(stations.size()), positions.data());
+		buw::Vector3d sampledMinimum = positions[0], sampledMaximum = positions[0];
+		for (const buw::Vector3d& p : positions)
+		{
+			sampledMinimum = buw::minimizedVector(sampledMinimum, p);
+			sampledMaximum = buw::maximizedVector(sampledMaximum, p);
+		}
+
+		// The samples miss the corners of the polyline by up to a step.
+		EXPECT_NEAR(0.0, (minimum - sampledMinimum).norm(), 1e-3);
+		EXPECT_NEAR(0.0, (maximum - sampledMaximum).norm(), 1e-3);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			EXPECT_LE(minimum[axis], sampledMinimum[axis] + 1e-9);
+			EXPECT_GE(maximum[axis], sampledMaximum[axis] - 1e-9);
+		}
+		if (type == buw::Alignment3DBased3DType::Spline)
+			EXPECT_GT(maximum.y(), 12.0);
+		else
+			EXPECT_DOUBLE_EQ(12.0, maximum.y());
+	}
+}
+
+TEST(Alignment3DBased3D, StationsAreMeasuredAlongTheCurve)
+{
+	for (buw::Alignment3DBased3DType type : { buw::Alignment3DBased3DType::Polyline, buw::Alignment3DBased3DType::Spline })
+	{
+		buw::Alignment3DBased3D alignment(100.0, type);
+		// Unevenly spaced points on a line starting at station 100.
+		for (double x : { 0.0, 2.0, 5.0, 6.0, 8.0 })
+			alignment.addPoint(buw::Vector3d(x, 0, 0));
+		EXPECT_NEAR(108.0, alignment.getEndStation(), 1e-9);
+
+		EXPECT_NEAR(0.0, (alignment.getPosition(100.0) - buw::Vector3d(0, 0, 0)).norm(), 1e-9);
+		EXPECT_NEAR(0.0, (alignment.getPosition(103.5) - buw::Vector3d(3.5, 0, 0)).norm(), 1e-9);
+		EXPECT_NEAR(0.0, (alignment.getPosition(108.0) - buw::Vector3d(8, 0, 0)).norm(), 1e-9);
+
+		const std::vector<double> stations = buw::createStations(95.0, 113.0, 0.3);
+		const int count = static_cast<int>(stations.size());
+		std::vector<buw::Vector3d> positions(count), tangents(count), normals(count);
+		alignment.getPositions(stations.data(), count, positions.data(), tangents.data(), normals.data(), 2);
+		for (int i = 0; i < count; i++)
+		{
+			EXPECT_NEAR(0.0, (alignment.getPosition(stations[i]) - positions[i]).norm(), 1e-12);
+			EXPECT_NEAR(0.0, (buw::Vector3d(1, 0, 0) - tangents[i]).norm(), 1e-9);
+			EXPECT_NEAR(0.0, (buw::Vector3d(0, 1, 0) - normals[i]).norm(), 1e-9);
+		}
+	}
+}
+
+TEST(Alignment3DBased3D, PolylineTessellationUsesItsPoints)
+{
+	// Segments of length 5, 0 and 2 starting at station 10.
+	buw::Alignment3DBased3D alignment(10.0, buw::Alignment3DBased3DType::Polyline);
+	for (const buw::Vector3d& p : { buw::Vector3d(0, 0, 0), buw::Vector3d(3, 4, 0), buw::Vector3d(3, 4, 0), buw::Vector3d(3, 4, 2) })
+		alignment.addPoint(p);
+
+	EXPECT_EQ(std::vector<buw::Stationing>({ 10.0, 15.0, 17.0 }), alignment.getTessellation(0.01));
+	EXPECT_EQ(std::vector<buw::Stationing>({ 10.0, 12.5, 15.0, 17.0 }), alignment.getTessellation(0.01, 3.0));
+}
@@ -0,0 +1,246 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment3DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/AlignmentModel.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/AlignmentSpatialIndex.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignment2D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DArc.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DClothoid.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DLine.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Line, entry clothoid, arc, exit clothoid and line, each element starting where the previous one ends.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> createAlignment(const buw::Vector2d& start, const double direction, const double startStation)
+	{
+		const double A = 150.0, length = 80.0, radius = A * A / length;
+		buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::make_shared<buw::HorizontalAlignment2D>(startStation);
+
+		const buw::Vector2d lineEnd = start + 100.0 * buw::Vector2d(std::cos(direction), std::sin(direction));
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(start, lineEnd));
+
+		auto entry = std::make_shared<buw::HorizontalAlignmentElement2DClothoid>(buw::clothoidDescription(lineEnd, direction, 0.0, true, A, true, length));
+		ha->addElement(entry);
+
+		const double arcStartDirection = entry->getEndDirection();
+		const buw::Vector2d arcStart = entry->getEndPosition();
+		const buw::Vector2d center = arcStart + radius * buw::Vector2d(-std::sin(arcStartDirection), std::cos(arcStartDirection));
+		const double sweep = 0.6;
+		const buw::Vector2d arcEnd = center + buw::createRotationMatrix(sweep) * (arcStart - center);
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DArc>(center, arcStart, arcEnd, false));
+
+		auto exit = std::make_shared<buw::HorizontalAlignmentElement2DClothoid>(buw::clothoidDescription(arcEnd, arcStartDirection + sweep, 1.0 / radius, true, A, false, length));
+		ha->addElement(exit);
+
+		const double endDirection = exit->getEndDirection();
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(exit->getEndPosition(), exit->getEndPosition() + 100.0 * buw::Vector2d(std::cos(endDirection), std::sin(endDirection))));
+
+		return std::make_shared<buw::Alignment2DBased3D>(ha);
+	}
+
+	// Closest point of the element among dense samples.
+	double sampleDistance(const buw::HorizontalAlignmentElement2D& element, const buw::Vector2d& point)
+	{
+		const int count = 20001;
+		double distance = std::numeric_limits<double>::max();
+		for (int i = 0; i < count; i++)
+			distance = std::min(distance, (element.getPosition(static_cast<double>(i) / (count - 1)) - point).norm());
+		return distance;
+	}
+
+	void expectClosestParameter(const buw::HorizontalAlignmentElement2D& element, std::mt19937& random)
+	{
+		buw::Vector2d minimum, maximum;
+		element.getExtends(minimum, maximum);
+		const buw::Vector2d margin(50.0, 50.0);
+		std::uniform_real_distribution<double> x(minimum.x() - margin.x(), maximum.x() + margin.x());
+		std::uniform_real_distribution<double> y(minimum.y() - margin.y(), maximum.y() + margin.y());
+
+		for (int i = 0; i < 40; i++)
+		{
+			const buw::Vector2d point(x(random), y(random));
+			const double lerpParameter = element.getClosestParameter(point);
+			EXPECT_GE(lerpParameter, 0.0);
+			EXPECT_LE(lerpParameter, 1.0);
+
+			// No sample is closer, the samples are at most a few centimeters apart.
+			const double distance = (element.getPosition(lerpParameter) - point).norm();
+			const double sampled = sampleDistance(element, point);
+			EXPECT_LE(distance, sampled + 1e-9);
+			EXPECT_NEAR(sampled, distance, 1e-3);
+		}
+	}
+}
+
+TEST(HorizontalAlignmentElement2D, ClosestParameterMatchesDenseSampling)
+{
+	std::mt19937 random(7);
+	expectClosestParameter(buw::HorizontalAlignmentElement2DLine(buw::Vector2d(10, 20), buw::Vector2d(130, -40)), random);
+
+	for (bool clockWise : { false, true })
+	{
+		const buw::Vector2d center(500, 300);
+		const buw::Vector2d start = center + buw::Vector2d(80, 0);
+		const buw::Vector2d end = center + 80.0 * buw::Vector2d(std::cos(4.0), clockWise ? -std::sin(4.0) : std::sin(4.0));
+		expectClosestParameter(buw::HorizontalAlignmentElement2DArc(center, start, end, clockWise), random);
+	}
+
+	// Short transitions and a spiral turning by 4.5 rad, whose distance has several local minima for points inside of it.
+	for (double length : { 60.0, 450.0 })
+	{
+		for (bool counterClockwise : { true, false })
+		{
+			expectClosestParameter(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 0.0, counterClockwise, 150.0, true, length)), random);
+			expectClosestParameter(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, length / (150.0 * 150.0), counterClockwise, 150.0, false, length)), random);
+		}
+	}
+
+	// Spanning L = 0, where the curvature changes its sign and the derivative of Newton's method is not positive for some points.
+	for (bool counterClockwise : { true, false })
+	{
+		expectClosestParameter(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 62.0, -59.1, 14.8, counterClockwise)), random);
+		expectClosestParameter(buw::HorizontalAlignmentElement2DClothoid(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 62.0, 14.8, -59.1, counterClockwise)), random);
+	}
+
+	// Its start and a point 24 meters further are almost equally far from this point, the closest sample is the start.
+	const buw::HorizontalAlignmentElement2DClothoid spanning(buw::clothoidDescription(buw::Vector2d(0, 0), 0.7, 62.0, -59.1, 14.8, false));
+	const buw::Vector2d point(-58.424, 66.168186);
+	EXPECT_LE((spanning.getPosition(spanning.getClosestParameter(point)) - point).norm(), sampleDistance(spanning, point) + 1e-9);
+	EXPECT_NEAR(0.32, spanning.getClosestParameter(point), 0.01);
+}
+
+TEST(AlignmentSpatialIndex, ProjectionFindsStationAndOffset)
+{
+	std::vector<buw::ReferenceCounted<buw::IAlignment3D>> alignments;
+	alignments.push_back(std::make_shared<buw::Alignment3DBased3D>(0.0));
+	alignments.push_back(createAlignment(buw::Vector2d(1000, 2000), 0.3, 500.0));
+	buw::AlignmentSpatialIndex index(alignments);
+	EXPECT_EQ(5, index.getElementCount());
+
+	// Points along the normals of the alignment are projected back onto their station, offsets are positive to the left.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = std::static_pointer_cast<buw::Alignment2DBased3D>(alignments[1]);
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = alignment->getHorizontalAlignment();
+	for (double station = 500.0; station <= alignment->getEndStation(); station += 3.7)
+	{
+		for (double offset : { -12.0, 0.0, 4.5 })
+		{
+			const buw::Vector2d point = ha->getPosition(station) + offset * ha->getNormal(station);
+			const buw::AlignmentProjection projection = index.project(point);
+			EXPECT_EQ(1, projection.alignment);
+			EXPECT_LE(std::abs(ha->getAlignmentElementIndexByStationing(station) - projection.element), 1);
+			EXPECT_NEAR(station, projection.station, 1e-6);
+			EXPECT_NEAR(offset, projection.offset, 1e-6);
+			EXPECT_NEAR(std::abs(offset), projection.distance, 1e-6);
+			EXPECT_NEAR(0.0, (ha->getPosition(station) - projection.position).norm(), 1e-6);
+		}
+	}
+
+	// Beyond the start the closest point is the start of the alignment.
+	const buw::AlignmentProjection before = index.project(buw::Vector2d(990, 1990));
+	EXPECT_DOUBLE_EQ(500.0, before.station);
+	EXPECT_NEAR(std::sqrt(200.0), before.distance, 1e-9);
+
+	// Nothing within the maximum distance.
+	const buw::AlignmentProjection far = index.project(buw::Vector2d(0, 0), 100.0);
+	EXPECT_EQ(-1, far.alignment);
+
+	buw::AlignmentSpatialIndex empty(std::vector<buw::ReferenceCounted<buw::IAlignment3D>>{});
+	EXPECT_EQ(-1, empty.project(buw::Vector2d(0, 0)).alignment);
+}
+
+TEST(AlignmentSpatialIndex, MatchesBruteForceOverManyAlignments)
+{
+	// A few hundred alignments give an R-tree with three levels.
+	std::mt19937 random(11);
+	std::uniform_real_distribution<double> coordinate(0.0, 20000.0);
+	std::uniform_real_distribution<double> direction(-3.1, 3.1);
+	std::vector<buw::ReferenceCounted<buw::IAlignment3D>> alignments;
+	for (int i = 0; i < 300; i++)
+		alignments.push_back(createAlignment(buw::Vector2d(coordinate(random), coordinate(random)), direction(random), 0.0));
+	buw::AlignmentSpatialIndex index(alignments);
+	ASSERT_EQ(1500, index.getElementCount());
+
+	const int count = 3000;
+	std::vector<buw::Vector2d> points(count);
+	for (int i = 0; i < count; i++)
+		points[i] = buw::Vector2d(coordinate(random), coordinate(random));
+
+	std::vector<buw::AlignmentProjection> projections(count);
+	index.project(points.data(), count, projections.data(), std::numeric_limits<double>::max(), 4);
+
+	for (int i = 0; i < count; i++)
+	{
+		// The projection onto each element of each alignment.
+		double best = std::numeric_limits<double>::max();
+		for (const auto& a : alignments)
+		{
+			buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::static_pointer_cast<buw::Alignment2DBased3D>(a)->getHorizontalAlignment();
+			for (int e = 0; e < ha->getAlignmentElementCount(); e++)
+			{
+				buw::ReferenceCounted<buw::HorizontalAlignmentElement2D> element = ha->getAlignmentElementByIndex(e);
+				best = std::min(best, (element->getPosition(element->getClosestParameter(points[i])) - points[i]).norm());
+			}
+		}
+
+		EXPECT_DOUBLE_EQ(best, projections[i].distance);
+
+		const buw::AlignmentProjection single = index.project(points[i]);
+		EXPECT_EQ(single.alignment, projections[i].alignment);
+		EXPECT_EQ(single.station, projections[i].station);
+
+		// Only alignments within the maximum distance are found.
+		const buw::AlignmentProjection limited = index.project(points[i], 0.5 * best);
+		EXPECT_EQ(-1, limited.alignment);
+	}
+}
+
+TEST(AlignmentSpatialIndex, ModelRebuildsTheIndexWhenAlignmentsChange)
+{
+	buw::AlignmentModel model;
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment(buw::Vector2d(0, 0), 0.0, 0.0);
+	model.addAlignment(alignment);
+	buw::ReferenceCounted<buw::AlignmentSpatialIndex> index = model.getSpatialIndex();
+	EXPECT_EQ(5, index->getElementCount());
+	EXPECT_EQ(index, model.getSpatialIndex());
+
+	// Copies share the index until either of them changes.
+	buw::AlignmentModel copy(model);
+	EXPECT_EQ(index, copy.getSpatialIndex());
+
+	// An element appended to the horizontal alignment of the model is found without invalidating anything.
+	buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = alignment->getHorizontalAlignment();
+	const buw::Vector2d end = ha->getPosition(ha->getEndStation());
+	ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(end, end + buw::Vector2d(0, 100)));
+	buw::ReferenceCounted<buw::AlignmentSpatialIndex> extended = model.getSpatialIndex();
+	EXPECT_NE(index, extended);
+	EXPECT_EQ(6, extended->getElementCount());
+	EXPECT_NEAR(ha->getEndStation() - 50.0, extended->project(end + buw::Vector2d(0, 50)).station, 1e-6);
+
+	// So are added and deleted alignments.
+	model.addAlignment(createAlignment(buw::Vector2d(5000, 0), 0.0, 0.0));
+	EXPECT_EQ(11, model.getSpatialIndex()->getElementCount());
+	model.deleteAlignment(alignment);
+	EXPECT_EQ(5, model.getSpatialIndex()->getElementCount());
+}
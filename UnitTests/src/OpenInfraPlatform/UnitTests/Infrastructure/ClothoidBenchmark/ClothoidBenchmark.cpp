@@ -0,0 +1,225 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "buw.OIPInfrastructure.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	// Parameters of the runs, all of them can be set on the command line.
+	struct BenchmarkDescription {
+		std::vector<double> ratios = { 0.25, 0.5, 1.0, 1.5, 2.0, 3.0 };
+		double clothoidConstant = 250.0;
+		int samples = 1000000;
+		int referenceIntervals = 200000;
+		std::string output = "ClothoidBenchmark.json";
+	};
+
+	struct AccuracyResult {
+		double ratio;
+		double seriesError;
+		double fresnelError;
+	};
+
+	struct OperationResult {
+		std::string name;
+		double seconds;
+		double samplesPerSecond;
+	};
+
+	// The five term series which was used by HorizontalAlignmentElement2DClothoid before the Fresnel integrals, kept as baseline.
+	double computeSeriesX(const double L, const double A) {
+		double x = L;
+		for(int i = 1; i < 6; i++) {
+			const double sign = i % 2 == 0 ? 1 : -1;
+			const double factor = buw::factorial(2 * i) * std::pow(2.0, 2 * i) * (5 + (i - 1) * 4);
+			x += sign * std::pow(L, 5 + (i - 1) * 4) / (factor * std::pow(A, i * 4));
+		}
+		return x;
+	}
+
+	double computeSeriesY(const double L, const double A) {
+		double y = 0;
+		for(int i = 0; i < 5; i++) {
+			const double sign = i % 2 == 0 ? 1 : -1;
+			const double factor = buw::factorial(2 * i + 1) * std::pow(2.0, i * 2) * 2 * (2 + i * 4 + 1);
+			y += sign * std::pow(L, 3 + i * 4) / (factor * std::pow(A, 2 + i * 4));
+		}
+		return y;
+	}
+
+	// The former getPosition, which evaluated the series at the start of the element and the start direction again for every sample.
+	buw::Vector2d computeSeriesPosition(const buw::clothoidDescription& desc, const double startL, const double endL, const double lerp) {
+		const double A = desc.clothoidConstant;
+		const double L = startL + (endL - startL) * lerp;
+		buw::Vector2d localOffset = buw::Vector2d(computeSeriesX(L, A), computeSeriesY(L, A)) - buw::Vector2d(computeSeriesX(startL, A), computeSeriesY(startL, A));
+		double angle = buw::HorizontalAlignmentElement2DClothoid::computeT(startL, A);
+		if(startL > endL) {
+			angle *= -1;
+			localOffset.x() *= -1;
+		}
+		if(!desc.counterClockwise) {
+			angle *= -1;
+			localOffset.y() *= -1;
+		}
+		return desc.startPosition + buw::createRotationMatrix(desc.startDirection - angle) * localOffset;
+	}
+
+	// Position at arc length L of the clothoid starting at the origin integrated with the composite Simpson rule over the direction L^2 / (2 A^2).
+	buw::Vector2d integratePosition(const double L, const double A, const int intervals) {
+		const double h = L / intervals;
+		buw::Vector2d sum = buw::Vector2d(0.0, 0.0);
+		for(int i = 0; i <= intervals; i++) {
+			const double weight = (i == 0 || i == intervals) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+			const double direction = buw::HorizontalAlignmentElement2DClothoid::computeT(i * h, A);
+			sum += weight * buw::Vector2d(std::cos(direction), std::sin(direction));
+		}
+		return sum * (h / 3.0);
+	}
+
+	// Largest distance of both evaluations to the reference along a clothoid of length ratio * A.
+	AccuracyResult measureAccuracy(const double ratio, const BenchmarkDescription &desc) {
+		const double A = desc.clothoidConstant;
+		AccuracyResult result = { ratio, 0.0, 0.0 };
+		for(int i = 1; i <= 20; i++) {
+			const double L = ratio * A * i / 20.0;
+			const buw::Vector2d reference = integratePosition(L, A, desc.referenceIntervals);
+			const buw::Vector2d series = buw::Vector2d(computeSeriesX(L, A), computeSeriesY(L, A));
+			const buw::Vector2d fresnel = buw::Vector2d(buw::HorizontalAlignmentElement2DClothoid::computeX(L, A), buw::HorizontalAlignmentElement2DClothoid::computeY(L, A));
+			result.seriesError = std::max(result.seriesError, (series - reference).norm());
+			result.fresnelError = std::max(result.fresnelError, (fresnel - reference).norm());
+		}
+		std::cout << "L / A = " << ratio << ": series error " << result.seriesError << "m, Fresnel error " << result.fresnelError << "m." << std::endl;
+		return result;
+	}
+
+	std::vector<std::string> split(const std::string &value) {
+		std::vector<std::string> parts = std::vector<std::string>();
+		std::stringstream stream = std::stringstream(value);
+		std::string part;
+		while(std::getline(stream, part, ','))
+			parts.push_back(part);
+		return parts;
+	}
+
+	// Evaluates the samples of an entry from a radius of 1000 m over a length of 1.5 A with the former and the current implementation.
+	std::vector<OperationResult> measureThroughput(const BenchmarkDescription &desc) {
+		const double A = desc.clothoidConstant;
+		const buw::clothoidDescription clothoid = buw::clothoidDescription(buw::Vector2d(4467579.35, 5333698.67), 4.3, 1.0 / 1000.0, false, A, true, 1.5 * A);
+		const buw::HorizontalAlignmentElement2DClothoid element = buw::HorizontalAlignmentElement2DClothoid(clothoid);
+
+		std::vector<double> lerps = std::vector<double>(desc.samples);
+		for(int i = 0; i < desc.samples; i++)
+			lerps[i] = desc.samples > 1 ? i / (desc.samples - 1.0) : 0.0;
+		std::vector<buw::Vector2d> positions = std::vector<buw::Vector2d>(desc.samples), tangents = std::vector<buw::Vector2d>(desc.samples);
+
+		std::vector<OperationResult> operations = std::vector<OperationResult>();
+		double checksum = 0.0;
+		auto time = [&](const std::string &name, const std::function<void()> &operation) {
+			auto start = std::chrono::steady_clock::now();
+			operation();
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			checksum += positions.back().x();
+			operations.push_back({ name, seconds, desc.samples / seconds });
+			std::cout << desc.samples << " samples: " << name << " took " << seconds << "s." << std::endl;
+		};
+
+		time("seriesGetPosition", [&]() {
+			for(int i = 0; i < desc.samples; i++)
+				positions[i] = computeSeriesPosition(clothoid, element.getStartParameter(), element.getEndParameter(), lerps[i]);
+		});
+		time("getPosition", [&]() {
+			for(int i = 0; i < desc.samples; i++)
+				positions[i] = element.getPosition(lerps[i]);
+		});
+		time("getPositions", [&]() { element.getPositions(lerps.data(), desc.samples, positions.data()); });
+		time("getPositionsWithTangents", [&]() { element.getPositions(lerps.data(), desc.samples, positions.data(), tangents.data()); });
+
+		std::cout << "Checksum " << checksum << "." << std::endl;
+		return operations;
+	}
+
+	void writeJson(const std::vector<AccuracyResult> &accuracy, const std::vector<OperationResult> &operations, const BenchmarkDescription &desc) {
+		std::ofstream file = std::ofstream(desc.output);
+		file << "{" << std::endl;
+		file << "\t\"benchmark\": \"Clothoid\"," << std::endl;
+		file << "\t\"timestamp\": " << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() << "," << std::endl;
+		file << "\t\"clothoidConstant\": " << desc.clothoidConstant << "," << std::endl;
+		file << "\t\"samples\": " << desc.samples << "," << std::endl;
+		file << "\t\"accuracy\": [" << std::endl;
+		for(size_t i = 0; i < accuracy.size(); i++) {
+			file << "\t\t{ \"lengthRatio\": " << accuracy[i].ratio << ", \"seriesError\": " << accuracy[i].seriesError << ", \"fresnelError\": " << accuracy[i].fresnelError << " }"
+				<< (i + 1 < accuracy.size() ? "," : "") << std::endl;
+		}
+		file << "\t]," << std::endl;
+		file << "\t\"operations\": [" << std::endl;
+		for(size_t o = 0; o < operations.size(); o++) {
+			file << "\t\t{ \"name\": \"" << operations[o].name << "\", \"seconds\": " << operations[o].seconds << ", \"samplesPerSecond\": " << operations[o].samplesPerSecond << " }"
+				<< (o + 1 < operations.size() ? "," : "") << std::endl;
+		}
+		file << "\t]" << std::endl;
+		file << "}" << std::endl;
+	}
+}
+
+// Usage: ClothoidBenchmark [--ratios 0.5,1,3] [--constant 250] [--samples 1000000] [--intervals 200000] [--output result.json]
+int main(int argc, char** argv) {
+	BenchmarkDescription desc;
+	for(int i = 1; i + 1 < argc; i += 2) {
+		const std::string option = argv[i], value = argv[i + 1];
+		if(option == "--ratios") {
+			desc.ratios.clear();
+			for(const auto &part : split(value))
+				desc.ratios.push_back(std::stod(part));
+		}
+		else if(option == "--constant")
+			desc.clothoidConstant = std::stod(value);
+		else if(option == "--samples")
+			desc.samples = std::stoi(value);
+		else if(option == "--intervals")
+			desc.referenceIntervals = std::stoi(value);
+		else if(option == "--output")
+			desc.output = value;
+		else {
+			std::cerr << "Unknown option " << option << "." << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<AccuracyResult> accuracy = std::vector<AccuracyResult>();
+	for(double ratio : desc.ratios)
+		accuracy.push_back(measureAccuracy(ratio, desc));
+
+	std::vector<OperationResult> operations = measureThroughput(desc);
+
+	writeJson(accuracy, operations, desc);
+
+	// Fail if the Fresnel integrals deviate from the reference so that the smoke test catches it.
+	for(const auto &result : accuracy) {
+		if(!(result.fresnelError < 1e-6))
+			return 1;
+	}
+
+	return 0;
+}
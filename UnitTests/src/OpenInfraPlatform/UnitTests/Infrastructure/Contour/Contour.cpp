@@ -0,0 +1,187 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Contour.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	// Grid terrain of size x size points with unit spacing.
+	buw::Surface createTerrain(const int size, const std::function<double(double, double)>& height)
+	{
+		std::vector<buw::Vector3d> points;
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+				points.push_back(buw::Vector3d(x, y, height(x, y)));
+		}
+
+		std::vector<buw::Vector3i> triangles;
+		for (int y = 0; y < size - 1; y++)
+		{
+			for (int x = 0; x < size - 1; x++)
+			{
+				triangles.push_back(buw::Vector3i(y * size + x, y * size + x + 1, (y + 1) * size + x));
+				triangles.push_back(buw::Vector3i(y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x));
+			}
+		}
+
+		buw::Surface surface;
+		surface.setPoints(points);
+		surface.setTriangles(triangles);
+		return surface;
+	}
+
+	double signedArea(const buw::ContourLine& contour)
+	{
+		double area = 0.0;
+		for (size_t i = 0; i < contour.points.size(); i++)
+		{
+			const buw::Vector2d& a = contour.points[i];
+			const buw::Vector2d& b = contour.points[(i + 1) % contour.points.size()];
+			area += a.x() * b.y() - b.x() * a.y();
+		}
+		return 0.5 * area;
+	}
+
+	double length(const std::vector<buw::ContourLine>& contours)
+	{
+		double sum = 0.0;
+		for (const auto& contour : contours)
+		{
+			for (size_t i = 0; i + 1 < contour.points.size(); i++)
+				sum += (contour.points[i + 1] - contour.points[i]).norm();
+			if (contour.closed)
+				sum += (contour.points.front() - contour.points.back()).norm();
+		}
+		return sum;
+	}
+}
+
+TEST(Contour, HillGivesClosedCounterclockwiseContours)
+{
+	// Cone with its peak between the grid points on a plain, so no point lies on a level.
+	buw::Surface surface = createTerrain(101, [](double x, double y) { return std::max(1.0, 55.3 - std::sqrt((x - 50.5) * (x - 50.5) + (y - 50.5) * (y - 50.5))); });
+
+	buw::ContourDescription desc;
+	desc.interval = 10.0;
+	std::vector<buw::ContourLine> contours = buw::createContours(surface, desc);
+
+	// Levels 10 to 50, all inside of the grid.
+	ASSERT_EQ(5, contours.size());
+	for (size_t i = 0; i < contours.size(); i++)
+	{
+		const buw::ContourLine& contour = contours[i];
+		EXPECT_DOUBLE_EQ(10.0 * (i + 1), contour.height);
+		EXPECT_TRUE(contour.closed);
+		EXPECT_EQ(i == 4, contour.major);
+
+		// The higher terrain is inside, on the left side.
+		const double radius = 55.3 - contour.height;
+		EXPECT_GT(signedArea(contour), 0.0);
+		EXPECT_NEAR(3.14159265 * radius * radius, signedArea(contour), 0.02 * radius * radius);
+
+		for (const auto& p : contour.points)
+			EXPECT_NEAR(radius, (p - buw::Vector2d(50.5, 50.5)).norm(), 0.05 * radius + 0.05);
+	}
+}
+
+TEST(Contour, SlopeGivesOpenContoursAcrossTheSurface)
+{
+	buw::Surface surface = createTerrain(21, [](double x, double y) { return 0.5 * x + 0.1; });
+
+	buw::ContourDescription desc;
+	desc.interval = 1.0;
+	std::vector<buw::ContourLine> contours = buw::createContours(surface, desc);
+
+	ASSERT_EQ(10, contours.size());
+	for (const auto& contour : contours)
+	{
+		EXPECT_FALSE(contour.closed);
+		EXPECT_DOUBLE_EQ(contour.points.front().y(), 20.0);
+		EXPECT_DOUBLE_EQ(contour.points.back().y(), 0.0);
+		for (const auto& p : contour.points)
+			EXPECT_NEAR(2.0 * (contour.height - 0.1), p.x(), 1e-9);
+	}
+}
+
+TEST(Contour, PointsOnLevelsGiveNoDegenerateContours)
+{
+	// Integer heights on a pyramid, the peak lies exactly on the highest level.
+	buw::Surface surface = createTerrain(21, [](double x, double y) { return 10.0 - std::max(std::abs(x - 10.0), std::abs(y - 10.0)); });
+
+	buw::ContourDescription desc;
+	desc.interval = 1.0;
+	std::vector<buw::ContourLine> contours = buw::createContours(surface, desc);
+
+	// Levels 1 to 9 are closed squares, level 10 is the peak only and level 0 the border.
+	ASSERT_EQ(9, contours.size());
+	for (const auto& contour : contours)
+	{
+		EXPECT_TRUE(contour.closed);
+		EXPECT_NEAR(4.0 * (10.0 - contour.height) * (10.0 - contour.height), signedArea(contour), 1e-9);
+	}
+}
+
+TEST(Contour, RasterAndThreadsGiveSameContours)
+{
+	auto height = [](double x, double y) { return 10.0 * std::sin(x * 0.05) * std::cos(y * 0.07) + 0.3 * std::sin(x * 0.9 + y * 1.3); };
+	buw::Surface surface = createTerrain(200, height);
+
+	buw::RasterSurface raster(200, 200, buw::Vector2d(0.0, 0.0), 1.0);
+	for (int y = 0; y < 200; y++)
+	{
+		for (int x = 0; x < 200; x++)
+			raster.setHeight(x, y, static_cast<float>(height(x, y)));
+	}
+
+	buw::ContourDescription desc;
+	desc.interval = 0.5;
+	desc.baseHeight = 0.25;
+	desc.threadCount = 1;
+	std::vector<buw::ContourLine> single = buw::createContours(surface, desc);
+	desc.threadCount = 4;
+	std::vector<buw::ContourLine> parallel = buw::createContours(surface, desc);
+
+	ASSERT_EQ(single.size(), parallel.size());
+	EXPECT_NEAR(length(single), length(parallel), 1e-6);
+
+	// The raster uses the other diagonal and float heights.
+	std::vector<buw::ContourLine> fromRaster = buw::createContours(raster, desc);
+	EXPECT_NEAR(length(single), length(fromRaster), 0.02 * length(single));
+
+	// Corner cutting keeps the ends of open contours and doubles the segments.
+	desc.smoothingIterations = 2;
+	std::vector<buw::ContourLine> smoothed = buw::createContours(surface, desc);
+	ASSERT_EQ(parallel.size(), smoothed.size());
+	for (size_t i = 0; i < smoothed.size(); i++)
+	{
+		if (parallel[i].closed)
+			continue;
+		EXPECT_EQ(parallel[i].points.front(), smoothed[i].points.front());
+		EXPECT_EQ(parallel[i].points.back(), smoothed[i].points.back());
+		EXPECT_EQ(4 * parallel[i].points.size(), smoothed[i].points.size());
+	}
+}
@@ -0,0 +1,280 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CorridorMeshBuilder.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DArc.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DLine.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignmentElement2DLine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Line along the x-axis followed by a quarter circle to the left, rising by 1 %.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> createAlignment()
+	{
+		buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::make_shared<buw::HorizontalAlignment2D>(0.0);
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(0, 0), buw::Vector2d(100, 0)));
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DArc>(buw::Vector2d(100, 50), buw::Vector2d(100, 0), buw::Vector2d(150, 50), false));
+
+		buw::ReferenceCounted<buw::VerticalAlignment2D> va = std::make_shared<buw::VerticalAlignment2D>();
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(0, 10), buw::Vector2d(200, 12)));
+
+		return std::make_shared<buw::Alignment2DBased3D>(ha, va);
+	}
+
+	buw::ReferenceCounted<buw::DesignCrossSectionProfile> createProfile(const bool bClosed, const std::vector<buw::Vector2d>& points)
+	{
+		buw::ReferenceCounted<buw::DesignCrossSectionProfile> profile = std::make_shared<buw::DesignCrossSectionProfile>();
+		profile->closedArea = bClosed;
+		for (const buw::Vector2d& p : points)
+		{
+			profile->crossSectionsPoints.push_back(std::make_shared<buw::CrossSectionPoint>());
+			profile->crossSectionsPoints.back()->position = p;
+		}
+		return profile;
+	}
+
+	// A lane from the left to the right, a slope on the left and the ground.
+	buw::ReferenceCounted<buw::CrossSectionStatic> createCrossSection(const double station)
+	{
+		buw::ReferenceCounted<buw::CrossSectionStatic> crossSection = std::make_shared<buw::CrossSectionStatic>();
+		crossSection->stationing = station;
+		crossSection->addDesignCrossSectionProfile(createProfile(true, { buw::Vector2d(3.5, -0.07), buw::Vector2d(0, 0), buw::Vector2d(-3.5, -0.07) }));
+		crossSection->addDesignCrossSectionProfile(createProfile(false, { buw::Vector2d(3.5, -0.07), buw::Vector2d(6, -1) }));
+
+		buw::ReferenceCounted<buw::CrossSectionProfile> ground = std::make_shared<buw::CrossSectionProfile>();
+		ground->pntList2D = { buw::Vector2d(-10, 9), buw::Vector2d(10, 11) };
+		crossSection->addCrossSectionProfile(ground);
+		return crossSection;
+	}
+
+	buw::Vector3d getTriangleNormal(const buw::CorridorMesh& mesh, const buw::Vector3i& triangle)
+	{
+		return (mesh.points[triangle.y()] - mesh.points[triangle.x()]).cross(mesh.points[triangle.z()] - mesh.points[triangle.x()]);
+	}
+}
+
+TEST(CorridorMeshBuilder, SweepsProfilesAlongTheAlignment)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	const std::vector<double> stations = { 0.0, 40.0, 110.0, 150.0 };
+	for (double station : stations)
+		alignment->addCrossSection(createCrossSection(station));
+
+	buw::CorridorMeshBuilder builder(alignment);
+	ASSERT_EQ(3, builder.getMeshCount());
+
+	for (int i = 0; i < builder.getMeshCount(); i++)
+	{
+		const buw::CorridorMesh& mesh = builder.getMesh(i);
+		EXPECT_EQ(stations[i], mesh.startStation);
+		EXPECT_EQ(stations[i + 1], mesh.endStation);
+		ASSERT_EQ(mesh.points.size(), mesh.textureCoordinates.size());
+		ASSERT_EQ(mesh.triangles.size(), mesh.surfaces.size());
+
+		// Two triangles per segment of the lane and the slope below the alignment, the slope running to the left is turned to face up as well.
+		ASSERT_EQ(6u, mesh.triangles.size());
+		for (size_t t = 0; t < mesh.triangles.size(); t++)
+		{
+			EXPECT_GT(getTriangleNormal(mesh, mesh.triangles[t]).z(), 0.0);
+			if (mesh.surfaces[t] != buw::eCorridorSurface::Body)
+				EXPECT_EQ(buw::eCorridorSurface::OpenBelow, mesh.surfaces[t]);
+		}
+		EXPECT_EQ(4, std::count(mesh.surfaces.begin(), mesh.surfaces.end(), buw::eCorridorSurface::Body));
+		EXPECT_EQ(5u, mesh.longitudinalEdges.size());
+
+		// Profiles at the end station only in the last mesh.
+		const bool bLast = i + 1 == builder.getMeshCount();
+		EXPECT_EQ(bLast ? 6u : 3u, mesh.profileEdges.size());
+		EXPECT_EQ(bLast ? 2u : 1u, mesh.groundEdges.size());
+
+		// The points are offset along the normal of the alignment, design heights are relative to it, ground heights are absolute.
+		for (const buw::Vector2i& edge : mesh.longitudinalEdges)
+		{
+			for (int end = 0; end < 2; end++)
+			{
+				const buw::Vector2d coordinates = mesh.textureCoordinates[edge[end]];
+				const double station = mesh.startStation + coordinates.y();
+				EXPECT_DOUBLE_EQ(end == 0 ? mesh.startStation : mesh.endStation, station);
+
+				buw::Vector3d position, normal;
+				alignment->getPositions(&station, 1, &position, nullptr, &normal);
+				const buw::Vector3d point = mesh.points[edge[end]];
+				EXPECT_NEAR(coordinates.x(), (point - position).head<2>().dot(normal.head<2>()), 1e-9);
+				EXPECT_NEAR(0.0, (point - position).head<2>().dot(buw::Vector2d(-normal.y(), normal.x())), 1e-9);
+				EXPECT_GE(point.z() - position.z(), -1.0 - 1e-9);
+				EXPECT_LE(point.z() - position.z(), 1e-9);
+			}
+		}
+		for (const buw::Vector2i& edge : mesh.groundEdges)
+		{
+			EXPECT_DOUBLE_EQ(9.0, mesh.points[edge.x()].z());
+			EXPECT_DOUBLE_EQ(11.0, mesh.points[edge.y()].z());
+		}
+	}
+
+	// On the arc the lane is turned towards its center at (100, 50).
+	const buw::CorridorMesh& arc = builder.getMesh(2);
+	for (size_t p = 0; p < arc.points.size(); p++)
+	{
+		if (arc.textureCoordinates[p].x() == 0.0)
+			EXPECT_NEAR(50.0, (arc.points[p].head<2>() - buw::Vector2d(100, 50)).norm(), 1e-9);
+		else if (arc.textureCoordinates[p].x() == 3.5)
+			EXPECT_NEAR(46.5, (arc.points[p].head<2>() - buw::Vector2d(100, 50)).norm(), 1e-9);
+	}
+
+	// The merged mesh has all points and triangles.
+	const buw::CorridorMesh merged = builder.getMergedMesh();
+	EXPECT_EQ(0.0, merged.startStation);
+	EXPECT_EQ(150.0, merged.endStation);
+	EXPECT_EQ(builder.getMesh(0).points.size() + builder.getMesh(1).points.size() + builder.getMesh(2).points.size(), merged.points.size());
+	EXPECT_EQ(18u, merged.triangles.size());
+	EXPECT_EQ(builder.getMesh(2).points[builder.getMesh(2).triangles[0].x()], merged.points[merged.triangles[12].x()]);
+}
+
+TEST(CorridorMeshBuilder, OnlyMatchingProfilesAreJoined)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	alignment->addCrossSection(createCrossSection(0.0));
+	buw::ReferenceCounted<buw::CrossSectionStatic> widened = createCrossSection(30.0);
+	widened->getClosedDesignCrossSectionProfile(0)->crossSectionsPoints.push_back(std::make_shared<buw::CrossSectionPoint>());
+	alignment->addCrossSection(widened);
+
+	buw::CorridorMeshBuilder builder(alignment);
+	ASSERT_EQ(1, builder.getMeshCount());
+	const buw::CorridorMesh& mesh = builder.getMesh(0);
+	EXPECT_EQ(2u, mesh.triangles.size());
+	EXPECT_EQ(2u, mesh.longitudinalEdges.size());
+	EXPECT_EQ(2 + 1 + 3 + 1, static_cast<int>(mesh.profileEdges.size()));
+}
+
+TEST(CorridorMeshBuilder, ClosedProfilesOnlyShowTheirTopFace)
+{
+	// The lane closed by a bottom, starting at the left bottom corner, so its top face starts at the second segment.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	for (double station : { 0.0, 20.0 })
+	{
+		buw::ReferenceCounted<buw::CrossSectionStatic> crossSection = std::make_shared<buw::CrossSectionStatic>();
+		crossSection->stationing = station;
+		crossSection->addDesignCrossSectionProfile(createProfile(true, { buw::Vector2d(3.5, -0.5), buw::Vector2d(3.5, -0.07), buw::Vector2d(0, 0), buw::Vector2d(-3.5, -0.07), buw::Vector2d(-3.5, -0.5) }));
+		alignment->addCrossSection(crossSection);
+	}
+
+	buw::CorridorMeshBuilder builder(alignment);
+	ASSERT_EQ(1, builder.getMeshCount());
+	const buw::CorridorMesh& mesh = builder.getMesh(0);
+	ASSERT_EQ(6u, mesh.triangles.size());
+	EXPECT_EQ(5u, mesh.longitudinalEdges.size());
+
+	// The lane and the right side, facing out of the profile.
+	for (size_t t = 0; t < mesh.triangles.size(); t++)
+	{
+		EXPECT_EQ(buw::eCorridorSurface::Body, mesh.surfaces[t]);
+		const buw::Vector3d normal = getTriangleNormal(mesh, mesh.triangles[t]);
+		if (t < 4)
+			EXPECT_GT(normal.z(), 0.0);
+		else
+			EXPECT_LT(normal.y(), 0.0);
+	}
+}
+
+TEST(CorridorMeshBuilder, OpenFacesAreSplitWhereTheyCrossTheAlignment)
+{
+	// A slope on the right, running to the right, whose outer point rises from 1 below to 3 above the alignment.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	for (double station : { 0.0, 20.0 })
+	{
+		buw::ReferenceCounted<buw::CrossSectionStatic> crossSection = std::make_shared<buw::CrossSectionStatic>();
+		crossSection->stationing = station;
+		crossSection->addDesignCrossSectionProfile(createProfile(false, { buw::Vector2d(-3.5, 0), buw::Vector2d(-6, station == 0.0 ? -1.0 : 3.0) }));
+		alignment->addCrossSection(crossSection);
+	}
+
+	buw::CorridorMeshBuilder builder(alignment);
+	ASSERT_EQ(1, builder.getMeshCount());
+	const buw::CorridorMesh& mesh = builder.getMesh(0);
+	ASSERT_EQ(3u, mesh.triangles.size());
+	ASSERT_EQ(5u, mesh.points.size());
+	EXPECT_EQ(buw::eCorridorSurface::OpenBelow, mesh.surfaces[0]);
+	EXPECT_EQ(buw::eCorridorSurface::OpenAbove, mesh.surfaces[1]);
+	EXPECT_EQ(buw::eCorridorSurface::OpenAbove, mesh.surfaces[2]);
+
+	// The crossing is a quarter along the outer edge, at the height of the alignment.
+	EXPECT_NEAR(-6.0, mesh.textureCoordinates[4].x(), 1e-9);
+	EXPECT_NEAR(5.0, mesh.textureCoordinates[4].y(), 1e-9);
+	EXPECT_NEAR(5.0, mesh.points[4].x(), 1e-9);
+	EXPECT_NEAR(-6.0, mesh.points[4].y(), 1e-9);
+	EXPECT_NEAR(alignment->getPosition(5.0).z(), mesh.points[4].z(), 1e-9);
+
+	// The three triangles cover the face without overlapping and face up.
+	double area = 0.0;
+	for (const buw::Vector3i& triangle : mesh.triangles)
+	{
+		const buw::Vector3d normal = getTriangleNormal(mesh, triangle);
+		EXPECT_GT(normal.z(), 0.0);
+		area += 0.5 * normal.z();
+	}
+	EXPECT_NEAR(20.0 * 2.5, area, 1e-9);
+}
+
+TEST(CorridorMeshBuilder, UpdatesOnlyWhatChanged)
+{
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	for (int i = 0; i < 200; i++)
+		alignment->addCrossSection(createCrossSection(0.75 * i));
+
+	buw::CorridorMeshDescription desc;
+	desc.threadCount = 4;
+	buw::CorridorMeshBuilder builder(alignment, desc);
+	ASSERT_EQ(199, builder.getMeshCount());
+	EXPECT_EQ(0, builder.update());
+
+	// The parallel build gives the same as building on one thread.
+	desc.threadCount = 1;
+	buw::CorridorMeshBuilder serial(alignment, desc);
+	for (int i = 0; i < builder.getMeshCount(); i++)
+	{
+		EXPECT_EQ(serial.getMesh(i).points, builder.getMesh(i).points);
+		EXPECT_EQ(serial.getMesh(i).triangles, builder.getMesh(i).triangles);
+	}
+
+	// A profile edited in place is picked up in the range given, the ranges on both sides of its cross section are built again.
+	alignment->getCrossSection(100)->getClosedDesignCrossSectionProfile(0)->crossSectionsPoints[1]->position = buw::Vector2d(0, 0.5);
+	const int revision = builder.getMesh(0).revision;
+	EXPECT_EQ(2, builder.update(74.9, 75.1));
+	EXPECT_EQ(revision, builder.getMesh(0).revision);
+	EXPECT_EQ(revision, builder.getMesh(101).revision);
+	EXPECT_LT(revision, builder.getMesh(99).revision);
+	EXPECT_EQ(builder.getMesh(99).revision, builder.getMesh(100).revision);
+	EXPECT_NEAR(0.5, builder.getMesh(99).points[4].z() - alignment->getPosition(75.0).z(), 1e-9);
+	EXPECT_NEAR(0.5, builder.getMesh(100).points[1].z() - alignment->getPosition(75.0).z(), 1e-9);
+	EXPECT_EQ(0, builder.update(200.0, 300.0));
+
+	// Changes of the alignment or the list of cross sections build everything again.
+	alignment->getHorizontalAlignment()->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(150, 50), buw::Vector2d(150, 100)));
+	EXPECT_EQ(199, builder.update(10.0, 11.0));
+	alignment->addCrossSection(createCrossSection(160.0));
+	EXPECT_EQ(200, builder.update());
+	alignment->getCrossSection(3)->stationing += 0.1;
+	EXPECT_EQ(200, builder.update());
+	EXPECT_EQ(0, builder.update());
+}
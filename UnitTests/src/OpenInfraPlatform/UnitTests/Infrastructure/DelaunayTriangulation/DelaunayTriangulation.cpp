@@ -0,0 +1,244 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DelaunayTriangulation.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	std::vector<buw::Vector3d> createRandomPoints(const int count, const unsigned seed)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<double> distribution(0.0, 100.0);
+		std::vector<buw::Vector3d> points;
+		for (int i = 0; i < count; i++)
+			points.push_back(buw::Vector3d(distribution(generator), distribution(generator), distribution(generator) / 10.0));
+		return points;
+	}
+
+	// Grid of size x size points with unit spacing, every four of them lie on a circle.
+	std::vector<buw::Vector3d> createGrid(const int size)
+	{
+		std::vector<buw::Vector3d> points;
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+				points.push_back(buw::Vector3d(x, y, 0.1 * x));
+		}
+		return points;
+	}
+
+	double cross(const buw::Vector3d& o, const buw::Vector3d& a, const buw::Vector3d& b)
+	{
+		return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+	}
+
+	double getArea(const std::vector<buw::Vector3d>& points, const buw::Vector3i& triangle)
+	{
+		return 0.5 * cross(points[triangle.x()], points[triangle.y()], points[triangle.z()]);
+	}
+
+	// Area of the convex hull by the monotone chain algorithm.
+	double getHullArea(std::vector<buw::Vector3d> points)
+	{
+		std::sort(points.begin(), points.end(), [](const buw::Vector3d& lhs, const buw::Vector3d& rhs) { return lhs.x() < rhs.x() || (lhs.x() == rhs.x() && lhs.y() < rhs.y()); });
+		std::vector<buw::Vector3d> hull(2 * points.size());
+		size_t k = 0;
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+				k--;
+			hull[k++] = points[i];
+		}
+		for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--)
+		{
+			while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+				k--;
+			hull[k++] = points[i - 1];
+		}
+
+		double area = 0.0;
+		for (size_t i = 0; i + 1 < k; i++)
+			area += hull[i].x() * hull[i + 1].y() - hull[i + 1].x() * hull[i].y();
+		return 0.5 * area;
+	}
+
+	// Whether 'p' lies inside the circumcircle of the counter-clockwise triangle, points on the circle are not inside.
+	bool isInCircumcircle(const std::vector<buw::Vector3d>& points, const buw::Vector3i& triangle, const buw::Vector3d& p)
+	{
+		const buw::Vector2d a = (points[triangle.x()] - p).head<2>();
+		const buw::Vector2d b = (points[triangle.y()] - p).head<2>();
+		const buw::Vector2d c = (points[triangle.z()] - p).head<2>();
+		const double determinant = a.squaredNorm() * (b.x() * c.y() - c.x() * b.y()) - b.squaredNorm() * (a.x() * c.y() - c.x() * a.y()) + c.squaredNorm() * (a.x() * b.y() - b.x() * a.y());
+		return determinant > 1e-9 * a.squaredNorm() * b.squaredNorm() * c.squaredNorm() / (a.squaredNorm() + b.squaredNorm() + c.squaredNorm());
+	}
+
+	std::set<std::pair<int, int>> getEdges(const std::vector<buw::Vector3i>& triangles)
+	{
+		std::set<std::pair<int, int>> edges;
+		for (const buw::Vector3i& triangle : triangles)
+		{
+			for (int i = 0; i < 3; i++)
+				edges.insert(std::minmax(triangle[i], triangle[(i + 1) % 3]));
+		}
+		return edges;
+	}
+
+	std::set<int> getUsedPoints(const std::vector<buw::Vector3i>& triangles)
+	{
+		std::set<int> used;
+		for (const buw::Vector3i& triangle : triangles)
+			used.insert({ triangle.x(), triangle.y(), triangle.z() });
+		return used;
+	}
+}
+
+TEST(DelaunayTriangulation, RandomPointsGiveEmptyCircumcircles)
+{
+	const std::vector<buw::Vector3d> points = createRandomPoints(1000, 1);
+	buw::DelaunayTriangulation triangulation(points);
+	ASSERT_EQ(points, triangulation.getPoints());
+
+	// Counter-clockwise triangles covering the convex hull and using every point.
+	const std::vector<buw::Vector3i> triangles = triangulation.getTriangles();
+	double area = 0.0;
+	for (const buw::Vector3i& triangle : triangles)
+	{
+		EXPECT_GT(getArea(points, triangle), 0.0);
+		area += getArea(points, triangle);
+	}
+	EXPECT_NEAR(getHullArea(points), area, 1e-6);
+	EXPECT_EQ(points.size(), getUsedPoints(triangles).size());
+
+	for (const buw::Vector3i& triangle : triangles)
+	{
+		for (const buw::Vector3d& p : points)
+			ASSERT_FALSE(isInCircumcircle(points, triangle, p));
+	}
+}
+
+TEST(DelaunayTriangulation, CocircularPointsAreTriangulated)
+{
+	const std::vector<buw::Vector3d> points = createGrid(20);
+	const std::vector<buw::Vector3i> triangles = buw::DelaunayTriangulation(points).getTriangles();
+
+	// Two triangles per square of the grid.
+	ASSERT_EQ(2u * 19u * 19u, triangles.size());
+	for (const buw::Vector3i& triangle : triangles)
+		EXPECT_DOUBLE_EQ(0.5, getArea(points, triangle));
+	EXPECT_EQ(points.size(), getUsedPoints(triangles).size());
+}
+
+TEST(DelaunayTriangulation, DuplicatePointsAreNotUsed)
+{
+	std::vector<buw::Vector3d> points = createGrid(5);
+	points.push_back(points[7]);
+	points.push_back(points[12]);
+
+	buw::DelaunayTriangulation triangulation(points);
+	const std::set<int> used = getUsedPoints(triangulation.getTriangles());
+	EXPECT_EQ(25u, used.size());
+	EXPECT_EQ(0u, used.count(25));
+	EXPECT_EQ(0u, used.count(26));
+	EXPECT_EQ(2u * 4u * 4u, triangulation.getTriangles().size());
+}
+
+TEST(DelaunayTriangulation, BreakLinesBecomeEdges)
+{
+	const std::vector<buw::Vector3d> points = createRandomPoints(500, 2);
+
+	// The second vertex of the first break line is one of the points, its copy is appended but not used.
+	const std::vector<std::vector<buw::Vector3d>> breakLines = {
+		{ buw::Vector3d(5.5, 7.25, 1.0), points[17], buw::Vector3d(93.0, 41.5, 2.0) },
+		{ buw::Vector3d(12.0, 88.0, 3.0), buw::Vector3d(70.5, 95.25, 4.0) }
+	};
+
+	buw::DelaunayTriangulation triangulation(points, breakLines);
+	ASSERT_EQ(points.size() + 5, triangulation.getPoints().size());
+	EXPECT_EQ(0, triangulation.getSkippedBreakLineSegmentCount());
+
+	const int first = (int)points.size();
+	const std::set<std::pair<int, int>> edges = getEdges(triangulation.getTriangles());
+	EXPECT_EQ(1u, edges.count(std::minmax(first, 17)));
+	EXPECT_EQ(1u, edges.count(std::minmax(17, first + 2)));
+	EXPECT_EQ(1u, edges.count(std::minmax(first + 3, first + 4)));
+	EXPECT_EQ(0u, getUsedPoints(triangulation.getTriangles()).count(first + 1));
+
+	// The break lines keep their heights.
+	EXPECT_EQ(breakLines[0][0], triangulation.getPoints()[first]);
+	EXPECT_EQ(breakLines[1][1], triangulation.getPoints()[first + 4]);
+
+	for (const buw::Vector3i& triangle : triangulation.getTriangles())
+		EXPECT_GT(getArea(triangulation.getPoints(), triangle), 0.0);
+}
+
+TEST(DelaunayTriangulation, CrossingBreakLinesAreSkipped)
+{
+	const std::vector<buw::Vector3d> points = createRandomPoints(200, 3);
+	const std::vector<std::vector<buw::Vector3d>> breakLines = {
+		{ buw::Vector3d(10.5, 10.25, 0.0), buw::Vector3d(90.5, 90.25, 0.0) },
+		{ buw::Vector3d(10.25, 90.5, 0.0), buw::Vector3d(90.25, 10.5, 0.0) }
+	};
+
+	buw::DelaunayTriangulation triangulation(points, breakLines);
+	EXPECT_EQ(1, triangulation.getSkippedBreakLineSegmentCount());
+	const std::set<std::pair<int, int>> edges = getEdges(triangulation.getTriangles());
+	EXPECT_EQ(1u, edges.count(std::make_pair(200, 201)));
+	EXPECT_EQ(0u, edges.count(std::make_pair(202, 203)));
+}
+
+TEST(DelaunayTriangulation, SurfaceFromPointsInterpolatesPlanes)
+{
+	// Points on the plane z = 2x - 3y + 5.
+	std::vector<buw::Vector3d> points = createRandomPoints(300, 4);
+	for (buw::Vector3d& p : points)
+		p.z() = 2.0 * p.x() - 3.0 * p.y() + 5.0;
+	for (const buw::Vector3d& corner : { buw::Vector3d(0, 0, 5), buw::Vector3d(100, 0, 205), buw::Vector3d(100, 100, -95), buw::Vector3d(0, 100, -295) })
+		points.push_back(corner);
+
+	buw::ReferenceCounted<buw::Surface> surface = buw::createSurfaceFromXYZPoints(points);
+	EXPECT_EQ(points.size(), (size_t)surface->getPointCount());
+	EXPECT_TRUE(surface->validate());
+
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<double> distribution(0.5, 99.5);
+	for (int i = 0; i < 100; i++)
+	{
+		const buw::Vector2d xy(distribution(generator), distribution(generator));
+		double z = 0.0;
+		ASSERT_TRUE(surface->tryGetZ(xy, z));
+		EXPECT_NEAR(2.0 * xy.x() - 3.0 * xy.y() + 5.0, z, 1e-9);
+	}
+
+	// With a break line its vertices are part of the surface.
+	const std::vector<std::vector<buw::Vector3d>> breakLines = { { buw::Vector3d(20.5, 30.5, 50.0), buw::Vector3d(60.5, 70.5, 50.0) } };
+	buw::ReferenceCounted<buw::Surface> withBreakLine = buw::createSurfaceFromXYZPoints(points, breakLines);
+	EXPECT_EQ(points.size() + 2, (size_t)withBreakLine->getPointCount());
+	double z = 0.0;
+	ASSERT_TRUE(withBreakLine->tryGetZ(buw::Vector2d(40.5, 50.5), z));
+	EXPECT_NEAR(50.0, z, 1e-9);
+}
@@ -0,0 +1,350 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/Alignment2DBased3D.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/HorizontalAlignment/HorizontalAlignmentElement2DLine.h"
+#include "OpenInfraPlatform/Infrastructure/Alignment/VerticalAlignment/VerticalAlignmentElement2DLine.h"
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CrossSectionStatic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Grid surface over [x0, x1] x [y0, y1] with unit spacing.
+	buw::ReferenceCounted<buw::Surface> createSurface(const int x0, const int y0, const int x1, const int y1, const std::function<double(double, double)>& height)
+	{
+		const int width = x1 - x0 + 1;
+		std::vector<buw::Vector3d> points;
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+				points.push_back(buw::Vector3d(x, y, height(x, y)));
+		}
+
+		std::vector<buw::Vector3i> triangles;
+		for (int y = 0; y < y1 - y0; y++)
+		{
+			for (int x = 0; x < x1 - x0; x++)
+			{
+				triangles.push_back(buw::Vector3i(y * width + x, y * width + x + 1, (y + 1) * width + x));
+				triangles.push_back(buw::Vector3i(y * width + x + 1, (y + 1) * width + x + 1, (y + 1) * width + x));
+			}
+		}
+
+		buw::ReferenceCounted<buw::Surface> surface = std::make_shared<buw::Surface>();
+		surface->setPoints(points);
+		surface->setTriangles(triangles);
+		return surface;
+	}
+
+	// Straight line from (0, 0) to (100, 0) at height 10.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> createAlignment()
+	{
+		buw::ReferenceCounted<buw::HorizontalAlignment2D> ha = std::make_shared<buw::HorizontalAlignment2D>(0.0);
+		ha->addElement(std::make_shared<buw::HorizontalAlignmentElement2DLine>(buw::Vector2d(0, 0), buw::Vector2d(100, 0)));
+
+		buw::ReferenceCounted<buw::VerticalAlignment2D> va = std::make_shared<buw::VerticalAlignment2D>();
+		va->addElement(std::make_shared<buw::VerticalAlignmentElement2DLine>(buw::Vector2d(0, 10), buw::Vector2d(100, 10)));
+
+		return std::make_shared<buw::Alignment2DBased3D>(ha, va);
+	}
+
+	// Closed profile of a rectangle from 'left' to 'right' and from 'bottom' to 0 relative to the alignment.
+	buw::ReferenceCounted<buw::CrossSectionStatic> createCrossSection(const double station, const double left, const double right, const double bottom)
+	{
+		buw::ReferenceCounted<buw::DesignCrossSectionProfile> profile = std::make_shared<buw::DesignCrossSectionProfile>();
+		profile->closedArea = true;
+		for (const buw::Vector2d& p : { buw::Vector2d(left, 0), buw::Vector2d(right, 0), buw::Vector2d(right, bottom), buw::Vector2d(left, bottom) })
+		{
+			profile->crossSectionsPoints.push_back(std::make_shared<buw::CrossSectionPoint>());
+			profile->crossSectionsPoints.back()->position = p;
+		}
+
+		buw::ReferenceCounted<buw::CrossSectionStatic> crossSection = std::make_shared<buw::CrossSectionStatic>();
+		crossSection->stationing = station;
+		crossSection->addDesignCrossSectionProfile(profile);
+		return crossSection;
+	}
+
+	double area(const buw::Surface& surface)
+	{
+		double sum = 0.0;
+		for (const auto& t : surface.getTriangeFaces())
+		{
+			const buw::Vector3d a = surface.getPoints()[t[1]] - surface.getPoints()[t[0]];
+			const buw::Vector3d b = surface.getPoints()[t[2]] - surface.getPoints()[t[0]];
+			sum += 0.5 * std::abs(a.x() * b.y() - a.y() * b.x());
+		}
+		return sum;
+	}
+}
+
+TEST(DigitalElevationModel, HeightZeroIsFound)
+{
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(0, 0, 10, 10, [](double, double) { return 0.0; }));
+	dem.addSurface(createSurface(5, 0, 20, 10, [](double, double) { return 5.0; }));
+
+	double z = -1.0;
+	EXPECT_TRUE(dem.tryGetHeightAtPosition(buw::Vector2d(7.3, 4.1), z));
+	EXPECT_EQ(0.0, z);
+	EXPECT_EQ(0.0, dem.getHeightAtPosition(buw::Vector2d(7.3, 4.1)));
+
+	EXPECT_TRUE(dem.tryGetHeightAtPosition(buw::Vector2d(15.0, 4.1), z));
+	EXPECT_EQ(5.0, z);
+
+	EXPECT_FALSE(dem.tryGetHeightAtPosition(buw::Vector2d(25.0, 4.1), z));
+}
+
+TEST(DigitalElevationModel, PriorityDecidesOverlaps)
+{
+	buw::DigitalElevationModel dem;
+	buw::ReferenceCounted<buw::Surface> a = createSurface(0, 0, 10, 10, [](double, double) { return 1.0; });
+	buw::ReferenceCounted<buw::Surface> b = createSurface(5, 0, 20, 10, [](double, double) { return 2.0; });
+	dem.addSurface(a);
+	dem.addSurface(b);
+
+	buw::ReferenceCounted<buw::RasterSurface> raster = std::make_shared<buw::RasterSurface>(11, 11, buw::Vector2d(0.0, 0.0), 1.0);
+	for (int y = 0; y < 11; y++)
+	{
+		for (int x = 0; x < 11; x++)
+			raster->setHeight(x, y, 3.0f);
+	}
+	dem.addRasterSurface(raster);
+
+	const buw::Vector2d p(7.5, 5.5);
+	EXPECT_EQ(1.0, dem.getHeightAtPosition(p));
+
+	dem.setSurfacePriority(b, 1);
+	EXPECT_EQ(1, dem.getSurfacePriority(b));
+	EXPECT_EQ(2.0, dem.getHeightAtPosition(p));
+
+	dem.setSurfacePriority(raster, 2);
+	EXPECT_EQ(3.0, dem.getHeightAtPosition(p));
+
+	// A copy keeps the priorities.
+	buw::DigitalElevationModel copy(dem);
+	dem.deleteRasterSurface(raster);
+	EXPECT_EQ(2.0, dem.getHeightAtPosition(p));
+	EXPECT_EQ(3.0, copy.getHeightAtPosition(p));
+}
+
+TEST(DigitalElevationModel, TriangulatedSurfacesIncludeRasters)
+{
+	buw::DigitalElevationModel dem;
+	buw::ReferenceCounted<buw::Surface> surface = createSurface(0, 0, 10, 10, [](double, double) { return 1.0; });
+	dem.addSurface(surface);
+
+	buw::ReferenceCounted<buw::RasterSurface> raster = std::make_shared<buw::RasterSurface>(5, 4, buw::Vector2d(20.0, 0.0), 2.0);
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 5; x++)
+			raster->setHeight(x, y, 3.0f);
+	}
+	raster->setName("Raster");
+	dem.addRasterSurface(raster);
+
+	// The raster follows the triangulated surface with its name and two triangles per cell.
+	const std::vector<buw::ReferenceCounted<buw::Surface>> surfaces = dem.getTriangulatedSurfaces();
+	ASSERT_EQ(2u, surfaces.size());
+	EXPECT_EQ(surface, surfaces[0]);
+	EXPECT_STREQ("Raster", surfaces[1]->getName());
+	EXPECT_EQ(20, surfaces[1]->getPointCount());
+	EXPECT_EQ(24u, surfaces[1]->getTriangeFaces().size());
+	EXPECT_NEAR(8.0 * 6.0, area(*surfaces[1]), 1e-9);
+}
+
+TEST(DigitalElevationModel, MergeClipsOverlaps)
+{
+	// An L-shaped union, so the triangulation of the convex hull has to be clipped as well.
+	buw::DigitalElevationModel dem;
+	buw::ReferenceCounted<buw::Surface> a = createSurface(0, 0, 10, 10, [](double x, double y) { return 1.0 + 0.1 * x; });
+	buw::ReferenceCounted<buw::Surface> b = createSurface(5, 0, 20, 5, [](double x, double y) { return 5.0 + 0.1 * y; });
+	dem.addSurface(b);
+	dem.addSurface(a);
+	dem.setSurfacePriority(a, 1);
+
+	buw::ReferenceCounted<buw::Surface> merged = dem.mergeSurfaces();
+	ASSERT_TRUE(merged->validate());
+
+	// The union without overlapping triangles.
+	EXPECT_NEAR(150.0, area(*merged), 1e-6);
+
+	// The triangles of the surface with the higher priority are kept, so are the ones of the other surface away from the overlap.
+	for (double x = 0.25; x < 20.0; x += 0.5)
+	{
+		for (double y = 0.25; y < 10.0; y += 0.5)
+		{
+			const buw::Vector2d p(x, y);
+			double expected = 0.0;
+			double z = 0.0;
+			const bool bInside = dem.tryGetHeightAtPosition(p, expected);
+			EXPECT_EQ(bInside, merged->tryGetZ(p, z));
+			if (bInside && (x < 10.0 || x > 11.0))
+				EXPECT_NEAR(expected, z, 1e-9);
+		}
+	}
+}
+
+TEST(DigitalElevationModel, EarthworkOfFlatSurfaces)
+{
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(-10, -20, 110, 20, [](double, double) { return 5.0; }));
+
+	buw::EarthworkDescription desc;
+	desc.cellSize = 0.5;
+
+	// Only the cells of the design are summed up.
+	const buw::EarthworkResult surface = dem.computeEarthwork(createSurface(0, 0, 10, 10, [](double, double) { return 7.0; }), desc);
+	EXPECT_NEAR(200.0, surface.fill, 1e-6);
+	EXPECT_NEAR(0.0, surface.cut, 1e-6);
+	EXPECT_TRUE(surface.intervals.empty());
+
+	// Along a straight alignment the corridor is 2 * 4 meters wide.
+	desc.corridorWidth = 4.0;
+	desc.stationInterval = 20.0;
+	const buw::EarthworkResult corridor = dem.computeEarthwork(createAlignment(), createSurface(-5, -10, 105, 10, [](double, double) { return 3.0; }), desc);
+	EXPECT_NEAR(1600.0, corridor.cut, 1e-6);
+	EXPECT_NEAR(0.0, corridor.fill, 1e-6);
+	ASSERT_EQ(5u, corridor.intervals.size());
+	for (size_t i = 0; i < corridor.intervals.size(); i++)
+	{
+		EXPECT_EQ(20.0 * i, corridor.intervals[i].startStation);
+		EXPECT_NEAR(320.0, corridor.intervals[i].cut, 1e-6);
+		EXPECT_NEAR(320.0 * (i + 1), corridor.intervals[i].massOrdinate, 1e-6);
+	}
+}
+
+TEST(DigitalElevationModel, EarthworkOfRoadBody)
+{
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(-10, -20, 110, 20, [](double, double) { return 5.0; }));
+
+	// A body 6 meters wide and 1 meter deep below the alignment at height 10, its lower side is 4 meters above the terrain.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	alignment->addCrossSection(createCrossSection(0.0, 3.0, -3.0, -1.0));
+	alignment->addCrossSection(createCrossSection(100.0, 3.0, -3.0, -1.0));
+
+	buw::EarthworkDescription desc;
+	desc.cellSize = 0.5;
+	desc.stationInterval = 50.0;
+	desc.cutFactor = 0.5;
+	const buw::EarthworkResult result = dem.computeEarthwork(alignment, desc);
+	EXPECT_NEAR(4.0 * 6.0 * 100.0, result.fill, 1e-6);
+	EXPECT_NEAR(0.0, result.cut, 1e-6);
+	ASSERT_EQ(2u, result.intervals.size());
+	EXPECT_NEAR(-4.0 * 6.0 * 100.0, result.intervals[1].massOrdinate, 1e-6);
+
+	// Below the terrain the body is cut, the cut factor only applies to the mass haul.
+	dem.deleteSurface(dem.getSurface(0));
+	dem.addSurface(createSurface(-10, -20, 110, 20, [](double, double) { return 11.0; }));
+	const buw::EarthworkResult below = dem.computeEarthwork(alignment, desc);
+	EXPECT_NEAR(2.0 * 6.0 * 100.0, below.cut, 1e-6);
+	EXPECT_NEAR(0.0, below.fill, 1e-6);
+	EXPECT_NEAR(0.5 * 2.0 * 6.0 * 100.0, below.intervals[1].massOrdinate, 1e-6);
+}
+
+TEST(DigitalElevationModel, EarthworkOffsetsArePositiveToTheLeft)
+{
+	// Terrain rising to the left of the alignment, which runs along the x-axis.
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(-10, -20, 110, 20, [](double, double y) { return 5.0 + 0.5 * y; }));
+
+	// A body only on the left, its lower side at 9 is 3 meters above the terrain on average, on the right it would be 5 meters.
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+	alignment->addCrossSection(createCrossSection(0.0, 4.0, 0.0, -1.0));
+	alignment->addCrossSection(createCrossSection(100.0, 4.0, 0.0, -1.0));
+
+	buw::EarthworkDescription desc;
+	desc.cellSize = 0.5;
+	const buw::EarthworkResult result = dem.computeEarthwork(alignment, desc);
+	EXPECT_NEAR(3.0 * 4.0 * 100.0, result.fill, 1e-6);
+	EXPECT_NEAR(0.0, result.cut, 1e-6);
+}
+
+TEST(DigitalElevationModel, SurfaceProfileSamplesTheStationRange)
+{
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(-5, -5, 105, 5, [](double x, double) { return 0.1 * x; }));
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+
+	// Stations below the end station, the same on any number of threads.
+	buw::SurfaceProfileDescription desc;
+	desc.threadCount = 1;
+	const std::vector<std::pair<double, double>> profile = dem.getSurfaceProfile(alignment, desc);
+	ASSERT_EQ(200u, profile.size());
+	for (size_t i = 0; i < profile.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(0.5 * i, profile[i].first);
+		EXPECT_NEAR(0.1 * profile[i].first, profile[i].second, 1e-9);
+	}
+	desc.threadCount = 4;
+	EXPECT_EQ(profile, dem.getSurfaceProfile(alignment, desc));
+
+	desc.startStation = 20.0;
+	desc.endStation = 30.0;
+	desc.step = 2.0;
+	const std::vector<std::pair<double, double>> range = dem.getSurfaceProfile(alignment, desc);
+	ASSERT_EQ(5u, range.size());
+	EXPECT_EQ(20.0, range.front().first);
+	EXPECT_EQ(28.0, range.back().first);
+
+	desc.step = 0.0;
+	EXPECT_TRUE(dem.getSurfaceProfile(alignment, desc).empty());
+}
+
+TEST(DigitalElevationModel, SurfaceProfileRefinesAtKinks)
+{
+	// The terrain bends at x = 53 between the samples at 50 and 60.
+	buw::DigitalElevationModel dem;
+	dem.addSurface(createSurface(-5, -5, 105, 5, [](double x, double) { return std::abs(x - 53.0); }));
+	buw::ReferenceCounted<buw::Alignment2DBased3D> alignment = createAlignment();
+
+	buw::SurfaceProfileDescription desc;
+	desc.step = 10.0;
+	desc.tolerance = 0.01;
+	desc.minimumStep = 0.5;
+	const std::vector<std::pair<double, double>> profile = dem.getSurfaceProfile(alignment, desc);
+	EXPECT_LT(10u, profile.size());
+
+	double closest = 100.0;
+	for (size_t i = 0; i < profile.size(); i++)
+	{
+		EXPECT_NEAR(std::abs(profile[i].first - 53.0), profile[i].second, 1e-9);
+		if (i > 0)
+			EXPECT_GE(profile[i].first - profile[i - 1].first, 0.5);
+		closest = std::min(closest, std::abs(profile[i].first - 53.0));
+	}
+	EXPECT_LE(closest, 0.5);
+
+	// A minimum step of 0 or below is limited to ten bisections of a step.
+	for (double minimumStep : { 0.0, -1.0 })
+	{
+		desc.minimumStep = minimumStep;
+		const std::vector<std::pair<double, double>> fine = dem.getSurfaceProfile(alignment, desc);
+		ASSERT_LT(profile.size(), fine.size());
+		for (size_t i = 1; i < fine.size(); i++)
+			EXPECT_GE(fine[i].first - fine[i - 1].first, desc.step / 1024 - 1e-9);
+	}
+}
@@ -18,15 +18,19 @@
 #include "gtest/gtest.h"
 
 #include "buw.OIPInfrastructure.h"
+#include "OpenInfraPlatform/Infrastructure/Core/Fresnel.h"
 
 #include <BlueFramework/Core/Math/vector.h>
 #include <BlueFramework/Core/Math/quaternion.h>
 #include <BlueFramework/Core/Math/util.h>
 #include <BlueFramework/Core/Math/matrix.h>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 using namespace std;
 
@@ -297,6 +301,120 @@ namespace
 		EXPECT_NEAR(dist, 0, 0.01);
 	}
 
+	// Composite Simpson rule over the integrands of the normalized Fresnel integrals.
+	void integrateFresnel(const double x, const int intervals, double& C, double& S)
+	{
+		const double pi = buw::constantsd::pi();
+		const double h = x / intervals;
+		C = 0.0;
+		S = 0.0;
+		for (int i = 0; i <= intervals; i++)
+		{
+			const double t = i * h;
+			const double weight = (i == 0 || i == intervals) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+			C += weight * std::cos(0.5 * pi * t * t);
+			S += weight * std::sin(0.5 * pi * t * t);
+		}
+		C *= h / 3.0;
+		S *= h / 3.0;
+	}
+
+	TEST(HorizontalAlignmentElement2DClothoid, FresnelIntegralsMatchNumericIntegration)
+	{
+		// Both sides of the switch between the power series and the auxiliary functions at x^2 = 2.5.
+		for (double x : { 0.01, 0.3, 1.0, 1.5, 1.58, 1.59, 2.2, 3.7, 5.0 })
+		{
+			double C, S, expectedC, expectedS;
+			buw::computeFresnelIntegrals(x, C, S);
+			integrateFresnel(x, 200000, expectedC, expectedS);
+			EXPECT_NEAR(expectedC, C, 1e-12);
+			EXPECT_NEAR(expectedS, S, 1e-12);
+
+			double negativeC, negativeS;
+			buw::computeFresnelIntegrals(-x, negativeC, negativeS);
+			EXPECT_EQ(-C, negativeC);
+			EXPECT_EQ(-S, negativeS);
+		}
+
+		double C, S;
+		buw::computeFresnelIntegrals(1.0, C, S);
+		EXPECT_NEAR(0.7798934003768228, C, 1e-15);
+		EXPECT_NEAR(0.4382591473903548, S, 1e-15);
+
+		buw::computeFresnelIntegrals(1e5, C, S);
+		EXPECT_EQ(0.5, C);
+		EXPECT_EQ(0.5, S);
+	}
+
+	TEST(HorizontalAlignmentElement2DClothoid, LongTransitionMatchesNumericIntegration)
+	{
+		// A turn of 4.5 radians, where a truncated series diverges. The position is the integral of the direction over the arc length.
+		const double A = 100.0;
+		const double L = 300.0;
+		buw::clothoidDescription desc(buw::Vector2d(10.0, 20.0), 0.5, 0.0, true, A, true, L);
+		buw::HorizontalAlignmentElement2DClothoid c(desc);
+
+		const int intervals = 200000;
+		const double h = L / intervals;
+		buw::Vector2d expected(0.0, 0.0);
+		for (int i = 0; i <= intervals; i++)
+		{
+			const double weight = (i == 0 || i == intervals) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+			const double direction = 0.5 + buw::HorizontalAlignmentElement2DClothoid::computeT(i * h, A);
+			expected += weight * buw::Vector2d(std::cos(direction), std::sin(direction));
+		}
+		expected = buw::Vector2d(10.0, 20.0) + expected * (h / 3.0);
+
+		EXPECT_NEAR(0.0, (c.getEndPosition() - expected).norm(), 1e-8);
+		EXPECT_NEAR(0.0, (buw::Vector2d(buw::HorizontalAlignmentElement2DClothoid::computeX(L, A), buw::HorizontalAlignmentElement2DClothoid::computeY(L, A)) - buw::createRotationMatrix(-0.5) * (expected - buw::Vector2d(10.0, 20.0))).norm(), 1e-8);
+	}
+
+	TEST(HorizontalAlignmentElement2DClothoid, TangentAndNormalFollowPositions)
+	{
+		// Entries and exits in both directions, one of them starting at a curvature and one given by its parameters.
+		std::vector<buw::clothoidDescription> descriptions = {
+			buw::clothoidDescription(buw::Vector2d(100.0, 50.0), 0.3, 0.0, true, 150.0, true, 120.0),
+			buw::clothoidDescription(buw::Vector2d(100.0, 50.0), 2.1, 1.0 / 400.0, false, 200.0, true, 80.0),
+			buw::clothoidDescription(buw::Vector2d(-40.0, 10.0), 4.0, 1.0 / 300.0, true, 180.0, false, 90.0),
+			buw::clothoidDescription(buw::Vector2d(-40.0, 10.0), 5.5, 1.0 / 250.0, false, 120.0, false, 57.6),
+			buw::clothoidDescription(buw::Vector2d(0.0, 0.0), 1.0, 90.0, 30.0, 140.0, true)
+		};
+
+		for (const buw::clothoidDescription& desc : descriptions)
+		{
+			buw::HorizontalAlignmentElement2DClothoid c(desc);
+			EXPECT_NEAR(0.0, (c.getStartPosition() - desc.startPosition).norm(), 1e-9);
+			EXPECT_NEAR(std::cos(c.getStartDirection()), c.getTangent(0.0).x(), 1e-12);
+			EXPECT_NEAR(std::sin(c.getStartDirection()), c.getTangent(0.0).y(), 1e-12);
+			EXPECT_NEAR(std::cos(c.getEndDirection()), c.getTangent(1.0).x(), 1e-12);
+			EXPECT_NEAR(std::sin(c.getEndDirection()), c.getTangent(1.0).y(), 1e-12);
+
+			std::vector<double> lerps;
+			for (int i = 0; i <= 50; i++)
+				lerps.push_back(i / 50.0);
+
+			std::vector<buw::Vector2d> positions(lerps.size()), tangents(lerps.size()), normals(lerps.size());
+			c.getPositions(lerps.data(), static_cast<int>(lerps.size()), positions.data(), tangents.data(), normals.data());
+
+			const double delta = 1e-6;
+			for (size_t i = 0; i < lerps.size(); i++)
+			{
+				const double lerp = lerps[i];
+				const buw::Vector2d tangent = c.getTangent(lerp);
+				EXPECT_NEAR(1.0, tangent.norm(), 1e-12);
+				EXPECT_NEAR(0.0, (buw::orthogonal(tangent, true) - c.getNormal(lerp)).norm(), 1e-12);
+
+				const double a = std::max(lerp - delta, 0.0);
+				const double b = std::min(lerp + delta, 1.0);
+				EXPECT_NEAR(0.0, ((c.getPosition(b) - c.getPosition(a)).normalized() - tangent).norm(), 1e-6);
+
+				EXPECT_NEAR(0.0, (c.getPosition(lerp) - positions[i]).norm(), 1e-9);
+				EXPECT_NEAR(0.0, (tangent - tangents[i]).norm(), 1e-12);
+				EXPECT_NEAR(0.0, (c.getNormal(lerp) - normals[i]).norm(), 1e-12);
+			}
+		}
+	}
+
 	void checkComputeClothidEndPoint(const std::string &filename)
 	{
 		buw::ImportLandXml parser(filename.c_str());
@@ -0,0 +1,163 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/Percentile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	std::vector<double> createValues(const size_t count, const unsigned seed)
+	{
+		std::mt19937 generator(seed);
+		std::normal_distribution<double> distribution(10.0, 2.0);
+		std::vector<double> values(count);
+		for (double& value : values)
+			value = distribution(generator);
+		return values;
+	}
+
+	// Fraction of the sorted values which are smaller than 'value'.
+	double getRank(const std::vector<double>& sorted, const double value)
+	{
+		return (double)(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) / sorted.size();
+	}
+}
+
+TEST(Percentile, SelectionMatchesSorting)
+{
+	std::vector<double> sorted = createValues(1001, 1);
+	std::sort(sorted.begin(), sorted.end());
+
+	for (double percentile : { 0.0, 0.05, 0.5, 0.95, 1.0 })
+	{
+		std::vector<double> values = createValues(1001, 1);
+		EXPECT_EQ(sorted[buw::getPercentileIndex(percentile, sorted.size())], buw::selectPercentile(values, percentile));
+	}
+
+	EXPECT_EQ(0u, buw::getPercentileIndex(-0.5, 10));
+	EXPECT_EQ(9u, buw::getPercentileIndex(1.0, 10));
+	EXPECT_EQ(0u, buw::getPercentileIndex(0.5, 0));
+
+	std::vector<double> empty;
+	EXPECT_EQ(0.0, buw::selectPercentile(empty, 0.5));
+}
+
+TEST(Percentile, RangeSplitsAtBothPercentiles)
+{
+	// Pairs ordered by their second value, the first one keeps track of the elements.
+	std::vector<double> keys = createValues(500, 2);
+	std::vector<std::pair<int, double>> elements;
+	for (size_t i = 0; i < keys.size(); i++)
+		elements.push_back(std::make_pair((int)i, keys[i]));
+	std::sort(keys.begin(), keys.end());
+
+	const buw::PercentileRange range = buw::selectPercentileRange(elements.begin(), elements.end(), 0.1, 0.9, [](const std::pair<int, double>& element) { return element.second; });
+
+	EXPECT_EQ(keys.front(), range.minimum);
+	EXPECT_EQ(keys[buw::getPercentileIndex(0.1, keys.size())], range.lower);
+	EXPECT_EQ(keys[buw::getPercentileIndex(0.9, keys.size())], range.upper);
+	EXPECT_EQ(keys.back(), range.maximum);
+	ASSERT_EQ(buw::getPercentileIndex(0.9, keys.size()), range.upperIndex);
+
+	const size_t lowerIndex = buw::getPercentileIndex(0.1, keys.size());
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		if (i < lowerIndex)
+			EXPECT_LE(elements[i].second, range.lower);
+		else if (i < range.upperIndex)
+			EXPECT_TRUE(range.lower <= elements[i].second && elements[i].second <= range.upper);
+		else
+			EXPECT_GE(elements[i].second, range.upper);
+	}
+
+	// The elements are only reordered.
+	std::sort(elements.begin(), elements.end());
+	for (size_t i = 0; i < elements.size(); i++)
+		EXPECT_EQ((int)i, elements[i].first);
+
+	// A lower percentile above the upper one is clamped to it.
+	const buw::PercentileRange clamped = buw::selectPercentileRange(elements.begin(), elements.end(), 0.8, 0.2, [](const std::pair<int, double>& element) { return element.second; });
+	EXPECT_EQ(clamped.lower, clamped.upper);
+}
+
+TEST(Percentile, SketchEstimatesTheTails)
+{
+	std::vector<double> values = createValues(100000, 3);
+	buw::PercentileSketch sketch;
+	for (double value : values)
+		sketch.add(value);
+	std::sort(values.begin(), values.end());
+
+	EXPECT_EQ(100000.0, sketch.getTotalWeight());
+	EXPECT_EQ(values.front(), sketch.getPercentile(0.0));
+	EXPECT_EQ(values.back(), sketch.getPercentile(1.0));
+
+	// The error in rank gets smaller towards the tails.
+	for (double percentile : { 0.25, 0.5, 0.75 })
+		EXPECT_NEAR(percentile, getRank(values, sketch.getPercentile(percentile)), 0.01);
+	for (double percentile : { 0.001, 0.01, 0.05, 0.95, 0.99, 0.999 })
+		EXPECT_NEAR(percentile, getRank(values, sketch.getPercentile(percentile)), 0.002);
+}
+
+TEST(Percentile, MergedSketchesMatchOneSketch)
+{
+	std::vector<double> values = createValues(20000, 4);
+	buw::PercentileSketch all, merged;
+	std::vector<buw::PercentileSketch> parts(8);
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		all.add(values[i]);
+		parts[i % parts.size()].add(values[i]);
+	}
+	for (buw::PercentileSketch& part : parts)
+		merged.merge(part);
+	std::sort(values.begin(), values.end());
+
+	EXPECT_EQ(all.getTotalWeight(), merged.getTotalWeight());
+	EXPECT_EQ(all.getMinimum(), merged.getMinimum());
+	EXPECT_EQ(all.getMaximum(), merged.getMaximum());
+	for (double percentile : { 0.01, 0.05, 0.5, 0.95, 0.99 })
+		EXPECT_NEAR(getRank(values, all.getPercentile(percentile)), getRank(values, merged.getPercentile(percentile)), 0.005);
+}
+
+TEST(Percentile, SketchWeightsAndEmptySketch)
+{
+	buw::PercentileSketch sketch;
+	EXPECT_TRUE(sketch.isEmpty());
+	EXPECT_TRUE(std::isnan(sketch.getPercentile(0.5)));
+
+	// A value with weight 3 counts like three values, invalid values and weights are ignored.
+	sketch.add(1.0, 3.0);
+	sketch.add(2.0);
+	sketch.add(5.0, 0.0);
+	sketch.add(std::nan(""));
+	EXPECT_EQ(4.0, sketch.getTotalWeight());
+	EXPECT_EQ(1.0, sketch.getMinimum());
+	EXPECT_EQ(2.0, sketch.getMaximum());
+	EXPECT_LE(sketch.getPercentile(0.5), 1.5);
+
+	sketch.clear();
+	EXPECT_TRUE(sketch.isEmpty());
+	EXPECT_EQ(0.0, sketch.getTotalWeight());
+}
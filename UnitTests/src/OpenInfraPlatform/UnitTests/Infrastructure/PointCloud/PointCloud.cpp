@@ -0,0 +1,498 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/PointCloud.h"
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/PointCloudSection.h"
+
+#include <ccPointCloud.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// A flat grid of 30 x 30 points with a spacing of 5 cm and, above it, 'numClusters' clusters of 5 points each.
+	buw::ReferenceCounted<ccPointCloud> createGridWithClusters(const int numClusters)
+	{
+		buw::ReferenceCounted<ccPointCloud> cloud = buw::makeReferenceCounted<ccPointCloud>();
+		cloud->reserve(30 * 30 + 5 * numClusters);
+		for(int i = 0; i < 30; i++)
+		{
+			for(int j = 0; j < 30; j++)
+				cloud->addPoint(CCVector3(0.05f * i, 0.05f * j, 0.0f));
+		}
+
+		for(int c = 0; c < numClusters; c++)
+		{
+			const CCVector3 center = CCVector3(0.5f * c, 0.0f, 5.0f);
+			cloud->addPoint(center);
+			cloud->addPoint(center + CCVector3(0.02f, 0.0f, 0.0f));
+			cloud->addPoint(center - CCVector3(0.02f, 0.0f, 0.0f));
+			cloud->addPoint(center + CCVector3(0.0f, 0.02f, 0.0f));
+			cloud->addPoint(center - CCVector3(0.0f, 0.02f, 0.0f));
+		}
+		return cloud;
+	}
+
+	// Ground of 4 m x 4 m with a spacing of 5 cm and two rails of 10 cm width, 15 cm above it along the x-axis. The rail points come last.
+	buw::ReferenceCounted<ccPointCloud> createGroundWithRails(unsigned &o_firstRailPoint)
+	{
+		buw::ReferenceCounted<ccPointCloud> cloud = buw::makeReferenceCounted<ccPointCloud>();
+		cloud->reserve(80 * 80 + 2 * 160 * 3);
+		for(int i = 0; i < 80; i++)
+		{
+			for(int j = 0; j < 80; j++)
+				cloud->addPoint(CCVector3(0.05f * i, 0.05f * j, 0.0f));
+		}
+
+		o_firstRailPoint = cloud->size();
+		for(float y : { 1.0f, 3.0f })
+		{
+			for(int i = 0; i < 160; i++)
+			{
+				for(int j = -1; j <= 1; j++)
+					cloud->addPoint(CCVector3(0.025f * i, y + 0.05f * j, 0.15f));
+			}
+		}
+		return cloud;
+	}
+
+	// A grid of 40 x 10 points with a spacing of 5 cm and after every seventh point an isolated point 20 cm above it.
+	buw::ReferenceCounted<ccPointCloud> createGridWithOutliers()
+	{
+		buw::ReferenceCounted<ccPointCloud> cloud = buw::makeReferenceCounted<ccPointCloud>();
+		cloud->reserve(40 * 10 + 40 * 10 / 7 + 1);
+		for(int i = 0; i < 40; i++)
+		{
+			for(int j = 0; j < 10; j++)
+			{
+				cloud->addPoint(CCVector3(0.05f * i, 0.05f * j, 0.0f));
+				if((i * 10 + j) % 7 == 0)
+					cloud->addPoint(CCVector3(0.05f * i, 0.05f * j, 0.2f));
+			}
+		}
+		return cloud;
+	}
+
+	// Uses the x-coordinate as chainage, so that there is one section per meter.
+	void computeSectionsAlongX(buw::PointCloud& pointCloud)
+	{
+		CCLib::ScalarField* chainage = pointCloud.getScalarField(pointCloud.addScalarField("Chainage"));
+		for(unsigned i = 0; i < pointCloud.size(); i++)
+			chainage->setValue(i, pointCloud.getPoint(i)->x);
+		chainage->computeMinAndMax();
+		pointCloud.computeSections(1.0f);
+	}
+
+	buw::LocalDensityFilterDescription createDensityFilterDescription()
+	{
+		buw::LocalDensityFilterDescription desc;
+		desc.dim = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterDimension::Volume3D;
+		desc.kernelRadius = 0.12f;
+		desc.minThreshold = 4.5f;
+		desc.density = CCLib::GeometricalAnalysisTools::Density::DENSITY_KNN;
+		return desc;
+	}
+
+	// Adds a flat grid with a spacing of 5 cm starting at 'x'.
+	void addGround(ccPointCloud& cloud, const float x, const int nx, const int ny)
+	{
+		cloud.reserve(cloud.size() + nx * ny);
+		for(int i = 0; i < nx; i++)
+		{
+			for(int j = 0; j < ny; j++)
+				cloud.addPoint(CCVector3(x + 0.05f * i, 0.05f * j, 0.0f));
+		}
+	}
+
+	// Points appended to a ground of 2 m x 1 m: 10 points 60 cm above it and the ground from 2 m to 2.5 m.
+	void addAppendedPoints(ccPointCloud& cloud)
+	{
+		cloud.reserve(cloud.size() + 10);
+		for(int k = 0; k < 10; k++)
+			cloud.addPoint(CCVector3(0.525f + 0.1f * k, 0.525f, 0.6f));
+		addGround(cloud, 2.0f, 10, 20);
+	}
+
+	// The heads of a straight track of 10 m along the x-axis, one point per centimeter and rail.
+	buw::ReferenceCounted<ccPointCloud> createTrack()
+	{
+		const float distance = 1.435f + 0.067f;
+		buw::ReferenceCounted<ccPointCloud> cloud = buw::makeReferenceCounted<ccPointCloud>();
+		cloud->reserve(2 * 1000);
+		for(int i = 0; i < 1000; i++)
+		{
+			cloud->addPoint(CCVector3(0.01f * i, -0.5f * distance, 0.672f));
+			cloud->addPoint(CCVector3(0.01f * i, 0.5f * distance, 0.672f));
+		}
+		return cloud;
+	}
+
+	bool isSamePoint(const CCVector3& lhs, const CCVector3& rhs)
+	{
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+	}
+
+	void deleteScalarField(buw::PointCloud& pointCloud, const char* name)
+	{
+		int idx = pointCloud.getScalarFieldIndexByName(name);
+		if(idx != -1)
+			pointCloud.deleteScalarField(idx);
+	}
+}
+
+TEST(PointCloud, FilterPipelineDensityMatchesLocalDensityFilter)
+{
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(createGridWithClusters(4)));
+
+	// Each point of a cluster has 4 neighbours besides itself, each point of the grid at least 7.
+	const buw::LocalDensityFilterDescription densityDesc = createDensityFilterDescription();
+
+	ASSERT_EQ(0, pointCloud->applyLocalDensityFilter(densityDesc));
+	const std::vector<uint32_t> filtered = std::get<1>(pointCloud->getIndices());
+	ASSERT_EQ(4u * 5u, filtered.size());
+	for(uint32_t index : filtered)
+		EXPECT_LE(30u * 30u, index);
+
+	// The single filter field is removed so that "Filtered" only holds the result of the pipeline.
+	deleteScalarField(*pointCloud, "Density");
+	deleteScalarField(*pointCloud, "Filtered");
+
+	buw::FilterPipelineDescription pipelineDesc;
+	buw::FilterPipelineStageDescription stage;
+	stage.type = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterType::LocalDensityFilter;
+	stage.localDensity = densityDesc;
+	pipelineDesc.stages.push_back(stage);
+	ASSERT_EQ(0, pointCloud->applyFilterPipeline(pipelineDesc));
+
+	EXPECT_EQ(filtered, std::get<1>(pointCloud->getIndices()));
+	EXPECT_EQ(pointCloud->size() - filtered.size(), std::get<0>(pointCloud->getIndices()).size());
+}
+
+TEST(PointCloud, RemovesFilteredPointsInPlace)
+{
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(createGridWithOutliers()));
+	computeSectionsAlongX(*pointCloud);
+
+	std::vector<CCVector3> points;
+	for(unsigned i = 0; i < pointCloud->size(); i++)
+		points.push_back(*pointCloud->getPoint(i));
+
+	// The isolated points have no neighbours within the radius.
+	ASSERT_EQ(0, pointCloud->applyLocalDensityFilter(createDensityFilterDescription()));
+	ASSERT_EQ(points.size() - 400u, std::get<1>(pointCloud->getIndices()).size());
+
+	const std::vector<int> remap = pointCloud->removeFilteredPoints();
+	ASSERT_EQ(points.size(), remap.size());
+	ASSERT_EQ(400u, pointCloud->size());
+
+	// The remaining points keep their order, coordinates and scalar values.
+	const CCLib::ScalarField* chainage = pointCloud->getScalarField(pointCloud->getScalarFieldIndexByName("Chainage"));
+	int next = 0;
+	for(size_t i = 0; i < points.size(); i++)
+	{
+		if(points[i].z > 0.1f)
+		{
+			EXPECT_EQ(-1, remap[i]);
+			continue;
+		}
+
+		ASSERT_EQ(next++, remap[i]);
+		EXPECT_TRUE(isSamePoint(points[i], *pointCloud->getPoint(remap[i])));
+		EXPECT_EQ(points[i].x, chainage->getValue(remap[i]));
+	}
+
+	// Index buffers, sections and octree refer to the new indices.
+	EXPECT_EQ(400u, std::get<0>(pointCloud->getIndices()).size());
+	EXPECT_TRUE(std::get<1>(pointCloud->getIndices()).empty());
+
+	ASSERT_EQ(2u, pointCloud->getSections().size());
+	unsigned numSectionPoints = 0;
+	for(const auto& section : pointCloud->getSections())
+	{
+		for(unsigned i = 0; i < section->size(); i++)
+		{
+			ASSERT_GT(400u, section->getPointGlobalIndex(i));
+			EXPECT_EQ(0.0f, section->getPoint(i)->z);
+		}
+		numSectionPoints += section->size();
+	}
+	EXPECT_EQ(400u, numSectionPoints);
+
+	// A point inside the grid has 20 neighbours besides itself within the radius.
+	buw::ReferenceCounted<buw::Octree> octree = pointCloud->getDGMOctree();
+	ASSERT_EQ(400u, octree->getNumberOfProjectedPoints());
+	CCLib::DgmOctree::NeighboursSet neighbours;
+	const unsigned char level = octree->findBestLevelForAGivenNeighbourhoodSizeExtraction(0.12f);
+	EXPECT_EQ(21, octree->getPointsInSphericalNeighbourhood(CCVector3(0.5f, 0.25f, 0.0f), 0.12f, neighbours, level));
+	for(const auto& neighbour : neighbours)
+		EXPECT_TRUE(isSamePoint(*pointCloud->getPoint(neighbour.pointIndex), *neighbour.point));
+}
+
+TEST(PointCloud, AppendsPointsToOctreeGridAndSections)
+{
+	buw::ReferenceCounted<ccPointCloud> ground = buw::makeReferenceCounted<ccPointCloud>();
+	addGround(*ground, 0.0f, 40, 20);
+	buw::ReferenceCounted<ccPointCloud> appended = buw::makeReferenceCounted<ccPointCloud>();
+	addAppendedPoints(*appended);
+
+	// The chainage of the appended points is copied, so that they can be sorted into the sections.
+	CCLib::ScalarField* chainage = appended->getScalarField(appended->addScalarField("Chainage"));
+	for(unsigned i = 0; i < appended->size(); i++)
+		chainage->setValue(i, appended->getPoint(i)->x);
+
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(ground));
+	pointCloud->computeGrid(buw::GridComputationDescription());
+	computeSectionsAlongX(*pointCloud);
+	ASSERT_EQ(0, pointCloud->add(appended));
+
+	// The same points processed at once.
+	buw::ReferenceCounted<ccPointCloud> all = buw::makeReferenceCounted<ccPointCloud>();
+	addGround(*all, 0.0f, 40, 20);
+	addAppendedPoints(*all);
+	buw::ReferenceCounted<buw::PointCloud> reference = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, reference->add(all));
+	reference->computeGrid(buw::GridComputationDescription());
+	computeSectionsAlongX(*reference);
+
+	ASSERT_EQ(reference->size(), pointCloud->size());
+	EXPECT_EQ(reference->size(), std::get<0>(pointCloud->getIndices()).size());
+
+	// The points above the ground are only filtered by the relative height if they have been sorted into the grid cells.
+	ASSERT_EQ(0, pointCloud->applyRelativeHeightWithGridFilter(buw::RelativeHeightFilterDescription()));
+	ASSERT_EQ(0, reference->applyRelativeHeightWithGridFilter(buw::RelativeHeightFilterDescription()));
+	const std::vector<uint32_t> filtered = std::get<1>(pointCloud->getIndices());
+	ASSERT_EQ(10u, filtered.size());
+	EXPECT_EQ(40u * 20u, filtered.front());
+	EXPECT_EQ(std::get<1>(reference->getIndices()), filtered);
+
+	// The appended ground gets a section of its own, points too far from the median height of their section are left out.
+	ASSERT_EQ(3u, pointCloud->getSections().size());
+	unsigned numSectionPoints = 0;
+	for(const auto& section : pointCloud->getSections())
+	{
+		for(unsigned i = 0; i < section->size(); i++)
+			EXPECT_EQ(0.0f, section->getPoint(i)->z);
+		numSectionPoints += section->size();
+	}
+	EXPECT_EQ(40u * 20u + 10u * 20u, numSectionPoints);
+
+	// The octree finds the appended points.
+	buw::ReferenceCounted<buw::Octree> octree = pointCloud->getDGMOctree();
+	ASSERT_EQ(pointCloud->size(), octree->getNumberOfProjectedPoints());
+	CCLib::DgmOctree::NeighboursSet neighbours;
+	const unsigned char level = octree->findBestLevelForAGivenNeighbourhoodSizeExtraction(0.12f);
+	EXPECT_EQ(21, octree->getPointsInSphericalNeighbourhood(CCVector3(2.2f, 0.5f, 0.0f), 0.12f, neighbours, level));
+	neighbours.clear();
+	EXPECT_EQ(1, octree->getPointsInSphericalNeighbourhood(CCVector3(0.525f, 0.525f, 0.6f), 0.05f, neighbours, level));
+}
+
+TEST(PointCloud, ConnectedComponentsDoNotDependOnTheThreads)
+{
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(createGridWithClusters(4)));
+
+	const int maxThreads = omp_get_max_threads();
+	std::vector<std::vector<std::vector<unsigned>>> results;
+	for(int numThreads : { 1, 4 })
+	{
+		omp_set_num_threads(numThreads);
+		std::vector<std::vector<unsigned>> components;
+		for(const auto& component : pointCloud->extractConnectedComponents(0.06f))
+		{
+			components.push_back(std::vector<unsigned>());
+			for(unsigned i = 0; i < component->size(); i++)
+				components.back().push_back(component->getPointGlobalIndex(i));
+		}
+		results.push_back(components);
+	}
+	omp_set_num_threads(maxThreads);
+
+	// The grid and each cluster, numbered by their smallest point index and with the points in ascending order.
+	ASSERT_EQ(5u, results[0].size());
+	EXPECT_EQ(30u * 30u, results[0][0].size());
+	for(size_t c = 0; c < results[0].size(); c++)
+	{
+		EXPECT_TRUE(std::is_sorted(results[0][c].begin(), results[0][c].end()));
+		if(c > 0)
+		{
+			ASSERT_EQ(5u, results[0][c].size());
+			EXPECT_EQ(30u * 30u + 5u * (c - 1), results[0][c].front());
+		}
+	}
+	EXPECT_EQ(results[0], results[1]);
+}
+
+TEST(PointCloud, PairsAndCenterlinesDoNotDependOnTheThreads)
+{
+	buw::PairComputationDescription pairDesc;
+	pairDesc.applyDensityFilter = false;
+
+	buw::CenterlineComputationDescription centerlineDesc;
+	centerlineDesc.minSegmentPoints = 10;
+	centerlineDesc.minSegmentLength = 1.0f;
+
+	const int maxThreads = omp_get_max_threads();
+	std::vector<std::vector<std::pair<size_t, size_t>>> pairs;
+	std::vector<int> numCenterlines;
+	std::vector<buw::ReferenceCounted<buw::PointCloud>> pointClouds;
+	for(int numThreads : { 1, 4 })
+	{
+		omp_set_num_threads(numThreads);
+		buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+		ASSERT_EQ(0, pointCloud->add(createTrack()));
+		computeSectionsAlongX(*pointCloud);
+
+		pairs.push_back(std::vector<std::pair<size_t, size_t>>());
+		pointCloud->computePairs(pairDesc, pairs.back());
+		numCenterlines.push_back(pointCloud->computeCenterlines(centerlineDesc));
+		pointClouds.push_back(pointCloud);
+	}
+	omp_set_num_threads(maxThreads);
+
+	// The points of each pair are as far apart as the centers of the rail heads.
+	ASSERT_FALSE(pairs[0].empty());
+	for(const auto& pair : pairs[0])
+		EXPECT_NEAR(1.435f + 0.067f, (*pointClouds[0]->getPoint(pair.first) - *pointClouds[0]->getPoint(pair.second)).norm(), pairDesc.maxError);
+	EXPECT_EQ(pairs[0], pairs[1]);
+	EXPECT_EQ(numCenterlines[0], numCenterlines[1]);
+
+	// The centerline points are added to the cloud in the same order.
+	ASSERT_EQ(pointClouds[0]->size(), pointClouds[1]->size());
+	for(unsigned i = 0; i < pointClouds[0]->size(); i++)
+		EXPECT_TRUE(isSamePoint(*pointClouds[0]->getPoint(i), *pointClouds[1]->getPoint(i)));
+	for(const char* name : { "Railway", "Centerline" })
+	{
+		const int idx = pointClouds[0]->getScalarFieldIndexByName(name);
+		ASSERT_EQ(idx != -1, pointClouds[1]->getScalarFieldIndexByName(name) != -1);
+		if(idx == -1)
+			continue;
+		const CCLib::ScalarField* lhs = pointClouds[0]->getScalarField(idx);
+		const CCLib::ScalarField* rhs = pointClouds[1]->getScalarField(pointClouds[1]->getScalarFieldIndexByName(name));
+		for(unsigned i = 0; i < pointClouds[0]->size(); i++)
+			EXPECT_TRUE(lhs->getValue(i) == rhs->getValue(i) || (std::isnan(lhs->getValue(i)) && std::isnan(rhs->getValue(i))));
+	}
+}
+
+TEST(PointCloud, CacheRestoresTheProcessingState)
+{
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(createTrack()));
+	computeSectionsAlongX(*pointCloud);
+	std::vector<std::pair<size_t, size_t>> pairs;
+	pointCloud->computePairs(buw::PairComputationDescription(), pairs);
+	buw::PositionFilterDescription positionDesc;
+	positionDesc.dimension = 0;
+	positionDesc.minValue = 1.0;
+	positionDesc.maxValue = 9.0;
+	ASSERT_EQ(0, pointCloud->applyPositionFilter(positionDesc));
+
+	const char* filename = "PointCloudCache.bin";
+	ASSERT_EQ(0, pointCloud->saveCache(filename));
+	buw::ReferenceCounted<buw::PointCloud> cached = buw::PointCloud::FromCache(filename);
+	ASSERT_NE(nullptr, cached);
+
+	// Points, colors and scalar fields.
+	ASSERT_EQ(pointCloud->size(), cached->size());
+	ASSERT_EQ(pointCloud->getNumberOfScalarFields(), cached->getNumberOfScalarFields());
+	for(unsigned i = 0; i < pointCloud->size(); i++)
+	{
+		EXPECT_TRUE(isSamePoint(*pointCloud->getPoint(i), *cached->getPoint(i)));
+		EXPECT_EQ(0, std::memcmp(pointCloud->getPointColor(i), cached->getPointColor(i), 3 * sizeof(ColorCompType)));
+	}
+	for(unsigned k = 0; k < pointCloud->getNumberOfScalarFields(); k++)
+	{
+		EXPECT_STREQ(pointCloud->getScalarFieldName(k), cached->getScalarFieldName(k));
+		for(unsigned i = 0; i < pointCloud->size(); i++)
+		{
+			const ScalarType lhs = pointCloud->getScalarField(k)->getValue(i), rhs = cached->getScalarField(k)->getValue(i);
+			EXPECT_TRUE(lhs == rhs || (std::isnan(lhs) && std::isnan(rhs)));
+		}
+	}
+
+	// Index buffers, sections with their pairs and the octree.
+	EXPECT_EQ(pointCloud->getIndices(), cached->getIndices());
+	EXPECT_FALSE(std::get<1>(cached->getIndices()).empty());
+	ASSERT_EQ(pointCloud->getSections().size(), cached->getSections().size());
+	for(size_t s = 0; s < pointCloud->getSections().size(); s++)
+	{
+		const auto& lhs = pointCloud->getSections()[s];
+		const auto& rhs = cached->getSections()[s];
+		ASSERT_EQ(lhs->size(), rhs->size());
+		for(unsigned i = 0; i < lhs->size(); i++)
+			EXPECT_EQ(lhs->getPointGlobalIndex(i), rhs->getPointGlobalIndex(i));
+		EXPECT_EQ(lhs->getPairs(), rhs->getPairs());
+		EXPECT_EQ(lhs->getLength(), rhs->getLength());
+	}
+	ASSERT_EQ(cached->size(), cached->getDGMOctree()->getNumberOfProjectedPoints());
+	CCLib::DgmOctree::NeighboursSet neighbours;
+	const unsigned char level = cached->getDGMOctree()->findBestLevelForAGivenNeighbourhoodSizeExtraction(0.05f);
+	EXPECT_EQ(7, cached->getDGMOctree()->getPointsInSphericalNeighbourhood(*cached->getPoint(100), 0.035f, neighbours, level));
+
+	// A truncated cache is rejected.
+	std::ifstream input(filename, std::ios::binary);
+	const std::vector<char> bytes = std::vector<char>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	input.close();
+	std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+	output.write(bytes.data(), bytes.size() / 2);
+	output.close();
+	EXPECT_EQ(nullptr, buw::PointCloud::FromCache(filename));
+
+	std::remove(filename);
+	EXPECT_EQ(nullptr, buw::PointCloud::FromCache(filename));
+}
+
+TEST(PointCloud, ApproximatePercentilesSegmentTheRails)
+{
+	unsigned firstRailPoint = 0;
+	buw::ReferenceCounted<buw::PointCloud> pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+	ASSERT_EQ(0, pointCloud->add(createGroundWithRails(firstRailPoint)));
+	const unsigned numRailPoints = pointCloud->size() - firstRailPoint;
+
+	buw::PercentileSegmentationDescription desc;
+	desc.kernelRadius = 0.5f;
+	desc.lowerPercentile = 0.05;
+	desc.upperPercentile = 0.95;
+	desc.minThreshold = 0.1f;
+	desc.maxThreshold = 0.5f;
+
+	// Each neighbourhood on a rail has more than 5 % rail points, so exactly the rails are in the upper percentile.
+	ASSERT_EQ(0, pointCloud->applyPercentilesSegmentation(desc));
+	const std::vector<uint32_t> exact = std::get<2>(pointCloud->getIndices());
+	ASSERT_EQ(numRailPoints, exact.size());
+	EXPECT_EQ(firstRailPoint, exact.front());
+
+	// The sketch per octree cell only estimates the percentiles, but it never segments the ground and misses few rail points.
+	desc.method = OpenInfraPlatform::Infrastructure::Enums::ePercentileComputationMethod::Approximate;
+	ASSERT_EQ(0, pointCloud->applyPercentilesSegmentation(desc));
+	const std::vector<uint32_t> approximate = std::get<2>(pointCloud->getIndices());
+	EXPECT_TRUE(std::all_of(approximate.begin(), approximate.end(), [&](uint32_t index) { return index >= firstRailPoint; }));
+	EXPECT_LE(0.9 * numRailPoints, approximate.size());
+}
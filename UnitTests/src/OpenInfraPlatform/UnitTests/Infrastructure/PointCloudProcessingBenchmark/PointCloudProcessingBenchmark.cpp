@@ -0,0 +1,364 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "buw.OIPInfrastructure.h"
+
+#include <GenericProgressCallback.h>
+
+#include <omp.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	// Parameters of the synthetic corridor and the runs, all of them can be set on the command line.
+	struct BenchmarkDescription {
+		std::vector<unsigned> points = { 100000 };
+		std::vector<int> threads = { 1, omp_get_max_threads() };
+		double length = 1000.0;
+		double noiseRatio = 0.1;
+		uint64_t seed = 42;
+		std::string output = "PointCloudProcessingBenchmark.json";
+	};
+
+	struct OperationResult {
+		std::string name;
+		double seconds;
+		int result;
+		std::vector<std::string> details;
+	};
+
+	struct RunResult {
+		unsigned points;
+		int threads;
+		std::vector<OperationResult> operations;
+	};
+
+	// Callback which does not report progress but collects the stage timings reported with setInfo.
+	class RecordingProgressCallback : public CCLib::GenericProgressCallback {
+	public:
+		virtual void update(float percent) override {}
+		virtual void setMethodTitle(const char* methodTitle) override {}
+		virtual void setInfo(const char* infoStr) override {
+#pragma omp critical
+			details_.push_back(infoStr);
+		}
+		virtual void start() override {}
+		virtual void stop() override {}
+		virtual bool isCancelRequested() override {
+			return false;
+		}
+
+		std::vector<std::string> takeDetails() {
+			std::vector<std::string> details = details_;
+			details_.clear();
+			return details;
+		}
+
+	private:
+		std::vector<std::string> details_;
+	};
+
+	// Gives access to the coordinates so that the synthetic points can be written in parallel.
+	class SyntheticCloud : public ccPointCloud {
+	public:
+		CCVector3* at(unsigned index) {
+			return point(index);
+		}
+	};
+
+	// Generates a curved double track corridor along the x-axis: two rails, the ballast bed and unstructured noise like vegetation or catenary.
+	// Every block of points has its own random generator seeded from the block index, so the cloud only depends on the seed and not on the number of threads.
+	buw::ReferenceCounted<SyntheticCloud> createCorridor(const unsigned numPoints, const BenchmarkDescription &desc) {
+		auto cloud = buw::makeReferenceCounted<SyntheticCloud>();
+		if(!cloud->resize(numPoints))
+			return nullptr;
+
+		const double gauge = 1.435, railHeadWidth = 0.067, railTop = 0.672;
+		const double ballastTopWidth = 3.0, ballastBottomWidth = 5.0, ballastHeight = 0.5;
+		const double amplitude = 20.0, wavelength = 2000.0;
+		const double railRatio = 0.15;
+		const long blockSize = 65536;
+		const long numBlocks = ((long)numPoints + blockSize - 1) / blockSize;
+
+#pragma omp parallel for schedule(dynamic, 4)
+		for(long block = 0; block < numBlocks; block++) {
+			std::mt19937_64 generator = std::mt19937_64(desc.seed * 0x9E3779B97F4A7C15ull + (uint64_t)block);
+			std::uniform_real_distribution<double> uniform = std::uniform_real_distribution<double>(0.0, 1.0);
+			std::normal_distribution<double> measurement = std::normal_distribution<double>(0.0, 0.005);
+
+			const long end = std::min((long)numPoints, (block + 1) * blockSize);
+			for(long i = block * blockSize; i < end; i++) {
+				const double x = uniform(generator) * desc.length;
+				const double type = uniform(generator);
+				double offset = 0.0, z = 0.0;
+
+				if(type < railRatio) {
+					// Rail head, left or right rail.
+					const double side = uniform(generator) < 0.5 ? -0.5 : 0.5;
+					offset = side * gauge + (uniform(generator) - 0.5) * railHeadWidth;
+					z = railTop;
+				}
+				else if(type < 1.0 - desc.noiseRatio) {
+					// Ballast bed with flat top and sloped shoulders.
+					offset = (uniform(generator) - 0.5) * ballastBottomWidth;
+					const double shoulder = std::max(0.0, std::abs(offset) - 0.5 * ballastTopWidth);
+					z = ballastHeight * (1.0 - shoulder / (0.5 * (ballastBottomWidth - ballastTopWidth)));
+				}
+				else {
+					offset = (uniform(generator) - 0.5) * 10.0;
+					z = uniform(generator) * 6.0 - 0.5;
+				}
+
+				// Move the point along the normal of the curved centerline.
+				const double slope = amplitude * 2.0 * M_PI / wavelength * std::cos(2.0 * M_PI * x / wavelength);
+				const double norm = std::sqrt(1.0 + slope * slope);
+				const double y = amplitude * std::sin(2.0 * M_PI * x / wavelength);
+				*cloud->at(i) = CCVector3(x - slope / norm * offset + measurement(generator), y + offset / norm + measurement(generator), z + measurement(generator));
+			}
+		}
+
+		cloud->invalidateBoundingBox();
+		return cloud;
+	}
+
+	std::vector<std::string> split(const std::string &value) {
+		std::vector<std::string> parts = std::vector<std::string>();
+		std::stringstream stream = std::stringstream(value);
+		std::string part;
+		while(std::getline(stream, part, ','))
+			parts.push_back(part);
+		return parts;
+	}
+
+	std::string escape(const std::string &value) {
+		std::string escaped;
+		for(char c : value) {
+			if(c == '"' || c == '\\')
+				escaped.push_back('\\');
+			escaped.push_back(c);
+		}
+		return escaped;
+	}
+
+	// Runs the processing chain of the user interface on one synthetic cloud and times every public operation.
+	RunResult runBenchmark(const unsigned numPoints, const int numThreads, const BenchmarkDescription &desc) {
+		omp_set_num_threads(numThreads);
+
+		RunResult run = { numPoints, numThreads, std::vector<OperationResult>() };
+		auto callback = std::make_shared<RecordingProgressCallback>();
+		buw::ReferenceCounted<SyntheticCloud> corridor = nullptr;
+		buw::ReferenceCounted<buw::PointCloud> pointCloud = nullptr;
+
+		auto time = [&](const std::string &name, const std::function<int()> &operation) {
+			auto start = std::chrono::steady_clock::now();
+			int result = operation();
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			run.operations.push_back({ name, seconds, result, callback->takeDetails() });
+			std::cout << numPoints << " points, " << numThreads << " threads: " << name << " took " << seconds << "s (" << result << ")." << std::endl;
+		};
+
+		time("generate", [&]() -> int {
+			corridor = createCorridor(numPoints, desc);
+			return corridor ? 0 : -1;
+		});
+		if(!corridor)
+			return run;
+
+		time("initialize", [&]() -> int {
+			pointCloud = buw::makeReferenceCounted<buw::PointCloud>();
+			return pointCloud->add(corridor, callback);
+		});
+		corridor = nullptr;
+
+		time("computeGrid", [&]() -> int {
+			buw::GridComputationDescription gridDesc;
+			pointCloud->computeGrid(gridDesc, callback);
+			return 0;
+		});
+
+		time("computeChainage", [&]() -> int {
+			buw::ChainageComputationDescription chainageDesc;
+			chainageDesc.base = OpenInfraPlatform::Infrastructure::Enums::eChainageComputationBase::Grid;
+			chainageDesc.interpolation = OpenInfraPlatform::Infrastructure::Enums::eChainageComputationInterpolationMethod::Linear;
+			pointCloud->computeChainage(chainageDesc, callback);
+			return 0;
+		});
+
+		buw::DuplicateFilterDescription duplicateDesc;
+		duplicateDesc.dim = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterDimension::Volume3D;
+		duplicateDesc.minDistance = 0.002;
+
+		buw::LocalDensityFilterDescription densityDesc;
+		densityDesc.dim = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterDimension::Volume3D;
+		densityDesc.kernelRadius = 0.1f;
+		densityDesc.minThreshold = 2.0f;
+		densityDesc.density = CCLib::GeometricalAnalysisTools::Density::DENSITY_KNN;
+
+		buw::PositionFilterDescription positionDesc;
+		positionDesc.dimension = 2;
+		positionDesc.minValue = -0.2;
+		positionDesc.maxValue = 1.5;
+
+		buw::RelativeHeightFilterDescription relativeHeightDesc;
+
+		time("applyDuplicateFilter", [&]() -> int { return pointCloud->applyDuplicateFilter(duplicateDesc, callback); });
+		time("applyLocalDensityFilter", [&]() -> int { return pointCloud->applyLocalDensityFilter(densityDesc, callback); });
+		time("applyPositionFilter", [&]() -> int { return pointCloud->applyPositionFilter(positionDesc, callback); });
+		time("applyRelativeHeightWithGridFilter", [&]() -> int { return pointCloud->applyRelativeHeightWithGridFilter(relativeHeightDesc, callback); });
+
+		// The same four filters evaluated in one pass, the single filter fields are removed first so that only the pipeline is measured.
+		for(const char* name : { "Duplicate", "Density", "Coord. X", "Coord. Y", "Coord. Z" }) {
+			int idx = pointCloud->getScalarFieldIndexByName(name);
+			if(idx != -1)
+				pointCloud->deleteScalarField(idx);
+		}
+
+		time("applyFilterPipeline", [&]() -> int {
+			buw::FilterPipelineDescription pipelineDesc;
+			buw::FilterPipelineStageDescription stage;
+			stage.type = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterType::DuplicateFilter;
+			stage.duplicate = duplicateDesc;
+			pipelineDesc.stages.push_back(stage);
+			stage.type = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterType::LocalDensityFilter;
+			stage.localDensity = densityDesc;
+			pipelineDesc.stages.push_back(stage);
+			stage.type = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterType::PositionFilter;
+			stage.position = positionDesc;
+			pipelineDesc.stages.push_back(stage);
+			stage.type = OpenInfraPlatform::Infrastructure::Enums::ePointCloudFilterType::RelativeHeightFilter;
+			stage.relativeHeight = relativeHeightDesc;
+			pipelineDesc.stages.push_back(stage);
+			return pointCloud->applyFilterPipeline(pipelineDesc, callback);
+		});
+
+		buw::PercentileSegmentationDescription percentileDesc;
+		percentileDesc.kernelRadius = 0.5f;
+		percentileDesc.lowerPercentile = 0.05;
+		percentileDesc.upperPercentile = 0.95;
+		percentileDesc.minThreshold = 0.1f;
+		percentileDesc.maxThreshold = 0.5f;
+
+		time("applyPercentilesSegmentation", [&]() -> int { return pointCloud->applyPercentilesSegmentation(percentileDesc, callback); });
+		time("applyPercentilesSegmentationHP", [&]() -> int { return pointCloud->applyPercentilesSegmentationHP(percentileDesc, callback); });
+
+		percentileDesc.method = OpenInfraPlatform::Infrastructure::Enums::ePercentileComputationMethod::Approximate;
+		time("applyPercentilesSegmentationApproximate", [&]() -> int { return pointCloud->applyPercentilesSegmentation(percentileDesc, callback); });
+
+		time("computeSections", [&]() -> int {
+			pointCloud->computeSections(10.0f, callback);
+			return (int)pointCloud->getSections().size();
+		});
+
+		time("computePairs", [&]() -> int {
+			buw::PairComputationDescription pairDesc;
+			std::vector<std::pair<size_t, size_t>> pairs = std::vector<std::pair<size_t, size_t>>();
+			pointCloud->computePairs(pairDesc, pairs, callback);
+			return (int)pairs.size();
+		});
+
+		time("computeCenterlines", [&]() -> int {
+			buw::CenterlineComputationDescription centerlineDesc;
+			return pointCloud->computeCenterlines(centerlineDesc, callback);
+		});
+
+		return run;
+	}
+
+	void writeJson(const std::vector<RunResult> &runs, const BenchmarkDescription &desc) {
+		std::ofstream file = std::ofstream(desc.output);
+		file << "{" << std::endl;
+		file << "\t\"benchmark\": \"PointCloudProcessing\"," << std::endl;
+		file << "\t\"timestamp\": " << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() << "," << std::endl;
+		file << "\t\"corridorLength\": " << desc.length << "," << std::endl;
+		file << "\t\"noiseRatio\": " << desc.noiseRatio << "," << std::endl;
+		file << "\t\"seed\": " << desc.seed << "," << std::endl;
+		file << "\t\"runs\": [" << std::endl;
+		for(size_t r = 0; r < runs.size(); r++) {
+			const RunResult &run = runs[r];
+			file << "\t\t{" << std::endl;
+			file << "\t\t\t\"points\": " << run.points << "," << std::endl;
+			file << "\t\t\t\"pointsPerMeter\": " << run.points / desc.length << "," << std::endl;
+			file << "\t\t\t\"threads\": " << run.threads << "," << std::endl;
+			file << "\t\t\t\"operations\": [" << std::endl;
+			for(size_t o = 0; o < run.operations.size(); o++) {
+				const OperationResult &operation = run.operations[o];
+				file << "\t\t\t\t{ \"name\": \"" << escape(operation.name) << "\", \"seconds\": " << operation.seconds << ", \"result\": " << operation.result << ", \"details\": [";
+				for(size_t d = 0; d < operation.details.size(); d++)
+					file << (d > 0 ? ", " : "") << "\"" << escape(operation.details[d]) << "\"";
+				file << "] }" << (o + 1 < run.operations.size() ? "," : "") << std::endl;
+			}
+			file << "\t\t\t]" << std::endl;
+			file << "\t\t}" << (r + 1 < runs.size() ? "," : "") << std::endl;
+		}
+		file << "\t]" << std::endl;
+		file << "}" << std::endl;
+	}
+}
+
+// Usage: PointCloudProcessingBenchmark [--points 100000,1000000] [--threads 1,8] [--length 1000] [--noise 0.1] [--seed 42] [--output result.json]
+int main(int argc, char** argv) {
+	BenchmarkDescription desc;
+	for(int i = 1; i + 1 < argc; i += 2) {
+		const std::string option = argv[i], value = argv[i + 1];
+		if(option == "--points") {
+			desc.points.clear();
+			for(const auto &part : split(value))
+				desc.points.push_back((unsigned)std::stoull(part));
+		}
+		else if(option == "--threads") {
+			desc.threads.clear();
+			for(const auto &part : split(value))
+				desc.threads.push_back(std::stoi(part));
+		}
+		else if(option == "--length")
+			desc.length = std::stod(value);
+		else if(option == "--noise")
+			desc.noiseRatio = std::stod(value);
+		else if(option == "--seed")
+			desc.seed = std::stoull(value);
+		else if(option == "--output")
+			desc.output = value;
+		else {
+			std::cerr << "Unknown option " << option << "." << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<RunResult> runs = std::vector<RunResult>();
+	for(unsigned numPoints : desc.points) {
+		for(int numThreads : desc.threads)
+			runs.push_back(runBenchmark(numPoints, numThreads, desc));
+	}
+
+	writeJson(runs, desc);
+
+	// Fail if a run could not process its cloud so that the smoke test catches it.
+	for(const auto &run : runs) {
+		if(run.operations.size() < 2 || run.operations[0].result != 0 || run.operations[1].result != 0)
+			return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace
+{
+	// Heights x + 10 y + x y at the samples, which bilinear interpolation reproduces exactly between them.
+	double getSampleHeight(const double x, const double y)
+	{
+		return x + 10.0 * y + x * y;
+	}
+
+	// 4 x 3 samples with a spacing of 2 starting at (10, 20).
+	buw::RasterSurface createRaster()
+	{
+		buw::RasterSurface raster(4, 3, buw::Vector2d(10.0, 20.0), 2.0);
+		for (int y = 0; y < raster.getHeight(); y++)
+		{
+			for (int x = 0; x < raster.getWidth(); x++)
+				raster.setHeight(x, y, static_cast<float>(getSampleHeight(x, y)));
+		}
+		return raster;
+	}
+}
+
+TEST(RasterSurface, SamplesAreLaidOutRowByRow)
+{
+	buw::RasterSurface raster = createRaster();
+	EXPECT_EQ(4, raster.getWidth());
+	EXPECT_EQ(3, raster.getHeight());
+	ASSERT_EQ(12u, raster.getHeights().size());
+	EXPECT_EQ(static_cast<float>(getSampleHeight(3, 1)), raster.getHeights()[7]);
+
+	EXPECT_EQ(buw::Vector3d(10.0, 20.0, 0.0), raster.getBoundsMin());
+	EXPECT_EQ(buw::Vector3d(16.0, 24.0, getSampleHeight(3, 2)), raster.getBoundsMax());
+
+	// Samples without data are NaN and do not count for the bounds.
+	buw::RasterSurface empty(2, 2, buw::Vector2d(0.0, 0.0), 1.0);
+	EXPECT_TRUE(empty.isNoData(1, 1));
+	empty.setHeight(1, 1, 3.0f);
+	empty.setHeight(0, 1, 5.0f);
+	empty.setNoData(0, 1);
+	EXPECT_FALSE(empty.isNoData(1, 1));
+	EXPECT_TRUE(empty.isNoData(0, 1));
+	EXPECT_EQ(3.0, empty.getBoundsMin().z());
+	EXPECT_EQ(3.0, empty.getBoundsMax().z());
+}
+
+TEST(RasterSurface, HeightsAreInterpolatedBilinearly)
+{
+	buw::RasterSurface raster = createRaster();
+
+	// At the samples, including the last row and column.
+	for (int y = 0; y < raster.getHeight(); y++)
+	{
+		for (int x = 0; x < raster.getWidth(); x++)
+		{
+			double z = -1.0;
+			ASSERT_TRUE(raster.tryGetZ(buw::Vector2d(10.0 + 2.0 * x, 20.0 + 2.0 * y), z));
+			EXPECT_DOUBLE_EQ(getSampleHeight(x, y), z);
+		}
+	}
+
+	// Between the samples.
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> distribution(0.0, 1.0);
+	for (int i = 0; i < 100; i++)
+	{
+		const double fx = 3.0 * distribution(generator);
+		const double fy = 2.0 * distribution(generator);
+		const buw::Vector2d xy(10.0 + 2.0 * fx, 20.0 + 2.0 * fy);
+		double z = 0.0;
+		ASSERT_TRUE(raster.tryGetZ(xy, z));
+		EXPECT_NEAR(getSampleHeight(fx, fy), z, 1e-9);
+		EXPECT_EQ(z, raster.getZ(xy));
+	}
+
+	// Outside of the raster.
+	double z = -1.0;
+	for (const buw::Vector2d& xy : { buw::Vector2d(9.9, 21.0), buw::Vector2d(16.1, 21.0), buw::Vector2d(12.0, 19.9), buw::Vector2d(12.0, 24.1) })
+	{
+		EXPECT_FALSE(raster.contains(xy));
+		EXPECT_FALSE(raster.tryGetZ(xy, z));
+		EXPECT_EQ(0.0, raster.getZ(xy));
+	}
+	EXPECT_EQ(-1.0, z);
+}
+
+TEST(RasterSurface, CellsWithoutDataAreLeftOut)
+{
+	buw::RasterSurface raster = createRaster();
+	raster.setNoData(1, 1);
+
+	// The four cells around the sample have no height, the two of the last column do.
+	double z = 0.0;
+	EXPECT_FALSE(raster.tryGetZ(buw::Vector2d(11.0, 21.0), z));
+	EXPECT_FALSE(raster.tryGetZ(buw::Vector2d(13.9, 23.0), z));
+	EXPECT_TRUE(raster.tryGetZ(buw::Vector2d(15.0, 21.0), z));
+	EXPECT_NEAR(getSampleHeight(2.5, 0.5), z, 1e-9);
+
+	buw::ReferenceCounted<buw::Surface> surface = raster.createSurface();
+	EXPECT_EQ(12, surface->getPointCount());
+	EXPECT_EQ(4u, surface->getTriangeFaces().size());
+
+	// Tiles of two cells share their border samples.
+	raster.setHeight(1, 1, static_cast<float>(getSampleHeight(1, 1)));
+	const std::vector<buw::ReferenceCounted<buw::Surface>> tiles = raster.createTiles(2);
+	ASSERT_EQ(2u, tiles.size());
+	EXPECT_EQ(9, tiles[0]->getPointCount());
+	EXPECT_EQ(8u, tiles[0]->getTriangeFaces().size());
+	EXPECT_EQ(6, tiles[1]->getPointCount());
+	EXPECT_EQ(4u, tiles[1]->getTriangeFaces().size());
+}
+
+TEST(RasterSurface, HeightmapIsCenteredOnTheRaster)
+{
+	buw::Image<buw::Color1f> image(5, 4);
+	for (int y = 0; y < image.getHeight(); y++)
+	{
+		for (int x = 0; x < image.getWidth(); x++)
+			image.setPixelColor(x, y, buw::Color1f(static_cast<float>(x + 5 * y)));
+	}
+
+	std::unique_ptr<buw::RasterSurface> raster(buw::RasterSurface::createFromHeightmap(image, 0.5, buw::Vector2d(100.0, 200.0)));
+	EXPECT_EQ(std::string("Heightmap terrain"), raster->getName());
+	ASSERT_EQ(5, raster->getWidth());
+	ASSERT_EQ(4, raster->getHeight());
+	EXPECT_EQ(0.5, raster->getCellSize());
+	EXPECT_EQ(buw::Vector2d(98.75, 199.0), raster->getOrigin());
+	for (int y = 0; y < image.getHeight(); y++)
+	{
+		for (int x = 0; x < image.getWidth(); x++)
+			EXPECT_EQ(static_cast<float>(x + 5 * y), raster->getHeight(x, y));
+	}
+
+	double z = 0.0;
+	ASSERT_TRUE(raster->tryGetZ(buw::Vector2d(100.0, 200.0), z));
+	EXPECT_DOUBLE_EQ(2.5 + 5.0 * 2.0, z);
+}
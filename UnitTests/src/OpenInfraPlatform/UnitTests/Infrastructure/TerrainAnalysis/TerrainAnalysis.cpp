@@ -0,0 +1,152 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainAnalysis.h"
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	buw::RasterSurface createRaster(const int size, const std::function<double(double, double)>& height)
+	{
+		buw::RasterSurface raster(size, size, buw::Vector2d(0.0, 0.0), 2.0);
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+				raster.setHeight(x, y, static_cast<float>(height(2.0 * x, 2.0 * y)));
+		}
+		return raster;
+	}
+}
+
+TEST(TerrainAnalysis, PlaneGivesConstantSlopeAndAspect)
+{
+	// Rises to the east and north, so it faces south-west.
+	buw::RasterSurface raster = createRaster(20, [](double x, double y) { return 0.5 * x + 0.2 * y; });
+
+	buw::TerrainLayer slope = buw::computeSlope(raster);
+	buw::TerrainLayer aspect = buw::computeAspect(raster);
+	ASSERT_EQ(20, slope.width);
+	ASSERT_EQ(400, slope.values.size());
+
+	// The borders use one sided differences, which are exact for a plane as well.
+	const double expectedSlope = std::atan(std::sqrt(0.25 + 0.04)) * 180.0 / 3.14159265358979;
+	const double expectedAspect = 360.0 + std::atan2(-0.5, -0.2) * 180.0 / 3.14159265358979;
+	for (size_t i = 0; i < slope.values.size(); i++)
+	{
+		EXPECT_NEAR(expectedSlope, slope.values[i], 1e-3);
+		EXPECT_NEAR(expectedAspect, aspect.values[i], 1e-3);
+	}
+
+	buw::TerrainAnalysisDescription desc;
+	desc.zFactor = 2.0;
+	EXPECT_NEAR(std::atan(2.0 * std::sqrt(0.29)) * 180.0 / 3.14159265358979, buw::computeSlope(raster, desc).getValue(7, 3), 1e-3);
+
+	buw::RasterSurface flat = createRaster(5, [](double, double) { return 3.0; });
+	EXPECT_EQ(0.0f, buw::computeSlope(flat).getValue(2, 2));
+	EXPECT_EQ(-1.0f, buw::computeAspect(flat).getValue(2, 2));
+}
+
+TEST(TerrainAnalysis, HillshadeFacesTheLight)
+{
+	buw::TerrainAnalysisDescription desc;
+	desc.azimuth = 270.0;
+	desc.altitude = 45.0;
+
+	// Flat terrain gets the sine of the altitude, a slope of 45 degrees towards the light is lit fully and one away from it is in the shadow.
+	buw::RasterSurface flat = createRaster(5, [](double, double) { return 0.0; });
+	EXPECT_NEAR(std::sqrt(0.5), buw::computeHillshade(flat, desc).getValue(2, 2), 1e-6);
+
+	buw::RasterSurface west = createRaster(5, [](double x, double) { return x; });
+	EXPECT_NEAR(1.0, buw::computeHillshade(west, desc).getValue(2, 2), 1e-6);
+
+	buw::RasterSurface east = createRaster(5, [](double x, double) { return -x; });
+	EXPECT_EQ(0.0f, buw::computeHillshade(east, desc).getValue(2, 2));
+
+	// Samples without data and their neighbours have no data.
+	flat.setNoData(2, 2);
+	buw::TerrainLayer shade = buw::computeHillshade(flat, desc);
+	EXPECT_TRUE(std::isnan(shade.getValue(2, 2)));
+	EXPECT_TRUE(std::isnan(shade.getValue(1, 3)));
+	EXPECT_NEAR(std::sqrt(0.5), shade.getValue(0, 0), 1e-6);
+}
+
+TEST(TerrainAnalysis, FlowFollowsTheValley)
+{
+	// A valley along x = 20 going down to the south.
+	buw::RasterSurface raster = createRaster(21, [](double x, double y) { return std::abs(x - 20.0) + 0.1 * y; });
+
+	buw::TerrainLayer direction = buw::computeFlowDirection(raster);
+	EXPECT_EQ(1.0f, direction.getValue(5, 5));
+	EXPECT_EQ(16.0f, direction.getValue(15, 5));
+	EXPECT_EQ(4.0f, direction.getValue(10, 5));
+	EXPECT_EQ(0.0f, direction.getValue(10, 0));
+
+	buw::TerrainAnalysisDescription desc;
+	desc.tileRows = 3;
+	for (int threads = 1; threads <= 4; threads *= 2)
+	{
+		desc.threadCount = threads;
+		buw::TerrainLayer accumulation = buw::computeFlowAccumulation(raster, desc);
+		for (int y = 0; y < 21; y++)
+		{
+			EXPECT_EQ(21.0f * (21 - y), accumulation.getValue(10, y));
+			EXPECT_EQ(1.0f, accumulation.getValue(0, y));
+			EXPECT_EQ(10.0f, accumulation.getValue(9, y));
+		}
+	}
+}
+
+TEST(TerrainAnalysis, SurfaceIsRasterizedAndExportedAsImage)
+{
+	std::vector<buw::Vector3d> points = { buw::Vector3d(0, 0, 1), buw::Vector3d(10, 0, 2), buw::Vector3d(0, 10, 3), buw::Vector3d(10, 10, 4) };
+	buw::ReferenceCounted<buw::Surface> surface = std::make_shared<buw::Surface>();
+	surface->setPoints(points);
+	surface->setTriangles({ buw::Vector3i(0, 1, 2) });
+
+	buw::ReferenceCounted<buw::RasterSurface> raster = buw::createRasterSurface(*surface, 1.0);
+	ASSERT_EQ(11, raster->getWidth());
+	ASSERT_EQ(11, raster->getHeight());
+	EXPECT_FLOAT_EQ(1.0f, raster->getHeight(0, 0));
+	EXPECT_FLOAT_EQ(1.0f + 0.1f * 4 + 0.2f * 3, raster->getHeight(4, 3));
+	EXPECT_TRUE(raster->isNoData(10, 10));
+
+	// The model uses its surfaces with priorities.
+	buw::DigitalElevationModel dem;
+	dem.addSurface(surface);
+	buw::ReferenceCounted<buw::RasterSurface> fromModel = dem.createRasterSurface(1.0);
+	ASSERT_EQ(11, fromModel->getWidth());
+	EXPECT_FLOAT_EQ(raster->getHeight(4, 3), fromModel->getHeight(4, 3));
+
+	buw::TerrainLayer slope = buw::computeSlope(*raster);
+	buw::Image4b image = buw::createTerrainImage(slope, 0.0, 90.0);
+	ASSERT_EQ(11, image.getWidth());
+
+	// The southern row is at the bottom of the image, samples without data are transparent.
+	const int grey = static_cast<int>(255.0 * slope.getValue(2, 0) / 90.0 + 0.5);
+	EXPECT_EQ(grey, image.getPixelColor(2, 10)[0]);
+	EXPECT_EQ(255, image.getPixelColor(2, 10)[3]);
+	EXPECT_EQ(0, image.getPixelColor(10, 0)[3]);
+
+	buw::Image4b heat = buw::createTerrainImage(slope, 0.0, 90.0, buw::eTerrainColorRamp::Heat);
+	EXPECT_EQ(255, heat.getPixelColor(2, 10)[3]);
+}
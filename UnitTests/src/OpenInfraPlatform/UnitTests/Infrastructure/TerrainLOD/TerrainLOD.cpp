@@ -0,0 +1,218 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainLOD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	// Hilly grid terrain with some noise and a hole, so tiles have inner borders as well.
+	buw::Surface createTerrain(const int size)
+	{
+		std::vector<buw::Vector3d> points;
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+				points.push_back(buw::Vector3d(x, y, 10.0 * std::sin(x * 0.05) * std::cos(y * 0.07) + 0.3 * std::sin(x * 0.9 + y * 1.3)));
+		}
+
+		std::vector<buw::Vector3i> triangles;
+		for (int y = 0; y < size - 1; y++)
+		{
+			for (int x = 0; x < size - 1; x++)
+			{
+				if (x > size / 3 && x < size / 2 && y > size / 3 && y < size / 2)
+					continue;
+
+				triangles.push_back(buw::Vector3i(y * size + x, y * size + x + 1, (y + 1) * size + x));
+				triangles.push_back(buw::Vector3i(y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x));
+			}
+		}
+
+		buw::Surface surface;
+		surface.setPoints(points);
+		surface.setTriangles(triangles);
+		return surface;
+	}
+
+	double area(const buw::Vector3d& a, const buw::Vector3d& b, const buw::Vector3d& c)
+	{
+		return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+	}
+
+	// Returns the triangles which are not part of the skirts.
+	std::vector<buw::Vector3i> getTopTriangles(const buw::TerrainLODMesh& mesh)
+	{
+		std::vector<buw::Vector3i> triangles;
+		for (const buw::Vector3i& t : mesh.triangles)
+		{
+			if (std::abs(area(mesh.points[t[0]], mesh.points[t[1]], mesh.points[t[2]])) > 1e-12)
+				triangles.push_back(t);
+		}
+		return triangles;
+	}
+
+	TEST(TerrainLOD, Levels)
+	{
+		buw::Surface surface = createTerrain(129);
+
+		buw::TerrainLODDescription desc;
+		desc.tileSize = 32.0;
+		desc.levelCount = 4;
+		desc.maximumError = 0.05;
+		buw::TerrainLOD lod(surface, desc);
+
+		EXPECT_EQ(lod.getTileCount(), 16);
+		EXPECT_EQ(lod.getLevelCount(), 4);
+
+		size_t triangleCount = 0;
+		for (int tile = 0; tile < lod.getTileCount(); tile++)
+			triangleCount += getTopTriangles(lod.getMesh(tile, 0)).size();
+		EXPECT_EQ(triangleCount, static_cast<size_t>(surface.getTriangleCount()));
+
+		for (int tile = 0; tile < lod.getTileCount(); tile++)
+		{
+			for (int level = 1; level < lod.getLevelCount(); level++)
+			{
+				EXPECT_DOUBLE_EQ(lod.getMesh(tile, level).error, desc.maximumError * std::pow(2.0, level - 1));
+				EXPECT_LE(getTopTriangles(lod.getMesh(tile, level)).size(), getTopTriangles(lod.getMesh(tile, level - 1)).size());
+			}
+			EXPECT_LT(getTopTriangles(lod.getMesh(tile, lod.getLevelCount() - 1)).size(), getTopTriangles(lod.getMesh(tile, 0)).size());
+		}
+	}
+
+	TEST(TerrainLOD, ErrorBound)
+	{
+		buw::Surface surface = createTerrain(129);
+
+		buw::TerrainLODDescription desc;
+		desc.tileSize = 32.0;
+		desc.maximumError = 0.05;
+		buw::TerrainLOD lod(surface, desc);
+
+		for (int tile = 0; tile < lod.getTileCount(); tile++)
+		{
+			const buw::TerrainLODMesh& original = lod.getMesh(tile, 0);
+			const std::vector<buw::Vector3i> originalTriangles = getTopTriangles(original);
+
+			for (int level = 1; level < lod.getLevelCount(); level++)
+			{
+				const buw::TerrainLODMesh& mesh = lod.getMesh(tile, level);
+				const std::vector<buw::Vector3i> triangles = getTopTriangles(mesh);
+
+				// The grid triangles are counter-clockwise, the simplification must not flip them.
+				for (const buw::Vector3i& t : triangles)
+					EXPECT_GT(area(mesh.points[t[0]], mesh.points[t[1]], mesh.points[t[2]]), 0.0);
+
+				// Each point of the tile has to be within the error of the simplified mesh, points outside of the moved border are skipped.
+				for (const buw::Vector3i& o : originalTriangles)
+				{
+					for (int k = 0; k < 3; k++)
+					{
+						const buw::Vector3d& p = original.points[o[k]];
+						for (const buw::Vector3i& t : triangles)
+						{
+							const buw::Vector3d& a = mesh.points[t[0]];
+							const buw::Vector3d& b = mesh.points[t[1]];
+							const buw::Vector3d& c = mesh.points[t[2]];
+							const double l0 = area(p, b, c) / area(a, b, c);
+							const double l1 = area(a, p, c) / area(a, b, c);
+							const double l2 = 1.0 - l0 - l1;
+							if (std::min(l0, std::min(l1, l2)) >= -1e-9)
+							{
+								EXPECT_LE(std::abs(l0 * a.z() + l1 * b.z() + l2 * c.z() - p.z()), mesh.error + 1e-9);
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	TEST(TerrainLOD, Skirts)
+	{
+		buw::Surface surface = createTerrain(65);
+
+		buw::TerrainLODDescription desc;
+		desc.tileSize = 32.0;
+		buw::TerrainLOD lod(surface, desc);
+
+		// Every edge of a mesh with skirts is shared by two triangles.
+		for (int tile = 0; tile < lod.getTileCount(); tile++)
+		{
+			for (int level = 0; level < lod.getLevelCount(); level++)
+			{
+				std::vector<std::pair<int, int>> edges;
+				for (const buw::Vector3i& t : lod.getMesh(tile, level).triangles)
+				{
+					for (int k = 0; k < 3; k++)
+						edges.push_back(std::make_pair(std::min(t[k], t[(k + 1) % 3]), std::max(t[k], t[(k + 1) % 3])));
+				}
+				std::sort(edges.begin(), edges.end());
+
+				int open = 0;
+				for (size_t i = 0; i < edges.size();)
+				{
+					size_t j = i + 1;
+					while (j < edges.size() && edges[j] == edges[i])
+						j++;
+					if (j - i == 1)
+						open++;
+					i = j;
+				}
+
+				// Only the bottom edges of the skirts remain open.
+				const buw::TerrainLODMesh& mesh = lod.getMesh(tile, level);
+				const std::vector<buw::Vector3i> top = getTopTriangles(mesh);
+				EXPECT_EQ(open, static_cast<int>(mesh.triangles.size() - top.size()) / 2);
+			}
+		}
+	}
+
+	TEST(TerrainLOD, SelectLevels)
+	{
+		buw::Surface surface = createTerrain(129);
+
+		buw::TerrainLODDescription desc;
+		desc.tileSize = 32.0;
+		buw::TerrainLOD lod(surface, desc);
+
+		std::vector<int> levels = lod.selectLevels(buw::Vector3d(16.0, 16.0, 0.0), 1e-3);
+		ASSERT_EQ(levels.size(), static_cast<size_t>(lod.getTileCount()));
+
+		// The tile below the camera is drawn in full detail, the others get coarser with the distance.
+		for (int tile = 0; tile < lod.getTileCount(); tile++)
+		{
+			buw::Vector3d min, max;
+			lod.getTileBounds(tile, min, max);
+			if (min.x() <= 16.0 && max.x() >= 16.0 && min.y() <= 16.0 && max.y() >= 16.0)
+				EXPECT_EQ(levels[tile], 0);
+		}
+
+		levels = lod.selectLevels(buw::Vector3d(0.0, 0.0, 1e6), 1e-3);
+		for (int level : levels)
+			EXPECT_EQ(level, lod.getLevelCount() - 1);
+	}
+}
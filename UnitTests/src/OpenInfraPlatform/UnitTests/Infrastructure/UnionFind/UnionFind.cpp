@@ -0,0 +1,84 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "OpenInfraPlatform/Infrastructure/PointCloudProcessing/UnionFind.h"
+
+#include <omp.h>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST(UnionFind, RootIsTheSmallestElement)
+{
+	buw::ConcurrentUnionFind unionFind(10);
+	EXPECT_EQ(10u, unionFind.size());
+	for (uint32_t i = 0; i < 10; i++)
+		EXPECT_EQ(i, unionFind.find(i));
+
+	// Two sets {2, 5, 7, 9} and {3, 4}, united in an order which links larger roots first.
+	unionFind.unite(9, 7);
+	unionFind.unite(7, 5);
+	unionFind.unite(5, 2);
+	unionFind.unite(4, 3);
+	unionFind.unite(9, 2);
+
+	for (uint32_t i : { 2, 5, 7, 9 })
+		EXPECT_EQ(2u, unionFind.find(i));
+	for (uint32_t i : { 3, 4 })
+		EXPECT_EQ(3u, unionFind.find(i));
+	for (uint32_t i : { 0, 1, 6, 8 })
+		EXPECT_EQ(i, unionFind.find(i));
+
+	unionFind.unite(4, 9);
+	for (uint32_t i : { 2, 3, 4, 5, 7, 9 })
+		EXPECT_EQ(2u, unionFind.find(i));
+}
+
+TEST(UnionFind, ConcurrentUnionsMatchSequentialOnes)
+{
+	// Random edges between 100000 elements, few enough that many components remain.
+	const uint32_t size = 100000;
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<uint32_t> distribution(0, size - 1);
+	std::vector<std::pair<uint32_t, uint32_t>> edges(60000);
+	for (auto& edge : edges)
+		edge = std::make_pair(distribution(generator), distribution(generator));
+
+	buw::ConcurrentUnionFind sequential(size);
+	for (const auto& edge : edges)
+		sequential.unite(edge.first, edge.second);
+
+	buw::ConcurrentUnionFind concurrent(size);
+#pragma omp parallel for num_threads(8) schedule(dynamic, 64)
+	for (long i = 0; i < (long)edges.size(); i++)
+		concurrent.unite(edges[i].first, edges[i].second);
+
+	// Both give the smallest element of each set as root, so the roots are the same and not only the partition.
+	size_t numComponents = 0;
+	for (uint32_t i = 0; i < size; i++)
+	{
+		const uint32_t root = sequential.find(i);
+		ASSERT_EQ(root, concurrent.find(i));
+		EXPECT_LE(root, i);
+		numComponents += root == i ? 1 : 0;
+	}
+	EXPECT_LT(1u, numComponents);
+	EXPECT_GT(size, numComponents);
+}
@@ -16,9 +16,13 @@
 */
 
 #include "buw.OIPInfrastructure.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainAnalysis.h"
 #include <tclap/CmdLine.h>
 #include <BlueFramework/Core/Diagnostics/log.h>
 #include <BlueFramework/Core/version.h>
+#include <BlueFramework/ImageProcessing/io.h>
+#include <fstream>
 #include <iomanip>
 
 void convertLandXMLtoIfcAlignment1x1ExcelComparison(const char* inputFilename, const char* outputFilename) {
@@ -76,7 +80,7 @@ void convertLandXMLtoIfcAlignment1x1(const std::string& inputFilename, const std
 	buw::ExportIfc4x1 ifcExport(desc, parser.getAlignmentModel(), dem, outputFilename);
 }
 
-void convertLandXMLtoSVG(const std::string& inputFilename, const std::string& outputFilename) {
+void convertLandXMLtoSVG(const std::string& inputFilename, const std::string& outputFilename, const double contourInterval) {
 	buw::ImportLandXml parser(inputFilename);
 
 	buw::ReferenceCounted<buw::DigitalElevationModel> dem = std::make_shared<buw::DigitalElevationModel>();
@@ -87,7 +91,97 @@ void convertLandXMLtoSVG(const std::string& inputFilename, const std::string& ou
 		}
 	}
 
-	buw::ExportSVG svgExport(parser.getAlignmentModel(), dem, outputFilename);
+	if (contourInterval > 0.0) {
+		buw::ContourDescription contours;
+		contours.interval = contourInterval;
+		buw::ExportSVG svgExport(parser.getAlignmentModel(), dem, outputFilename, contours);
+	}
+	else {
+		buw::ExportSVG svgExport(parser.getAlignmentModel(), dem, outputFilename);
+	}
+}
+
+void convertLandXMLtoDXF(const std::string& inputFilename, const std::string& outputFilename, const double contourInterval) {
+	buw::ImportLandXml parser(inputFilename);
+
+	buw::ReferenceCounted<buw::DigitalElevationModel> dem = std::make_shared<buw::DigitalElevationModel>();
+
+	if (parser.getDigitalElevationModel()) {
+		for (int i = 0; i < parser.getDigitalElevationModel()->getSurfaceCount(); i++) {
+			dem->addSurface(parser.getDigitalElevationModel()->getSurface(i));
+		}
+	}
+
+	buw::ContourDescription contours;
+	contours.interval = contourInterval;
+	buw::ExportDXF dxfExport(parser.getAlignmentModel(), dem, outputFilename, contours);
+}
+
+// Writes cut, fill and mass haul of each alignment per station interval as CSV. Without a design surface the road bodies of the cross sections are used.
+void computeEarthworkFromLandXML(const std::string& inputFilename, const std::string& outputFilename, const buw::EarthworkDescription& desc, const std::string& designSurfaceName) {
+	buw::ImportLandXml parser(inputFilename);
+
+	buw::ReferenceCounted<buw::DigitalElevationModel> dem = std::make_shared<buw::DigitalElevationModel>();
+	buw::ReferenceCounted<buw::Surface> design = nullptr;
+
+	if (parser.getDigitalElevationModel()) {
+		for (int i = 0; i < parser.getDigitalElevationModel()->getSurfaceCount(); i++) {
+			buw::ReferenceCounted<buw::Surface> surface = parser.getDigitalElevationModel()->getSurface(i);
+			if (!designSurfaceName.empty() && designSurfaceName == surface->getName())
+				design = surface;
+			else
+				dem->addSurface(surface);
+		}
+	}
+
+	if (!designSurfaceName.empty() && !design) {
+		BLUE_LOG(error) << "Design surface " << designSurfaceName << " not found.";
+		return;
+	}
+
+	std::ofstream file(outputFilename);
+	file << "Alignment;StartStation;EndStation;Cut;Fill;MassOrdinate" << std::endl;
+	file << std::fixed << std::setprecision(3);
+
+	buw::ReferenceCounted<buw::AlignmentModel> alignmentModel = parser.getAlignmentModel();
+	for (int i = 0; i < alignmentModel->getAlignmentCount(); i++) {
+		buw::ReferenceCounted<buw::IAlignment3D> alignment = alignmentModel->getAlignment(i);
+
+		buw::EarthworkResult result;
+		if (design)
+			result = dem->computeEarthwork(alignment, design, desc);
+		else if (alignment->getType() == buw::e3DAlignmentType::e2DBased)
+			result = dem->computeEarthwork(std::static_pointer_cast<buw::Alignment2DBased3D>(alignment), desc);
+		else
+			continue;
+
+		const std::string name = alignment->getName().toStdString();
+		for (const buw::EarthworkInterval& interval : result.intervals)
+			file << name << ";" << interval.startStation << ";" << interval.endStation << ";" << interval.cut << ";" << interval.fill << ";" << interval.massOrdinate << std::endl;
+
+		BLUE_LOG(info) << name << ": cut " << result.cut << ", fill " << result.fill;
+	}
+}
+
+// Writes the hill-shade of the surfaces sampled in cells of the given size as image.
+void exportHillshadeFromLandXML(const std::string& inputFilename, const std::string& outputFilename, const double cellSize) {
+	buw::ImportLandXml parser(inputFilename);
+
+	buw::DigitalElevationModel dem;
+	if (parser.getDigitalElevationModel()) {
+		for (int i = 0; i < parser.getDigitalElevationModel()->getSurfaceCount(); i++) {
+			dem.addSurface(parser.getDigitalElevationModel()->getSurface(i));
+		}
+	}
+
+	if (!dem.hasSurfaces()) {
+		BLUE_LOG(error) << "No surfaces found.";
+		return;
+	}
+
+	buw::ReferenceCounted<buw::RasterSurface> raster = dem.createRasterSurface(cellSize);
+	buw::TerrainLayer hillshade = buw::computeHillshade(*raster);
+	buw::storeImage(outputFilename.c_str(), buw::createTerrainImage(hillshade, 0.0, 1.0));
 }
 
 int main(int argc, char* argv[]) {
@@ -105,6 +199,9 @@ int main(int argc, char* argv[]) {
 		allowed.push_back("IfcAlignment1x1");
 		allowed.push_back("IfcAlignment1x1_XLSX");
 		allowed.push_back("SVG");
+		allowed.push_back("Earthwork");
+		allowed.push_back("DXF");
+		allowed.push_back("Hillshade");
 		TCLAP::ValuesConstraint<std::string> allowedVals(allowed);
 
 		TCLAP::ValueArg<std::string> nameArg("t", "exportType", "Export type that should be used", true, "IfcAlignment1x0", &allowedVals);
@@ -118,6 +215,22 @@ int main(int argc, char* argv[]) {
 		TCLAP::ValueArg<std::string> nameInputArg("i", "input", "Path to input file", true, "text.xml", "string");
 		cmd.add(nameInputArg);
 
+		TCLAP::ValueArg<double> contourIntervalArg("", "contourInterval", "Height difference of the contours in SVG and DXF exports, 0 exports no contours", false, 0.0, "double");
+		cmd.add(contourIntervalArg);
+
+		// Options of the earthwork computation.
+		TCLAP::ValueArg<double> intervalArg("", "interval", "Length of the earthwork station intervals", false, 20.0, "double");
+		cmd.add(intervalArg);
+
+		TCLAP::ValueArg<double> cellSizeArg("", "cellSize", "Cell size of the earthwork computation and the hill-shade raster", false, 0.5, "double");
+		cmd.add(cellSizeArg);
+
+		TCLAP::ValueArg<double> corridorWidthArg("", "corridorWidth", "Width of the earthwork corridor to each side of the alignment", false, 50.0, "double");
+		cmd.add(corridorWidthArg);
+
+		TCLAP::ValueArg<std::string> designArg("", "design", "Name of the design surface, by default the road bodies of the cross sections are used", false, "", "string");
+		cmd.add(designArg);
+
 		// Parse the args.
 		cmd.parse(argc, argv);
 
@@ -135,12 +248,28 @@ int main(int argc, char* argv[]) {
 		}
 
 		if (exportType == "SVG") {
-			convertLandXMLtoSVG(inputFilename.c_str(), outputFilename.c_str());
+			convertLandXMLtoSVG(inputFilename.c_str(), outputFilename.c_str(), contourIntervalArg.getValue());
+		}
+
+		if (exportType == "DXF") {
+			convertLandXMLtoDXF(inputFilename, outputFilename, contourIntervalArg.getValue());
 		}
 
 		if (exportType == "IfcAlignment1x1_XLSX") {
 			convertLandXMLtoIfcAlignment1x1ExcelComparison(inputFilename.c_str(), outputFilename.c_str());
 		}
+
+		if (exportType == "Earthwork") {
+			buw::EarthworkDescription desc;
+			desc.stationInterval = intervalArg.getValue();
+			desc.cellSize = cellSizeArg.getValue();
+			desc.corridorWidth = corridorWidthArg.getValue();
+			computeEarthworkFromLandXML(inputFilename, outputFilename, desc, designArg.getValue());
+		}
+
+		if (exportType == "Hillshade") {
+			exportHillshadeFromLandXML(inputFilename, outputFilename, cellSizeArg.getValue());
+		}
 	} catch (TCLAP::ArgException& e) // catch any exceptions
 	{
 		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
@@ -24,6 +24,12 @@ surface_(surface)
 
 }
 
+OpenInfraPlatform::DataManagement::Command::DeleteSurface::DeleteSurface(buw::ReferenceCounted<buw::RasterSurface> surface) :
+rasterSurface_(surface)
+{
+
+}
+
 OpenInfraPlatform::DataManagement::Command::DeleteSurface::~DeleteSurface()
 {
 
@@ -31,10 +37,16 @@ OpenInfraPlatform::DataManagement::Command::DeleteSurface::~DeleteSurface()
 
 void OpenInfraPlatform::DataManagement::Command::DeleteSurface::execute()
 {
-	OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().deleteSurface(surface_);
+	if (rasterSurface_)
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().deleteSurface(rasterSurface_);
+	else
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().deleteSurface(surface_);
 }
 
 void OpenInfraPlatform::DataManagement::Command::DeleteSurface::unexecute()
 {
-	OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().addSurface(surface_);
+	if (rasterSurface_)
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().addSurface(rasterSurface_);
+	else
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().addSurface(surface_);
 }
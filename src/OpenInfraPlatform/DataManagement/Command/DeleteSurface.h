@@ -20,6 +20,7 @@
 #define OpenInfraPlatform_DataManagement_Command_DeleteSurface_8481e70d_b71a_4983_bef4_224c6281e73a_h
 
 #include "OpenInfraPlatform/Data/terrainDescription.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/RasterSurface.h"
 #include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/Surface.h"
 #include <BlueFramework/Application/DataManagement/Command/ICommand.h>
 #include <BlueFramework/Core/Math/vector.h>
@@ -37,6 +38,8 @@ namespace OpenInfraPlatform
 			public:
 				DeleteSurface(buw::ReferenceCounted<buw::Surface> surface);
 
+				DeleteSurface(buw::ReferenceCounted<buw::RasterSurface> surface);
+
 				virtual ~DeleteSurface();
 
 				//! Execute action.
@@ -47,6 +50,7 @@ namespace OpenInfraPlatform
 
 			private:
 				buw::ReferenceCounted<buw::Surface> surface_;
+				buw::ReferenceCounted<buw::RasterSurface> rasterSurface_;
 
 			}; // end class DeleteSurface
 		} // end namespace Command
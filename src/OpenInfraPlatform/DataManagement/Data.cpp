@@ -671,6 +671,9 @@ void OpenInfraPlatform::DataManagement::Data::importJob(const std::string& filen
 	else if(buwstrFilename.toLower().endsWith(".bin")) {
 		importBINJob(filename);
 	}
+	else if(buwstrFilename.toLower().endsWith(".oipc")) {
+		importPointCloudCacheJob(filename);
+	}
 	else if (buwstrFilename.toLower().endsWith(".d40"))
 	{
 		importer_ = new buw::ImportD40Import(filename);
@@ -732,6 +735,10 @@ void OpenInfraPlatform::DataManagement::Data::jobFinished(int jobID, bool comple
 			{
 				digitalElevationModel_->addSurface(surface);
 			}
+			for (auto surface : importer_->getDigitalElevationModel()->getRasterSurfaces())
+			{
+				digitalElevationModel_->addRasterSurface(surface);
+			}
 			for (auto breakLine : importer_->getDigitalElevationModel()->getBreakLines())
 			{
 				digitalElevationModel_->addBreakLine(breakLine);
@@ -884,6 +891,17 @@ void OpenInfraPlatform::DataManagement::Data::exportSVGJob(const std::string& fi
 	buw::ExportSVG(alignmentModel_, digitalElevationModel_, filename);
 }
 
+void OpenInfraPlatform::DataManagement::Data::exportObj(const std::string& filename)
+{
+	currentJobID_ = AsyncJob::getInstance().startJob(&Data::exportObjJob, this, filename);
+}
+void OpenInfraPlatform::DataManagement::Data::exportObjJob(const std::string& filename)
+{
+	OpenInfraPlatform::AsyncJob::getInstance().updateStatus(std::string("Exporting OBJ ").append(filename));
+
+	buw::ExportObj(alignmentModel_, digitalElevationModel_, filename);
+}
+
 void OpenInfraPlatform::DataManagement::Data::exportOkstra(const std::string& filename, const std::string& version)
 {
 	currentJobID_ = AsyncJob::getInstance().startJob(&Data::exportOkstraJob, this, filename, version);
@@ -948,7 +966,11 @@ void OpenInfraPlatform::DataManagement::Data::exportPointCloud(const std::string
 		QString extension = QString(filename.data()).split(".").back();
 		auto filter = FileIOFilter::FindBestFilterForExtension(extension.toUpper());
 		auto pointCloud = data->getPointCloud();
-		if(pointCloud) {
+		// The cache keeps scalar fields, octree, sections and pairs so that processing can be resumed after loading it.
+		if(pointCloud && extension.toLower() == "oipc") {
+			pointCloud->saveCache(filename.c_str());
+		}
+		else if(pointCloud) {
 			pointCloud->deleteAllScalarFields();
 			int error = FileIOFilter::SaveToFile(std::static_pointer_cast<ccHObject>(pointCloud).get(), QString(filename.data()), FileIOFilter::SaveParameters(), filter);
 		}
@@ -1061,6 +1083,18 @@ void OpenInfraPlatform::DataManagement::Data::deleteSurface(buw::ReferenceCounte
 	pushChange(ChangeFlag::DigitalElevationModel);
 }
 
+void OpenInfraPlatform::DataManagement::Data::addSurface(buw::ReferenceCounted<buw::RasterSurface> surface)
+{
+	digitalElevationModel_->addRasterSurface(surface);
+	pushChange(ChangeFlag::DigitalElevationModel);
+}
+
+void OpenInfraPlatform::DataManagement::Data::deleteSurface(buw::ReferenceCounted<buw::RasterSurface> surface)
+{
+	digitalElevationModel_->deleteRasterSurface(surface);
+	pushChange(ChangeFlag::DigitalElevationModel);
+}
+
 void OpenInfraPlatform::DataManagement::Data::setClearColor( const buw::Color3f& color )
 {
 	clearColor_ = color;
@@ -1109,7 +1143,7 @@ const char* OpenInfraPlatform::DataManagement::Data::getApplicationVersionString
 
 const char* OpenInfraPlatform::DataManagement::Data::getApplicationOpenFileFilter()
 {
-	return "All files (*.*);;LandXML (*.xml);;OKSTRA (*.xml; *.cte);;IfcAlignment BuildingSmart P6 Step File (*.ifc);;TUM Open Infra Platform File (*.bic);;IfcRoad (TUM Proposal) ICCBEI 2015 (*.ifc);;IfcBridge Step File (*.stp)";
+	return "All files (*.*);;LandXML (*.xml);;OKSTRA (*.xml; *.cte);;IfcAlignment BuildingSmart P6 Step File (*.ifc);;TUM Open Infra Platform File (*.bic);;IfcRoad (TUM Proposal) ICCBEI 2015 (*.ifc);;IfcBridge Step File (*.stp);;Point Cloud (*.las; *.bin);;TUM Open Infra Platform Point Cloud Cache (*.oipc)";
 }
 
 const char* OpenInfraPlatform::DataManagement::Data::getApplicationSaveFileFilter()
@@ -1181,7 +1215,7 @@ buw::Vector3d OpenInfraPlatform::DataManagement::Data::getOffset() const
 	if (alignmentModel_ && alignmentModel_->getAlignmentCount() > 0)
 	{
 		auto aabb = alignmentModel_->getExtends();
-		if (digitalElevationModel_ && digitalElevationModel_->getSurfaceCount() > 0)
+		if (digitalElevationModel_ && digitalElevationModel_->hasSurfaces())
 		{
 			minPos = buw::minimizedVector(minPos, aabb.getMinimum());
 			maxPos = buw::maximizedVector(maxPos, aabb.getMaximum());
@@ -1368,6 +1402,23 @@ const int OpenInfraPlatform::DataManagement::Data::getPointCloudPointCount() con
 		return -1;
 }
 
+// Loads the cache next to a LAS or BIN file if it is newer than the file, otherwise imports the file and writes the cache for the next time.
+static buw::ReferenceCounted<buw::PointCloud> importPointCloudWithCache(const std::string& filename)
+{
+	const std::string cacheFilename = filename + ".oipc";
+	if(boost::filesystem::exists(cacheFilename) && boost::filesystem::last_write_time(cacheFilename) >= boost::filesystem::last_write_time(filename)) {
+		auto pointCloud = buw::PointCloud::FromCache(cacheFilename.c_str());
+		if(pointCloud)
+			return pointCloud;
+		BLUE_LOG(warning) << "Ignoring invalid point cloud cache " << cacheFilename << ".";
+	}
+
+	auto pointCloud = buw::PointCloud::FromFile(filename.c_str());
+	if(pointCloud && pointCloud->saveCache(cacheFilename.c_str()) != 0)
+		BLUE_LOG(warning) << "Could not write point cloud cache " << cacheFilename << ".";
+	return pointCloud;
+}
+
 void OpenInfraPlatform::DataManagement::Data::importLAS(const std::string& filename)
 {
 	merge_ = false;
@@ -1387,7 +1438,7 @@ void OpenInfraPlatform::DataManagement::Data::importLASJob(const std::string& fi
 	if (tempPointCloud_)
 		tempPointCloud_ = nullptr;
 
-	tempPointCloud_ = buw::PointCloud::FromFile(filename.c_str());
+	tempPointCloud_ = importPointCloudWithCache(filename);
 }
 
 void OpenInfraPlatform::DataManagement::Data::importBINJob(const std::string& filename)
@@ -1397,7 +1448,17 @@ void OpenInfraPlatform::DataManagement::Data::importBINJob(const std::string& fi
 	if(tempPointCloud_)
 		tempPointCloud_ = nullptr;
 
-	tempPointCloud_ = buw::PointCloud::FromFile(filename.c_str());
+	tempPointCloud_ = importPointCloudWithCache(filename);
+}
+
+void OpenInfraPlatform::DataManagement::Data::importPointCloudCacheJob(const std::string& filename)
+{
+	OpenInfraPlatform::AsyncJob::getInstance().updateStatus(std::string("Loading point cloud cache ").append(filename));
+
+	if(tempPointCloud_)
+		tempPointCloud_ = nullptr;
+
+	tempPointCloud_ = buw::PointCloud::FromCache(filename.c_str());
 }
 
 
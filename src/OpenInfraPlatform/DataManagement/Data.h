@@ -145,6 +145,7 @@ namespace OpenInfraPlatform
 			void exportIfc4x1(const buw::ifcAlignmentExportDescription& desc, const std::string & filename);
 			void exportSVGAdvanced(const std::string& filename);
 			void exportSVG( const std::string& filename );
+			void exportObj(const std::string& filename);
 			void exportLandXML( const std::string& filename );
 			void exportLandInfra(const std::string& filename);
 			void exportOkstra(const std::string& filename, const std::string& version);
@@ -170,6 +171,9 @@ namespace OpenInfraPlatform
 			void addSurface(buw::ReferenceCounted<buw::Surface> surface);
 			void deleteSurface(buw::ReferenceCounted<buw::Surface> surface);
 
+			void addSurface(buw::ReferenceCounted<buw::RasterSurface> surface);
+			void deleteSurface(buw::ReferenceCounted<buw::RasterSurface> surface);
+
 			buw::Vector3d getOffset() const;
 
 			void createRandomTerrain(const buw::terrainDescription& td);
@@ -293,6 +297,7 @@ namespace OpenInfraPlatform
 			void exportIfc4x1Job(const buw::ifcAlignmentExportDescription& desc, const std::string & filename);
 			void exportSVGAdvancedJob(const std::string& filename);
 			void exportSVGJob(const std::string& filename);
+			void exportObjJob(const std::string& filename);
 			void exportLandXMLJob(const std::string& filename);
 			void exportLandInfraJob(const std::string& filename);
 			void exportOkstraJob(const std::string& filename, const std::string& version);
@@ -305,6 +310,7 @@ namespace OpenInfraPlatform
 
 			void importLASJob(const std::string& filename);
 			void importBINJob(const std::string& filename);
+			void importPointCloudCacheJob(const std::string& filename);
 
 			void importXYZJob(const std::string& filename, const buw::Vector2d& start, const buw::Vector2d& end);
 			void createRandomTerrainJob(const buw::terrainDescription& td);
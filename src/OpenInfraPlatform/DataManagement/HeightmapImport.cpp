@@ -24,42 +24,16 @@
 OpenInfraPlatform::DataManagement::HeightmapImport::HeightmapImport(const std::string& filename, const buw::Vector3d& offsetViewArea) :
     buw::Import(filename)
 {
-    buw::ReferenceCounted<buw::Image4b> heightmap = buw::makeReferenceCounted<buw::Image4b>(buw::loadImage4b(filename));
-    buw::ReferenceCounted<buw::Surface> s = std::make_shared<buw::Surface>();
-    s->setName("Random terrain");
-
-    buw::Vector3d p;
+    buw::ReferenceCounted<buw::Image4b> image = buw::makeReferenceCounted<buw::Image4b>(buw::loadImage4b(filename));
     float tileSize = 1;// td.tileSize;
 
-    for(int y = 0; y < heightmap->getHeight(); y++)
-        for(int x = 0; x < heightmap->getWidth(); x++) {
-            float v = heightmap->getPixelColor(x, y).red();
-
-            // Generating the vertex positions
-            p = buw::Vector3d((x - heightmap->getWidth()/2.0) * tileSize, (y - heightmap->getHeight() / 2.0) * tileSize, v) + offsetViewArea;
-            p.z() -= offsetViewArea.z();
-            s->addPoint(p);
-        }
-
-    // Generating the triangle indicies
-    for(int y = 0; y < heightmap->getHeight() - 1; y++) {
-        for(int x = 0; x < heightmap->getWidth() - 1; x++) {
-            float a = x + y      * heightmap->getWidth();
-            float b = x + (y + 1) * heightmap->getWidth();
-            float c = (x + 1) + y	    * heightmap->getWidth();
-
-            buw::Vector3i indicies(a, b, c);
-            s->addTriangle(indicies);
-
-            a = (x + 1) + y		 * heightmap->getWidth();
-            b = x + (y + 1)	 * heightmap->getWidth();
-            c = (x + 1) + (y + 1)	 * heightmap->getWidth();
-
-            buw::Vector3i indicies2(a, b, c);
-            s->addTriangle(indicies2);
-        }
-    }
+    // The red channel gives the height in the range [0, 255].
+    buw::Image<buw::Color1f> heightmap(image->getWidth(), image->getHeight());
+    for(int y = 0; y < image->getHeight(); y++)
+        for(int x = 0; x < image->getWidth(); x++)
+            heightmap.setPixelColor(x, y, buw::Color1f(static_cast<float>(image->getPixelColor(x, y).red())));
 
-    digitalElevationModel_->addSurface(s);
+    buw::ReferenceCounted<buw::RasterSurface> s = buw::claimOwnership<buw::RasterSurface>(buw::RasterSurface::createFromHeightmap(heightmap, tileSize, buw::Vector2d(offsetViewArea.x(), offsetViewArea.y())));
+    digitalElevationModel_->addRasterSurface(s);
 
 }
\ No newline at end of file
@@ -144,6 +144,15 @@ OpenInfraPlatform::DataManagement::RandomTerrainImport::RandomTerrainImport(cons
  //           s->addTriangle(indicies2);
  //       }
  // }
-	buw::ReferenceCounted<buw::Surface> s = buw::claimOwnership<buw::Surface>(buw::Surface::createFromHeightmap(buw::generateRandomHeightmap(td.lod, td.roughness, td.mean, td.deviation), td.tileSize));
-    digitalElevationModel_->addSurface(s);
+	const auto image = buw::generateRandomHeightmap(td.lod, td.roughness, td.mean, td.deviation);
+
+	// Smoothed like Surface::createFromHeightmap, which was used before.
+	buw::Image<buw::Color1f> heightmap(image.getWidth(), image.getHeight());
+	for(int y = 0; y < heightmap.getHeight(); y++)
+		for(int x = 0; x < heightmap.getWidth(); x++)
+			heightmap.setPixelColor(x, y, buw::ColorConverter::convertTo<buw::Color1f>(image.getPixelColor(x, y)));
+	heightmap = BlueFramework::ImageProcessing::applyGaussian<float, 1, buw::eFilterSize::Large>(heightmap, buw::Matrix22f::Identity());
+
+	buw::ReferenceCounted<buw::RasterSurface> s = buw::claimOwnership<buw::RasterSurface>(buw::RasterSurface::createFromHeightmap(heightmap, td.tileSize));
+    digitalElevationModel_->addRasterSurface(s);
 }
\ No newline at end of file
@@ -17,69 +17,192 @@
 
 #include "OpenInfraPlatform/DataManagement/XYZImport.h"
 
-#include <iostream>
-//#include "buw.BlueEngine.h"
-//#include <BlueFramework/Engine/Lexer/SimpleLexer.h>
+#include <QFile>
 
-OpenInfraPlatform::DataManagement::XYZImport::XYZImport(const std::string& filename, const buw::Vector2d& start, const buw::Vector2d& end) :
-	buw::Import(filename)
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace
 {
-	// read the data
-	double x, y, z;
-	std::vector<buw::Vector3d> positions;
-	/*
-	buw::SimpleLexer sl(filename.c_str());
+	inline bool isSeparator(const char c)
+	{
+		return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+	}
 
-	if (!filename.empty())
+	// Parses a decimal number like "-1234.567e2" starting at 'p'. Up to 19 significant digits with an exponent of at most 22 are exact, since the
+	// mantissa and the power of ten are exact doubles and only a single rounding happens. Other numbers fall back to strtod.
+	bool parseNumber(const char*& p, const char* end, double& o_value)
 	{
-		sl.SetIgnoreWhitespace(true);
-		buw::Token token;
+		static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
 
-		// read token
-		bool eof = false;
-		while (sl.ReadToken(token))
+		const char* begin = p;
+		bool bNegative = false;
+		if (p < end && (*p == '-' || *p == '+'))
 		{
-			while (token.GetType() == buw::eTokenType::New_Line)
+			bNegative = *p == '-';
+			p++;
+		}
+
+		std::uint64_t mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		bool bHasDigits = false;
+		for (; p < end && *p >= '0' && *p <= '9'; p++)
+		{
+			bHasDigits = true;
+			if (digits < 19)
 			{
-				if (!sl.ReadToken(token))
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0)
+					digits++;
+			}
+			else
+				exponent++;
+		}
+
+		if (p < end && *p == '.')
+		{
+			p++;
+			for (; p < end && *p >= '0' && *p <= '9'; p++)
+			{
+				bHasDigits = true;
+				if (digits < 19)
 				{
-					eof = true;
-					break;
+					mantissa = mantissa * 10 + (*p - '0');
+					if (mantissa != 0)
+						digits++;
+					exponent--;
 				}
 			}
+		}
+
+		if (!bHasDigits)
+		{
+			p = begin;
+			return false;
+		}
+
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			const char* exponentBegin = p++;
+			bool bNegativeExponent = false;
+			if (p < end && (*p == '-' || *p == '+'))
+			{
+				bNegativeExponent = *p == '-';
+				p++;
+			}
 
-			if (eof)
+			if (p < end && *p >= '0' && *p <= '9')
 			{
-				break;
+				int value = 0;
+				for (; p < end && *p >= '0' && *p <= '9'; p++)
+					value = std::min(value * 10 + (*p - '0'), 100000);
+				exponent += bNegativeExponent ? -value : value;
 			}
+			else
+				p = exponentBegin;
+		}
 
-			BLUE_ASSERT(token.GetType() == buw::eTokenType::Float ||
-				token.GetType() == buw::eTokenType::Integer,
-				"Invalid token");
-			x = token.GetDoubleValue();
-
-			sl.ReadToken(token);
-			BLUE_ASSERT(token.GetType() == buw::eTokenType::Float ||
-				token.GetType() == buw::eTokenType::Integer,
-				"Invalid token");
-			y = token.GetDoubleValue();
-
-			sl.ReadToken(token);
-			BLUE_ASSERT(token.GetType() == buw::eTokenType::Float ||
-				token.GetType() == buw::eTokenType::Integer,
-				"Invalid token");
-			z = token.GetDoubleValue();
-
-			buw::Vector3d tempv(x, y, z);
-			if (tempv.x() < start.x() || tempv.y() < start.y() ||
-				tempv.x() > end.x() || tempv.y() > end.y())
-				continue;
-
-			positions.push_back(tempv);
+		if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22)
+		{
+			double value = static_cast<double>(mantissa);
+			value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+			o_value = bNegative ? -value : value;
+			return true;
 		}
 
-		buw::ReferenceCounted<buw::Surface> surface = buw::createSurfaceFromXYZPoints(positions);
-		digitalElevationModel_->addSurface(surface);
+		char buffer[128];
+		const size_t length = std::min(static_cast<size_t>(p - begin), sizeof(buffer) - 1);
+		std::memcpy(buffer, begin, length);
+		buffer[length] = '\0';
+		o_value = std::strtod(buffer, nullptr);
+		return true;
 	}
-	*/
-}
\ No newline at end of file
+
+	// Parses the lines in [begin, end) and keeps the points within the window. Lines which do not start with three numbers, e.g. headers or
+	// comments, are skipped and further columns are ignored.
+	void parseLines(const char* begin, const char* end, const buw::Vector2d& start, const buw::Vector2d& stop, std::vector<buw::Vector3d>& o_positions)
+	{
+		const char* p = begin;
+		while (p < end)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			if (!lineEnd)
+				lineEnd = end;
+
+			double values[3];
+			int count = 0;
+			while (count < 3)
+			{
+				while (p < lineEnd && isSeparator(*p))
+					p++;
+				if (p == lineEnd || !parseNumber(p, lineEnd, values[count]))
+					break;
+				count++;
+			}
+
+			if (count == 3 && values[0] >= start.x() && values[1] >= start.y() && values[0] <= stop.x() && values[1] <= stop.y())
+				o_positions.push_back(buw::Vector3d(values[0], values[1], values[2]));
+
+			p = lineEnd + 1;
+		}
+	}
+}
+
+OpenInfraPlatform::DataManagement::XYZImport::XYZImport(const std::string& filename, const buw::Vector2d& start, const buw::Vector2d& end) :
+	buw::Import(filename)
+{
+	QFile file(filename.c_str());
+	if (!file.open(QIODevice::ReadOnly))
+		throw buw::Exception("Unable to open the file.");
+
+	const qint64 size = file.size();
+	std::vector<buw::Vector3d> positions;
+	if (size > 0)
+	{
+		const char* data = reinterpret_cast<const char*>(file.map(0, size));
+		if (!data)
+			throw buw::Exception("Unable to map the file.");
+
+		// Split the file into chunks which end after a line break, so each chunk can be parsed on its own.
+		const qint64 chunkSize = 16 << 20;
+		std::vector<qint64> chunkStart(1, 0);
+		while (chunkStart.back() < size)
+		{
+			qint64 next = std::min(chunkStart.back() + chunkSize, size);
+			const char* lineEnd = next < size ? static_cast<const char*>(std::memchr(data + next, '\n', size - next)) : nullptr;
+			chunkStart.push_back(lineEnd ? (lineEnd - data) + 1 : size);
+		}
+
+		const int chunkCount = static_cast<int>(chunkStart.size()) - 1;
+		std::vector<std::vector<buw::Vector3d>> chunks(chunkCount);
+
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < chunkCount; i++)
+		{
+			// Reserve for about 30 characters per line.
+			chunks[i].reserve(static_cast<size_t>((chunkStart[i + 1] - chunkStart[i]) / 30));
+			parseLines(data + chunkStart[i], data + chunkStart[i + 1], start, end, chunks[i]);
+		}
+
+		std::vector<size_t> offsets(chunkCount + 1, 0);
+		for (int i = 0; i < chunkCount; i++)
+			offsets[i + 1] = offsets[i] + chunks[i].size();
+
+		positions.resize(offsets.back());
+#pragma omp parallel for
+		for (int i = 0; i < chunkCount; i++)
+		{
+			std::copy(chunks[i].begin(), chunks[i].end(), positions.begin() + offsets[i]);
+			std::vector<buw::Vector3d>().swap(chunks[i]);
+		}
+
+		file.unmap(const_cast<uchar*>(reinterpret_cast<const uchar*>(data)));
+	}
+	file.close();
+
+	buw::ReferenceCounted<buw::Surface> surface = buw::createSurfaceFromXYZPoints(positions, digitalElevationModel_->getBreakLines());
+	digitalElevationModel_->addSurface(surface);
+}
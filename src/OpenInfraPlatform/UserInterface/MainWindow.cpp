@@ -811,10 +811,18 @@ void OpenInfraPlatform::UserInterface::MainWindow::on_actionExportLandInfra_trig
 	}
 }
 
+void OpenInfraPlatform::UserInterface::MainWindow::on_actionExportObj_triggered() {
+	QString filename = QFileDialog::getSaveFileName(this, tr("Save Document"), QDir::currentPath(), tr("Wavefront OBJ (*.obj)"));
+
+	if (!filename.isNull()) {
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().exportObj(filename.toStdString());
+	}
+}
+
 void OpenInfraPlatform::UserInterface::MainWindow::on_actionExportPointCloud_triggered()
 {
 	if(OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().getPointCloud().get() != nullptr) {
-		QString filename = QFileDialog::getSaveFileName(this, tr("Save Document"), QDir::currentPath(), tr("*.bin;;*.las"));
+		QString filename = QFileDialog::getSaveFileName(this, tr("Save Document"), QDir::currentPath(), tr("*.bin;;*.las;;*.oipc"));
 		if(!filename.isNull()) {
 			OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().exportPointCloud(filename.toStdString());
 		}
@@ -1104,6 +1112,10 @@ void OpenInfraPlatform::UserInterface::MainWindow::onChange(ChangeFlag changeFla
 
 			ui_->comboBoxSurfaces->addItem(surface->getName());
 		}
+
+		// Raster surfaces are listed after the triangulated ones.
+		for (const auto& raster : dem->getRasterSurfaces())
+			ui_->comboBoxSurfaces->addItem(raster->getName());
 	}
 
 	if (changeFlag & ChangeFlag::ProxyModel) {
@@ -2251,6 +2263,11 @@ void OpenInfraPlatform::UserInterface::MainWindow::on_pushButtonDeleteSurface_cl
 	if (dem->getSurfaceCount() > index && index >= 0) {
 		buw::ReferenceCounted<buw::Surface> s = dem->getSurface(index);
 
+		buw::ReferenceCounted<buw::DeleteSurface> actionDeleteSurface = std::make_shared<buw::DeleteSurface>(s);
+		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().execute(actionDeleteSurface);
+	} else if (index >= dem->getSurfaceCount() && index - dem->getSurfaceCount() < static_cast<int>(dem->getRasterSurfaces().size())) {
+		buw::ReferenceCounted<buw::RasterSurface> s = dem->getRasterSurfaces()[index - dem->getSurfaceCount()];
+
 		buw::ReferenceCounted<buw::DeleteSurface> actionDeleteSurface = std::make_shared<buw::DeleteSurface>(s);
 		OpenInfraPlatform::DataManagement::DocumentManager::getInstance().execute(actionDeleteSurface);
 	}
@@ -2542,7 +2559,7 @@ void OpenInfraPlatform::UserInterface::MainWindow::on_pushButtonExtractSegmentat
 	if(dialog.exec() == QMessageBox::StandardButton::Yes) {
 		auto pointCloud = OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().getPointCloud();
 		if(pointCloud) {
-			pointCloud->removeNotSegmentedPoints();
+			pointCloud->removeNotSegmentedPoints(callback_);
 			OpenInfraPlatform::DataManagement::DocumentManager::getInstance().getData().pushChange(OpenInfraPlatform::DataManagement::ChangeFlag::PointCloud);
 		}
 	}
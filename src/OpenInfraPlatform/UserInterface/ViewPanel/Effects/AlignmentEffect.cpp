@@ -58,6 +58,7 @@ AlignmentEffect::~AlignmentEffect()
     designCrossSectionVertexBuffers_.clear();
     roadBodyWireframeVertexBuffers_.clear();
     roadBodySolidVertexBuffers_.clear();
+    corridors_.clear();
 
     lineStripState_ = nullptr;
     lineListState_ = nullptr;
@@ -137,30 +138,47 @@ void AlignmentEffect::setAlignment(buw::ReferenceCounted<buw::AlignmentModel> al
     std::time_t start, end;
     std::time(&start);
 
+    std::map<buw::Alignment2DBased3D*, Corridor> corridors;
+
     for (int index = 0; index < alignmentModel->getAlignmentCount(); index++) {
         auto alignment = alignmentModel->getAlignment(index);
         UINT alignmentId = index;
         UINT alignmentType = 0;
 
-        UINT pickId = OpenInfraPlatform::PickIdGenerator::getInstance().getId();
         buw::ReferenceCounted<OpenInfraPlatform::Infrastructure::Alignment2DBased3D> alignment2D = nullptr;
-        alignmentIds_.insert(std::pair<UINT, int>(pickId, alignmentId));
 
         //const int numSamples = 1000;
         std::vector<VertexTypeWireframe> vertices(0);
        
-        float start = alignment->getStartStation();
-        float end = alignment->getEndStation();
-
         if(alignment->getType() == OpenInfraPlatform::Infrastructure::e3DAlignmentType::e2DBased)
             alignment2D = std::static_pointer_cast<OpenInfraPlatform::Infrastructure::Alignment2DBased3D>(alignment);
-                
 
-        for(float s = start; s < end; s += 0.8) {
-            buw::Vector3f position = (alignment->getPosition(s) + offset).cast<float>();            
+        // The road body of an alignment drawn before keeps its pick id, so that the buffers of its unchanged ranges stay valid.
+        Corridor corridor;
+        auto it = alignment2D ? corridors_.find(alignment2D.get()) : corridors_.end();
+        if(it != corridors_.end() && it->second.builder->getAlignment() == alignment2D) {
+            corridor = it->second;
+            corridor.builder->update();
+        }
+        else {
+            corridor.pickId = OpenInfraPlatform::PickIdGenerator::getInstance().getId();
+            if(alignment2D)
+                corridor.builder = std::make_shared<buw::CorridorMeshBuilder>(alignment2D);
+        }
+
+        const UINT pickId = corridor.pickId;
+        alignmentIds_[pickId] = alignmentId;
+
+        // Vertices where the chords leave the alignment by 5 mm, at least every 20 m so that the element types stay close to their borders.
+        const std::vector<buw::Stationing> stations = alignment->getTessellation(0.005, 20.0);
+        std::vector<buw::Vector3d> positions(stations.size());
+        alignment->getPositions(stations.data(), static_cast<int>(stations.size()), positions.data(), nullptr, nullptr, 0);
+
+        for(size_t i = 0; i < stations.size(); i++) {
+            buw::Vector3f position = (positions[i] + offset).cast<float>();
 
             if(alignment2D && alignment2D->hasHorizontalAlignment())
-                alignmentType = (UINT)alignment2D->getHorizontalAlignment()->getAlignmentElementByStationing(s)->getAlignmentType();
+                alignmentType = (UINT)alignment2D->getHorizontalAlignment()->getAlignmentElementByStationing(stations[i])->getAlignmentType();
             else
                 alignmentType = 0;
             VertexTypeWireframe vertex = { position, alignmentId, alignmentType, pickId };
@@ -181,416 +199,100 @@ void AlignmentEffect::setAlignment(buw::ReferenceCounted<buw::AlignmentModel> al
         }
 
         if(alignment2D) {
-            std::vector<std::vector<VertexTypeWireframe>> crossSectionVertices(alignment2D->getCrossSectionCount());
-            std::vector<std::vector<VertexTypeWireframe>> designCrossSectionVertices(alignment2D->getCrossSectionCount());
-            std::vector<std::vector<VertexTypeWireframe>> roadBodyWireframeVertices(alignment2D->getCrossSectionCount());
-            std::vector<std::vector<VertexTypeSolid>> roadBodySolidVertices(alignment2D->getCrossSectionCount());
-            
-            #pragma omp parallel for firstprivate(alignmentType)
-            for(int sectionIdx = 0; sectionIdx < alignment2D->getCrossSectionCount() - 1; sectionIdx++) {
-                auto crossSection = alignment2D->getCrossSection(sectionIdx);
-                alignmentType = 4;
-
-                buw::Vector3d currentCenter = (alignment2D->getPosition(crossSection->stationing));
-                buw::Vector3d nextCenter = (alignment2D->getPosition(alignment2D->getCrossSection(sectionIdx + 1)->stationing));
-                
-                //auto getRotation44f = [&](buw::ReferenceCounted<OpenInfraPlatform::Infrastructure::CrossSectionStatic> crossSection) {
-                //	auto pos1 = alignment2D->getPosition(crossSection->stationing);
-                //	auto pos2 = alignment2D->getPosition(crossSection->stationing + 0.001f);
-                //	buw::Vector3d direction;
-                //	if(buw::distance(pos2, pos1) > 0.0001) {
-                //		direction = (pos2 - pos1).normalized();
-                //	}
-                //	else {
-                //		pos2 = alignment2D->getPosition(crossSection->stationing + 0.1f);
-                //		direction = (pos2 - pos1).normalized();
-                //	}
-                //	
-                //	buw::Matrix44f rotation = buw::createRotationMatrixZ(
-                //		buw::calculateAngleBetweenVectors(
-                //			buw::Vector2f(1, 0),
-                //			buw::Vector2f(direction.x(), direction.y())
-                //		)
-                //	);
-                //	return rotation;
-                //};
-
-                auto getRotation33d = [&](buw::ReferenceCounted<OpenInfraPlatform::Infrastructure::CrossSectionStatic> crossSection) {
-                    auto pos1 = alignment2D->getPosition(crossSection->stationing);
-                    auto pos2 = alignment2D->getPosition(crossSection->stationing + 0.001);
-                    buw::Vector3d direction;
-                    if(buw::distance(pos2, pos1) > 0.0001) {
-                        direction = (pos2 - pos1).normalized();
-                    }
-                    else {
-                        pos2 = alignment2D->getPosition(crossSection->stationing + 0.01);
-                        if(buw::distance(pos2, pos1) > 0.0001) {
-                            direction = (pos2 - pos1).normalized();
-                        }
-                        else
-                        {
-                            pos2 = alignment2D->getPosition(crossSection->stationing + 0.1);
-                            direction = (pos2 - pos1).normalized();
-                        }
-                    }
-                    buw::Matrix33d rotation = buw::createRotationMatrix3TZ(
-                        buw::calculateAngleBetweenVectors(
-                            buw::Vector2d(-1, 0),
-                            buw::Vector2d(direction.x(), direction.y())
-                        )
-                    );
-                    return rotation;
-                };
-
-                auto rotation = getRotation33d(crossSection);
-                auto nextRotation = getRotation33d(alignment2D->getCrossSection(sectionIdx + 1));
-
-                for(int surfaceIdx = 0; surfaceIdx < crossSection->getCrossSectionProfileCount(); surfaceIdx++) {
-                    auto crossSectionProfile = crossSection->getCrossSectionProfile(surfaceIdx);
-                    
-                    // iterate through all points  of CrossSectionProfile
-
-                    bool isFirstPoint = true;
-                    buw::Vector3d lastPoint;
-                    for(int p = 0; p < crossSectionProfile->pntList2D.size(); p++) {
-                        buw::Vector3d position = buw::Vector3d(
-                            0,
-                            crossSectionProfile->pntList2D[p].x(),
-                            crossSectionProfile->pntList2D[p].y()
-                        );
-
-                        position = rotation * position;
-                        position = buw::Vector3d(
-                            position[0] + currentCenter[0] + offset[0],
-                            position[1] + currentCenter[1] + offset[1],
-                            position[2] + offset[2]
-                        );
-
-                        if(isFirstPoint)
-                            isFirstPoint = false;
-                        else {
-                            crossSectionVertices[sectionIdx].push_back({ buw::Vector3f(lastPoint.x(),lastPoint.y(),lastPoint.z()) ,alignmentId, alignmentType, pickId });
-                            crossSectionVertices[sectionIdx].push_back({ buw::Vector3f(position.x(),position.y(),position.z()) ,alignmentId, alignmentType, pickId });
-                        }
-
-                        lastPoint = position;
-                    }
-
+            const buw::ReferenceCounted<buw::CorridorMeshBuilder>& builder = corridor.builder;
+
+            // The vertices hold the id of the alignment and the offset, all ranges are uploaded again if one of them changed.
+            if(corridor.alignmentId != alignmentId || corridor.offset != offset)
+                corridor.ranges.clear();
+            corridor.alignmentId = alignmentId;
+            corridor.offset = offset;
+            corridor.ranges.resize(builder->getMeshCount());
+
+            auto addLines = [&](std::vector<VertexTypeWireframe>& vertices, const buw::CorridorMesh& mesh, const std::vector<buw::Vector2i>& edges, const UINT type) {
+                for(const buw::Vector2i& edge : edges) {
+                    vertices.push_back({ buw::Vector3f((mesh.points[edge.x()] + offset).cast<float>()), alignmentId, type, pickId });
+                    vertices.push_back({ buw::Vector3f((mesh.points[edge.y()] + offset).cast<float>()), alignmentId, type, pickId });
                 }
-
-                for(int surfaceIdx = 0; surfaceIdx < crossSection->getDesignCrossSectionProfileCount(); surfaceIdx++) {
-                    auto designCrossSectionProfile = crossSection->getDesignCrossSectionProfile(surfaceIdx);
-                    alignmentType = 5;
-                    if(designCrossSectionProfile->crossSectionsPoints.size() > 1) {
-                        buw::Vector3d lastPosition = buw::Vector3d(0, designCrossSectionProfile->crossSectionsPoints[0]->position.x(), designCrossSectionProfile->crossSectionsPoints[0]->position.y());
-                        lastPosition = rotation*lastPosition;
-                        lastPosition += buw::Vector3d(
-                            currentCenter.x() + offset[0],
-                            currentCenter.y() + offset[1],
-                            currentCenter.z() + offset[2]);
-
-                        for(auto point2D = designCrossSectionProfile->crossSectionsPoints.begin() + 1; point2D != designCrossSectionProfile->crossSectionsPoints.end(); point2D++) {
-                            buw::Vector3d position = lastPosition;
-                            designCrossSectionVertices[sectionIdx].push_back({ buw::Vector3f(position.x(),position.y(),position.z()) ,alignmentId, alignmentType, pickId });
-
-                            buw::Vector3d nextPosition = buw::Vector3d(0, point2D->get()->position.x(), point2D->get()->position.y());
-                            nextPosition = rotation * nextPosition;
-                            nextPosition += buw::Vector3d(
-                                currentCenter.x() + offset[0],
-                                currentCenter.y() + offset[1],
-                                currentCenter.z() + offset[2]);
-                            designCrossSectionVertices[sectionIdx].push_back({ buw::Vector3f(nextPosition.x(),nextPosition.y(),nextPosition.z()) ,alignmentId, alignmentType, pickId });
-
-                            lastPosition = nextPosition;
-                        }
+            };
+
+            auto createWireframeBuffer = [&](const std::vector<VertexTypeWireframe>& vertices) -> buw::ReferenceCounted<buw::IVertexBuffer> {
+                if(vertices.size() == 0)
+                    return nullptr;
+
+                buw::vertexBufferDescription vbd;
+                vbd.data = &vertices[0];
+                vbd.vertexCount = static_cast<int>(vertices.size());
+                vbd.vertexLayout = VertexTypeWireframe::getVertexLayout();
+                return renderSystem()->createVertexBuffer(vbd);
+            };
+
+            // Only the ranges the builder built again since their buffers were created are uploaded.
+            for(int meshIdx = 0; meshIdx < builder->getMeshCount(); meshIdx++) {
+                const buw::CorridorMesh& mesh = builder->getMesh(meshIdx);
+                CorridorRange& range = corridor.ranges[meshIdx];
+                if(range.revision == mesh.revision)
+                    continue;
+
+                std::vector<VertexTypeWireframe> crossSectionVertices, designCrossSectionVertices, roadBodyWireframeVertices;
+                std::vector<VertexTypeSolid> roadBodySolidVertices;
+
+                addLines(crossSectionVertices, mesh, mesh.groundEdges, 4);
+                addLines(designCrossSectionVertices, mesh, mesh.profileEdges, 5);
+                addLines(roadBodyWireframeVertices, mesh, mesh.longitudinalEdges, 6);
+
+                // Flat shaded triangles, the builder already turns them out of the road body following the winding of the profiles.
+                for(size_t t = 0; t < mesh.triangles.size(); t++) {
+                    const buw::Vector3i& triangle = mesh.triangles[t];
+                    buw::Vector3d normal = (mesh.points[triangle.y()] - mesh.points[triangle.x()]).cross(mesh.points[triangle.z()] - mesh.points[triangle.x()]);
+                    if(normal.norm() != 0)
+                        normal.normalize();
+
+                    if(mesh.surfaces[t] == buw::eCorridorSurface::Body)
+                        alignmentType = 7;
+                    else if(mesh.surfaces[t] == buw::eCorridorSurface::OpenAbove)
+                        alignmentType = 8;
+                    else
+                        alignmentType = 9;
+
+                    for(int corner = 0; corner < 3; corner++) {
+                        const int index = triangle[corner];
+                        roadBodySolidVertices.push_back(VertexTypeSolid(buw::Vector3f((mesh.points[index] + offset).cast<float>()), normal.cast<float>(), alignmentId, alignmentType, pickId, mesh.textureCoordinates[index].cast<float>()));
                     }
                 }
 
-                auto nextCrossSection = crossSection;
-                if(sectionIdx < alignment2D->getCrossSectionCount() - 1) {
-                    nextCrossSection = alignment2D->getCrossSection(sectionIdx + 1);
-                    
-                    if(crossSection->getClosedDesignCrossSectionProfileCount() == nextCrossSection->getClosedDesignCrossSectionProfileCount()) {
-                        alignmentType = 6;
-                        
-                        for(int closedDesignSurfaceIdx = 0; closedDesignSurfaceIdx < crossSection->getClosedDesignCrossSectionProfileCount(); closedDesignSurfaceIdx++) {
-                            buw::ReferenceCounted<buw::DesignCrossSectionProfile> startProfile = crossSection->getClosedDesignCrossSectionProfile(closedDesignSurfaceIdx);
-                            buw::ReferenceCounted<buw::DesignCrossSectionProfile> endProfile = nextCrossSection->getClosedDesignCrossSectionProfile(closedDesignSurfaceIdx);
-                            alignmentType = 6;
-                            if(startProfile->crossSectionsPoints.size() == endProfile->crossSectionsPoints.size()) {
-                                buw::Vector3d previousStartPoint;
-                                buw::Vector3d previousEndPoint;
-
-                                bool isSlope = false;
-                                int slopeType = 0;
-                                bool isTopFace = false;
-
-                                for(int pointIdx = 0; pointIdx < startProfile->crossSectionsPoints.size(); pointIdx++) {
-                                    if(startProfile->crossSectionsPoints.size() == 2) isSlope = true;
-                                    bool left = false, right = false;
-
-                                    buw::Vector3d startPoint = buw::Vector3d(
-                                        0,
-                                        startProfile->crossSectionsPoints[pointIdx]->position.x(),
-                                        startProfile->crossSectionsPoints[pointIdx]->position.y()										
-                                    );
-                                    
-                                    // points on greater station
-                                    buw::Vector3d endPoint = buw::Vector3d(
-                                        0,
-                                        endProfile->crossSectionsPoints[pointIdx]->position.x(),
-                                        endProfile->crossSectionsPoints[pointIdx]->position.y()
-                                    );
-
-                                    if(startPoint == buw::Vector3d(0, 0, 0) || endPoint == buw::Vector3d(0, 0, 0))
-                                        isTopFace = true;
-
-                                    
-                                    if(startPoint.y() < 0)
-                                        right = true;
-                                    else
-                                        left = true;
-
-
-                                    // transform points on smaller station
-                                    startPoint = rotation * startPoint + currentCenter + offset;
-
-                                    endPoint = nextRotation * endPoint + nextCenter + offset;
-
-                                    roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(startPoint.x(),startPoint.y(),startPoint.z()) ,alignmentId, alignmentType, pickId });
-                                    roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()) ,alignmentId, alignmentType, pickId });
-
-                                    if(pointIdx > 0 && isTopFace) {
-                                        float segmentLength = (currentCenter - nextCenter).norm();
-                                        alignmentType = 7;
-
-                                        buw::Vector3f normal1 = (buw::Vector3f)(previousStartPoint - endPoint).cross(startPoint - endPoint).cast<float>();
-                                        if(normal1.norm()!=0)
-                                            normal1.normalize();
-                                        buw::Vector3f normal2 = (buw::Vector3f)(previousStartPoint - endPoint).cross(startPoint - endPoint).cast<float>();
-                                        if(normal2.norm()!=0)
-                                            normal2.normalize();
-                                        
-                                        if(right) {
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousStartPoint.x(), previousStartPoint.y(), previousStartPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(0, 0)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousEndPoint.x(), previousEndPoint.y(), previousEndPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(0, segmentLength)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(endPoint.x(), endPoint.y(), endPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(1, segmentLength)));
-
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(startPoint.x(), startPoint.y(), startPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(1, 0)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousStartPoint.x(), previousStartPoint.y(), previousStartPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(0,0)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(endPoint.x(), endPoint.y(), endPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(1, segmentLength)));
-                                        }
-                                        else
-                                        {
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousStartPoint.x(), previousStartPoint.y(), previousStartPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(0, 0)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(endPoint.x(), endPoint.y(), endPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(1, segmentLength)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousEndPoint.x(), previousEndPoint.y(), previousEndPoint.z()), normal1, alignmentId, alignmentType, pickId, buw::Vector2f(0, segmentLength)));
-
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(startPoint.x(), startPoint.y(), startPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(1, 0)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(endPoint.x(), endPoint.y(), endPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(1, segmentLength)));
-                                            roadBodySolidVertices[sectionIdx].push_back(VertexTypeSolid(buw::Vector3f(previousStartPoint.x(), previousStartPoint.y(), previousStartPoint.z()), normal2, alignmentId, alignmentType, pickId, buw::Vector2f(0, 0)));
-                                        }
-                                    }
-
-                                    previousStartPoint = startPoint;
-                                    previousEndPoint = endPoint;
-                                }
-
-                            }
-                        }
-                        
-                    }
-                    
-                    if(crossSection->getOpenDesignCrossSectionProfileCount() == nextCrossSection->getOpenDesignCrossSectionProfileCount()) {
-                        for(int openDesignSurfaceIdx = 0; openDesignSurfaceIdx < crossSection->getOpenDesignCrossSectionProfileCount(); openDesignSurfaceIdx++) {
-                            buw::ReferenceCounted<buw::DesignCrossSectionProfile> startProfile = crossSection->getOpenDesignCrossSectionProfile(openDesignSurfaceIdx);
-                            buw::ReferenceCounted<buw::DesignCrossSectionProfile> endProfile = nextCrossSection->getOpenDesignCrossSectionProfile(openDesignSurfaceIdx);
-                            alignmentType = 6;
-                            if(startProfile->crossSectionsPoints.size() == endProfile->crossSectionsPoints.size()) {
-                                buw::Vector3d previousStartPoint;
-                                buw::Vector3d previousEndPoint;
-
-                                bool isSlope = false;
-                                int slopeType = 0;
-                                bool isTopFace = false;
-
-                                for(int pointIdx = 0; pointIdx < startProfile->crossSectionsPoints.size(); pointIdx++) {
-                                    if(startProfile->crossSectionsPoints.size() == 2) isSlope = true;
-                                    bool right = false;
-                                    buw::Vector3d startPoint = buw::Vector3d(
-                                        0,
-                                        startProfile->crossSectionsPoints[pointIdx]->position.x(),
-                                        startProfile->crossSectionsPoints[pointIdx]->position.y()										
-                                    );
-
-                                    if(startPoint.y() >= 0)
-                                        right = true;
-                                    
-                                    
-
-                                    // transform points on smaller station
-                                    startPoint = rotation * startPoint + currentCenter + offset;
-
-                                    // points on greater station
-                                    buw::Vector3d endPoint = buw::Vector3d(
-                                        0,
-                                        endProfile->crossSectionsPoints[pointIdx]->position.x(),
-                                        endProfile->crossSectionsPoints[pointIdx]->position.y()
-                                    );
-
-                                    endPoint = nextRotation * endPoint + nextCenter + offset;
-
-
-                                    if(pointIdx > 0) {										
-                                        float segmentLength = (currentCenter - nextCenter).norm();
-                                        auto tempEndPoint = endPoint;
-                                        double lerpParameter = 0.0;
-
-                                        if(startProfile->crossSectionsPoints[pointIdx]->position.y() < 0)
-                                            alignmentType = 9;
-                                        else
-                                            alignmentType = 8;
-
-                                        if(startProfile->crossSectionsPoints[pointIdx]->position.y() * endProfile->crossSectionsPoints[pointIdx]->position.y() < 0) {
-                                            double h1 = (startPoint - previousStartPoint).norm();
-                                            double h2 = (endPoint - previousEndPoint).norm();
-                                        
-                                            BLUE_ASSERT(h1 > 0 || h2 > 0)
-                                            lerpParameter = (h1 / h2) / (h1 / h2 + 1.0);
-                                        
-                                            endPoint = buw::lerp(previousStartPoint, previousEndPoint, lerpParameter);									
-                                        }
-                                        alignmentType = 7;
-
-                                        roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(startPoint.x(),startPoint.y(),startPoint.z()) ,alignmentId, alignmentType, pickId });
-                                        roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()) ,alignmentId, alignmentType, pickId });
-
-                                        if(startProfile->crossSectionsPoints[pointIdx]->position.y() < 0)
-                                            alignmentType = 9;
-                                        else 
-                                            alignmentType = 8;
-
-                                        buw::Vector3f normal1 = (buw::Vector3f)(previousStartPoint - endPoint).cross(startPoint - endPoint).cast<float>();
-                                        if(normal1.norm() != 0)
-                                            normal1.normalize();
-
-                                        
-                                        if(right) {
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousStartPoint.x(),previousStartPoint.y(),previousStartPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,0) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(startPoint.x(),startPoint.y(),startPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,0) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,segmentLength) });
-                                        }
-                                        else {
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousStartPoint.x(),previousStartPoint.y(),previousStartPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,0) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,segmentLength) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(startPoint.x(),startPoint.y(),startPoint.z()),normal1 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,0) });
-                                        }
-                                        if(startProfile->crossSectionsPoints[pointIdx]->position.y() * endProfile->crossSectionsPoints[pointIdx]->position.y() < 0) {
-                                        
-                                            endPoint = tempEndPoint;
-                                            previousStartPoint = buw::lerp(previousStartPoint, previousEndPoint, lerpParameter);
-                                        
-                                            alignmentType = 7;
-                                        
-                                            roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(previousStartPoint.x(),previousStartPoint.y(),previousStartPoint.z()) ,alignmentId, alignmentType, pickId });
-                                            roadBodyWireframeVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()) ,alignmentId, alignmentType, pickId });
-
-                                            if(startProfile->crossSectionsPoints[pointIdx]->position.y() < 0)
-                                                alignmentType = 8;
-                                            else 
-                                                alignmentType = 9;
-                                        }
-                                                                    
-                                        buw::Vector3f normal2 = (buw::Vector3f)(endPoint - previousStartPoint).cross(previousEndPoint - previousStartPoint).cast<float>();
-                                        if(normal2.norm() != 0)
-                                            normal2.normalize();
-
-                                        if(right) {
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousStartPoint.x(),previousStartPoint.y(),previousStartPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,0) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,segmentLength) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousEndPoint.x(),previousEndPoint.y(),previousEndPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,segmentLength) });
-                                        }
-                                        else {
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousStartPoint.x(),previousStartPoint.y(),previousStartPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,0) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(previousEndPoint.x(),previousEndPoint.y(),previousEndPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(0,segmentLength) });
-                                            roadBodySolidVertices[sectionIdx].push_back({ buw::Vector3f(endPoint.x(),endPoint.y(),endPoint.z()),normal2 ,alignmentId, alignmentType, pickId, buw::Vector2f(1,segmentLength) });
-                                        }
-                                    }									
-
-                                    previousStartPoint = startPoint;
-                                    previousEndPoint = endPoint;
-                                }
-
-                            }
-                        }
-                    }
-                }
-            }
+                range.revision = mesh.revision;
+                range.crossSectionVertexBuffer = createWireframeBuffer(crossSectionVertices);
+                range.designCrossSectionVertexBuffer = createWireframeBuffer(designCrossSectionVertices);
+                range.roadBodyWireframeVertexBuffer = createWireframeBuffer(roadBodyWireframeVertices);
+                range.roadBodySolidVertexBuffer = nullptr;
 
-            if(crossSectionVertices.size() >= 1) {
-                std::vector<VertexTypeWireframe> vertices(0);
-                for(int i = 0; i < crossSectionVertices.size(); i++)
-                    vertices.insert(vertices.end(), crossSectionVertices[i].begin(), crossSectionVertices[i].end());
-                if(vertices.size() > 0) {
+                if(roadBodySolidVertices.size() > 0) {
                     buw::vertexBufferDescription vbd;
-                    vbd.data = &vertices[0];
-                    vbd.vertexCount = static_cast<int>(vertices.size());
-                    vbd.vertexLayout = VertexTypeWireframe::getVertexLayout();
-
-                    auto vertexBuffer = renderSystem()->createVertexBuffer(vbd);
-                    crossSectionVertexBuffers_.push_back(vertexBuffer);
-                }
-            }
-
-            if(designCrossSectionVertices.size() >= 1) {
-                std::vector<VertexTypeWireframe> vertices(0);
-                for(int i = 0; i < designCrossSectionVertices.size(); i++)
-                    vertices.insert(vertices.end(), designCrossSectionVertices[i].begin(), designCrossSectionVertices[i].end());
-
-                if(vertices.size() > 0) {
-                    buw::vertexBufferDescription vbd;
-                    vbd.data = &vertices[0];
-                    vbd.vertexCount = static_cast<int>(vertices.size());
-                    vbd.vertexLayout = VertexTypeWireframe::getVertexLayout();
+                    vbd.data = &roadBodySolidVertices[0];
+                    vbd.vertexCount = static_cast<int>(roadBodySolidVertices.size());
+                    vbd.vertexLayout = VertexTypeSolid::getVertexLayout();
 
-                    auto vertexBuffer = renderSystem()->createVertexBuffer(vbd);
-                    designCrossSectionVertexBuffers_.push_back(vertexBuffer);
+                    range.roadBodySolidVertexBuffer = renderSystem()->createVertexBuffer(vbd);
                 }
             }
 
-            if(roadBodyWireframeVertices.size() > 0) {
-                std::vector<VertexTypeWireframe> vertices(0);
-                for(int i = 0; i < roadBodyWireframeVertices.size(); i++)
-                    vertices.insert(vertices.end(), roadBodyWireframeVertices[i].begin(), roadBodyWireframeVertices[i].end());
-
-                if(vertices.size() > 0) {
-                    buw::vertexBufferDescription vbd;
-                    vbd.data = &vertices[0];
-                    vbd.vertexCount = static_cast<int>(vertices.size());
-                    vbd.vertexLayout = VertexTypeWireframe::getVertexLayout();
-
-                    auto vertexBuffer = renderSystem()->createVertexBuffer(vbd);
-                    roadBodyWireframeVertexBuffers_.push_back(vertexBuffer);
-                }
+            for(const CorridorRange& range : corridor.ranges) {
+                if(range.crossSectionVertexBuffer)
+                    crossSectionVertexBuffers_.push_back(range.crossSectionVertexBuffer);
+                if(range.designCrossSectionVertexBuffer)
+                    designCrossSectionVertexBuffers_.push_back(range.designCrossSectionVertexBuffer);
+                if(range.roadBodyWireframeVertexBuffer)
+                    roadBodyWireframeVertexBuffers_.push_back(range.roadBodyWireframeVertexBuffer);
+                if(range.roadBodySolidVertexBuffer)
+                    roadBodySolidVertexBuffers_.push_back(range.roadBodySolidVertexBuffer);
             }
 
-            if(roadBodySolidVertices.size() > 0) {
-                std::vector<VertexTypeSolid> vertices(0);
-                for(int i = 0; i < roadBodySolidVertices.size(); i++)
-                    vertices.insert(vertices.end(), roadBodySolidVertices[i].begin(), roadBodySolidVertices[i].end());
-
-                if(vertices.size() > 0) {
-                    buw::vertexBufferDescription vbd;
-                    vbd.data = &vertices[0];
-                    vbd.vertexCount = static_cast<int>(vertices.size());
-                    vbd.vertexLayout = VertexTypeSolid::getVertexLayout();
-
-                    auto vertexBuffer = renderSystem()->createVertexBuffer(vbd);
-                    roadBodySolidVertexBuffers_.push_back(vertexBuffer);
-                }
-            }
-        }        
+            corridors[alignment2D.get()] = corridor;
+        }
     }	
+
+    // Road bodies of removed alignments are dropped.
+    corridors_.swap(corridors);
     
     printf("Time passed: %.5f \n", difftime(time(&end), start));
 }
@@ -20,6 +20,7 @@
 #define OpenInfraPlatform_UserInterface_AlignmentEffect_8ae12bd5_fa99_492b_9eda_4b1563bc3edf_h
 
 #include "OpenInfraPlatform/Infrastructure/Alignment/AlignmentModel.h"
+#include "OpenInfraPlatform/Infrastructure/CrossSection/CorridorMeshBuilder.h"
 #include "OpenInfraPlatform/namespace.h"
 #include <boost/signals2.hpp>
 
@@ -80,6 +81,7 @@ public:
     void drawRoadBodyTextured(const bool checked);
     void drawFlattened(const bool checked);
 
+    //! Builds and uploads the road bodies again only where they changed.
     void setAlignment(buw::ReferenceCounted<buw::AlignmentModel> alignmentModel, buw::Vector3d& offset);
     void loadShader();
 
@@ -130,6 +132,27 @@ private:
 
     std::map<UINT, int> alignmentIds_;
 
+    // Vertex buffers of the road body between two consecutive cross sections and the revision of the mesh they were created from.
+    struct CorridorRange {
+        int revision = -1;
+        buw::ReferenceCounted<buw::IVertexBuffer>
+            crossSectionVertexBuffer = nullptr,
+            designCrossSectionVertexBuffer = nullptr,
+            roadBodyWireframeVertexBuffer = nullptr,
+            roadBodySolidVertexBuffer = nullptr;
+    };
+
+    // Road body of an alignment, kept to build and upload only the ranges which changed on the next setAlignment.
+    struct Corridor {
+        buw::ReferenceCounted<buw::CorridorMeshBuilder> builder = nullptr;
+        UINT alignmentId = 0;
+        UINT pickId = 0;
+        buw::Vector3d offset = buw::Vector3d::Zero();
+        std::vector<CorridorRange> ranges;
+    };
+
+    std::map<buw::Alignment2DBased3D*, Corridor> corridors_;
+
     SettingsBuffer settings_;
     ColorBuffer colors_;
 
@@ -40,49 +40,143 @@ DEMEffect::DEMEffect(buw::IRenderSystem* renderSystem,
 {
 }
 
+DEMEffect::~DEMEffect() {
+	if (terrainBuildThread_.joinable())
+		terrainBuildThread_.join();
+}
+
 void DEMEffect::setDEM(buw::ReferenceCounted<buw::DigitalElevationModel> dem, buw::Vector3d& offset) {
     settings_.maxHeight = dem->getMaximumHeight();
     settings_.minHeight = dem->getMinimumHeight();
 
-	buw::VertexLayout vertexLayout = buw::VertexPosition3::getVertexLayout();
+	// The buffers are created again with the new offset when they are drawn.
+	offset_ = offset;
+	for (auto& tiles : terrainTiles_)
+		for (auto& tile : tiles)
+			for (auto& level : tile.levels)
+				level = TerrainLevel();
+
+	// Surfaces are not modified after they are added to the model, so the worker thread can use them while the model changes.
+	pendingSurfaces_ = dem->getSurfaces();
+	pendingRasterSurfaces_ = dem->getRasterSurfaces();
+	bTerrainBuildPending_ = true;
+
+	if (!terrainBuildThread_.joinable())
+		startTerrainBuild();
+}
+
+void DEMEffect::startTerrainBuild() {
+	std::vector<buw::ReferenceCounted<buw::Surface>> surfaces;
+	std::vector<buw::ReferenceCounted<buw::RasterSurface>> rasterSurfaces;
+	surfaces.swap(pendingSurfaces_);
+	rasterSurfaces.swap(pendingRasterSurfaces_);
+	bTerrainBuildPending_ = false;
+	bTerrainBuilt_ = false;
+
+	// Each surface is split into tiles with several levels of detail, raster surfaces are triangulated only for this.
+	terrainBuildThread_ = std::thread([this, surfaces, rasterSurfaces]() {
+		std::vector<buw::ReferenceCounted<buw::TerrainLOD>> lods;
+		auto addSurface = [&lods](const buw::Surface& surface) {
+			buw::ReferenceCounted<buw::TerrainLOD> lod = buw::makeReferenceCounted<buw::TerrainLOD>(surface);
+			if (lod->getTileCount() > 0)
+				lods.push_back(lod);
+		};
+
+		for (const auto& surface : surfaces)
+			addSurface(*surface);
+		for (const auto& raster : rasterSurfaces)
+			addSurface(*raster->createSurface());
+
+		builtTerrainLODs_.swap(lods);
+		bTerrainBuilt_ = true;
+	});
+}
 
+bool DEMEffect::updateTerrain() {
+	if (!bTerrainBuilt_)
+		return false;
+
+	terrainBuildThread_.join();
+	bTerrainBuilt_ = false;
+
+	terrainLODs_.swap(builtTerrainLODs_);
+	builtTerrainLODs_.clear();
+	terrainTiles_.clear();
+	for (const auto& lod : terrainLODs_) {
+		std::vector<TerrainTile> tiles(lod->getTileCount());
+		for (auto& tile : tiles)
+			tile.levels.resize(lod->getLevelCount());
+		terrainTiles_.push_back(tiles);
+	}
+
+	// The DEM changed again while the levels were built.
+	if (bTerrainBuildPending_)
+		startTerrainBuild();
+
+	return true;
+}
+
+void DEMEffect::createTerrainBuffers(const buw::TerrainLODMesh& mesh, TerrainLevel& level) {
 	std::vector<buw::VertexPosition3> vertices;
+	vertices.reserve(mesh.points.size());
+	for (const auto& point : mesh.points) {
+		buw::Vector3f vertex = (point + offset_).cast<float>();
+		vertices.push_back(buw::VertexPosition3(vertex));
+	}
+
 	std::vector<unsigned int> indices;
-	int indexOffset = 0;
+	indices.reserve(3 * mesh.triangles.size());
+	for (const auto& triangle : mesh.triangles) {
+		indices.push_back(triangle.x());
+		indices.push_back(triangle.y());
+		indices.push_back(triangle.z());
+	}
 
-	for (const auto& surface : dem->getSurfaces()) {
-		for (const auto& point : surface->getPoints()) {
-			buw::Vector3f vertex = (point + offset).cast<float>();
-			vertices.push_back(buw::VertexPosition3(vertex));
-		}
-		for (const auto& triangle : surface->getTriangeFaces()) {
-			indices.push_back(indexOffset + triangle.x());
-			indices.push_back(indexOffset + triangle.y());
-			indices.push_back(indexOffset + triangle.z());
-		}
+	buw::vertexBufferDescription vbd;
+	vbd.data = vertices.data();
+	vbd.vertexCount = static_cast<int>(vertices.size());
+	vbd.vertexLayout = buw::VertexPosition3::getVertexLayout();
+
+	buw::indexBufferDescription idb;
+	idb.data = indices.data();
+	idb.indexCount = static_cast<int>(indices.size());
+	idb.format = buw::eIndexBufferFormat::UnsignedInt32;
+
+	level.vertexBuffer = renderSystem()->createVertexBuffer(vbd);
+	level.indexBuffer = renderSystem()->createIndexBuffer(idb);
+}
 
-		indexOffset += surface->getPointCount();
+void DEMEffect::setCameraPosition(const buw::Vector3f& position) {
+	cameraPosition_ = position.cast<double>() - offset_;
+}
+
+void DEMEffect::drawTerrainTiles() {
+	for (size_t i = 0; i < terrainLODs_.size(); i++) {
+		std::vector<int> levels = terrainLODs_[i]->selectLevels(cameraPosition_, errorPerDistance_);
+		for (size_t tile = 0; tile < levels.size(); tile++) {
+			const buw::TerrainLODMesh& mesh = terrainLODs_[i]->getMesh(static_cast<int>(tile), levels[tile]);
+			if (mesh.triangles.empty())
+				continue;
+
+			// Only the levels which are drawn get buffers.
+			TerrainLevel& level = terrainTiles_[i][tile].levels[levels[tile]];
+			if (!level.vertexBuffer)
+				createTerrainBuffers(mesh, level);
+			level.lastFrame = frame_;
+
+			setVertexBuffer(level.vertexBuffer);
+			setIndexBuffer(level.indexBuffer);
+			drawIndexed(static_cast<UINT>(level.indexBuffer->getIndexCount()));
+		}
 	}
+}
 
-	if (vertices.size() > 0) {
-		buw::vertexBufferDescription vbd;
-		vbd.data = &vertices[0];
-		vbd.vertexCount = static_cast<int>(vertices.size());
-		vbd.vertexLayout = vertexLayout;
-
-		vertexBuffer_ = renderSystem()->createVertexBuffer(vbd);
-	} else
-		vertexBuffer_ = nullptr;
-
-	if (indices.size() > 0) {
-		buw::indexBufferDescription idb;
-		idb.data = &indices[0];
-		idb.indexCount = static_cast<int>(indices.size());
-		idb.format = buw::eIndexBufferFormat::UnsignedInt32;
-
-		indexBuffer_ = renderSystem()->createIndexBuffer(idb);
-	} else
-		indexBuffer_ = nullptr;
+void DEMEffect::evictTerrainBuffers() {
+	for (auto& tiles : terrainTiles_)
+		for (auto& tile : tiles)
+			for (auto& level : tile.levels)
+				if (level.vertexBuffer && frame_ - level.lastFrame > evictionFrameCount_)
+					level = TerrainLevel();
 }
 
 void DEMEffect::loadShader() {
@@ -167,7 +261,7 @@ void DEMEffect::v_render() {
 		return;
 	}
 
-	if (pipelineStateSolid_ && vertexBuffer_ && indexBuffer_) {
+	if (pipelineStateSolid_ && !terrainTiles_.empty()) {
 		updateSettingsBuffer(settings_);
 
 		buw::ReferenceCounted<buw::ITexture2D> renderTarget = renderSystem()->getBackBufferTarget();
@@ -191,14 +285,11 @@ void DEMEffect::v_render() {
             setSampler(colorRampSampler_, "colorRampSampler_");
             setTexture(gradientRampTexture_, "texGradientRamp");
         }
-                
-		setVertexBuffer(vertexBuffer_);
-		setIndexBuffer(indexBuffer_);
 
 		setConstantBuffer(worldBuffer_, "WorldBuffer");
 		setConstantBuffer(cbSettingsBuffer_, "SettingsBuffer");
 
-		drawIndexed(static_cast<UINT>(indexBuffer_->getIndexCount()));
+		drawTerrainTiles();
 
         //render to pick buffer and non multisampled depth stencil
         {
@@ -206,13 +297,13 @@ void DEMEffect::v_render() {
             setRenderTarget(pickBuffer_, depthStencil_);
             setViewport(viewport_);
 
-            setVertexBuffer(vertexBuffer_);
-            setIndexBuffer(indexBuffer_);
-
             setConstantBuffer(worldBuffer_, "WorldBuffer");
 
-            drawIndexed(static_cast<UINT>(indexBuffer_->getIndexCount()));
+            drawTerrainTiles();
         }
+
+		evictTerrainBuffers();
+		frame_++;
 	}
 }
 
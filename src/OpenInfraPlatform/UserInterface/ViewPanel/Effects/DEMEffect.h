@@ -20,10 +20,15 @@
 #define OpenInfraPlatform_UserInterface_DEMEffect_fac1f76b_d5ec_452f_9ba1_3878cb359839_h
 
 #include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/DigitalElevationModel.h"
+#include "OpenInfraPlatform/Infrastructure/DigitalElevationModel/TerrainLOD.h"
 #include "OpenInfraPlatform/namespace.h"
 
 #include <buw.Rasterizer.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 OIP_NAMESPACE_OPENINFRAPLATFORM_UI_BEGIN
 
 class DEMEffect : public buw::Effect {
@@ -47,9 +52,19 @@ public:
 	                     buw::ReferenceCounted<buw::ITexture2D> depthStencil,
 	                     buw::ReferenceCounted<buw::IConstantBuffer> worldBuffer);
 
+	virtual ~DEMEffect();
+
+	//! Builds the levels of detail of the surfaces on a worker thread, the previous terrain is drawn until updateTerrain takes them over.
 	void setDEM(buw::ReferenceCounted<buw::DigitalElevationModel> dem, buw::Vector3d& offset);
+
+	//! Takes over the levels of detail once the worker thread has built them. Returns true if the terrain changed and has to be redrawn.
+	bool updateTerrain();
+
 	void loadShader();
 
+	//! Sets the camera position in scene coordinates which selects the level of detail of each terrain tile.
+	void setCameraPosition(const buw::Vector3f& position);
+
 	void setDrawTerrainWireframe(const bool enable);
 
 	void hideTerrain(const bool checked);
@@ -63,8 +78,27 @@ public:
 	void enableSnow(const bool checked);
 
 private:
+	// Buffers of one level of a tile, only created while the level is drawn.
+	struct TerrainLevel {
+		buw::ReferenceCounted<buw::IVertexBuffer> vertexBuffer;
+		buw::ReferenceCounted<buw::IIndexBuffer> indexBuffer;
+		int lastFrame = -1;
+	};
+
+	struct TerrainTile {
+		std::vector<TerrainLevel> levels;
+	};
+
 	void updateSettingsBuffer(SettingsBuffer& buffer);
 
+	void startTerrainBuild();
+
+	void createTerrainBuffers(const buw::TerrainLODMesh& mesh, TerrainLevel& level);
+
+	void drawTerrainTiles();
+
+	void evictTerrainBuffers();
+
 private:
 	void v_init();
 	void v_render();
@@ -85,8 +119,29 @@ private:
 
 	buw::ReferenceCounted<buw::IConstantBuffer> cbSettingsBuffer_;
 
-	buw::ReferenceCounted<buw::IVertexBuffer> vertexBuffer_;
-	buw::ReferenceCounted<buw::IIndexBuffer> indexBuffer_;
+	// levels of detail of each surface and the buffers of the levels drawn in the last frames
+	std::vector<buw::ReferenceCounted<buw::TerrainLOD>> terrainLODs_;
+	std::vector<std::vector<TerrainTile>> terrainTiles_;
+	int frame_ = 0;
+
+	// buffers of levels which have not been drawn for this many frames are released
+	int evictionFrameCount_ = 60;
+
+	// surfaces of the last DEM which is built as soon as the worker thread is free
+	std::vector<buw::ReferenceCounted<buw::Surface>> pendingSurfaces_;
+	std::vector<buw::ReferenceCounted<buw::RasterSurface>> pendingRasterSurfaces_;
+	bool bTerrainBuildPending_ = false;
+
+	// worker thread building the levels of detail, its result is only read after bTerrainBuilt_ is set
+	std::thread terrainBuildThread_;
+	std::atomic<bool> bTerrainBuilt_{ false };
+	std::vector<buw::ReferenceCounted<buw::TerrainLOD>> builtTerrainLODs_;
+
+	buw::Vector3d offset_ = buw::Vector3d(0, 0, 0);
+	buw::Vector3d cameraPosition_ = buw::Vector3d(0, 0, 0);
+
+	// tolerated vertical error per distance to the camera, about a pixel for a full HD viewport
+	double errorPerDistance_ = 1e-3;
 
 	buw::ReferenceCounted<buw::ITexture2D> texture_;
 	buw::ReferenceCounted<buw::ITexture1D> gradientRampTexture_;
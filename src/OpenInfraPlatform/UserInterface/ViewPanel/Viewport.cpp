@@ -743,6 +743,8 @@ void Viewport::updateWorldBuffer() {
     cbd.sizeInBytes = sizeof(WorldBuffer);
     cbd.data = &world;
     worldBuffer_->uploadData(cbd);
+
+    demEffect_->setCameraPosition(world.cam);
 }
 
 void Viewport::tick() {
@@ -752,7 +754,8 @@ void Viewport::tick() {
     cameraController_->tick(delta);
     camera_->tick(delta);
 
-	if(cameraController_->isCameraMoving()) {
+	// The levels of detail of the terrain are built in the background.
+	if(demEffect_->updateTerrain() || cameraController_->isCameraMoving()) {
 		repaint();
 	}
 
@@ -780,7 +783,7 @@ void Viewport::onChange(ChangeFlag changeFlag) {
     min = buw::Vector3d(-1, -1, -1);
     max = buw::Vector3d(1, 1, 1);
 
-    if (dem && dem->getSurfaceCount() > 0)
+    if (dem && dem->hasSurfaces())
         dem->getSurfacesExtend(min, max);
     else if (alignment && alignment->getAlignmentCount() > 0) {
         auto bb = alignment->getExtends();
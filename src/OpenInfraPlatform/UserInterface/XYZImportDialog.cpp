@@ -58,7 +58,7 @@ void OpenInfraPlatform::UserInterface::XYZImportDialog::on_pushButtonImport_clic
 {
 
 	bool useRestriction = ui_->restrict_radioButton->isChecked();
-	buw::Vector2d start = buw::Vector2d::Ones() * std::numeric_limits<double>::min();
+	buw::Vector2d start = buw::Vector2d::Ones() * std::numeric_limits<double>::lowest();
 	buw::Vector2d end = buw::Vector2d::Ones() * std::numeric_limits<double>::max();
 
 	if (useRestriction)